@@ -739,3 +739,39 @@ Feature: Car - Turn restrictions
             | from | to | route                       | turns                                            |
             | a    | c  | albic,dobe,dobe,albic,albic | depart,turn left,continue uturn,turn left,arrive |
             | a    | e  | albic,dobe,dobe             | depart,turn left,arrive                          |
+
+    @no_turning @conditionals @mld_only
+    Scenario: Car - Conditional restriction evaluated for the departure time with cached unpacking
+        Given the extract extra arguments "--parse-conditional-restrictions"
+        And the partition extra arguments "--small-component-size 1 --max-cell-sizes 4,16,64"
+                                            # time stamp for 10am on Tues, 02 May 2017 GMT
+        And the customize extra arguments "--time-zone-file=test/data/tz/{timezone_names}/guinea.geojson --parse-conditionals-from-now=1493719200 --conditional-turns-horizon 7"
+        And the routed extra arguments "--unpacking-cache-size 16"
+        Given the node map
+            """
+            a b c d e f g h i j k l m n o
+                      |   |
+                      p---q
+            """
+
+        And the ways
+            | nodes    |
+            | abcdef   |
+            | fgh      |
+            | hijklmno |
+            | fp       |
+            | pq       |
+            | qh       |
+
+        And the relations
+            | type        | way:from | way:to | node:via | restriction:conditional               |
+            | restriction | abcdef   | fgh    | f        | no_straight_on @ (Mo-Fr 07:00-10:30)  |
+
+        # the overlay edges unpacked without the restriction are cached and must not be
+        # used once the restriction is active, 10am and 2pm on Tues, 02 May 2017 GMT
+        When I route I should get
+            | from | to | param:departure_time | route                                 |
+            | a    | o  | 1493733600           | abcdef,fgh,hijklmno,hijklmno          |
+            | a    | o  | 1493719200           | abcdef,fp,pq,qh,hijklmno,hijklmno     |
+            | a    | o  | 1493733600           | abcdef,fgh,hijklmno,hijklmno          |
+            | a    | o  | 1493719200           | abcdef,fp,pq,qh,hijklmno,hijklmno     |
@@ -67,3 +67,56 @@ end
            | a    | b  | ac,cb,cb | 19.2s |
            | a    | d  | ac,cd,cd | 19.2s |
            | a    | e  | ac,ce    | 20s   |
+
+    Scenario: Turn penalties computed in batches
+        Given the profile file
+           """
+api_version = 1
+
+properties.weight_name                     = 'test_version1'
+properties.weight_precision                = 2
+
+function way_function(way, result)
+  result.name = way:get_value_by_key('name')
+  result.weight = 10
+  result.forward_mode = mode.driving
+  result.backward_mode = mode.driving
+  result.forward_speed = 36
+  result.backward_speed = 36
+end
+
+function turn_function (turn)
+  error('turn_function must not be called if turn_batch_function is defined')
+end
+
+function turn_batch_function (turns)
+  print('turn_batch_function ' .. #turns)
+  for _, turn in ipairs(turns) do
+    turn.weight = turn.angle == 0 and 0 or 4.2
+    turn.duration = turn.weight
+  end
+end
+           """
+        And the node map
+           """
+               a
+              bcd
+               e
+           """
+        And the ways
+            | nodes  |
+            | ac     |
+            | cb     |
+            | cd     |
+            | ce     |
+        And the data has been saved to disk
+
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit successfully
+        And stdout should contain "turn_batch_function"
+
+        When I route I should get
+           | from | to | route    | time  |
+           | a    | b  | ac,cb,cb | 19.2s |
+           | a    | d  | ac,cd,cd | 19.2s |
+           | a    | e  | ac,ce    | 20s   |
@@ -16,6 +16,10 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--ip"
         And stdout should contain "--port"
         And stdout should contain "--threads"
+        And stdout should contain "--io-threads"
+        And stdout should contain "--reuse-port"
+        And stdout should contain "--heap-pool-size"
+        And stdout should contain "--heap-stats-interval"
         And stdout should contain "--shared-memory"
         And stdout should contain "--max-viaroute-size"
         And stdout should contain "--max-trip-size"
@@ -35,6 +39,10 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--ip"
         And stdout should contain "--port"
         And stdout should contain "--threads"
+        And stdout should contain "--io-threads"
+        And stdout should contain "--reuse-port"
+        And stdout should contain "--heap-pool-size"
+        And stdout should contain "--heap-stats-interval"
         And stdout should contain "--shared-memory"
         And stdout should contain "--max-viaroute-size"
         And stdout should contain "--max-trip-size"
@@ -54,6 +62,10 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--ip"
         And stdout should contain "--port"
         And stdout should contain "--threads"
+        And stdout should contain "--io-threads"
+        And stdout should contain "--reuse-port"
+        And stdout should contain "--heap-pool-size"
+        And stdout should contain "--heap-stats-interval"
         And stdout should contain "--shared-memory"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
@@ -88,6 +88,22 @@ module.exports = function () {
         assert.equal(this.stderr.split('\n').length - 1, parseInt(lines));
     });
 
+    this.Then(/^the file "(.*?)" should( not)? exist$/, (file, not) => {
+        const exists = fs.existsSync(this.expandOptions(file));
+        assert.ok(typeof not === 'undefined' ? exists : !exists);
+    });
+
+    this.Then(/^the changed nodes file should list (\d+) nodes?$/, (count) => {
+        // fingerprint, 64 bit element count and the sorted edge-based node ids
+        const data = fs.readFileSync(this.processedCacheFile + '.changed_nodes');
+        const size = data.readUInt32LE(8);
+        assert.equal(data.readUInt32LE(12), 0);
+        assert.equal(data.length, 16 + 4 * size);
+        assert.equal(size, parseInt(count));
+        for (let index = 1; index < size; ++index)
+            assert.ok(data.readUInt32LE(12 + 4 * index) < data.readUInt32LE(16 + 4 * index));
+    });
+
     this.Given(/^the query options$/, (table, callback) => {
         table.raw().forEach(tuple => {
             this.queryParams[tuple[0]] = tuple[1];
@@ -0,0 +1,52 @@
+@routing @testbot @speed_profiles @mld_only
+Feature: Testbot - Time-sliced speed profiles
+
+    Background:
+        Given the profile "testbot"
+        And the customize extra arguments "--speed-profile-file {speeds_file} --time-slices 2"
+        # the segment ab is driven at 18 km/h at midnight and 72 km/h at noon UTC,
+        # the node of abc takes 150% of its static 20s at midnight and 75% at noon
+        And the speed file
+            """
+            1,2,18 72
+            """
+        And the node map
+            """
+            a b c d
+            """
+        And the nodes
+            | node | id |
+            | a    | 1  |
+            | b    | 2  |
+            | c    | 3  |
+            | d    | 4  |
+        And the ways
+            | nodes |
+            | abc   |
+            | cd    |
+
+    Scenario: Testbot - Route durations use the speed factors of the departure time
+        When I route I should get
+            | from | to | route       | param:departure_time | time     |
+            | a    | b  | abc,abc     | 1493683200           | 15s +-1  |
+            | a    | c  | abc,abc     | 1493683200           | 30s +-1  |
+            | a    | d  | abc,cd,cd   | 1493683200           | 40s +-1  |
+            | c    | a  | abc,abc     | 1493683200           | 20s +-1  |
+            | a    | b  | abc,abc     | 1493726400           | 8s +-1   |
+            | a    | c  | abc,abc     | 1493726400           | 15s +-1  |
+            | a    | d  | abc,cd,cd   | 1493726400           | 25s +-1  |
+
+    Scenario: Testbot - Table durations agree with the route durations at midnight
+        Given the query options
+            | departure_time | 1493683200 |
+        When I request a travel time matrix I should get
+            |   | a       | b       | c       | d       |
+            | a | 0       | 15 +-1  | 30 +-1  | 40 +-1  |
+            | c | 20 +-1  | 10 +-1  | 0       | 10 +-1  |
+
+    Scenario: Testbot - Table durations agree with the route durations at noon
+        Given the query options
+            | departure_time | 1493726400 |
+        When I request a travel time matrix I should get
+            |   | a       | b       | c       | d       |
+            | a | 0       | 8 +-1   | 15 +-1  | 25 +-1  |
@@ -57,6 +57,72 @@ Feature: Traffic - speeds
           | a    | g  | ad,df,fb,fb | 30 km/h | 1275.7,487.5,304.7,0 | 1:0:0         |
 
 
+    Scenario: Weighting based on speed file as a delta update
+        Given the contract extra arguments "--segment-speed-file {speeds_file} --delta-update"
+        And the customize extra arguments "--segment-speed-file {speeds_file} --delta-update"
+        And the speed file
+        """
+        1,2,0,0
+        2,1,0,0
+        2,3,27,7.5
+        3,2,27,7.5
+        1,4,27,7.5
+        4,1,27,7.5
+        """
+        And the query options
+          | annotations | datasources |
+        And the data has been saved to disk
+
+        # the steps rerun every tool, so no delta state of an earlier test run is reused
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        And I run "osrm-partition {processed_file}"
+        And I run "osrm-contract --segment-speed-file {speeds_file} --delta-update {processed_file}"
+        Then stderr should contain "No applied state"
+        When I run "osrm-customize --segment-speed-file {speeds_file} --delta-update {processed_file}"
+        Then the file "{processed_file}.traffic_state" should exist
+
+        When I route I should get
+          | from | to | route       | speed   | weights              | a:datasources |
+          | a    | b  | ad,de,eb,eb | 30 km/h | 1275.7,400.4,378.2,0 | 1:0:0:0       |
+          | a    | c  | ad,dc,dc    | 31 km/h | 1275.7,956.8,0       | 1:0           |
+          | b    | c  | bc,bc       | 27 km/h | 741.5,0              | 1:0           |
+          | a    | d  | ad,ad       | 27 km/h | 1275.7,0             | 1:0           |
+          | d    | c  | dc,dc       | 36 km/h | 956.8,0              | 0             |
+          | g    | b  | fb,fb       | 36 km/h | 164.7,0              | 0             |
+          | a    | g  | ad,df,fb,fb | 30 km/h | 1275.7,487.5,304.7,0 | 1:0:0         |
+
+        # only ad changes, ab stays closed and bc keeps its speed from the first update
+        Given the speed file
+        """
+        2,3,27,7.5
+        3,2,27,7.5
+        1,4,54,7.5
+        4,1,54,7.5
+        """
+        When I run "osrm-contract --segment-speed-file {speeds_file} --delta-update {processed_file}"
+        Then stderr should not contain "No applied state"
+        And stdout should contain "Delta update changed 2 edge-based nodes"
+        And the changed nodes file should list 2 nodes
+        When I run "osrm-customize --segment-speed-file {speeds_file} --delta-update {processed_file}"
+        Then stderr should not contain "No applied state"
+
+        When I route I should get
+          | from | to | route       | speed   | weights              |
+          | a    | d  | ad,ad       | 54 km/h | 1275.7,0             |
+          | a    | b  | ad,de,eb,eb | 44 km/h | 1275.7,400.4,378.2,0 |
+          | b    | c  | bc,bc       | 27 km/h | 741.5,0              |
+          | d    | c  | dc,dc       | 36 km/h | 956.8,0              |
+
+        # applying the same values again changes nothing
+        When I run "osrm-contract --segment-speed-file {speeds_file} --delta-update {processed_file}"
+        Then stdout should contain "Delta update changed 0 edge-based nodes"
+        And the changed nodes file should list 0 nodes
+
+        # a full update starts from the extracted graph again and drops the delta state
+        When I run "osrm-contract --segment-speed-file {speeds_file} {processed_file}"
+        Then the file "{processed_file}.traffic_state" should not exist
+
+
     Scenario: Weighting based on speed file weights, ETA based on file durations
         Given the contract extra arguments "--segment-speed-file {speeds_file}"
         And the customize extra arguments "--segment-speed-file {speeds_file}"
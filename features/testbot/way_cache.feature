@@ -0,0 +1,49 @@
+@routing @testbot @way_cache
+Feature: Testbot - Cached way_function results
+
+    Background:
+        Given the profile file "testbot" extended with
+        """
+        function get_way_cache_keys(vector)
+          vector:Add('highway')
+          vector:Add('surface')
+        end
+
+        function way_function(way, result)
+          local speed = 36
+          if way:get_value_by_key('surface') == 'gravel' then
+            speed = 18
+          end
+          result.forward_mode = mode.driving
+          result.backward_mode = mode.driving
+          result.forward_speed = speed
+          result.backward_speed = speed
+        end
+        """
+        And the node map
+            """
+            a b
+            c d
+            e f
+            g h
+            """
+        And the ways
+            | nodes | surface |
+            | ab    |         |
+            | cd    |         |
+            | ef    | gravel  |
+            | gh    | gravel  |
+
+    Scenario: Testbot - Ways with the same cached tags share the result
+        When I route I should get
+            | from | to | route | speed   |
+            | a    | b  | ,     | 36 km/h |
+            | c    | d  | ,     | 36 km/h |
+            | e    | f  | ,     | 18 km/h |
+            | g    | h  | ,     | 18 km/h |
+
+    Scenario: Testbot - Only ways with new cached tags call way_function
+        Given the data has been saved to disk
+        When I run "osrm-extract --threads 1 --profile {profile_file} {osm_file}"
+        Then it should exit successfully
+        And stdout should contain "way_function cache: 2 hits, 2 misses"
@@ -1,13 +1,21 @@
 #ifndef OSRM_CELLS_CUSTOMIZER_HPP
 #define OSRM_CELLS_CUSTOMIZER_HPP
 
+#include "customizer/cell_metric.hpp"
+
 #include "partition/cell_storage.hpp"
 #include "partition/multi_level_partition.hpp"
 #include "util/query_heap.hpp"
 
+#include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
 
+#include <atomic>
+#include <functional>
 #include <unordered_set>
+#include <vector>
 
 namespace osrm
 {
@@ -30,78 +38,186 @@ class CellCustomizer
 
     CellCustomizer(const partition::MultiLevelPartition &partition) : partition(partition) {}
 
-    template <typename GraphT>
-    void Customize(
-        const GraphT &graph, Heap &heap, partition::CellStorage &cells, LevelID level, CellID id)
+    // Scales the base graph edges by the speed factor of their source node, which customizes
+    // the metric of a time slice on the static graph
+    CellCustomizer(const partition::MultiLevelPartition &partition,
+                   std::vector<std::uint16_t> node_factors)
+        : partition(partition), node_factors(std::move(node_factors))
     {
-        auto cell = cells.GetCell(level, id);
-        auto destinations = cell.GetDestinationNodes();
+    }
 
-        // for each source do forward search
+    template <typename GraphT>
+    void Customize(const GraphT &graph,
+                   Heap &heap,
+                   const partition::CellStorage &cells,
+                   CellMetric &metric,
+                   LevelID level,
+                   CellID id)
+    {
+        auto cell = cells.GetCell(metric, level, id);
         for (auto source : cell.GetSourceNodes())
         {
-            std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
-            heap.Clear();
-            heap.Insert(source, 0, {false, 0});
+            CustomizeSource(graph, heap, cells, metric, cell, level, source);
+        }
+    }
 
-            // explore search space
-            while (!heap.Empty() && !destinations_set.empty())
-            {
-                const NodeID node = heap.DeleteMin();
-                const EdgeWeight weight = heap.GetKey(node);
-                const EdgeDuration duration = heap.GetData(node).duration;
+    template <typename GraphT>
+    void Customize(const GraphT &graph, const partition::CellStorage &cells, CellMetric &metric)
+    {
+        Heap heap_exemplar(graph.GetNumberOfNodes());
+        HeapPtr heaps(heap_exemplar);
 
-                if (level == 1)
-                    RelaxNode<true>(graph, cells, heap, level, node, weight, duration);
-                else
-                    RelaxNode<false>(graph, cells, heap, level, node, weight, duration);
+        // Cells on level l + 1 only depend on their children on level l, so instead of a
+        // barrier after every level a cell is scheduled as soon as its last child is done.
+        // This keeps all threads busy while the few large cells of the upper levels run.
+        const auto num_levels = partition.GetNumberOfLevels();
+        std::vector<std::size_t> level_offsets(num_levels + 1, 0);
+        for (LevelID level = 1; level < num_levels; ++level)
+        {
+            level_offsets[level + 1] = level_offsets[level] + partition.GetNumberOfCells(level);
+        }
 
-                destinations_set.erase(node);
+        std::vector<CellID> parents(level_offsets[num_levels], INVALID_CELL_ID);
+        std::vector<std::atomic<std::uint32_t>> pending_children(level_offsets[num_levels]);
+        for (LevelID level = 2; level < num_levels; ++level)
+        {
+            for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+            {
+                const auto begin = partition.BeginChildren(level, id);
+                const auto end = partition.EndChildren(level, id);
+                pending_children[level_offsets[level] + id] = end - begin;
+                for (auto child = begin; child < end; ++child)
+                {
+                    parents[level_offsets[level - 1] + child] = id;
+                }
             }
+        }
+
+        tbb::task_group tasks;
+        std::function<void(LevelID, CellID)> customize_cell = [&](LevelID level, CellID id) {
+            CustomizeCell(graph, heaps, cells, metric, level, id);
 
-            // fill a map of destination nodes to placeholder pointers
-            auto weights = cell.GetOutWeight(source);
-            auto durations = cell.GetOutDuration(source);
-            for (auto &destination : destinations)
+            if (level + 1 < num_levels)
             {
-                BOOST_ASSERT(!weights.empty());
-                BOOST_ASSERT(!durations.empty());
+                const auto parent = parents[level_offsets[level] + id];
+                BOOST_ASSERT(parent != INVALID_CELL_ID);
+                if (--pending_children[level_offsets[level + 1] + parent] == 0)
+                {
+                    tasks.run([&customize_cell, level, parent] {
+                        customize_cell(level + 1, parent);
+                    });
+                }
+            }
+        };
 
-                const bool inserted = heap.WasInserted(destination);
-                weights.front() = inserted ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
-                durations.front() =
-                    inserted ? heap.GetData(destination).duration : MAXIMAL_EDGE_DURATION;
+        tasks.run([&] {
+            tbb::parallel_for(tbb::blocked_range<CellID>(0, partition.GetNumberOfCells(1)),
+                              [&](const tbb::blocked_range<CellID> &range) {
+                                  for (auto id = range.begin(), end = range.end(); id != end; ++id)
+                                  {
+                                      customize_cell(1, id);
+                                  }
+                              });
+        });
+        tasks.wait();
+    }
+
+  private:
+    // Cells with more sources split their searches into tasks of this many sources
+    static constexpr std::size_t SOURCES_PER_TASK = 16;
+
+    template <typename GraphT>
+    void CustomizeCell(const GraphT &graph,
+                       HeapPtr &heaps,
+                       const partition::CellStorage &cells,
+                       CellMetric &metric,
+                       LevelID level,
+                       CellID id)
+    {
+        auto cell = cells.GetCell(metric, level, id);
+        const auto sources = cell.GetSourceNodes();
 
-                weights.advance_begin(1);
-                durations.advance_begin(1);
+        if (static_cast<std::size_t>(sources.size()) <= SOURCES_PER_TASK)
+        {
+            auto &heap = heaps.local();
+            for (auto source : sources)
+            {
+                CustomizeSource(graph, heap, cells, metric, cell, level, source);
             }
-            BOOST_ASSERT(weights.empty());
-            BOOST_ASSERT(durations.empty());
+            return;
         }
+
+        // every source writes its own row of the cell matrix
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, sources.size(), SOURCES_PER_TASK),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                auto &heap = heaps.local();
+                for (auto index = range.begin(), end = range.end(); index != end; ++index)
+                {
+                    CustomizeSource(graph, heap, cells, metric, cell, level, sources[index]);
+                }
+            });
     }
 
-    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+    template <typename GraphT>
+    void CustomizeSource(const GraphT &graph,
+                         Heap &heap,
+                         const partition::CellStorage &cells,
+                         const CellMetric &metric,
+                         const partition::CellStorage::Cell &cell,
+                         LevelID level,
+                         NodeID source) const
     {
-        Heap heap_exemplar(graph.GetNumberOfNodes());
-        HeapPtr heaps(heap_exemplar);
+        auto destinations = cell.GetDestinationNodes();
+        std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
+        heap.Clear();
+        heap.Insert(source, 0, {false, 0});
 
-        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        // explore search space
+        while (!heap.Empty() && !destinations_set.empty())
         {
-            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, partition.GetNumberOfCells(level)),
-                              [&](const tbb::blocked_range<std::size_t> &range) {
-                                  auto &heap = heaps.local();
-                                  for (auto id = range.begin(), end = range.end(); id != end; ++id)
-                                  {
-                                      Customize(graph, heap, cells, level, id);
-                                  }
-                              });
+            const NodeID node = heap.DeleteMin();
+            const EdgeWeight weight = heap.GetKey(node);
+            const EdgeDuration duration = heap.GetData(node).duration;
+
+            if (level == 1)
+                RelaxNode<true>(graph, cells, metric, heap, level, node, weight, duration);
+            else
+                RelaxNode<false>(graph, cells, metric, heap, level, node, weight, duration);
+
+            destinations_set.erase(node);
         }
+
+        // fill a map of destination nodes to placeholder pointers
+        auto weights = cell.GetOutWeight(source);
+        auto durations = cell.GetOutDuration(source);
+        for (auto &destination : destinations)
+        {
+            BOOST_ASSERT(!weights.empty());
+            BOOST_ASSERT(!durations.empty());
+
+            const bool inserted = heap.WasInserted(destination);
+            weights.front() = inserted ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
+            durations.front() =
+                inserted ? heap.GetData(destination).duration : MAXIMAL_EDGE_DURATION;
+
+            weights.advance_begin(1);
+            durations.advance_begin(1);
+        }
+        BOOST_ASSERT(weights.empty());
+        BOOST_ASSERT(durations.empty());
+    }
+
+    template <typename EdgeDataT>
+    static EdgeWeight GetEdgeWeight(const CellMetric &metric, const EdgeDataT &data)
+    {
+        return metric.source == MetricSource::Duration ? data.duration : data.weight;
     }
 
-  private:
     template <bool first_level, typename GraphT>
     void RelaxNode(const GraphT &graph,
                    const partition::CellStorage &cells,
+                   const CellMetric &metric,
                    Heap &heap,
                    LevelID level,
                    NodeID node,
@@ -123,7 +239,7 @@ class CellCustomizer
             {
                 // Relax sub-cell nodes
                 auto subcell_id = partition.GetCell(level - 1, node);
-                auto subcell = cells.GetCell(level - 1, subcell_id);
+                auto subcell = cells.GetCell(metric, level - 1, subcell_id);
                 auto subcell_destination = subcell.GetDestinationNodes().begin();
                 auto subcell_duration = subcell.GetOutDuration(node).begin();
                 for (auto subcell_weight : subcell.GetOutWeight(node))
@@ -150,6 +266,7 @@ class CellCustomizer
         }
 
         // Relax base graph edges if a sub-cell border edge
+        const auto factor = node_factors.empty() ? SPEED_PROFILE_BASE_FACTOR : node_factors[node];
         for (auto edge : graph.GetInternalEdgeRange(level, node))
         {
             const NodeID to = graph.GetTarget(edge);
@@ -158,21 +275,25 @@ class CellCustomizer
                 (first_level ||
                  partition.GetCell(level - 1, node) != partition.GetCell(level - 1, to)))
             {
-                const EdgeWeight to_weight = weight + data.weight;
+                const EdgeWeight to_weight =
+                    weight + applySpeedFactor(GetEdgeWeight(metric, data), factor);
+                const EdgeDuration to_duration = duration + applySpeedFactor(data.duration, factor);
                 if (!heap.WasInserted(to))
                 {
-                    heap.Insert(to, to_weight, {false, duration + data.duration});
+                    heap.Insert(to, to_weight, {false, to_duration});
                 }
                 else if (to_weight < heap.GetKey(to))
                 {
                     heap.DecreaseKey(to, to_weight);
-                    heap.GetData(to) = {false, duration + data.duration};
+                    heap.GetData(to) = {false, to_duration};
                 }
             }
         }
     }
 
     const partition::MultiLevelPartition &partition;
+    // speed factor per base graph node, empty for the static metrics
+    const std::vector<std::uint16_t> node_factors;
 };
 }
 }
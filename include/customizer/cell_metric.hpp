@@ -0,0 +1,80 @@
+#ifndef OSRM_CUSTOMIZER_CELL_METRIC_HPP
+#define OSRM_CUSTOMIZER_CELL_METRIC_HPP
+
+#include "customizer/quantized_values.hpp"
+#include "customizer/speed_profiles.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace osrm
+{
+namespace customizer
+{
+
+// Selects which value of the shared base graph a metric is customized on.
+// All metrics share the partition, cell topology and geometry, so only values
+// that are present in the base data can be used as metric weights.
+enum class MetricSource : std::uint8_t
+{
+    Weight = 0,  // the profile weight (e.g. routability)
+    Duration = 1 // the travel time, yields the fastest route
+};
+
+inline const char *toString(const MetricSource source)
+{
+    switch (source)
+    {
+    case MetricSource::Duration:
+        return "duration";
+    case MetricSource::Weight:
+    default:
+        return "weight";
+    }
+}
+
+inline boost::optional<MetricSource> metricSourceFromString(const std::string &name)
+{
+    if (name == "weight")
+        return MetricSource::Weight;
+    if (name == "duration")
+        return MetricSource::Duration;
+    return boost::none;
+}
+
+namespace detail
+{
+template <storage::Ownership Ownership> struct CellMetricImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+    MetricSource source = MetricSource::Weight;
+    // Minute of the day (UTC) at which the speed profiles were evaluated for this metric,
+    // INVALID_TIME_SLICE for metrics on the static values
+    std::uint16_t time_slice = INVALID_TIME_SLICE;
+    Vector<EdgeWeight> weights;
+    Vector<EdgeDuration> durations;
+
+    // Only set if the metric was quantized, replaces weights and durations
+    QuantizedValuesImpl<EdgeWeight, Ownership> quantized_weights;
+    QuantizedValuesImpl<EdgeDuration, Ownership> quantized_durations;
+
+    bool IsQuantized() const { return !quantized_weights.empty(); }
+    bool IsTimeSlice() const { return time_slice != INVALID_TIME_SLICE; }
+};
+}
+
+using CellMetric = detail::CellMetricImpl<storage::Ownership::Container>;
+using CellMetricView = detail::CellMetricImpl<storage::Ownership::View>;
+}
+}
+
+#endif
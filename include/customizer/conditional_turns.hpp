@@ -0,0 +1,123 @@
+#ifndef OSRM_CUSTOMIZER_CONDITIONAL_TURNS_HPP
+#define OSRM_CUSTOMIZER_CONDITIONAL_TURNS_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/assert.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+namespace osrm
+{
+namespace customizer
+{
+
+// Time interval [begin, end) in seconds since the epoch (UTC)
+struct ConditionalInterval
+{
+    std::uint32_t begin;
+    std::uint32_t end;
+
+    bool operator<(const ConditionalInterval &other) const { return begin < other.begin; }
+};
+
+// A turn that is forbidden while its condition is active. The turn is identified by
+// the edge-based edge turn_id that connects the edge-based nodes from and to.
+struct ConditionalTurn
+{
+    EdgeID turn_id;
+    NodeID from;
+    NodeID to;
+    std::uint32_t condition;
+};
+
+namespace detail
+{
+template <storage::Ownership Ownership> class ConditionalTurnsImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::ConditionalTurnsImpl<Ownership> &turns);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::ConditionalTurnsImpl<Ownership> &turns);
+}
+
+namespace detail
+{
+// Side table of the conditional turn restrictions that are evaluated at query time.
+//
+// The opening hours of each condition are expanded into sorted intervals over a fixed horizon
+// when the table is built, so checking a condition is a binary search. The turns of each
+// condition are stored consecutively, the offset vectors have one entry per condition plus one.
+template <storage::Ownership Ownership> class ConditionalTurnsImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    ConditionalTurnsImpl() = default;
+
+    ConditionalTurnsImpl(Vector<ConditionalTurn> turns_,
+                         Vector<std::uint32_t> turn_offsets_,
+                         Vector<ConditionalInterval> intervals_,
+                         Vector<std::uint32_t> interval_offsets_)
+        : turns(std::move(turns_)), turn_offsets(std::move(turn_offsets_)),
+          intervals(std::move(intervals_)), interval_offsets(std::move(interval_offsets_))
+    {
+        BOOST_ASSERT(turn_offsets.size() == interval_offsets.size());
+    }
+
+    bool Empty() const { return turns.empty(); }
+
+    std::size_t GetNumberOfConditions() const
+    {
+        return turn_offsets.empty() ? 0 : turn_offsets.size() - 1;
+    }
+
+    // Returns true if the condition applies at the given time
+    bool IsActive(const std::uint32_t condition, const std::uint32_t time) const
+    {
+        BOOST_ASSERT(condition + 1 < interval_offsets.size());
+        const auto begin = intervals.begin() + interval_offsets[condition];
+        const auto end = intervals.begin() + interval_offsets[condition + 1];
+
+        // first interval that starts after time, the one before can contain it
+        const auto next = std::upper_bound(begin, end, ConditionalInterval{time, time});
+        return next != begin && time < std::prev(next)->end;
+    }
+
+    auto GetTurns(const std::uint32_t condition) const
+    {
+        BOOST_ASSERT(condition + 1 < turn_offsets.size());
+        return boost::make_iterator_range(turns.begin() + turn_offsets[condition],
+                                          turns.begin() + turn_offsets[condition + 1]);
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               ConditionalTurnsImpl &turns);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const ConditionalTurnsImpl &turns);
+
+  private:
+    Vector<ConditionalTurn> turns;
+    Vector<std::uint32_t> turn_offsets;
+    Vector<ConditionalInterval> intervals;
+    Vector<std::uint32_t> interval_offsets;
+};
+}
+
+using ConditionalTurns = detail::ConditionalTurnsImpl<storage::Ownership::Container>;
+using ConditionalTurnsView = detail::ConditionalTurnsImpl<storage::Ownership::View>;
+}
+}
+
+#endif
@@ -1,12 +1,15 @@
 #ifndef OSRM_CUSTOMIZE_CUSTOMIZER_CONFIG_HPP
 #define OSRM_CUSTOMIZE_CUSTOMIZER_CONFIG_HPP
 
+#include "customizer/cell_metric.hpp"
+
 #include "updater/updater_config.hpp"
 
 #include <boost/filesystem/path.hpp>
 
 #include <array>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -15,7 +18,11 @@ namespace customizer
 
 struct CustomizationConfig
 {
-    CustomizationConfig() : requested_num_threads(0) {}
+    CustomizationConfig()
+        : requested_num_threads(0), quantize_cells(false), metric_sources{MetricSource::Weight},
+          time_slices(0)
+    {
+    }
 
     void UseDefaults()
     {
@@ -35,6 +42,7 @@ struct CustomizationConfig
         edge_based_graph_path = basepath + ".osrm.ebg";
         mld_partition_path = basepath + ".osrm.partition";
         mld_storage_path = basepath + ".osrm.cells";
+        mld_cell_metrics_path = basepath + ".osrm.cell_metrics";
         mld_graph_path = basepath + ".osrm.mldgr";
 
         updater_config.osrm_input_path = basepath + ".osrm";
@@ -46,9 +54,18 @@ struct CustomizationConfig
     boost::filesystem::path edge_based_graph_path;
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
+    boost::filesystem::path mld_cell_metrics_path;
     boost::filesystem::path mld_graph_path;
 
     unsigned requested_num_threads;
+    bool quantize_cells;
+
+    // one metric is customized for each entry, the first one is the default
+    std::vector<MetricSource> metric_sources;
+
+    // every metric is customized again for this many times of the day using the speed
+    // profiles of the updater, 0 only customizes the static metrics
+    unsigned time_slices;
 
     updater::UpdaterConfig updater_config;
 };
@@ -0,0 +1,107 @@
+#ifndef OSRM_CUSTOMIZER_FILES_HPP
+#define OSRM_CUSTOMIZER_FILES_HPP
+
+#include "customizer/serialization.hpp"
+
+#include "storage/io.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace files
+{
+
+// reads .osrm.cell_metrics file
+template <typename CellMetricT>
+inline void readCellMetrics(const boost::filesystem::path &path, std::vector<CellMetricT> &metrics)
+{
+    static_assert(std::is_same<CellMetricView, CellMetricT>::value ||
+                      std::is_same<CellMetric, CellMetricT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, metrics);
+}
+
+// writes .osrm.cell_metrics file
+template <typename CellMetricT>
+inline void writeCellMetrics(const boost::filesystem::path &path,
+                             const std::vector<CellMetricT> &metrics)
+{
+    static_assert(std::is_same<CellMetricView, CellMetricT>::value ||
+                      std::is_same<CellMetric, CellMetricT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, metrics);
+}
+
+// reads .osrm.conditional_turns file
+template <typename ConditionalTurnsT>
+inline void readConditionalTurns(const boost::filesystem::path &path, ConditionalTurnsT &turns)
+{
+    static_assert(std::is_same<ConditionalTurnsView, ConditionalTurnsT>::value ||
+                      std::is_same<ConditionalTurns, ConditionalTurnsT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, turns);
+}
+
+// writes .osrm.conditional_turns file
+template <typename ConditionalTurnsT>
+inline void writeConditionalTurns(const boost::filesystem::path &path,
+                                  const ConditionalTurnsT &turns)
+{
+    static_assert(std::is_same<ConditionalTurnsView, ConditionalTurnsT>::value ||
+                      std::is_same<ConditionalTurns, ConditionalTurnsT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, turns);
+}
+
+// reads .osrm.speed_profiles file
+template <typename SpeedProfilesT>
+inline void readSpeedProfiles(const boost::filesystem::path &path, SpeedProfilesT &profiles)
+{
+    static_assert(std::is_same<SpeedProfilesView, SpeedProfilesT>::value ||
+                      std::is_same<SpeedProfiles, SpeedProfilesT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, profiles);
+}
+
+// writes .osrm.speed_profiles file
+template <typename SpeedProfilesT>
+inline void writeSpeedProfiles(const boost::filesystem::path &path,
+                               const SpeedProfilesT &profiles)
+{
+    static_assert(std::is_same<SpeedProfilesView, SpeedProfilesT>::value ||
+                      std::is_same<SpeedProfiles, SpeedProfilesT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, profiles);
+}
+}
+}
+}
+
+#endif
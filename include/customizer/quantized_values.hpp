@@ -0,0 +1,209 @@
+#ifndef OSRM_CUSTOMIZER_QUANTIZED_VALUES_HPP
+#define OSRM_CUSTOMIZER_QUANTIZED_VALUES_HPP
+
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/assert.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+// Compressed representation of the cell matrices: every cell stores one base
+// value and each matrix entry a 16 bit difference to it. Invalid entries and
+// differences that do not fit use the two reserved codes below, the values
+// of the latter are stored in a table of outliers sorted by their index.
+using QuantizedCode = std::uint16_t;
+static constexpr QuantizedCode QUANTIZED_INVALID = std::numeric_limits<QuantizedCode>::max();
+static constexpr QuantizedCode QUANTIZED_ESCAPE = QUANTIZED_INVALID - 1;
+static constexpr QuantizedCode QUANTIZED_MAX_DELTA = QUANTIZED_ESCAPE - 1;
+
+template <typename T> struct QuantizedOutlier
+{
+    std::uint32_t index;
+    T value;
+
+    bool operator<(const QuantizedOutlier &other) const { return index < other.index; }
+};
+
+// Outlier tables of all metrics have to be the same size to be stored back to back,
+// padding entries sort behind all real ones and are never looked up.
+static constexpr std::uint32_t QUANTIZED_PADDING_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+// Returns the value encoded by code relative to the base of its cell, index is the
+// position of code in the codes of all cells and used to look up outliers
+template <typename T>
+inline T decodeQuantized(const T base,
+                         const QuantizedCode code,
+                         const std::uint32_t index,
+                         const QuantizedOutlier<T> *outliers_begin,
+                         const QuantizedOutlier<T> *outliers_end)
+{
+    if (code <= QUANTIZED_MAX_DELTA)
+        return base + code;
+
+    if (code == QUANTIZED_INVALID)
+        return std::numeric_limits<T>::max();
+
+    BOOST_ASSERT(code == QUANTIZED_ESCAPE);
+    const auto outlier = std::lower_bound(
+        outliers_begin, outliers_end, QuantizedOutlier<T>{index, T{}});
+    BOOST_ASSERT(outlier != outliers_end && outlier->index == index);
+    return outlier->value;
+}
+
+// Strided iterator decoding one row or column of a cell matrix
+template <typename T>
+class QuantizedValueIterator
+    : public boost::iterator_facade<QuantizedValueIterator<T>,
+                                    T,
+                                    boost::random_access_traversal_tag,
+                                    T>
+{
+    using base_t = boost::iterator_facade<QuantizedValueIterator<T>,
+                                          T,
+                                          boost::random_access_traversal_tag,
+                                          T>;
+
+  public:
+    using difference_type = typename base_t::difference_type;
+
+    QuantizedValueIterator()
+        : current(nullptr), codes_begin(nullptr), outliers_begin(nullptr),
+          outliers_end(nullptr), base(0), stride(1)
+    {
+    }
+
+    QuantizedValueIterator(const QuantizedCode *current,
+                           const std::size_t stride,
+                           const T base,
+                           const QuantizedCode *codes_begin,
+                           const QuantizedOutlier<T> *outliers_begin,
+                           const QuantizedOutlier<T> *outliers_end)
+        : current(current), codes_begin(codes_begin), outliers_begin(outliers_begin),
+          outliers_end(outliers_end), base(base), stride(stride)
+    {
+    }
+
+  private:
+    void increment() { current += stride; }
+    void decrement() { current -= stride; }
+    void advance(difference_type offset) { current += stride * offset; }
+    bool equal(const QuantizedValueIterator &other) const { return current == other.current; }
+    difference_type distance_to(const QuantizedValueIterator &other) const
+    {
+        return (other.current - current) / static_cast<std::intptr_t>(stride);
+    }
+    T dereference() const
+    {
+        return decodeQuantized(
+            base, *current, current - codes_begin, outliers_begin, outliers_end);
+    }
+
+    friend class ::boost::iterator_core_access;
+
+    const QuantizedCode *current;
+    const QuantizedCode *codes_begin;
+    const QuantizedOutlier<T> *outliers_begin;
+    const QuantizedOutlier<T> *outliers_end;
+    T base;
+    std::size_t stride;
+};
+
+namespace detail
+{
+template <typename T, storage::Ownership Ownership> struct QuantizedValuesImpl
+{
+    template <typename U> using Vector = util::ViewOrVector<U, Ownership>;
+
+    Vector<T> bases;
+    Vector<QuantizedCode> codes;
+    Vector<QuantizedOutlier<T>> outliers;
+
+    bool empty() const { return codes.empty(); }
+
+    // Number of bytes used, to compare against the plain representation
+    std::size_t GetSizeInBytes() const
+    {
+        return bases.size() * sizeof(T) + codes.size() * sizeof(QuantizedCode) +
+               outliers.size() * sizeof(QuantizedOutlier<T>);
+    }
+};
+}
+
+template <typename T>
+using QuantizedValues = detail::QuantizedValuesImpl<T, storage::Ownership::Container>;
+template <typename T>
+using QuantizedValuesView = detail::QuantizedValuesImpl<T, storage::Ownership::View>;
+
+// Encodes values where cell i covers [offsets[i], offsets[i+1]). Values behind the
+// last offset belong to no cell and are encoded relative to a zero base.
+template <typename T>
+QuantizedValues<T> quantizeValues(const std::vector<T> &values,
+                                  const std::vector<std::uint32_t> &offsets)
+{
+    BOOST_ASSERT(!offsets.empty());
+    BOOST_ASSERT(offsets.back() <= values.size());
+
+    const auto invalid = std::numeric_limits<T>::max();
+
+    QuantizedValues<T> quantized;
+    quantized.bases.resize(offsets.size() - 1, 0);
+    quantized.codes.resize(values.size(), QUANTIZED_INVALID);
+
+    const auto encode = [&](const T base, const std::size_t begin, const std::size_t end) {
+        for (auto index = begin; index < end; ++index)
+        {
+            const auto value = values[index];
+            if (value == invalid)
+                continue;
+
+            const auto delta = static_cast<std::int64_t>(value) - base;
+            if (delta >= 0 && delta <= QUANTIZED_MAX_DELTA)
+            {
+                quantized.codes[index] = static_cast<QuantizedCode>(delta);
+            }
+            else
+            {
+                quantized.codes[index] = QUANTIZED_ESCAPE;
+                quantized.outliers.push_back({static_cast<std::uint32_t>(index), value});
+            }
+        }
+    };
+
+    for (std::size_t cell = 0; cell + 1 < offsets.size(); ++cell)
+    {
+        const auto begin = values.begin() + offsets[cell];
+        const auto end = values.begin() + offsets[cell + 1];
+
+        // the smallest valid value keeps all deltas positive
+        T base = invalid;
+        for (auto iter = begin; iter != end; ++iter)
+            base = std::min(base, *iter);
+        if (base == invalid)
+            base = 0;
+
+        quantized.bases[cell] = base;
+        encode(base, offsets[cell], offsets[cell + 1]);
+    }
+    encode(0, offsets.back(), values.size());
+
+    // cells are encoded in order, so the outliers are sorted by index already
+    BOOST_ASSERT(std::is_sorted(quantized.outliers.begin(), quantized.outliers.end()));
+
+    return quantized;
+}
+}
+}
+
+#endif
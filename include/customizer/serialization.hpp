@@ -0,0 +1,127 @@
+#ifndef OSRM_CUSTOMIZER_SERIALIZATION_HPP
+#define OSRM_CUSTOMIZER_SERIALIZATION_HPP
+
+#include "customizer/cell_metric.hpp"
+#include "customizer/conditional_turns.hpp"
+#include "customizer/speed_profiles.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace serialization
+{
+
+template <typename T, storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::QuantizedValuesImpl<T, Ownership> &values)
+{
+    storage::serialization::read(reader, values.bases);
+    storage::serialization::read(reader, values.codes);
+    storage::serialization::read(reader, values.outliers);
+}
+
+template <typename T, storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::QuantizedValuesImpl<T, Ownership> &values)
+{
+    storage::serialization::write(writer, values.bases);
+    storage::serialization::write(writer, values.codes);
+    storage::serialization::write(writer, values.outliers);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::CellMetricImpl<Ownership> &metric)
+{
+    metric.source = reader.ReadOne<MetricSource>();
+    metric.time_slice = reader.ReadOne<std::uint16_t>();
+    storage::serialization::read(reader, metric.weights);
+    storage::serialization::read(reader, metric.durations);
+    read(reader, metric.quantized_weights);
+    read(reader, metric.quantized_durations);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer, const detail::CellMetricImpl<Ownership> &metric)
+{
+    writer.WriteOne(metric.source);
+    writer.WriteOne(metric.time_slice);
+    storage::serialization::write(writer, metric.weights);
+    storage::serialization::write(writer, metric.durations);
+    write(writer, metric.quantized_weights);
+    write(writer, metric.quantized_durations);
+}
+
+// Views need to be set up with the number of metrics in the file,
+// containers are resized to match.
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 std::vector<detail::CellMetricImpl<Ownership>> &metrics)
+{
+    const auto num_metrics = reader.ReadElementCount64();
+    if (Ownership == storage::Ownership::Container)
+        metrics.resize(num_metrics);
+    BOOST_ASSERT(metrics.size() == num_metrics);
+
+    for (auto &metric : metrics)
+    {
+        read(reader, metric);
+    }
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const std::vector<detail::CellMetricImpl<Ownership>> &metrics)
+{
+    writer.WriteElementCount64(metrics.size());
+    for (const auto &metric : metrics)
+    {
+        write(writer, metric);
+    }
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::ConditionalTurnsImpl<Ownership> &turns)
+{
+    storage::serialization::read(reader, turns.turns);
+    storage::serialization::read(reader, turns.turn_offsets);
+    storage::serialization::read(reader, turns.intervals);
+    storage::serialization::read(reader, turns.interval_offsets);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::ConditionalTurnsImpl<Ownership> &turns)
+{
+    storage::serialization::write(writer, turns.turns);
+    storage::serialization::write(writer, turns.turn_offsets);
+    storage::serialization::write(writer, turns.intervals);
+    storage::serialization::write(writer, turns.interval_offsets);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::SpeedProfilesImpl<Ownership> &profiles)
+{
+    storage::serialization::read(reader, profiles.points);
+    storage::serialization::read(reader, profiles.profile_offsets);
+    storage::serialization::read(reader, profiles.node_profiles);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::SpeedProfilesImpl<Ownership> &profiles)
+{
+    storage::serialization::write(writer, profiles.points);
+    storage::serialization::write(writer, profiles.profile_offsets);
+    storage::serialization::write(writer, profiles.node_profiles);
+}
+}
+}
+}
+
+#endif
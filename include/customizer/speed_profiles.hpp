@@ -0,0 +1,226 @@
+#ifndef OSRM_CUSTOMIZER_SPEED_PROFILES_HPP
+#define OSRM_CUSTOMIZER_SPEED_PROFILES_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/assert.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+static constexpr std::uint16_t MINUTES_PER_DAY = 24 * 60;
+static constexpr std::uint16_t INVALID_TIME_SLICE = std::numeric_limits<std::uint16_t>::max();
+static constexpr std::uint32_t INVALID_SPEED_PROFILE = std::numeric_limits<std::uint32_t>::max();
+// factor of the static weights and durations
+static constexpr std::uint16_t SPEED_PROFILE_BASE_FACTOR = 100;
+
+// Breakpoint of a piecewise-linear profile: at the minute of the day (UTC) the static
+// weight and duration of a segment are scaled by factor / 100.
+struct SpeedProfilePoint
+{
+    std::uint16_t minute;
+    std::uint16_t factor;
+
+    bool operator<(const SpeedProfilePoint &other) const
+    {
+        return std::tie(minute, factor) < std::tie(other.minute, other.factor);
+    }
+    bool operator==(const SpeedProfilePoint &other) const
+    {
+        return std::tie(minute, factor) == std::tie(other.minute, other.factor);
+    }
+};
+
+// Scales a weight or duration of the base graph, the result is never below 1
+template <typename T> inline T applySpeedFactor(const T value, const std::uint16_t factor)
+{
+    if (factor == SPEED_PROFILE_BASE_FACTOR)
+        return value;
+    const auto scaled =
+        (static_cast<std::int64_t>(value) * factor + SPEED_PROFILE_BASE_FACTOR / 2) /
+        SPEED_PROFILE_BASE_FACTOR;
+    return static_cast<T>(std::min<std::int64_t>(
+        std::max<std::int64_t>(scaled, 1), std::numeric_limits<T>::max() - 1));
+}
+
+// Scales the part [offset, offset + value) of a sum. The parts are the differences of the scaled
+// running sums, so the scaled parts of a weight or duration add up to the scaled whole.
+template <typename T>
+inline T applySpeedFactor(const T offset, const T value, const std::uint16_t factor)
+{
+    if (factor == SPEED_PROFILE_BASE_FACTOR)
+        return value;
+    const auto scale = [factor](const T sum) {
+        return sum == 0 ? T{0} : applySpeedFactor(sum, factor);
+    };
+    return scale(offset + value) - scale(offset);
+}
+
+namespace detail
+{
+template <storage::Ownership Ownership> class SpeedProfilesImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::SpeedProfilesImpl<Ownership> &profiles);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::SpeedProfilesImpl<Ownership> &profiles);
+}
+
+namespace detail
+{
+// Library of the piecewise-linear speed profiles of the edge-based nodes.
+//
+// Most roads share few distinct traffic patterns, so equal profiles are only stored once
+// and every edge-based node references its profile by id. Nodes with INVALID_SPEED_PROFILE
+// keep their static values at all times. The breakpoints of each profile are sorted by
+// minute and wrap around at midnight.
+template <storage::Ownership Ownership> class SpeedProfilesImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    SpeedProfilesImpl() = default;
+
+    SpeedProfilesImpl(Vector<SpeedProfilePoint> points_,
+                      Vector<std::uint32_t> profile_offsets_,
+                      Vector<std::uint32_t> node_profiles_)
+        : points(std::move(points_)), profile_offsets(std::move(profile_offsets_)),
+          node_profiles(std::move(node_profiles_))
+    {
+    }
+
+    bool Empty() const { return node_profiles.empty(); }
+
+    std::size_t GetNumberOfProfiles() const
+    {
+        return profile_offsets.empty() ? 0 : profile_offsets.size() - 1;
+    }
+
+    std::uint32_t GetProfile(const NodeID node) const
+    {
+        return node < node_profiles.size() ? node_profiles[node] : INVALID_SPEED_PROFILE;
+    }
+
+    auto GetPoints(const std::uint32_t profile) const
+    {
+        BOOST_ASSERT(profile + 1 < profile_offsets.size());
+        return boost::make_iterator_range(points.begin() + profile_offsets[profile],
+                                          points.begin() + profile_offsets[profile + 1]);
+    }
+
+    // Interpolates the factor of the profile at the minute of the day
+    std::uint16_t GetFactor(const std::uint32_t profile, const std::uint16_t minute) const
+    {
+        if (profile == INVALID_SPEED_PROFILE)
+            return SPEED_PROFILE_BASE_FACTOR;
+
+        const auto range = GetPoints(profile);
+        BOOST_ASSERT(!range.empty());
+        const auto next = std::upper_bound(
+            range.begin(), range.end(), minute, [](const auto minute, const auto &point) {
+                return minute < point.minute;
+            });
+
+        // the neighbours of the minute wrap around at midnight
+        const auto &after = next == range.end() ? range.front() : *next;
+        const auto &before = next == range.begin() ? range.back() : *std::prev(next);
+        const std::int32_t to_after = (after.minute + MINUTES_PER_DAY - minute) % MINUTES_PER_DAY;
+        const std::int32_t length =
+            (after.minute + MINUTES_PER_DAY - before.minute) % MINUTES_PER_DAY;
+        if (length == 0)
+            return before.factor;
+
+        const double delta = static_cast<double>(after.factor) - before.factor;
+        return static_cast<std::uint16_t>(std::lround(after.factor - delta * to_after / length));
+    }
+
+    // Factors of all profiles at the minute of the day, indexed by profile id
+    std::vector<std::uint16_t> GetFactors(const std::uint16_t minute) const
+    {
+        std::vector<std::uint16_t> factors(GetNumberOfProfiles());
+        for (std::uint32_t profile = 0; profile < factors.size(); ++profile)
+            factors[profile] = GetFactor(profile, minute);
+        return factors;
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               SpeedProfilesImpl &profiles);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const SpeedProfilesImpl &profiles);
+
+  private:
+    Vector<SpeedProfilePoint> points;
+    Vector<std::uint32_t> profile_offsets;
+    Vector<std::uint32_t> node_profiles;
+};
+}
+
+using SpeedProfiles = detail::SpeedProfilesImpl<storage::Ownership::Container>;
+using SpeedProfilesView = detail::SpeedProfilesImpl<storage::Ownership::View>;
+
+// Collects the profiles of the edge-based nodes and stores each distinct profile once
+class SpeedProfilesBuilder
+{
+  public:
+    // Returns the id of the profile, profiles without any change get INVALID_SPEED_PROFILE
+    std::uint32_t Add(std::vector<SpeedProfilePoint> profile)
+    {
+        std::sort(profile.begin(), profile.end());
+        profile.erase(std::unique(profile.begin(),
+                                  profile.end(),
+                                  [](const auto &lhs, const auto &rhs) {
+                                      return lhs.minute == rhs.minute;
+                                  }),
+                      profile.end());
+
+        if (std::all_of(profile.begin(), profile.end(), [](const auto &point) {
+                return point.factor == SPEED_PROFILE_BASE_FACTOR;
+            }))
+            return INVALID_SPEED_PROFILE;
+
+        const auto id = static_cast<std::uint32_t>(profile_ids.size());
+        const auto inserted = profile_ids.emplace(std::move(profile), id);
+        if (!inserted.second)
+            return inserted.first->second;
+
+        points.insert(points.end(), inserted.first->first.begin(), inserted.first->first.end());
+        profile_offsets.push_back(points.size());
+        return id;
+    }
+
+    std::size_t GetNumberOfProfiles() const { return profile_ids.size(); }
+
+    SpeedProfiles Build(std::vector<std::uint32_t> node_profiles) const
+    {
+        return SpeedProfiles{points, profile_offsets, std::move(node_profiles)};
+    }
+
+  private:
+    std::map<std::vector<SpeedProfilePoint>, std::uint32_t> profile_ids;
+    std::vector<SpeedProfilePoint> points;
+    std::vector<std::uint32_t> profile_offsets = {0};
+};
+}
+}
+
+#endif
@@ -2,14 +2,17 @@
 #define ENGINE_API_BASE_API_HPP
 
 #include "engine/api/base_parameters.hpp"
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/api/json_factory.hpp"
+#include "engine/api/pbf_factory.hpp"
 #include "engine/hint.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/range/algorithm/transform.hpp>
 
+#include <protozero/pbf_writer.hpp>
+
 #include <vector>
 
 namespace osrm
@@ -22,7 +25,8 @@ namespace api
 class BaseAPI
 {
   public:
-    BaseAPI(const datafacade::BaseDataFacade &facade_, const BaseParameters &parameters_)
+    BaseAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+            const BaseParameters &parameters_)
         : facade(facade_), parameters(parameters_)
     {
     }
@@ -66,7 +70,39 @@ class BaseAPI
         }
     }
 
-    const datafacade::BaseDataFacade &facade;
+    void WriteWaypoints(protozero::pbf_writer &response,
+                        const std::vector<PhantomNodes> &segment_end_coordinates) const
+    {
+        BOOST_ASSERT(parameters.coordinates.size() == segment_end_coordinates.size() + 1);
+
+        WriteWaypoint(response,
+                      pbf::response::waypoints,
+                      segment_end_coordinates.front().source_phantom);
+        for (const auto &phantom_pair : segment_end_coordinates)
+        {
+            WriteWaypoint(response, pbf::response::waypoints, phantom_pair.target_phantom);
+        }
+    }
+
+    void WriteWaypoint(protozero::pbf_writer &response,
+                       const protozero::pbf_tag_type tag,
+                       const PhantomNode &phantom) const
+    {
+        boost::optional<Hint> hint;
+        if (parameters.generate_hints)
+        {
+            hint = Hint{phantom, facade.GetCheckSum()};
+        }
+        pbf::writeWaypoint(
+            response,
+            tag,
+            phantom.location,
+            facade.GetNameForID(facade.GetNameIndex(phantom.forward_segment_id.id)).to_string(),
+            hint);
+    }
+
+    // The concrete facade, its accessors are final and can be called without virtual dispatch
+    const datafacade::ContiguousInternalMemoryDataFacadeBase &facade;
     const BaseParameters &parameters;
 };
 
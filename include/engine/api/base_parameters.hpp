@@ -36,6 +36,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/optional.hpp>
 
 #include <algorithm>
+#include <ctime>
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -57,12 +59,22 @@ namespace api
  *  - bearings: limits the search for segments in the road network to given bearing(s) in degree
  *              towards true north in clockwise direction, optional per coordinate
  *  - approaches: force the phantom node to start towards the node with the road country side.
+ *  - metric: name of the customized metric to route on, empty selects the default metric.
+ *  - departure_time: UTC time stamp for which conditional turn restrictions are evaluated by MLD,
+ *                    defaults to the time of the request.
+ *  - format: encoding of the response, only the route and table services support PBF.
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
  */
 struct BaseParameters
 {
+    enum class OutputFormatType
+    {
+        JSON,
+        PBF
+    };
+
     std::vector<util::Coordinate> coordinates;
     std::vector<boost::optional<Hint>> hints;
     std::vector<boost::optional<double>> radiuses;
@@ -72,6 +84,12 @@ struct BaseParameters
     // Adds hints to response which can be included in subsequent requests, see `hints` above.
     bool generate_hints = true;
 
+    std::string metric;
+
+    boost::optional<std::time_t> departure_time;
+
+    OutputFormatType format = OutputFormatType::JSON;
+
     BaseParameters(const std::vector<util::Coordinate> coordinates_ = {},
                    const std::vector<boost::optional<Hint>> hints_ = {},
                    std::vector<boost::optional<double>> radiuses_ = {},
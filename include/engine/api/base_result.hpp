@@ -0,0 +1,24 @@
+#ifndef ENGINE_API_BASE_RESULT_HPP
+#define ENGINE_API_BASE_RESULT_HPP
+
+#include "util/json_container.hpp"
+
+#include <mapbox/variant.hpp>
+
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+// Either a JSON object or a response that was already encoded, e.g. as protobuf
+using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif
@@ -5,7 +5,7 @@
 #include "engine/api/match_parameters_tidy.hpp"
 #include "engine/api/route_api.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/internal_route_result.hpp"
 #include "engine/map_matching/sub_matching.hpp"
@@ -22,7 +22,7 @@ namespace api
 class MatchAPI final : public RouteAPI
 {
   public:
-    MatchAPI(const datafacade::BaseDataFacade &facade_,
+    MatchAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
              const MatchParameters &parameters_,
              const tidy::Result &tidy_result_)
         : RouteAPI(facade_, parameters_), parameters(parameters_), tidy_result(tidy_result_)
@@ -0,0 +1,167 @@
+#ifndef ENGINE_API_PBF_FACTORY_HPP
+#define ENGINE_API_PBF_FACTORY_HPP
+
+#include "engine/guidance/route.hpp"
+#include "engine/guidance/route_leg.hpp"
+#include "engine/hint.hpp"
+#include "util/coordinate.hpp"
+
+#include <protozero/pbf_writer.hpp>
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+// Writers for the binary response format. The schema is documented in docs/response.proto,
+// all coordinates are fixed point numbers with COORDINATE_PRECISION.
+namespace pbf
+{
+
+// Bumped on every incompatible change of the field numbers below
+const constexpr std::uint32_t RESPONSE_VERSION = 1;
+
+namespace response
+{
+enum : protozero::pbf_tag_type
+{
+    version = 1,
+    code = 2,
+    waypoints = 3,
+    routes = 4,
+    sources = 5,
+    destinations = 6,
+    durations = 7
+};
+}
+
+namespace waypoint
+{
+enum : protozero::pbf_tag_type
+{
+    longitude = 1,
+    latitude = 2,
+    name = 3,
+    hint = 4
+};
+}
+
+namespace matrix
+{
+enum : protozero::pbf_tag_type
+{
+    rows = 1,
+    columns = 2,
+    values = 3
+};
+}
+
+namespace route
+{
+enum : protozero::pbf_tag_type
+{
+    distance = 1,
+    duration = 2,
+    weight = 3,
+    weight_name = 4,
+    geometry = 5,
+    legs = 6
+};
+}
+
+namespace leg
+{
+enum : protozero::pbf_tag_type
+{
+    distance = 1,
+    duration = 2,
+    weight = 3,
+    summary = 4,
+    annotation = 5
+};
+}
+
+namespace annotation
+{
+enum : protozero::pbf_tag_type
+{
+    duration = 1,
+    distance = 2,
+    weight = 3,
+    datasources = 4,
+    nodes = 5,
+    speed = 6
+};
+}
+
+inline void writeWaypoint(protozero::pbf_writer &parent,
+                          const protozero::pbf_tag_type tag,
+                          const util::Coordinate location,
+                          const std::string &name,
+                          const boost::optional<Hint> &hint)
+{
+    protozero::pbf_writer waypoint(parent, tag);
+    waypoint.add_sint32(waypoint::longitude, static_cast<std::int32_t>(location.lon));
+    waypoint.add_sint32(waypoint::latitude, static_cast<std::int32_t>(location.lat));
+    waypoint.add_string(waypoint::name, name);
+    if (hint)
+    {
+        // the raw bytes take a quarter less space and no encoding
+        waypoint.add_bytes(
+            waypoint::hint, reinterpret_cast<const char *>(&hint.get()), sizeof(Hint));
+    }
+}
+
+// Writes the coordinates as packed pairs of zigzag encoded longitude and latitude deltas
+template <typename ForwardIter>
+void writeGeometry(protozero::pbf_writer &parent,
+                   const protozero::pbf_tag_type tag,
+                   ForwardIter begin,
+                   ForwardIter end)
+{
+    protozero::packed_field_sint32 geometry(parent, tag);
+    std::int32_t previous_lon = 0;
+    std::int32_t previous_lat = 0;
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        const auto lon = static_cast<std::int32_t>(iter->lon);
+        const auto lat = static_cast<std::int32_t>(iter->lat);
+        geometry.add_element(lon - previous_lon);
+        geometry.add_element(lat - previous_lat);
+        previous_lon = lon;
+        previous_lat = lat;
+    }
+}
+
+// Writes the fields of a leg, annotations are added by the caller
+inline void writeRouteLeg(protozero::pbf_writer &leg_writer, const guidance::RouteLeg &leg)
+{
+    leg_writer.add_double(leg::distance, leg.distance);
+    leg_writer.add_double(leg::duration, leg.duration);
+    leg_writer.add_double(leg::weight, leg.weight);
+    leg_writer.add_string(leg::summary, leg.summary);
+}
+
+// Writes the fields of a route, the geometry and legs are added by the caller
+inline void writeRoute(protozero::pbf_writer &route_writer,
+                       const guidance::Route &route,
+                       const char *weight_name)
+{
+    route_writer.add_double(route::distance, route.distance);
+    route_writer.add_double(route::duration, route.duration);
+    route_writer.add_double(route::weight, route.weight);
+    route_writer.add_string(route::weight_name, weight_name);
+}
+
+} // namespace pbf
+} // namespace api
+} // namespace engine
+} // namespace osrm
+
+#endif // ENGINE_API_PBF_FACTORY_HPP
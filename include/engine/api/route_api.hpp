@@ -3,9 +3,10 @@
 
 #include "engine/api/base_api.hpp"
 #include "engine/api/json_factory.hpp"
+#include "engine/api/pbf_factory.hpp"
 #include "engine/api/route_parameters.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/guidance/assemble_geometry.hpp"
 #include "engine/guidance/assemble_leg.hpp"
@@ -23,7 +24,13 @@
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
 
+#include <protozero/pbf_writer.hpp>
+
+#include <cstdint>
 #include <iterator>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -36,7 +43,8 @@ namespace api
 class RouteAPI : public BaseAPI
 {
   public:
-    RouteAPI(const datafacade::BaseDataFacade &facade_, const RouteParameters &parameters_)
+    RouteAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+             const RouteParameters &parameters_)
         : BaseAPI(facade_, parameters_), parameters(parameters_)
     {
     }
@@ -65,6 +73,30 @@ class RouteAPI : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Steps are not part of the binary format, the caller has to reject them
+    void MakeResponse(const InternalManyRoutesResult &raw_routes, std::string &pbf_response) const
+    {
+        BOOST_ASSERT(!raw_routes.routes.empty());
+        BOOST_ASSERT(!parameters.steps);
+
+        protozero::pbf_writer response(pbf_response);
+        response.add_uint32(pbf::response::version, pbf::RESPONSE_VERSION);
+        response.add_string(pbf::response::code, "Ok");
+        BaseAPI::WriteWaypoints(response, raw_routes.routes[0].segment_end_coordinates);
+
+        for (const auto &route : raw_routes.routes)
+        {
+            if (!route.is_valid())
+                continue;
+
+            WriteRoute(response,
+                       route.segment_end_coordinates,
+                       route.unpacked_path_segments,
+                       route.source_traversed_in_reverse,
+                       route.target_traversed_in_reverse);
+        }
+    }
+
   protected:
     template <typename ForwardIter>
     util::json::Value MakeGeometry(ForwardIter begin, ForwardIter end) const
@@ -96,10 +128,12 @@ class RouteAPI : public BaseAPI
         return annotations_store;
     }
 
-    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
-                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
-                                 const std::vector<bool> &source_traversed_in_reverse,
-                                 const std::vector<bool> &target_traversed_in_reverse) const
+    // Assembles the legs and their geometries, including the post-processed steps if requested
+    std::pair<std::vector<guidance::RouteLeg>, std::vector<guidance::LegGeometry>>
+    MakeLegs(const std::vector<PhantomNodes> &segment_end_coordinates,
+             const std::vector<std::vector<PathData>> &unpacked_path_segments,
+             const std::vector<bool> &source_traversed_in_reverse,
+             const std::vector<bool> &target_traversed_in_reverse) const
     {
         std::vector<guidance::RouteLeg> legs;
         std::vector<guidance::LegGeometry> leg_geometries;
@@ -189,6 +223,34 @@ class RouteAPI : public BaseAPI
             legs.push_back(std::move(leg));
         }
 
+        return std::make_pair(std::move(legs), std::move(leg_geometries));
+    }
+
+    RouteParameters::AnnotationsType GetRequestedAnnotations() const
+    {
+        // To maintain support for uses of the old default constructors, we check
+        // if annotations property was set manually after default construction
+        auto requested_annotations = parameters.annotations_type;
+        if ((parameters.annotations == true) &&
+            (parameters.annotations_type == RouteParameters::AnnotationsType::None))
+        {
+            requested_annotations = RouteParameters::AnnotationsType::All;
+        }
+        return requested_annotations;
+    }
+
+    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
+                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                                 const std::vector<bool> &source_traversed_in_reverse,
+                                 const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        std::tie(legs, leg_geometries) = MakeLegs(segment_end_coordinates,
+                                                  unpacked_path_segments,
+                                                  source_traversed_in_reverse,
+                                                  target_traversed_in_reverse);
+
         auto route = guidance::assembleRoute(legs);
         boost::optional<util::json::Value> json_overview;
         if (parameters.overview != RouteParameters::OverviewType::False)
@@ -237,15 +299,7 @@ class RouteAPI : public BaseAPI
 
         std::vector<util::json::Object> annotations;
 
-        // To maintain support for uses of the old default constructors, we check
-        // if annotations property was set manually after default construction
-        auto requested_annotations = parameters.annotations_type;
-        if ((parameters.annotations == true) &&
-            (parameters.annotations_type == RouteParameters::AnnotationsType::None))
-        {
-            requested_annotations = RouteParameters::AnnotationsType::All;
-        }
-
+        const auto requested_annotations = GetRequestedAnnotations();
         if (requested_annotations != RouteParameters::AnnotationsType::None)
         {
             for (const auto idx : util::irange<std::size_t>(0UL, leg_geometries.size()))
@@ -316,6 +370,94 @@ class RouteAPI : public BaseAPI
         return result;
     }
 
+    void WriteRoute(protozero::pbf_writer &response,
+                    const std::vector<PhantomNodes> &segment_end_coordinates,
+                    const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                    const std::vector<bool> &source_traversed_in_reverse,
+                    const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        std::tie(legs, leg_geometries) = MakeLegs(segment_end_coordinates,
+                                                  unpacked_path_segments,
+                                                  source_traversed_in_reverse,
+                                                  target_traversed_in_reverse);
+
+        protozero::pbf_writer route_writer(response, pbf::response::routes);
+        pbf::writeRoute(route_writer, guidance::assembleRoute(legs), facade.GetWeightName());
+
+        if (parameters.overview != RouteParameters::OverviewType::False)
+        {
+            const auto use_simplification =
+                parameters.overview == RouteParameters::OverviewType::Simplified;
+            const auto overview = guidance::assembleOverview(leg_geometries, use_simplification);
+            pbf::writeGeometry(
+                route_writer, pbf::route::geometry, overview.begin(), overview.end());
+        }
+
+        const auto requested_annotations = GetRequestedAnnotations();
+        for (const auto idx : util::irange<std::size_t>(0UL, legs.size()))
+        {
+            protozero::pbf_writer leg_writer(route_writer, pbf::route::legs);
+            pbf::writeRouteLeg(leg_writer, legs[idx]);
+            if (requested_annotations != RouteParameters::AnnotationsType::None)
+            {
+                WriteAnnotation(leg_writer, leg_geometries[idx], requested_annotations);
+            }
+        }
+    }
+
+    void WriteAnnotation(protozero::pbf_writer &leg_writer,
+                         const guidance::LegGeometry &leg_geometry,
+                         const RouteParameters::AnnotationsType requested_annotations) const
+    {
+        using Annotation = guidance::LegGeometry::Annotation;
+
+        protozero::pbf_writer annotation(leg_writer, pbf::leg::annotation);
+        const auto write_floats = [&](const protozero::pbf_tag_type tag, auto get) {
+            protozero::packed_field_float values(
+                annotation, tag, leg_geometry.annotations.size());
+            for (const auto &anno : leg_geometry.annotations)
+                values.add_element(static_cast<float>(get(anno)));
+        };
+
+        // same as for JSON, speed is only reported if it was requested explicitly
+        if (parameters.annotations_type & RouteParameters::AnnotationsType::Speed)
+        {
+            write_floats(pbf::annotation::speed, [](const Annotation &anno) {
+                return util::json::clamp_float(
+                    static_cast<float>(std::round(anno.distance / anno.duration * 10.) / 10.));
+            });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Duration)
+        {
+            write_floats(pbf::annotation::duration,
+                         [](const Annotation &anno) { return anno.duration; });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Distance)
+        {
+            write_floats(pbf::annotation::distance,
+                         [](const Annotation &anno) { return anno.distance; });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Weight)
+        {
+            write_floats(pbf::annotation::weight,
+                         [](const Annotation &anno) { return anno.weight; });
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Datasources)
+        {
+            protozero::packed_field_uint32 datasources(annotation, pbf::annotation::datasources);
+            for (const auto &anno : leg_geometry.annotations)
+                datasources.add_element(anno.datasource);
+        }
+        if (requested_annotations & RouteParameters::AnnotationsType::Nodes)
+        {
+            protozero::packed_field_uint64 nodes(annotation, pbf::annotation::nodes);
+            for (const auto node_id : leg_geometry.osm_node_ids)
+                nodes.add_element(static_cast<std::uint64_t>(node_id));
+        }
+    }
+
     const RouteParameters &parameters;
 };
 
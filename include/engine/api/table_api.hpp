@@ -3,9 +3,10 @@
 
 #include "engine/api/base_api.hpp"
 #include "engine/api/json_factory.hpp"
+#include "engine/api/pbf_factory.hpp"
 #include "engine/api/table_parameters.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/guidance/assemble_geometry.hpp"
 #include "engine/guidance/assemble_leg.hpp"
@@ -19,7 +20,11 @@
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <protozero/pbf_writer.hpp>
+
 #include <iterator>
+#include <limits>
+#include <string>
 
 namespace osrm
 {
@@ -31,7 +36,8 @@ namespace api
 class TableAPI final : public BaseAPI
 {
   public:
-    TableAPI(const datafacade::BaseDataFacade &facade_, const TableParameters &parameters_)
+    TableAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+             const TableParameters &parameters_)
         : BaseAPI(facade_, parameters_), parameters(parameters_)
     {
     }
@@ -69,7 +75,56 @@ class TableAPI final : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Encodes the durations as a packed array of floats in seconds, unreachable pairs are NaN
+    void MakeResponse(const std::vector<EdgeWeight> &durations,
+                      const std::vector<PhantomNode> &phantoms,
+                      std::string &pbf_response) const
+    {
+        protozero::pbf_writer response(pbf_response);
+        response.add_uint32(pbf::response::version, pbf::RESPONSE_VERSION);
+        response.add_string(pbf::response::code, "Ok");
+
+        const auto number_of_sources =
+            WriteWaypoints(response, pbf::response::sources, phantoms, parameters.sources);
+        const auto number_of_destinations = WriteWaypoints(
+            response, pbf::response::destinations, phantoms, parameters.destinations);
+        BOOST_ASSERT(durations.size() == number_of_sources * number_of_destinations);
+
+        protozero::pbf_writer matrix(response, pbf::response::durations);
+        matrix.add_uint32(pbf::matrix::rows, number_of_sources);
+        matrix.add_uint32(pbf::matrix::columns, number_of_destinations);
+        protozero::packed_field_float values(matrix, pbf::matrix::values, durations.size());
+        for (const auto duration : durations)
+        {
+            values.add_element(duration == MAXIMAL_EDGE_DURATION
+                                   ? std::numeric_limits<float>::quiet_NaN()
+                                   : duration / 10.f);
+        }
+    }
+
   protected:
+    // Writes the waypoints of the selected phantoms, all of them if no indices are given.
+    // Returns the number of waypoints.
+    std::size_t WriteWaypoints(protozero::pbf_writer &response,
+                               const protozero::pbf_tag_type tag,
+                               const std::vector<PhantomNode> &phantoms,
+                               const std::vector<std::size_t> &indices) const
+    {
+        if (indices.empty())
+        {
+            for (const auto &phantom : phantoms)
+                WriteWaypoint(response, tag, phantom);
+            return phantoms.size();
+        }
+
+        for (const auto index : indices)
+        {
+            BOOST_ASSERT(index < phantoms.size());
+            WriteWaypoint(response, tag, phantoms[index]);
+        }
+        return indices.size();
+    }
+
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
     {
         util::json::Array json_waypoints;
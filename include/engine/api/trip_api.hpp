@@ -4,7 +4,7 @@
 #include "engine/api/route_api.hpp"
 #include "engine/api/trip_parameters.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/internal_route_result.hpp"
 
@@ -20,7 +20,8 @@ namespace api
 class TripAPI final : public RouteAPI
 {
   public:
-    TripAPI(const datafacade::BaseDataFacade &facade_, const TripParameters &parameters_)
+    TripAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+            const TripParameters &parameters_)
         : RouteAPI(facade_, parameters_), parameters(parameters_)
     {
     }
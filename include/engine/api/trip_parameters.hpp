@@ -59,6 +59,12 @@ struct TripParameters : public RouteParameters
         Any,
         Last
     };
+    enum class SolverType
+    {
+        Auto,
+        Exact,
+        Heuristic
+    };
 
     template <typename... Args>
     TripParameters(SourceType source_,
@@ -73,6 +79,8 @@ struct TripParameters : public RouteParameters
     SourceType source = SourceType::Any;
     DestinationType destination = DestinationType::Any;
     bool roundtrip = true;
+    // Auto solves small trips exactly and uses the heuristic for larger ones
+    SolverType solver = SolverType::Auto;
 
     bool IsValid() const { return RouteParameters::IsValid(); }
 };
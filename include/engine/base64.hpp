@@ -1,6 +1,7 @@
 #ifndef OSRM_BASE64_HPP
 #define OSRM_BASE64_HPP
 
+#include <array>
 #include <iterator>
 #include <string>
 #include <type_traits>
@@ -8,12 +9,9 @@
 
 #include <climits>
 #include <cstddef>
+#include <cstdint>
 
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/archive/iterators/base64_from_binary.hpp>
-#include <boost/archive/iterators/binary_from_base64.hpp>
-#include <boost/archive/iterators/transform_width.hpp>
-#include <boost/range/algorithm/copy.hpp>
+#include <boost/assert.hpp>
 
 namespace osrm
 {
@@ -27,44 +25,105 @@ namespace detail
 static_assert(CHAR_BIT == 8u, "we assume a byte holds 8 bits");
 static_assert(sizeof(char) == 1u, "we assume a char is one byte large");
 
-using Base64FromBinary = boost::archive::iterators::base64_from_binary<
-    boost::archive::iterators::transform_width<const char *, // sequence of chars
-                                               6,            // get view of 6 bit
-                                               8             // from sequence of 8 bit
-                                               >>;
-
-using BinaryFromBase64 = boost::archive::iterators::transform_width<
-    boost::archive::iterators::binary_from_base64<std::string::const_iterator>,
-    8, // get a view of 8 bit
-    6  // from a sequence of 6 bit
-    >;
-} // ns detail
-namespace engine
+const constexpr char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+// Section 5 of the RFC: safe for usage as GET parameter in URLs
+const constexpr char BASE64_URL_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Maps the characters of both alphabets to their 6 bit values. All other characters,
+// including the padding, map to zero: callers are expected to validate their input.
+inline const std::array<std::uint8_t, 256> &base64DecodingTable()
 {
+    static const auto table = [] {
+        std::array<std::uint8_t, 256> table{};
+        for (std::uint8_t value = 0; value < 64; ++value)
+        {
+            table[static_cast<unsigned char>(BASE64_ALPHABET[value])] = value;
+            table[static_cast<unsigned char>(BASE64_URL_ALPHABET[value])] = value;
+        }
+        return table;
+    }();
+    return table;
+}
 
-// Encoding Implementation
+// Appends the encoding of size bytes to output, three input bytes at a time
+inline void encodeBase64(const unsigned char *first,
+                         const std::size_t size,
+                         const char *alphabet,
+                         std::string &output)
+{
+    const auto offset = output.size();
+    output.resize(offset + (size + 2) / 3 * 4);
+    auto out = &output[offset];
 
-// Encodes a chunk of memory to Base64.
-inline std::string encodeBase64(const unsigned char *first, std::size_t size)
+    const auto last_chunk = first + size / 3 * 3;
+    for (; first != last_chunk; first += 3, out += 4)
+    {
+        const std::uint32_t chunk = first[0] << 16 | first[1] << 8 | first[2];
+        out[0] = alphabet[chunk >> 18];
+        out[1] = alphabet[(chunk >> 12) & 0x3f];
+        out[2] = alphabet[(chunk >> 6) & 0x3f];
+        out[3] = alphabet[chunk & 0x3f];
+    }
+
+    const auto remaining = size % 3;
+    if (remaining > 0)
+    {
+        const std::uint32_t chunk = first[0] << 16 | (remaining == 2 ? first[1] << 8 : 0);
+        out[0] = alphabet[chunk >> 18];
+        out[1] = alphabet[(chunk >> 12) & 0x3f];
+        out[2] = remaining == 2 ? alphabet[(chunk >> 6) & 0x3f] : '=';
+        out[3] = '=';
+    }
+}
+
+// Decodes four characters at a time, trailing padding is optional
+template <typename OutputIter>
+OutputIter decodeBase64(const char *first, const char *last, OutputIter out)
 {
-    std::vector<unsigned char> bytes{first, first + size};
-    BOOST_ASSERT(!bytes.empty());
+    const auto &table = base64DecodingTable();
+    const auto value = [&table](const char character) -> std::uint32_t {
+        return table[static_cast<unsigned char>(character)];
+    };
 
-    std::size_t bytes_to_pad{0};
+    while (last != first && *(last - 1) == '=')
+        --last;
 
-    while (bytes.size() % 3 != 0)
+    const auto last_chunk = first + (last - first) / 4 * 4;
+    for (; first != last_chunk; first += 4)
     {
-        bytes_to_pad += 1;
-        bytes.push_back(0);
+        const auto chunk = value(first[0]) << 18 | value(first[1]) << 12 |
+                           value(first[2]) << 6 | value(first[3]);
+        *out++ = static_cast<unsigned char>(chunk >> 16);
+        *out++ = static_cast<unsigned char>(chunk >> 8);
+        *out++ = static_cast<unsigned char>(chunk);
     }
 
-    BOOST_ASSERT(bytes_to_pad == 0 || bytes_to_pad == 1 || bytes_to_pad == 2);
-    BOOST_ASSERT_MSG(0 == bytes.size() % 3, "base64 input data size is not a multiple of 3");
+    // two or three characters hold one or two bytes, a single one can not hold a byte
+    const auto remaining = last - first;
+    if (remaining >= 2)
+    {
+        const auto chunk = value(first[0]) << 18 | value(first[1]) << 12 |
+                           (remaining == 3 ? value(first[2]) << 6 : 0);
+        *out++ = static_cast<unsigned char>(chunk >> 16);
+        if (remaining == 3)
+            *out++ = static_cast<unsigned char>(chunk >> 8);
+    }
+    return out;
+}
+} // ns detail
+namespace engine
+{
 
-    std::string encoded{detail::Base64FromBinary{bytes.data()},
-                        detail::Base64FromBinary{bytes.data() + (bytes.size() - bytes_to_pad)}};
+// Encoding Implementation
 
-    return encoded.append(bytes_to_pad, '=');
+// Encodes a chunk of memory to Base64.
+inline std::string encodeBase64(const unsigned char *first, std::size_t size)
+{
+    std::string encoded;
+    detail::encodeBase64(first, size, detail::BASE64_ALPHABET, encoded);
+    return encoded;
 }
 
 // C++11 standard 3.9.1/1: Plain char, signed char, and unsigned char are three distinct types
@@ -94,27 +153,35 @@ template <typename T> std::string encodeBase64Bytewise(const T &x)
     return encodeBase64(reinterpret_cast<const unsigned char *>(&x), sizeof(T));
 }
 
+// Encode any sufficiently trivial object to the URL safe variant of Base64.
+template <typename T> std::string encodeBase64URLBytewise(const T &x)
+{
+#if not defined __GNUC__ or __GNUC__ > 4
+    static_assert(std::is_trivially_copyable<T>::value, "requires a trivially copyable type");
+#endif
+
+    std::string encoded;
+    detail::encodeBase64(reinterpret_cast<const unsigned char *>(&x),
+                         sizeof(T),
+                         detail::BASE64_URL_ALPHABET,
+                         encoded);
+    return encoded;
+}
+
 // Decoding Implementation
 
 // Decodes into a chunk of memory that is at least as large as the input.
+// Accepts both the standard and the URL safe alphabet.
 template <typename OutputIter> void decodeBase64(const std::string &encoded, OutputIter out)
 {
-    auto unpadded = encoded;
-
-    const auto num_padded = std::count(begin(encoded), end(encoded), '=');
-    std::replace(begin(unpadded), end(unpadded), '=', 'A'); // A_64 == \0
-
-    std::string decoded{detail::BinaryFromBase64{begin(unpadded)},
-                        detail::BinaryFromBase64{begin(unpadded) + unpadded.length()}};
-
-    decoded.erase(end(decoded) - num_padded, end(decoded));
-    std::copy(begin(decoded), end(decoded), out);
+    detail::decodeBase64(encoded.data(), encoded.data() + encoded.size(), out);
 }
 
 // Convenience specialization, filling string instead of byte-dumping into it.
 inline std::string decodeBase64(const std::string &encoded)
 {
     std::string rv;
+    rv.reserve(encoded.size() / 4 * 3 + 2);
 
     decodeBase64(encoded, std::back_inserter(rv));
 
@@ -0,0 +1,189 @@
+#ifndef OSRM_ENGINE_CONDITIONAL_TURN_FILTER_HPP
+#define OSRM_ENGINE_CONDITIONAL_TURN_FILTER_HPP
+
+#include "customizer/conditional_turns.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Turns that are forbidden by conditional restrictions at the departure time of a request.
+//
+// The overlay cells are customized without the conditional restrictions, so the shortcuts of
+// every cell that contains an active restricted turn can not be used. The search descends below
+// these cells and checks the turns of the base graph edges instead. Most edges are not
+// restricted, a small bit mask over hashed turn ids rejects them before the exact lookup.
+class ConditionalTurnFilter
+{
+  public:
+    ConditionalTurnFilter() = default;
+
+    template <typename MultiLevelPartitionT, typename ConditionalTurnsT>
+    ConditionalTurnFilter(const MultiLevelPartitionT &partition,
+                          const ConditionalTurnsT &conditional_turns,
+                          const std::uint32_t time)
+    {
+        std::vector<EdgeID> restricted_turns;
+        std::vector<std::vector<CellID>> restricted_cells(partition.GetNumberOfLevels());
+
+        for (const auto condition :
+             util::irange<std::uint32_t>(0, conditional_turns.GetNumberOfConditions()))
+        {
+            if (!conditional_turns.IsActive(condition, time))
+                continue;
+
+            for (const auto &turn : conditional_turns.GetTurns(condition))
+            {
+                restricted_turns.push_back(turn.turn_id);
+                for (LevelID level = 1; level < restricted_cells.size(); ++level)
+                {
+                    const auto cell = partition.GetCell(level, turn.from);
+                    if (cell == partition.GetCell(level, turn.to))
+                        restricted_cells[level].push_back(cell);
+                }
+            }
+        }
+
+        if (restricted_turns.empty())
+            return;
+
+        std::sort(restricted_turns.begin(), restricted_turns.end());
+        restricted_turns.erase(std::unique(restricted_turns.begin(), restricted_turns.end()),
+                               restricted_turns.end());
+        for (auto &cells : restricted_cells)
+        {
+            std::sort(cells.begin(), cells.end());
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        }
+
+        std::vector<std::uint64_t> turn_mask(TURN_MASK_SIZE / 64, 0);
+        for (const auto turn_id : restricted_turns)
+            turn_mask[(turn_id & (TURN_MASK_SIZE - 1)) / 64] |= std::uint64_t{1} << (turn_id % 64);
+
+        restrictions = std::make_shared<const Restrictions>(Restrictions{
+            std::move(restricted_turns), std::move(restricted_cells), std::move(turn_mask)});
+    }
+
+    bool Empty() const { return !restrictions; }
+
+    bool IsRestricted(const EdgeID turn_id) const
+    {
+        if (!restrictions)
+            return false;
+
+        const auto bit = std::uint64_t{1} << (turn_id % 64);
+        if ((restrictions->turn_mask[(turn_id & (TURN_MASK_SIZE - 1)) / 64] & bit) == 0)
+            return false;
+
+        const auto &restricted_turns = restrictions->restricted_turns;
+        return std::binary_search(restricted_turns.begin(), restricted_turns.end(), turn_id);
+    }
+
+    // Checks the turn of a base graph edge of the node in the direction of the search. A merged
+    // forward and backward edge keeps the turn of its forward direction, so the reverse search
+    // checks the copy of the edge that is stored at its target.
+    template <typename FacadeT>
+    bool IsRestricted(const FacadeT &facade,
+                      const NodeID node,
+                      const EdgeID edge,
+                      const bool reverse_search) const
+    {
+        if (!restrictions)
+            return false;
+
+        const auto &data = facade.GetEdgeData(edge);
+        if (reverse_search && data.forward)
+        {
+            const auto forward_edge = facade.FindEdge(facade.GetTarget(edge), node);
+            BOOST_ASSERT(forward_edge != SPECIAL_EDGEID);
+            return IsRestricted(facade.GetEdgeData(forward_edge).turn_id);
+        }
+
+        return IsRestricted(data.turn_id);
+    }
+
+    // Highest level whose cell of the node contains no restricted turn
+    template <typename MultiLevelPartitionT>
+    LevelID GetMaxLevel(const MultiLevelPartitionT &partition, const NodeID node) const
+    {
+        if (!restrictions)
+            return INVALID_LEVEL_ID;
+
+        // a restricted cell is contained in restricted cells on all higher levels
+        const auto &restricted_cells = restrictions->restricted_cells;
+        for (LevelID level = 1; level < restricted_cells.size(); ++level)
+        {
+            const auto &cells = restricted_cells[level];
+            if (std::binary_search(cells.begin(), cells.end(), partition.GetCell(level, node)))
+                return level - 1;
+        }
+        return INVALID_LEVEL_ID;
+    }
+
+  private:
+    static constexpr std::size_t TURN_MASK_SIZE = 1 << 16;
+
+    struct Restrictions
+    {
+        std::vector<EdgeID> restricted_turns;
+        std::vector<std::vector<CellID>> restricted_cells;
+        std::vector<std::uint64_t> turn_mask;
+    };
+
+    // shared by the copies of a filter, nullptr if no turn is restricted
+    std::shared_ptr<const Restrictions> restrictions;
+};
+
+// Filters of recent minutes for the conditional turns of one dataset. Opening hours change on
+// full minutes, so all requests of a minute share the filter of its first second. Requests
+// without a departure time all fall into the current minute.
+class ConditionalTurnFilterCache
+{
+  public:
+    template <typename MultiLevelPartitionT, typename ConditionalTurnsT>
+    ConditionalTurnFilter Get(const MultiLevelPartitionT &partition,
+                              const ConditionalTurnsT &conditional_turns,
+                              const std::uint32_t time)
+    {
+        const auto minute = time / 60;
+        auto &slot = slots[minute % NUM_SLOTS];
+
+        auto entry = std::atomic_load(&slot);
+        if (!entry || entry->minute != minute)
+        {
+            // concurrent requests of a new minute may build the filter twice, the last one wins
+            entry = std::make_shared<const Entry>(
+                Entry{minute, ConditionalTurnFilter{partition, conditional_turns, minute * 60}});
+            std::atomic_store(&slot, entry);
+        }
+        return entry->filter;
+    }
+
+  private:
+    static constexpr std::size_t NUM_SLOTS = 16;
+
+    struct Entry
+    {
+        std::uint32_t minute;
+        ConditionalTurnFilter filter;
+    };
+
+    std::array<std::shared_ptr<const Entry>, NUM_SLOTS> slots;
+};
+}
+}
+
+#endif
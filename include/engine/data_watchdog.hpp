@@ -3,6 +3,7 @@
 
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/shared_memory_allocator.hpp"
+#include "engine/datafacade_factory.hpp"
 
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
@@ -13,6 +14,7 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <atomic>
 #include <memory>
 #include <thread>
 
@@ -30,14 +32,17 @@ template <typename AlgorithmT> class DataWatchdog final
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdog() : active(true), timestamp(0)
+    // Every facade gets its own unpacking cache of this size, see DataFacadeFactory
+    explicit DataWatchdog(const std::size_t unpacking_cache_size)
+        : active(true), timestamp(0), unpacking_cache_size(unpacking_cache_size)
     {
         // create the initial facade before launching the watchdog thread
         {
             boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-            facade = std::make_shared<const FacadeT>(
-                std::make_unique<datafacade::SharedMemoryAllocator>(barrier.data().region));
+            facade_factory = std::make_shared<const DataFacadeFactory<AlgorithmT>>(
+                std::make_shared<datafacade::SharedMemoryAllocator>(barrier.data().region),
+                unpacking_cache_size);
             timestamp = barrier.data().timestamp;
         }
 
@@ -51,7 +56,17 @@ template <typename AlgorithmT> class DataWatchdog final
         watcher.join();
     }
 
-    std::shared_ptr<const FacadeT> Get() const { return facade; }
+    std::shared_ptr<const FacadeT> Get(const api::BaseParameters &params) const
+    {
+        return std::atomic_load(&facade_factory)->Get(params);
+    }
+
+    std::shared_ptr<const FacadeT> Get(const api::TileParameters &params) const
+    {
+        return std::atomic_load(&facade_factory)->Get(params);
+    }
+
+    unsigned GetTimestamp() const { return timestamp; }
 
   private:
     void Run()
@@ -68,8 +83,10 @@ template <typename AlgorithmT> class DataWatchdog final
             if (timestamp != barrier.data().timestamp)
             {
                 auto region = barrier.data().region;
-                facade = std::make_shared<const FacadeT>(
-                    std::make_unique<datafacade::SharedMemoryAllocator>(region));
+                std::atomic_store(&facade_factory,
+                                  std::make_shared<const DataFacadeFactory<AlgorithmT>>(
+                                      std::make_shared<datafacade::SharedMemoryAllocator>(region),
+                                      unpacking_cache_size));
                 timestamp = barrier.data().timestamp;
                 util::Log() << "updated facade to region " << region << " with timestamp "
                             << timestamp;
@@ -82,8 +99,12 @@ template <typename AlgorithmT> class DataWatchdog final
     storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
     std::thread watcher;
     bool active;
-    unsigned timestamp;
-    std::shared_ptr<const FacadeT> facade;
+    // written after the facade is swapped and read by request threads
+    std::atomic<unsigned> timestamp;
+    const std::size_t unpacking_cache_size;
+    // swapped as a whole by the watchdog thread while request threads read it, a request
+    // keeps the factory alive until it has picked its facade
+    std::shared_ptr<const DataFacadeFactory<AlgorithmT>> facade_factory;
 };
 }
 }
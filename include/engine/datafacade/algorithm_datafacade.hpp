@@ -2,6 +2,8 @@
 #define OSRM_ENGINE_DATAFACADE_ALGORITHM_DATAFACADE_HPP
 
 #include "contractor/query_edge.hpp"
+#include "customizer/cell_metric.hpp"
+#include "customizer/conditional_turns.hpp"
 #include "extractor/edge_based_edge.hpp"
 #include "engine/algorithm.hpp"
 
@@ -95,6 +97,18 @@ template <> class AlgorithmDataFacade<MLD>
 
     virtual const partition::CellStorageView &GetCellStorage() const = 0;
 
+    // cell weights and durations of the metric this facade serves
+    virtual const customizer::CellMetricView &GetCellMetric() const = 0;
+
+    // conditional turn restrictions that are evaluated at query time, empty if none were stored
+    virtual const customizer::ConditionalTurnsView &GetConditionalTurns() const = 0;
+
+    // weight and duration of a base graph edge that leaves the node from under the metric
+    // this facade serves, time slice metrics scale them by the speed profile of the node
+    virtual EdgeWeight GetEdgeWeight(const EdgeID e, const NodeID from) const = 0;
+
+    virtual EdgeDuration GetEdgeDuration(const EdgeID e, const NodeID from) const = 0;
+
     virtual EdgeRange GetBorderEdgeRange(const LevelID level, const NodeID node) const = 0;
 
     // searches for a specific edge
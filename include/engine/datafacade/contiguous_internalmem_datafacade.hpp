@@ -7,8 +7,11 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/approach.hpp"
+#include "engine/conditional_turn_filter.hpp"
 #include "engine/geospatial_query.hpp"
+#include "engine/unpacking_cache.hpp"
 
+#include "customizer/cell_metric.hpp"
 #include "customizer/edge_based_graph.hpp"
 
 #include "extractor/datasources.hpp"
@@ -209,7 +212,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     using IndexBlock = util::RangeTable<16, storage::Ownership::View>::BlockT;
     using RTreeLeaf = super::RTreeLeaf;
     using SharedRTree = util::StaticRTree<RTreeLeaf, storage::Ownership::View>;
-    using SharedGeospatialQuery = GeospatialQuery<SharedRTree, BaseDataFacade>;
+    // The query calls back into the facade for every candidate, using the concrete type
+    // lets the compiler resolve the final overrides below without a virtual call
+    using SharedGeospatialQuery =
+        GeospatialQuery<SharedRTree, const ContiguousInternalMemoryDataFacadeBase>;
     using RTreeNode = SharedRTree::TreeNode;
 
     std::string m_timestamp;
@@ -246,6 +252,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    // which base data values are reported as weights, see customizer::MetricSource
+    customizer::MetricSource weight_source;
+
     void InitializeProfilePropertiesPointer(storage::DataLayout &data_layout, char *memory_block)
     {
         m_profile_properties = data_layout.GetBlockPtr<extractor::ProfileProperties>(
@@ -550,8 +559,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
   public:
     // allows switching between process_memory/shared_memory datafacade, based on the type of
     // allocator
-    ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_)
-        : allocator(std::move(allocator_))
+    ContiguousInternalMemoryDataFacadeBase(
+        std::shared_ptr<ContiguousBlockAllocator> allocator_,
+        const customizer::MetricSource weight_source_ = customizer::MetricSource::Weight)
+        : allocator(std::move(allocator_)), weight_source(weight_source_)
     {
         InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
     }
@@ -567,67 +578,63 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         return m_osmnodeid_list[id];
     }
 
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
-
-        auto range = segment_data.GetForwardGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        return segment_data.GetForwardGeometry(id);
     }
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const override final
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        return segment_data.GetReverseGeometry(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardDurations(const EdgeID id) const override final
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetForwardDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseDurations(const EdgeID id) const override final
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetReverseDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardWeights(const EdgeID id) const override final
+    // weights and durations share one packed representation, so a duration metric
+    // can hand out the duration ranges directly
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        if (weight_source == customizer::MetricSource::Duration)
+            return segment_data.GetForwardDurations(id);
+
+        return segment_data.GetForwardWeights(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseWeights(const EdgeID id) const override final
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        if (weight_source == customizer::MetricSource::Duration)
+            return segment_data.GetReverseDurations(id);
+
+        return segment_data.GetReverseWeights(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
-    GetUncompressedForwardDatasources(const EdgeID id) const override final
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        return segment_data.GetForwardDatasources(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
-    GetUncompressedReverseDatasources(const EdgeID id) const override final
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        return segment_data.GetReverseDatasources(id);
     }
 
     virtual TurnPenalty GetWeightPenaltyForEdgeID(const unsigned id) const override final
     {
+        if (weight_source == customizer::MetricSource::Duration)
+            return GetDurationPenaltyForEdgeID(id);
+
         BOOST_ASSERT(m_turn_weight_penalties.size() > id);
         return m_turn_weight_penalties[id];
     }
@@ -638,6 +645,11 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         return m_turn_duration_penalties[id];
     }
 
+    virtual std::uint16_t GetSpeedFactor(const NodeID /* id */) const override
+    {
+        return customizer::SPEED_PROFILE_BASE_FACTOR;
+    }
+
     extractor::guidance::TurnInstruction
     GetTurnInstructionForEdgeID(const EdgeID id) const override final
     {
@@ -772,7 +784,11 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, bearing, bearing_range, approach);
     }
 
-    unsigned GetCheckSum() const override final { return m_check_sum; }
+    // Hints carry phantom node weights, so they must not be reused across metrics
+    unsigned GetCheckSum() const override final
+    {
+        return m_check_sum + static_cast<unsigned>(weight_source);
+    }
 
     GeometryID GetGeometryIndex(const NodeID id) const override final
     {
@@ -852,15 +868,25 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         return m_profile_properties->max_speed_for_map_matching;
     }
 
-    const char *GetWeightName() const override final { return m_profile_properties->weight_name; }
+    const char *GetWeightName() const override final
+    {
+        if (weight_source == customizer::MetricSource::Duration)
+            return "duration";
+        return m_profile_properties->weight_name;
+    }
 
+    // durations are stored in deciseconds
     unsigned GetWeightPrecision() const override final
     {
+        if (weight_source == customizer::MetricSource::Duration)
+            return 1;
         return m_profile_properties->weight_precision;
     }
 
     double GetWeightMultiplier() const override final
     {
+        if (weight_source == customizer::MetricSource::Duration)
+            return 10.;
         return m_profile_properties->GetWeightMultiplier();
     }
 
@@ -945,6 +971,12 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
     // MLD data
     partition::MultiLevelPartitionView mld_partition;
     partition::CellStorageView mld_cell_storage;
+    customizer::CellMetricView mld_cell_metric;
+    customizer::ConditionalTurnsView mld_conditional_turns;
+    customizer::SpeedProfilesView mld_speed_profiles;
+    // factors of all speed profiles at the time slice of the metric, empty for static metrics
+    std::vector<std::uint16_t> speed_factors;
+    std::size_t metric_index;
     using QueryGraph = customizer::MultiLevelEdgeBasedGraphView;
     using GraphNode = QueryGraph::NodeArrayEntry;
     using GraphEdge = QueryGraph::EdgeArrayEntry;
@@ -984,15 +1016,10 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
                 partition::MultiLevelPartitionView{level_data, partition, cell_to_children};
         }
 
-        if (data_layout.GetBlockSize(storage::DataLayout::MLD_CELL_WEIGHTS) > 0)
+        if (data_layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0)
         {
-            BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
             BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
 
-            auto mld_cell_weights_ptr = data_layout.GetBlockPtr<EdgeWeight>(
-                memory_block, storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto mld_cell_durations_ptr = data_layout.GetBlockPtr<EdgeDuration>(
-                memory_block, storage::DataLayout::MLD_CELL_DURATIONS);
             auto mld_source_boundary_ptr = data_layout.GetBlockPtr<NodeID>(
                 memory_block, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
             auto mld_destination_boundary_ptr = data_layout.GetBlockPtr<NodeID>(
@@ -1002,10 +1029,6 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
             auto mld_cell_level_offsets_ptr = data_layout.GetBlockPtr<std::uint64_t>(
                 memory_block, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
 
-            auto weight_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto duration_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS);
             auto source_boundary_entries_count =
                 data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
             auto destination_boundary_entries_count =
@@ -1014,11 +1037,6 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
             auto cell_level_offsets_entries_count =
                 data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
 
-            BOOST_ASSERT(weight_entries_count == duration_entries_count);
-
-            util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
-            util::vector_view<EdgeDuration> durations(mld_cell_durations_ptr,
-                                                      duration_entries_count);
             util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
                                                       source_boundary_entries_count);
             util::vector_view<NodeID> destination_boundary(mld_destination_boundary_ptr,
@@ -1028,13 +1046,142 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
             util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
                                                            cell_level_offsets_entries_count);
 
-            mld_cell_storage = partition::CellStorageView{std::move(weights),
-                                                          std::move(durations),
-                                                          std::move(source_boundary),
+            mld_cell_storage = partition::CellStorageView{std::move(source_boundary),
                                                           std::move(destination_boundary),
                                                           std::move(cells),
                                                           std::move(level_offsets)};
         }
+
+        if (data_layout.GetBlockSize(storage::DataLayout::MLD_CONDITIONAL_TURN_OFFSETS) > 0)
+        {
+            auto turns_ptr = data_layout.GetBlockPtr<customizer::ConditionalTurn>(
+                memory_block, storage::DataLayout::MLD_CONDITIONAL_TURNS);
+            auto turn_offsets_ptr = data_layout.GetBlockPtr<std::uint32_t>(
+                memory_block, storage::DataLayout::MLD_CONDITIONAL_TURN_OFFSETS);
+            auto intervals_ptr = data_layout.GetBlockPtr<customizer::ConditionalInterval>(
+                memory_block, storage::DataLayout::MLD_CONDITIONAL_INTERVALS);
+            auto interval_offsets_ptr = data_layout.GetBlockPtr<std::uint32_t>(
+                memory_block, storage::DataLayout::MLD_CONDITIONAL_INTERVAL_OFFSETS);
+
+            util::vector_view<customizer::ConditionalTurn> turns(
+                turns_ptr, data_layout.GetBlockEntries(storage::DataLayout::MLD_CONDITIONAL_TURNS));
+            util::vector_view<std::uint32_t> turn_offsets(
+                turn_offsets_ptr,
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_CONDITIONAL_TURN_OFFSETS));
+            util::vector_view<customizer::ConditionalInterval> intervals(
+                intervals_ptr,
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_CONDITIONAL_INTERVALS));
+            util::vector_view<std::uint32_t> interval_offsets(
+                interval_offsets_ptr,
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_CONDITIONAL_INTERVAL_OFFSETS));
+
+            mld_conditional_turns = customizer::ConditionalTurnsView{std::move(turns),
+                                                                     std::move(turn_offsets),
+                                                                     std::move(intervals),
+                                                                     std::move(interval_offsets)};
+        }
+
+        if (data_layout.GetBlockSize(storage::DataLayout::MLD_SPEED_PROFILE_OFFSETS) > 0)
+        {
+            auto points_ptr = data_layout.GetBlockPtr<customizer::SpeedProfilePoint>(
+                memory_block, storage::DataLayout::MLD_SPEED_PROFILE_POINTS);
+            auto profile_offsets_ptr = data_layout.GetBlockPtr<std::uint32_t>(
+                memory_block, storage::DataLayout::MLD_SPEED_PROFILE_OFFSETS);
+            auto node_profiles_ptr = data_layout.GetBlockPtr<std::uint32_t>(
+                memory_block, storage::DataLayout::MLD_NODE_SPEED_PROFILES);
+
+            util::vector_view<customizer::SpeedProfilePoint> points(
+                points_ptr,
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_SPEED_PROFILE_POINTS));
+            util::vector_view<std::uint32_t> profile_offsets(
+                profile_offsets_ptr,
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_SPEED_PROFILE_OFFSETS));
+            util::vector_view<std::uint32_t> node_profiles(
+                node_profiles_ptr,
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_NODE_SPEED_PROFILES));
+
+            mld_speed_profiles = customizer::SpeedProfilesView{
+                std::move(points), std::move(profile_offsets), std::move(node_profiles)};
+        }
+
+        const auto num_metrics = data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_METRICS);
+        if (num_metrics > 0)
+        {
+            if (metric_index >= num_metrics)
+            {
+                throw util::exception("Metric " + std::to_string(metric_index) +
+                                      " is not loaded, only " + std::to_string(num_metrics) +
+                                      " metrics are available" + SOURCE_REF);
+            }
+
+            auto mld_cell_metrics_ptr = data_layout.GetBlockPtr<customizer::MetricSource>(
+                memory_block, storage::DataLayout::MLD_CELL_METRICS);
+            auto mld_cell_weights_ptr = data_layout.GetBlockPtr<EdgeWeight>(
+                memory_block, storage::DataLayout::MLD_CELL_WEIGHTS);
+            auto mld_cell_durations_ptr = data_layout.GetBlockPtr<EdgeDuration>(
+                memory_block, storage::DataLayout::MLD_CELL_DURATIONS);
+
+            // metrics are stored back to back, see Storage::PopulateData
+            auto weight_entries_count =
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS) / num_metrics;
+            auto duration_entries_count =
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS) / num_metrics;
+
+            BOOST_ASSERT(weight_entries_count == duration_entries_count);
+
+            mld_cell_metric.source = mld_cell_metrics_ptr[metric_index];
+            mld_cell_metric.time_slice = data_layout.GetBlockPtr<std::uint16_t>(
+                memory_block, storage::DataLayout::MLD_CELL_METRIC_TIME_SLICES)[metric_index];
+            if (mld_cell_metric.IsTimeSlice() && !mld_speed_profiles.Empty())
+                speed_factors = mld_speed_profiles.GetFactors(mld_cell_metric.time_slice);
+            mld_cell_metric.weights = util::vector_view<EdgeWeight>(
+                mld_cell_weights_ptr + metric_index * weight_entries_count, weight_entries_count);
+            mld_cell_metric.durations = util::vector_view<EdgeDuration>(
+                mld_cell_durations_ptr + metric_index * duration_entries_count,
+                duration_entries_count);
+
+            InitializeQuantizedValues(data_layout,
+                                      memory_block,
+                                      storage::DataLayout::MLD_CELL_WEIGHT_BASES,
+                                      storage::DataLayout::MLD_CELL_WEIGHT_CODES,
+                                      storage::DataLayout::MLD_CELL_WEIGHT_OUTLIERS,
+                                      num_metrics,
+                                      mld_cell_metric.quantized_weights);
+            InitializeQuantizedValues(data_layout,
+                                      memory_block,
+                                      storage::DataLayout::MLD_CELL_DURATION_BASES,
+                                      storage::DataLayout::MLD_CELL_DURATION_CODES,
+                                      storage::DataLayout::MLD_CELL_DURATION_OUTLIERS,
+                                      num_metrics,
+                                      mld_cell_metric.quantized_durations);
+        }
+    }
+
+    // quantized values are stored back to back as well, empty unless customized with quantization
+    template <typename T>
+    void InitializeQuantizedValues(storage::DataLayout &data_layout,
+                                   char *memory_block,
+                                   const storage::DataLayout::BlockID bases_block,
+                                   const storage::DataLayout::BlockID codes_block,
+                                   const storage::DataLayout::BlockID outliers_block,
+                                   const std::size_t num_metrics,
+                                   customizer::QuantizedValuesView<T> &values)
+    {
+        const auto bases_count = data_layout.GetBlockEntries(bases_block) / num_metrics;
+        const auto codes_count = data_layout.GetBlockEntries(codes_block) / num_metrics;
+        const auto outliers_count = data_layout.GetBlockEntries(outliers_block) / num_metrics;
+
+        auto bases_ptr = data_layout.GetBlockPtr<T>(memory_block, bases_block);
+        auto codes_ptr =
+            data_layout.GetBlockPtr<customizer::QuantizedCode>(memory_block, codes_block);
+        auto outliers_ptr =
+            data_layout.GetBlockPtr<customizer::QuantizedOutlier<T>>(memory_block, outliers_block);
+
+        values.bases = util::vector_view<T>(bases_ptr + metric_index * bases_count, bases_count);
+        values.codes = util::vector_view<customizer::QuantizedCode>(
+            codes_ptr + metric_index * codes_count, codes_count);
+        values.outliers = util::vector_view<customizer::QuantizedOutlier<T>>(
+            outliers_ptr + metric_index * outliers_count, outliers_count);
     }
     void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
     {
@@ -1062,14 +1209,34 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    // unpacked overlay edges of this dataset and metric, nullptr if disabled
+    const std::unique_ptr<UnpackingCache> unpacking_cache;
+
+    // conditional turn filters of recent minutes of this dataset
+    const std::unique_ptr<ConditionalTurnFilterCache> conditional_turn_filters;
+
   public:
     ContiguousInternalMemoryAlgorithmDataFacade(
-        std::shared_ptr<ContiguousBlockAllocator> allocator_)
-        : allocator(std::move(allocator_))
+        std::shared_ptr<ContiguousBlockAllocator> allocator_,
+        const std::size_t metric_index_,
+        const std::size_t unpacking_cache_size)
+        : metric_index(metric_index_), allocator(std::move(allocator_)),
+          unpacking_cache(unpacking_cache_size > 0
+                              ? std::make_unique<UnpackingCache>(unpacking_cache_size)
+                              : nullptr),
+          conditional_turn_filters(std::make_unique<ConditionalTurnFilterCache>())
     {
         InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
     }
 
+    UnpackingCache *GetUnpackingCache() const { return unpacking_cache.get(); }
+
+    // Turns restricted by the conditional turns at the given time
+    ConditionalTurnFilter GetConditionalTurnFilter(const std::uint32_t time) const
+    {
+        return conditional_turn_filters->Get(mld_partition, mld_conditional_turns, time);
+    }
+
     const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override
     {
         return mld_partition;
@@ -1077,6 +1244,39 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
     const partition::CellStorageView &GetCellStorage() const override { return mld_cell_storage; }
 
+    const customizer::CellMetricView &GetCellMetric() const override { return mld_cell_metric; }
+
+    const customizer::ConditionalTurnsView &GetConditionalTurns() const override
+    {
+        return mld_conditional_turns;
+    }
+
+    EdgeWeight GetEdgeWeight(const EdgeID e, const NodeID from) const override final
+    {
+        const auto &data = query_graph.GetEdgeData(e);
+        const EdgeWeight weight =
+            mld_cell_metric.source == customizer::MetricSource::Duration ? data.duration
+                                                                         : data.weight;
+        return customizer::applySpeedFactor(weight, GetSpeedFactor(from));
+    }
+
+    EdgeDuration GetEdgeDuration(const EdgeID e, const NodeID from) const override final
+    {
+        const EdgeDuration duration = query_graph.GetEdgeData(e).duration;
+        return customizer::applySpeedFactor(duration, GetSpeedFactor(from));
+    }
+
+    std::uint16_t GetSpeedFactor(const NodeID node) const
+    {
+        if (speed_factors.empty())
+            return customizer::SPEED_PROFILE_BASE_FACTOR;
+
+        const auto profile = mld_speed_profiles.GetProfile(node);
+        return profile == customizer::INVALID_SPEED_PROFILE
+                   ? customizer::SPEED_PROFILE_BASE_FACTOR
+                   : speed_factors[profile];
+    }
+
     // search graph access
     unsigned GetNumberOfNodes() const override final { return query_graph.GetNumberOfNodes(); }
 
@@ -1121,12 +1321,32 @@ class ContiguousInternalMemoryDataFacade<MLD> final
       public ContiguousInternalMemoryAlgorithmDataFacade<MLD>
 {
   private:
+    static customizer::MetricSource GetMetricSource(ContiguousBlockAllocator &allocator,
+                                                    const std::size_t metric_index)
+    {
+        auto &layout = allocator.GetLayout();
+        if (metric_index >= layout.GetBlockEntries(storage::DataLayout::MLD_CELL_METRICS))
+            return customizer::MetricSource::Weight;
+
+        return layout.GetBlockPtr<customizer::MetricSource>(
+            allocator.GetMemory(), storage::DataLayout::MLD_CELL_METRICS)[metric_index];
+    }
+
   public:
-    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator)
-        : ContiguousInternalMemoryDataFacadeBase(allocator),
-          ContiguousInternalMemoryAlgorithmDataFacade<MLD>(allocator)
+    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
+                                       const std::size_t metric_index = 0,
+                                       const std::size_t unpacking_cache_size = 0)
+        : ContiguousInternalMemoryDataFacadeBase(allocator,
+                                                 GetMetricSource(*allocator, metric_index)),
+          ContiguousInternalMemoryAlgorithmDataFacade<MLD>(
+              allocator, metric_index, unpacking_cache_size)
+
+    {
+    }
 
+    std::uint16_t GetSpeedFactor(const NodeID id) const override final
     {
+        return ContiguousInternalMemoryAlgorithmDataFacade<MLD>::GetSpeedFactor(id);
     }
 };
 }
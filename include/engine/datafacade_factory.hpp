@@ -0,0 +1,141 @@
+#ifndef OSRM_ENGINE_DATAFACADE_FACTORY_HPP
+#define OSRM_ENGINE_DATAFACADE_FACTORY_HPP
+
+#include "engine/algorithm.hpp"
+#include "engine/api/base_parameters.hpp"
+#include "engine/api/tile_parameters.hpp"
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+
+#include "customizer/cell_metric.hpp"
+#include "storage/shared_datatype.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Creates one facade per metric on top of a single allocation, so all metrics
+// share the graph, geometry and partition data. Requests pick a facade by the
+// name of their metric, requests without one use the first metric. Requests with
+// a departure time use the closest time slice of their metric if it was customized
+// with speed profiles.
+template <typename AlgorithmT> class DataFacadeFactory
+{
+  public:
+    using Facade = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
+
+    // The unpacking cache size in bytes is only used by MLD facades, 0 disables the cache
+    explicit DataFacadeFactory(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator,
+                               const std::size_t unpacking_cache_size = 0)
+        : DataFacadeFactory(allocator,
+                            unpacking_cache_size,
+                            routing_algorithms::HasMultipleMetrics<AlgorithmT>{})
+    {
+        BOOST_ASSERT_MSG(!facades.empty(), "at least one facade needs to be created");
+    }
+
+    // Returns nullptr if the requested metric is not loaded
+    std::shared_ptr<const Facade> Get(const api::BaseParameters &params) const
+    {
+        const auto &metric = params.metric.empty() ? default_metric : params.metric;
+        const auto iter = metric_to_facade.find(metric);
+        if (iter == metric_to_facade.end())
+            return {};
+
+        if (params.departure_time)
+        {
+            const auto slices = metric_to_time_slices.find(metric);
+            if (slices != metric_to_time_slices.end())
+                return facades[GetClosestTimeSlice(slices->second, *params.departure_time)];
+        }
+
+        return facades[iter->second];
+    }
+
+    // Tile requests have no metric parameter and always show the default metric
+    std::shared_ptr<const Facade> Get(const api::TileParameters &) const
+    {
+        return facades.front();
+    }
+
+  private:
+    using TimeSlices = std::vector<std::pair<std::uint16_t, std::size_t>>;
+
+    // Index of the slice that is closest to the minute of the day of the time stamp
+    static std::size_t GetClosestTimeSlice(const TimeSlices &slices, const std::time_t time)
+    {
+        BOOST_ASSERT(!slices.empty());
+        const auto seconds_per_day = customizer::MINUTES_PER_DAY * 60;
+        const auto minute =
+            static_cast<int>(((time % seconds_per_day + seconds_per_day) % seconds_per_day) / 60);
+        const auto distance = [minute](const auto &slice) {
+            const auto difference = std::abs(static_cast<int>(slice.first) - minute);
+            return std::min<int>(difference, customizer::MINUTES_PER_DAY - difference);
+        };
+        return std::min_element(slices.begin(),
+                                slices.end(),
+                                [&](const auto &lhs, const auto &rhs) {
+                                    return distance(lhs) < distance(rhs);
+                                })
+            ->second;
+    }
+
+    DataFacadeFactory(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator,
+                      const std::size_t unpacking_cache_size,
+                      std::true_type)
+    {
+        default_metric = customizer::toString(customizer::MetricSource::Weight);
+        const auto num_metrics =
+            allocator->GetLayout().GetBlockEntries(storage::DataLayout::MLD_CELL_METRICS);
+        if (num_metrics == 0)
+        {
+            facades.push_back(std::make_shared<const Facade>(allocator, 0, unpacking_cache_size));
+            metric_to_facade[customizer::toString(customizer::MetricSource::Weight)] = 0;
+            return;
+        }
+
+        for (std::size_t index = 0; index < num_metrics; ++index)
+        {
+            facades.push_back(
+                std::make_shared<const Facade>(allocator, index, unpacking_cache_size));
+            const auto &metric = facades.back()->GetCellMetric();
+            const std::string name = customizer::toString(metric.source);
+            if (index == 0)
+                default_metric = name;
+            if (metric.IsTimeSlice())
+                metric_to_time_slices[name].emplace_back(metric.time_slice, index);
+            else
+                metric_to_facade.emplace(name, index);
+        }
+    }
+
+    DataFacadeFactory(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator,
+                      const std::size_t,
+                      std::false_type)
+    {
+        default_metric = customizer::toString(customizer::MetricSource::Weight);
+        facades.push_back(std::make_shared<const Facade>(allocator));
+        metric_to_facade[customizer::toString(customizer::MetricSource::Weight)] = 0;
+    }
+
+    std::vector<std::shared_ptr<const Facade>> facades;
+    std::unordered_map<std::string, std::size_t> metric_to_facade;
+    std::unordered_map<std::string, TimeSlices> metric_to_time_slices;
+    std::string default_metric;
+};
+}
+}
+
+#endif
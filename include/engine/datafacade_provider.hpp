@@ -4,6 +4,7 @@
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
+#include "engine/datafacade_factory.hpp"
 
 namespace osrm
 {
@@ -17,7 +18,12 @@ template <typename AlgorithmT> class DataFacadeProvider
   public:
     virtual ~DataFacadeProvider() = default;
 
-    virtual std::shared_ptr<const FacadeT> Get() const = 0;
+    virtual std::shared_ptr<const FacadeT> Get(const api::BaseParameters &params) const = 0;
+    virtual std::shared_ptr<const FacadeT> Get(const api::TileParameters &params) const = 0;
+
+    // Changes whenever a new dataset is loaded. Must be read before Get() so data of a
+    // new dataset is never attributed to the timestamp of an old one.
+    virtual unsigned GetTimestamp() const = 0;
 };
 
 template <typename AlgorithmT> class ImmutableProvider final : public DataFacadeProvider<AlgorithmT>
@@ -25,16 +31,24 @@ template <typename AlgorithmT> class ImmutableProvider final : public DataFacade
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    ImmutableProvider(const storage::StorageConfig &config)
-        : immutable_data_facade(std::make_shared<FacadeT>(
-              std::make_shared<datafacade::ProcessMemoryAllocator>(config)))
+    ImmutableProvider(const storage::StorageConfig &config, const std::size_t unpacking_cache_size)
+        : facade_factory(std::make_shared<datafacade::ProcessMemoryAllocator>(config),
+                         unpacking_cache_size)
     {
     }
 
-    std::shared_ptr<const FacadeT> Get() const override final { return immutable_data_facade; }
+    std::shared_ptr<const FacadeT> Get(const api::BaseParameters &params) const override final
+    {
+        return facade_factory.Get(params);
+    }
+    std::shared_ptr<const FacadeT> Get(const api::TileParameters &params) const override final
+    {
+        return facade_factory.Get(params);
+    }
+    unsigned GetTimestamp() const override final { return 0; }
 
   private:
-    std::shared_ptr<const FacadeT> immutable_data_facade;
+    DataFacadeFactory<AlgorithmT> facade_factory;
 };
 
 template <typename AlgorithmT> class WatchingProvider final : public DataFacadeProvider<AlgorithmT>
@@ -43,12 +57,22 @@ template <typename AlgorithmT> class WatchingProvider final : public DataFacadeP
     DataWatchdog<AlgorithmT> watchdog;
 
   public:
-    std::shared_ptr<const FacadeT> Get() const override final
+    explicit WatchingProvider(const std::size_t unpacking_cache_size)
+        : watchdog(unpacking_cache_size)
+    {
+    }
+
+    // We need a singleton here because multiple instances of DataWatchdog
+    // conflict on shared memory mappings
+    std::shared_ptr<const FacadeT> Get(const api::BaseParameters &params) const override final
+    {
+        return watchdog.Get(params);
+    }
+    std::shared_ptr<const FacadeT> Get(const api::TileParameters &params) const override final
     {
-        // We need a singleton here because multiple instances of DataWatchdog
-        // conflict on shared memory mappings
-        return watchdog.Get();
+        return watchdog.Get(params);
     }
+    unsigned GetTimestamp() const override final { return watchdog.GetTimestamp(); }
 };
 }
 }
@@ -1,6 +1,7 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "engine/api/base_result.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -19,13 +20,24 @@
 #include "engine/plugins/viaroute.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
+#include "engine/tile_cache.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/json_container.hpp"
+#include "util/timing_util.hpp"
+#include "util/web_mercator.hpp"
 
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace osrm
 {
@@ -36,10 +48,8 @@ class EngineInterface
 {
   public:
     virtual ~EngineInterface() = default;
-    virtual Status Route(const api::RouteParameters &parameters,
-                         util::json::Object &result) const = 0;
-    virtual Status Table(const api::TableParameters &parameters,
-                         util::json::Object &result) const = 0;
+    virtual Status Route(const api::RouteParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Nearest(const api::NearestParameters &parameters,
                            util::json::Object &result) const = 0;
     virtual Status Trip(const api::TripParameters &parameters,
@@ -61,17 +71,36 @@ template <typename Algorithm> class Engine final : public EngineInterface
           tile_plugin()                                                         //
 
     {
+        heaps.request_parallelism = config.request_parallelism;
+        heaps.heap_trim_interval = config.heap_trim_interval;
+        heaps.heap_pool_size = config.heap_pool_size;
+
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider =
+                std::make_unique<WatchingProvider<Algorithm>>(config.unpacking_cache_size);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, config.unpacking_cache_size);
+        }
+
+        if (config.tile_cache_size > 0)
+        {
+            tile_cache = std::make_unique<TileCache>(config.tile_cache_size);
+        }
+
+        if (config.tile_prerender_area)
+        {
+            BOOST_ASSERT(tile_cache);
+            prerender_active = true;
+            tile_prerenderer =
+                std::thread(&Engine::PrerenderTiles, this, *config.tile_prerender_area);
         }
     }
 
@@ -80,57 +109,173 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Engine(const Engine &) = delete;
     Engine &operator=(const Engine &) = delete;
-    virtual ~Engine() = default;
+    virtual ~Engine()
+    {
+        if (tile_prerenderer.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(prerender_mutex);
+                prerender_active = false;
+            }
+            prerender_condition.notify_all();
+            tile_prerenderer.join();
+        }
+    }
 
-    Status Route(const api::RouteParameters &params,
-                 util::json::Object &result) const override final
+    Status Route(const api::RouteParameters &params, api::ResultT &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto facade = facade_provider->Get(params);
+        if (!facade)
+            return UnknownMetric(params, result);
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, params.departure_time};
         return route_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
-    Status Table(const api::TableParameters &params,
-                 util::json::Object &result) const override final
+    Status Table(const api::TableParameters &params, api::ResultT &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto facade = facade_provider->Get(params);
+        if (!facade)
+            return UnknownMetric(params, result);
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, params.departure_time};
         return table_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     Status Nearest(const api::NearestParameters &params,
                    util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
+        auto facade = facade_provider->Get(params);
+        if (!facade)
+            return UnknownMetric(params, result);
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return nearest_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     Status Trip(const api::TripParameters &params, util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto facade = facade_provider->Get(params);
+        if (!facade)
+            return UnknownMetric(params, result);
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, params.departure_time};
         return trip_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     Status Match(const api::MatchParameters &params,
                  util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto facade = facade_provider->Get(params);
+        if (!facade)
+            return UnknownMetric(params, result);
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, params.departure_time};
         return match_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     Status Tile(const api::TileParameters &params, std::string &result) const override final
     {
-        auto facade = facade_provider->Get();
+        // the timestamp needs to be read before the facade, see DataFacadeProvider
+        const TileKey key{params.x, params.y, params.z, facade_provider->GetTimestamp()};
+        if (tile_cache && tile_cache->Get(key, result))
+            return Status::Ok;
+
+        auto facade = facade_provider->Get(params);
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return tile_plugin.HandleRequest(*facade, algorithms, params, result);
+        const auto status = tile_plugin.HandleRequest(*facade, algorithms, params, result);
+        if (tile_cache && status == Status::Ok)
+            tile_cache->Put(key, result);
+        return status;
     }
 
     static bool CheckCompability(const EngineConfig &config);
 
   private:
+    // Renders the tiles of the area into the cache once at start-up and again whenever
+    // a new dataset is loaded
+    void PrerenderTiles(const EngineConfig::TilePrerenderArea area) const
+    {
+        boost::optional<unsigned> rendered_timestamp;
+        std::unique_lock<std::mutex> lock(prerender_mutex);
+        while (prerender_active)
+        {
+            const auto timestamp = facade_provider->GetTimestamp();
+            if (timestamp != rendered_timestamp)
+            {
+                lock.unlock();
+                TIMER_START(prerender);
+                const auto num_tiles = RenderTiles(area, timestamp);
+                TIMER_STOP(prerender);
+                lock.lock();
+
+                // rendering is aborted if the engine shuts down or the dataset changes
+                if (num_tiles)
+                {
+                    util::Log() << "Pre-rendered " << *num_tiles << " tiles for dataset "
+                                << timestamp << " in " << TIMER_SEC(prerender) << "s";
+                    rendered_timestamp = timestamp;
+                }
+                continue;
+            }
+
+            // there is no notification for data swaps, so poll for a new timestamp
+            prerender_condition.wait_for(lock, std::chrono::seconds(1));
+        }
+    }
+
+    boost::optional<std::size_t> RenderTiles(const EngineConfig::TilePrerenderArea &area,
+                                             const unsigned timestamp) const
+    {
+        std::size_t num_tiles = 0;
+        for (auto z = area.min_zoom; z <= area.max_zoom; ++z)
+        {
+            const auto max_pixel = (1u << z) * util::web_mercator::TILE_SIZE - 1;
+            const auto to_tile = [max_pixel](const double pixel) {
+                const auto clamped = std::min<double>(std::max(pixel, 0.), max_pixel);
+                return static_cast<unsigned>(clamped / util::web_mercator::TILE_SIZE);
+            };
+
+            // tile rows are counted from the north
+            const auto min_x =
+                to_tile(util::web_mercator::degreeToPixel(util::toFloating(area.southwest.lon), z));
+            const auto max_x =
+                to_tile(util::web_mercator::degreeToPixel(util::toFloating(area.northeast.lon), z));
+            const auto min_y =
+                to_tile(util::web_mercator::degreeToPixel(util::toFloating(area.northeast.lat), z));
+            const auto max_y =
+                to_tile(util::web_mercator::degreeToPixel(util::toFloating(area.southwest.lat), z));
+
+            for (auto x = min_x; x <= max_x; ++x)
+            {
+                for (auto y = min_y; y <= max_y; ++y)
+                {
+                    if (!prerender_active || facade_provider->GetTimestamp() != timestamp)
+                        return boost::none;
+
+                    const api::TileParameters params{x, y, z};
+                    if (!params.IsValid() || tile_cache->Contains({x, y, z, timestamp}))
+                        continue;
+
+                    std::string pbf_buffer;
+                    Tile(params, pbf_buffer);
+                    ++num_tiles;
+                }
+            }
+        }
+
+        return num_tiles;
+    }
+
+    Status UnknownMetric(const api::BaseParameters &params, util::json::Object &result) const
+    {
+        result.values["code"] = "InvalidOptions";
+        result.values["message"] = "Metric " + params.metric + " is not loaded";
+        return Status::Error;
+    }
+
+    Status UnknownMetric(const api::BaseParameters &params, api::ResultT &result) const
+    {
+        // errors are always reported as JSON
+        result = util::json::Object();
+        return UnknownMetric(params, result.get<util::json::Object>());
+    }
+
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
 
@@ -140,6 +285,12 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+
+    std::unique_ptr<TileCache> tile_cache;
+    std::thread tile_prerenderer;
+    std::atomic<bool> prerender_active{false};
+    mutable std::mutex prerender_mutex;
+    mutable std::condition_variable prerender_condition;
 };
 
 template <>
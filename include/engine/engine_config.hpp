@@ -29,8 +29,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ENGINE_CONFIG_HPP
 
 #include "storage/storage_config.hpp"
+#include "util/coordinate.hpp"
 
 #include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
 
 #include <string>
 
@@ -90,6 +92,32 @@ struct EngineConfig final
     int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
     bool use_shared_memory = true;
     Algorithm algorithm = Algorithm::CH;
+
+    // Tiles of this area and zoom range are rendered into the tile cache in the
+    // background whenever a new dataset is loaded
+    struct TilePrerenderArea
+    {
+        util::Coordinate southwest;
+        util::Coordinate northeast;
+        unsigned min_zoom;
+        unsigned max_zoom;
+    };
+
+    // Maximal size of the cache for rendered vector tiles in bytes, 0 disables the cache
+    std::size_t tile_cache_size = 0;
+    // Maximal size of the cache for unpacked MLD overlay edges per metric in bytes,
+    // 0 disables the cache
+    std::size_t unpacking_cache_size = 0;
+    // Maximal number of threads a single /route or /match request uses to search its legs
+    // and sub-matchings in parallel, 1 searches them one after another
+    unsigned request_parallelism = 1;
+    // Search heaps only grow, every heap_trim_interval queries a heap is shrunk to the largest
+    // query it saw since the last shrink, 0 never shrinks them
+    unsigned heap_trim_interval = 0;
+    // Maximal number of idle search heaps per heap type kept in a pool shared by all threads,
+    // 0 keeps the heaps of each thread for the lifetime of the thread instead
+    unsigned heap_pool_size = 0;
+    boost::optional<TilePrerenderArea> tile_prerender_area;
 };
 }
 }
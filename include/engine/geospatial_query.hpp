@@ -1,6 +1,8 @@
 #ifndef GEOSPATIAL_QUERY_HPP
 #define GEOSPATIAL_QUERY_HPP
 
+#include "customizer/speed_profiles.hpp"
+
 #include "engine/approach.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
@@ -13,6 +15,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -435,35 +438,29 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         const auto geometry_id = datafacade.GetGeometryIndex(data.forward_segment_id.id).id;
         const auto component_id = datafacade.GetComponentID(data.forward_segment_id.id);
 
-        const std::vector<EdgeWeight> forward_weight_vector =
-            datafacade.GetUncompressedForwardWeights(geometry_id);
-        const std::vector<EdgeWeight> reverse_weight_vector =
-            datafacade.GetUncompressedReverseWeights(geometry_id);
-        const std::vector<EdgeWeight> forward_duration_vector =
-            datafacade.GetUncompressedForwardDurations(geometry_id);
-        const std::vector<EdgeWeight> reverse_duration_vector =
-            datafacade.GetUncompressedReverseDurations(geometry_id);
+        const auto forward_weight_range = datafacade.GetUncompressedForwardWeights(geometry_id);
+        const auto reverse_weight_range = datafacade.GetUncompressedReverseWeights(geometry_id);
+        const auto forward_duration_range = datafacade.GetUncompressedForwardDurations(geometry_id);
+        const auto reverse_duration_range = datafacade.GetUncompressedReverseDurations(geometry_id);
+        const std::size_t num_segments = forward_weight_range.size();
 
         for (std::size_t i = 0; i < data.fwd_segment_position; i++)
         {
-            forward_weight_offset += forward_weight_vector[i];
-            forward_duration_offset += forward_duration_vector[i];
+            forward_weight_offset += forward_weight_range[i];
+            forward_duration_offset += forward_duration_range[i];
         }
-        forward_weight = forward_weight_vector[data.fwd_segment_position];
-        forward_duration = forward_duration_vector[data.fwd_segment_position];
+        forward_weight = forward_weight_range[data.fwd_segment_position];
+        forward_duration = forward_duration_range[data.fwd_segment_position];
 
-        BOOST_ASSERT(data.fwd_segment_position < reverse_weight_vector.size());
+        BOOST_ASSERT(data.fwd_segment_position < num_segments);
 
-        for (std::size_t i = 0; i < reverse_weight_vector.size() - data.fwd_segment_position - 1;
-             i++)
+        for (std::size_t i = 0; i < num_segments - data.fwd_segment_position - 1; i++)
         {
-            reverse_weight_offset += reverse_weight_vector[i];
-            reverse_duration_offset += reverse_duration_vector[i];
+            reverse_weight_offset += reverse_weight_range[i];
+            reverse_duration_offset += reverse_duration_range[i];
         }
-        reverse_weight =
-            reverse_weight_vector[reverse_weight_vector.size() - data.fwd_segment_position - 1];
-        reverse_duration =
-            reverse_duration_vector[reverse_duration_vector.size() - data.fwd_segment_position - 1];
+        reverse_weight = reverse_weight_range[num_segments - data.fwd_segment_position - 1];
+        reverse_duration = reverse_duration_range[num_segments - data.fwd_segment_position - 1];
 
         ratio = std::min(1.0, std::max(0.0, ratio));
         if (data.forward_segment_id.id != SPECIAL_SEGMENTID)
@@ -477,19 +474,38 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             reverse_duration -= static_cast<EdgeDuration>(reverse_duration * ratio);
         }
 
+        // Scale the phantom parts like the routing graph scales the whole node, so that the
+        // phantom weights and durations fit the edge weights of the facade's time slice
+        const auto scale = [](const std::uint16_t factor, auto &offset, auto &value) {
+            value = customizer::applySpeedFactor(offset, value, factor);
+            offset = customizer::applySpeedFactor(0, offset, factor);
+        };
+        if (data.forward_segment_id.id != SPECIAL_SEGMENTID)
+        {
+            const auto factor = datafacade.GetSpeedFactor(data.forward_segment_id.id);
+            scale(factor, forward_weight_offset, forward_weight);
+            scale(factor, forward_duration_offset, forward_duration);
+        }
+        if (data.reverse_segment_id.id != SPECIAL_SEGMENTID)
+        {
+            const auto factor = datafacade.GetSpeedFactor(data.reverse_segment_id.id);
+            scale(factor, reverse_weight_offset, reverse_weight);
+            scale(factor, reverse_duration_offset, reverse_duration);
+        }
+
         // check phantom node segments validity
         auto areSegmentsValid = [](auto first, auto last) -> bool {
             return std::find(first, last, INVALID_SEGMENT_WEIGHT) == last;
         };
         bool is_forward_valid_source =
-            areSegmentsValid(forward_weight_vector.begin(), forward_weight_vector.end());
+            areSegmentsValid(forward_weight_range.begin(), forward_weight_range.end());
         bool is_forward_valid_target =
-            areSegmentsValid(forward_weight_vector.begin(),
-                             forward_weight_vector.begin() + data.fwd_segment_position + 1);
+            areSegmentsValid(forward_weight_range.begin(),
+                             forward_weight_range.begin() + data.fwd_segment_position + 1);
         bool is_reverse_valid_source =
-            areSegmentsValid(reverse_weight_vector.begin(), reverse_weight_vector.end());
+            areSegmentsValid(reverse_weight_range.begin(), reverse_weight_range.end());
         bool is_reverse_valid_target = areSegmentsValid(
-            reverse_weight_vector.begin(), reverse_weight_vector.end() - data.fwd_segment_position);
+            reverse_weight_range.begin(), reverse_weight_range.end() - data.fwd_segment_position);
 
         auto transformed = PhantomNodeWithDistance{PhantomNode{data,
                                                                component_id,
@@ -572,17 +588,15 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         BOOST_ASSERT(data.forward_segment_id.id != SPECIAL_NODEID);
         const auto geometry_id = datafacade.GetGeometryIndex(data.forward_segment_id.id).id;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
-            datafacade.GetUncompressedForwardWeights(geometry_id);
+        const auto forward_weight_range = datafacade.GetUncompressedForwardWeights(geometry_id);
 
-        if (forward_weight_vector[data.fwd_segment_position] != INVALID_SEGMENT_WEIGHT)
+        if (forward_weight_range[data.fwd_segment_position] != INVALID_SEGMENT_WEIGHT)
         {
             forward_edge_valid = data.forward_segment_id.enabled;
         }
 
-        const std::vector<EdgeWeight> reverse_weight_vector =
-            datafacade.GetUncompressedReverseWeights(geometry_id);
-        if (reverse_weight_vector[reverse_weight_vector.size() - data.fwd_segment_position - 1] !=
+        const auto reverse_weight_range = datafacade.GetUncompressedReverseWeights(geometry_id);
+        if (reverse_weight_range[reverse_weight_range.size() - data.fwd_segment_position - 1] !=
             INVALID_SEGMENT_WEIGHT)
         {
             reverse_edge_valid = data.reverse_segment_id.enabled;
@@ -31,12 +31,15 @@ namespace guidance
 //             |---| segment 1
 //                 |---| segment 2
 //                     |---| segment 3
-inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
-                                    const std::vector<PathData> &leg_data,
-                                    const PhantomNode &source_node,
-                                    const PhantomNode &target_node,
-                                    const bool reversed_source,
-                                    const bool reversed_target)
+//
+// Templated on the facade so calls from the engine resolve against the concrete facade
+template <typename DataFacadeT>
+LegGeometry assembleGeometry(const DataFacadeT &facade,
+                             const std::vector<PathData> &leg_data,
+                             const PhantomNode &source_node,
+                             const PhantomNode &target_node,
+                             const bool reversed_source,
+                             const bool reversed_target)
 {
     LegGeometry geometry;
 
@@ -54,8 +57,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     const auto source_node_id =
         reversed_source ? source_node.reverse_segment_id.id : source_node.forward_segment_id.id;
     const auto source_gemetry_id = facade.GetGeometryIndex(source_node_id).id;
-    const std::vector<NodeID> source_geometry =
-        facade.GetUncompressedForwardGeometry(source_gemetry_id);
+    const auto source_geometry = facade.GetUncompressedForwardGeometry(source_gemetry_id);
     geometry.osm_node_ids.push_back(
         facade.GetOSMNodeIDOfNode(source_geometry[source_segment_start_coordinate]));
 
@@ -95,8 +97,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     const auto target_node_id =
         reversed_target ? target_node.reverse_segment_id.id : target_node.forward_segment_id.id;
     const auto target_gemetry_id = facade.GetGeometryIndex(target_node_id).id;
-    const std::vector<DatasourceID> forward_datasources =
-        facade.GetUncompressedForwardDatasources(target_gemetry_id);
+    const auto forward_datasources = facade.GetUncompressedForwardDatasources(target_gemetry_id);
 
     // FIXME if source and target phantoms are on the same segment then duration and weight
     // will be from one projected point till end of segment
@@ -118,8 +119,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     // target node rev:       1       1 <- 2 <- 3
     const auto target_segment_end_coordinate =
         target_node.fwd_segment_position + (reversed_target ? 0 : 1);
-    const std::vector<NodeID> target_geometry =
-        facade.GetUncompressedForwardGeometry(target_gemetry_id);
+    const auto target_geometry = facade.GetUncompressedForwardGeometry(target_gemetry_id);
     geometry.osm_node_ids.push_back(
         facade.GetOSMNodeIDOfNode(target_geometry[target_segment_end_coordinate]));
 
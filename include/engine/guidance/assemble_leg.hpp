@@ -38,9 +38,8 @@ struct NamedSegment
     std::uint32_t name_id;
 };
 
-template <std::size_t SegmentNumber>
-
-std::array<std::uint32_t, SegmentNumber> summarizeRoute(const datafacade::BaseDataFacade &facade,
+template <std::size_t SegmentNumber, typename DataFacadeT>
+std::array<std::uint32_t, SegmentNumber> summarizeRoute(const DataFacadeT &facade,
                                                         const std::vector<PathData> &route_data,
                                                         const PhantomNode &target_node,
                                                         const bool target_traversed_in_reverse)
@@ -124,13 +123,14 @@ std::array<std::uint32_t, SegmentNumber> summarizeRoute(const datafacade::BaseDa
 }
 }
 
-inline RouteLeg assembleLeg(const datafacade::BaseDataFacade &facade,
-                            const std::vector<PathData> &route_data,
-                            const LegGeometry &leg_geometry,
-                            const PhantomNode &source_node,
-                            const PhantomNode &target_node,
-                            const bool target_traversed_in_reverse,
-                            const bool needs_summary)
+template <typename DataFacadeT>
+RouteLeg assembleLeg(const DataFacadeT &facade,
+                     const std::vector<PathData> &route_data,
+                     const LegGeometry &leg_geometry,
+                     const PhantomNode &source_node,
+                     const PhantomNode &target_node,
+                     const bool target_traversed_in_reverse,
+                     const bool needs_summary)
 {
     const auto target_duration =
         (target_traversed_in_reverse ? target_node.reverse_duration : target_node.forward_duration);
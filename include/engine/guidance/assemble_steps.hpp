@@ -33,13 +33,14 @@ std::pair<short, short> getDepartBearings(const LegGeometry &leg_geometry);
 std::pair<short, short> getArriveBearings(const LegGeometry &leg_geometry);
 } // ns detail
 
-inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &facade,
-                                            const std::vector<PathData> &leg_data,
-                                            const LegGeometry &leg_geometry,
-                                            const PhantomNode &source_node,
-                                            const PhantomNode &target_node,
-                                            const bool source_traversed_in_reverse,
-                                            const bool target_traversed_in_reverse)
+template <typename DataFacadeT>
+std::vector<RouteStep> assembleSteps(const DataFacadeT &facade,
+                                     const std::vector<PathData> &leg_data,
+                                     const LegGeometry &leg_geometry,
+                                     const PhantomNode &source_node,
+                                     const PhantomNode &target_node,
+                                     const bool source_traversed_in_reverse,
+                                     const bool target_traversed_in_reverse)
 {
     const double weight_multiplier = facade.GetWeightMultiplier();
 
@@ -3,6 +3,7 @@
 
 #include "engine/plugins/plugin_base.hpp"
 
+#include "engine/api/base_result.hpp"
 #include "engine/api/table_parameters.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
@@ -24,7 +25,7 @@ class TablePlugin final : public BasePlugin
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
                          const api::TableParameters &params,
-                         util::json::Object &result) const;
+                         api::ResultT &result) const;
 
   private:
     const int max_locations_distance_table;
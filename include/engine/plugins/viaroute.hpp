@@ -3,6 +3,7 @@
 
 #include "engine/plugins/plugin_base.hpp"
 
+#include "engine/api/base_result.hpp"
 #include "engine/api/route_api.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/routing_algorithms.hpp"
@@ -35,7 +36,7 @@ class ViaRoutePlugin final : public BasePlugin
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
                          const api::RouteParameters &route_parameters,
-                         util::json::Object &json_result) const;
+                         api::ResultT &result) const;
 };
 }
 }
@@ -5,6 +5,9 @@
 
 #include <algorithm>
 #include <boost/assert.hpp>
+#include <climits>
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -14,44 +17,133 @@ namespace engine
 {
 namespace detail
 {
-std::string encode(std::vector<int> &numbers);
-std::int32_t decode_polyline_integer(std::string::const_iterator &first,
-                                     std::string::const_iterator last);
+// varint coding parameters, every character holds 5 bits and the continuation bit
+const constexpr std::uint32_t POLYLINE_BITS_IN_CHUNK = 5;
+const constexpr std::uint32_t POLYLINE_CONTINUATION_BIT = 1 << POLYLINE_BITS_IN_CHUNK;
+const constexpr std::uint32_t POLYLINE_CHUNK_MASK = POLYLINE_CONTINUATION_BIT - 1;
+// characters are shifted into the printable ASCII range [?..~]
+const constexpr char POLYLINE_CHARACTER_OFFSET = 63;
+
+// "zig-zag" sign coding moves the sign to the lowest bit
+inline std::uint32_t zigzagEncode(const std::int32_t number)
+{
+    const auto shifted = static_cast<std::uint32_t>(number) << 1u;
+    return number < 0 ? ~shifted : shifted;
+}
+
+inline std::size_t encodedLength(std::uint32_t number)
+{
+    std::size_t length = 1;
+    while (number >= POLYLINE_CONTINUATION_BIT)
+    {
+        number >>= POLYLINE_BITS_IN_CHUNK;
+        ++length;
+    }
+    return length;
+}
+
+inline char *encode(std::uint32_t number, char *output)
+{
+    while (number >= POLYLINE_CONTINUATION_BIT)
+    {
+        *output++ = static_cast<char>((POLYLINE_CONTINUATION_BIT | (number & POLYLINE_CHUNK_MASK)) +
+                                      POLYLINE_CHARACTER_OFFSET);
+        number >>= POLYLINE_BITS_IN_CHUNK;
+    }
+    *output++ = static_cast<char>(number + POLYLINE_CHARACTER_OFFSET);
+    return output;
+}
+
+// Decodes an integer of at most 7 characters (35 bits), which never reads past the end if
+// at least 7 characters are left
+inline std::int32_t decodePolylineIntegerUnchecked(const char *&first)
+{
+    std::uint32_t result = 0;
+    std::uint32_t shift = 0;
+    std::uint32_t value;
+    do
+    {
+        value = *first++ - POLYLINE_CHARACTER_OFFSET;
+        result |= (value & POLYLINE_CHUNK_MASK) << shift;
+        shift += POLYLINE_BITS_IN_CHUNK;
+    } while ((value & POLYLINE_CONTINUATION_BIT) && shift < CHAR_BIT * sizeof(result) - 1);
+
+    return static_cast<std::int32_t>(((result & 1) == 1) ? ~(result >> 1) : (result >> 1));
+}
+
+// https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+inline std::int32_t decodePolylineInteger(const char *&first, const char *const last)
+{
+    std::uint32_t result = 0;
+    for (std::uint32_t value = POLYLINE_CONTINUATION_BIT, shift = 0;
+         (value & POLYLINE_CONTINUATION_BIT) && (shift < CHAR_BIT * sizeof(result) - 1) &&
+         first != last;
+         ++first, shift += POLYLINE_BITS_IN_CHUNK)
+    {
+        // convert ASCII coding [?..~] to an integer [0..63]
+        value = *first - POLYLINE_CHARACTER_OFFSET;
+        result |= (value & POLYLINE_CHUNK_MASK) << shift;
+    }
+
+    // change "zig-zag" sign coding to two's complement
+    result = ((result & 1) == 1) ? ~(result >> 1) : (result >> 1);
+    return static_cast<std::int32_t>(result);
+}
 }
 using CoordVectorForwardIter = std::vector<util::Coordinate>::const_iterator;
-// Encodes geometry into polyline format.
+// Encodes geometry into polyline format and appends it to output. The length of the encoded
+// geometry is computed first, so the output is only resized once.
 // See: https://developers.google.com/maps/documentation/utilities/polylinealgorithm
 
 template <unsigned POLYLINE_PRECISION = 100000>
-std::string encodePolyline(CoordVectorForwardIter begin, CoordVectorForwardIter end)
+void encodePolyline(CoordVectorForwardIter begin, CoordVectorForwardIter end, std::string &output)
 {
-    double coordinate_to_polyline = POLYLINE_PRECISION / COORDINATE_PRECISION;
-    auto size = std::distance(begin, end);
-    if (size == 0)
+    const double coordinate_to_polyline = POLYLINE_PRECISION / COORDINATE_PRECISION;
+    const auto to_polyline_lat = [coordinate_to_polyline](const util::Coordinate loc) {
+        return static_cast<std::int32_t>(
+            std::round(static_cast<int>(loc.lat) * coordinate_to_polyline));
+    };
+    const auto to_polyline_lon = [coordinate_to_polyline](const util::Coordinate loc) {
+        return static_cast<std::int32_t>(
+            std::round(static_cast<int>(loc.lon) * coordinate_to_polyline));
+    };
+
+    std::size_t length = 0;
+    std::int32_t current_lat = 0;
+    std::int32_t current_lon = 0;
+    for (auto iter = begin; iter != end; ++iter)
     {
-        return {};
+        const auto lat = to_polyline_lat(*iter);
+        const auto lon = to_polyline_lon(*iter);
+        length += detail::encodedLength(detail::zigzagEncode(lat - current_lat)) +
+                  detail::encodedLength(detail::zigzagEncode(lon - current_lon));
+        current_lat = lat;
+        current_lon = lon;
     }
 
-    std::vector<int> delta_numbers;
-    BOOST_ASSERT(size > 0);
-    delta_numbers.reserve((size - 1) * 2);
-    int current_lat = 0;
-    int current_lon = 0;
-    std::for_each(
-        begin,
-        end,
-        [&delta_numbers, &current_lat, &current_lon, coordinate_to_polyline](
-            const util::Coordinate loc) {
-            const int lat_diff =
-                std::round(static_cast<int>(loc.lat) * coordinate_to_polyline) - current_lat;
-            const int lon_diff =
-                std::round(static_cast<int>(loc.lon) * coordinate_to_polyline) - current_lon;
-            delta_numbers.emplace_back(lat_diff);
-            delta_numbers.emplace_back(lon_diff);
-            current_lat += lat_diff;
-            current_lon += lon_diff;
-        });
-    return detail::encode(delta_numbers);
+    const auto offset = output.size();
+    output.resize(offset + length);
+    char *out = &output[0] + offset;
+    current_lat = 0;
+    current_lon = 0;
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        const auto lat = to_polyline_lat(*iter);
+        const auto lon = to_polyline_lon(*iter);
+        out = detail::encode(detail::zigzagEncode(lat - current_lat), out);
+        out = detail::encode(detail::zigzagEncode(lon - current_lon), out);
+        current_lat = lat;
+        current_lon = lon;
+    }
+    BOOST_ASSERT(out == &output[0] + output.size());
+}
+
+template <unsigned POLYLINE_PRECISION = 100000>
+std::string encodePolyline(CoordVectorForwardIter begin, CoordVectorForwardIter end)
+{
+    std::string output;
+    encodePolyline<POLYLINE_PRECISION>(begin, end, output);
+    return output;
 }
 
 // Decodes geometry from polyline format
@@ -61,15 +153,36 @@ template <unsigned POLYLINE_PRECISION = 100000>
 std::vector<util::Coordinate> decodePolyline(const std::string &polyline)
 {
     double polyline_to_coordinate = COORDINATE_PRECISION / POLYLINE_PRECISION;
-    std::vector<util::Coordinate> coordinates;
     std::int32_t latitude = 0, longitude = 0;
 
-    std::string::const_iterator first = polyline.begin();
-    const std::string::const_iterator last = polyline.end();
+    const char *first = polyline.data();
+    const char *const last = first + polyline.size();
+
+    // Every integer ends with a character without continuation bit, two integers form a
+    // coordinate. Counting them is a branch-free pass that saves the reallocations.
+    const std::size_t number_of_integers = std::count_if(first, last, [](const char character) {
+        return character < detail::POLYLINE_CHARACTER_OFFSET +
+                               static_cast<char>(detail::POLYLINE_CONTINUATION_BIT);
+    });
+    std::vector<util::Coordinate> coordinates;
+    coordinates.reserve((number_of_integers + 1) / 2);
+
+    // two integers with the maximal length of 7 characters can be decoded without bound checks
+    const auto MAX_COORDINATE_LENGTH = 14;
+    while (last - first >= MAX_COORDINATE_LENGTH)
+    {
+        latitude += detail::decodePolylineIntegerUnchecked(first);
+        longitude += detail::decodePolylineIntegerUnchecked(first);
+
+        coordinates.emplace_back(util::Coordinate{
+            util::FixedLongitude{static_cast<std::int32_t>(longitude * polyline_to_coordinate)},
+            util::FixedLatitude{static_cast<std::int32_t>(latitude * polyline_to_coordinate)}});
+    }
+
     while (first != last)
     {
-        const auto dlat = detail::decode_polyline_integer(first, last);
-        const auto dlon = detail::decode_polyline_integer(first, last);
+        const auto dlat = detail::decodePolylineInteger(first, last);
+        const auto dlon = detail::decodePolylineInteger(first, last);
 
         latitude += dlat;
         longitude += dlon;
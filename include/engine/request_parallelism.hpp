@@ -0,0 +1,44 @@
+#ifndef OSRM_ENGINE_REQUEST_PARALLELISM_HPP
+#define OSRM_ENGINE_REQUEST_PARALLELISM_HPP
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <cstddef>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Calls body(begin, end) for chunks of [0, size) on at most `parallelism` threads.
+//
+// The work runs in a task arena limited to `parallelism` threads. Nested calls, e.g. for
+// the legs of the sub-matchings of a match request, run in the arena of the outer call,
+// so a request never uses more threads in total. Everything that is not shared between
+// the chunks, like search heaps, has to be created per chunk.
+template <typename Body>
+void parallelForRequest(const unsigned parallelism, const std::size_t size, const Body &body)
+{
+    const auto run = [&] {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, size),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              body(range.begin(), range.end());
+                          });
+    };
+
+    if (tbb::this_task_arena::max_concurrency() <= static_cast<int>(parallelism))
+    {
+        run();
+    }
+    else
+    {
+        tbb::task_arena arena(static_cast<int>(parallelism));
+        arena.execute(run);
+    }
+}
+}
+}
+
+#endif
@@ -11,11 +11,46 @@
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/tile_turns.hpp"
 
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+
 namespace osrm
 {
 namespace engine
 {
 
+namespace routing_algorithms
+{
+// Only MLD evaluates conditional turn restrictions at query time
+template <typename Algorithm>
+inline void
+initializeConditionalTurns(SearchEngineData<Algorithm> &,
+                           const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &,
+                           const boost::optional<std::time_t> &)
+{
+}
+
+inline void initializeConditionalTurns(
+    SearchEngineData<mld::Algorithm> &heaps,
+    const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+    const boost::optional<std::time_t> &departure_time)
+{
+    const auto &conditional_turns = facade.GetConditionalTurns();
+    if (conditional_turns.Empty())
+        return;
+
+    // without a departure time the restrictions apply for the time of the request
+    const auto time = departure_time ? *departure_time : std::time(nullptr);
+    if (time < 0 || time > std::numeric_limits<std::uint32_t>::max())
+        return;
+
+    heaps.conditional_turns = facade.GetConditionalTurnFilter(static_cast<std::uint32_t>(time));
+}
+}
+
 class RoutingAlgorithmsInterface
 {
   public:
@@ -27,6 +62,10 @@ class RoutingAlgorithmsInterface
     ShortestPathSearch(const std::vector<PhantomNodes> &phantom_node_pair,
                        const boost::optional<bool> continue_straight_at_waypoint) const = 0;
 
+    virtual std::vector<InternalRouteResult>
+    ShortestPathSearches(const std::vector<std::vector<PhantomNodes>> &phantom_node_pairs,
+                         const boost::optional<bool> continue_straight_at_waypoint) const = 0;
+
     virtual InternalRouteResult
     DirectShortestPathSearch(const PhantomNodes &phantom_node_pair) const = 0;
 
@@ -58,13 +97,23 @@ class RoutingAlgorithmsInterface
 template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgorithmsInterface
 {
   public:
-    RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
+    RoutingAlgorithms(const SearchEngineData<Algorithm> &heaps,
                       const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade)
         : heaps(heaps), facade(facade)
     {
     }
 
-    virtual ~RoutingAlgorithms() = default;
+    // Searches of routing requests respect the conditional restrictions at the departure time
+    RoutingAlgorithms(const SearchEngineData<Algorithm> &heaps,
+                      const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                      const boost::optional<std::time_t> &departure_time)
+        : heaps(heaps), facade(facade)
+    {
+        routing_algorithms::initializeConditionalTurns(this->heaps, facade, departure_time);
+    }
+
+    // the heaps of the thread go back to the shared pool when the request is done
+    virtual ~RoutingAlgorithms() { heaps.ReleaseThreadLocalStorage(); }
 
     InternalManyRoutesResult
     AlternativePathSearch(const PhantomNodes &phantom_node_pair,
@@ -74,6 +123,10 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
         const std::vector<PhantomNodes> &phantom_node_pair,
         const boost::optional<bool> continue_straight_at_waypoint) const final override;
 
+    std::vector<InternalRouteResult> ShortestPathSearches(
+        const std::vector<std::vector<PhantomNodes>> &phantom_node_pairs,
+        const boost::optional<bool> continue_straight_at_waypoint) const final override;
+
     InternalRouteResult
     DirectShortestPathSearch(const PhantomNodes &phantom_nodes) const final override;
 
@@ -124,7 +177,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
     }
 
   private:
-    SearchEngineData<Algorithm> &heaps;
+    // Copied for every request, the heaps are thread local and only the per-request
+    // state is copied
+    mutable SearchEngineData<Algorithm> heaps;
 
     // Owned by shared-ptr passed to the query
     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade;
@@ -148,6 +203,15 @@ InternalRouteResult RoutingAlgorithms<Algorithm>::ShortestPathSearch(
         heaps, facade, phantom_node_pair, continue_straight_at_waypoint);
 }
 
+template <typename Algorithm>
+std::vector<InternalRouteResult> RoutingAlgorithms<Algorithm>::ShortestPathSearches(
+    const std::vector<std::vector<PhantomNodes>> &phantom_node_pairs,
+    const boost::optional<bool> continue_straight_at_waypoint) const
+{
+    return routing_algorithms::shortestPathSearches(
+        heaps, facade, phantom_node_pairs, continue_straight_at_waypoint);
+}
+
 template <typename Algorithm>
 InternalRouteResult
 RoutingAlgorithms<Algorithm>::DirectShortestPathSearch(const PhantomNodes &phantom_nodes) const
@@ -1,6 +1,8 @@
 #ifndef OSRM_ENGINE_ROUTING_BASE_HPP
 #define OSRM_ENGINE_ROUTING_BASE_HPP
 
+#include "customizer/speed_profiles.hpp"
+
 #include "extractor/guidance/turn_instruction.hpp"
 
 #include "engine/algorithm.hpp"
@@ -146,55 +148,71 @@ void annotatePath(const FacadeT &facade,
         const auto classes = facade.GetClassData(node_id);
 
         const auto geometry_index = facade.GetGeometryIndex(node_id);
-        std::vector<NodeID> id_vector;
+        // The routing graph scales the weight and duration of the whole node and turn by the
+        // speed factor of the node, the segments get their part of the scaled sums
+        const auto factor = facade.GetSpeedFactor(node_id);
+        EdgeWeight node_weight = 0;
+        EdgeDuration node_duration = 0;
+
+        const auto append_segments = [&](const auto &id_range,
+                                         const auto &weight_range,
+                                         const auto &duration_range,
+                                         const auto &datasource_range) {
+            BOOST_ASSERT(id_range.size() > 0);
+            BOOST_ASSERT(datasource_range.size() > 0);
+            BOOST_ASSERT(weight_range.size() == id_range.size() - 1);
+            BOOST_ASSERT(duration_range.size() == id_range.size() - 1);
+            const bool is_first_segment = unpacked_path.empty();
+
+            const std::size_t start_index =
+                (is_first_segment
+                     ? ((start_traversed_in_reverse)
+                            ? weight_range.size() -
+                                  phantom_node_pair.source_phantom.fwd_segment_position - 1
+                            : phantom_node_pair.source_phantom.fwd_segment_position)
+                     : 0);
+            const std::size_t end_index = weight_range.size();
+
+            BOOST_ASSERT(start_index >= 0);
+            BOOST_ASSERT(start_index < end_index);
+            for (std::size_t segment_idx = 0; segment_idx < end_index; ++segment_idx)
+            {
+                const auto weight = static_cast<EdgeWeight>(weight_range[segment_idx]);
+                const auto duration = static_cast<EdgeDuration>(duration_range[segment_idx]);
+                node_weight += weight;
+                node_duration += duration;
+                if (segment_idx < start_index)
+                    continue;
+
+                unpacked_path.push_back(PathData{
+                    id_range[segment_idx + 1],
+                    name_index,
+                    customizer::applySpeedFactor(node_weight - weight, weight, factor),
+                    customizer::applySpeedFactor(node_duration - duration, duration, factor),
+                    extractor::guidance::TurnInstruction::NO_TURN(),
+                    {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
+                    travel_mode,
+                    classes,
+                    EMPTY_ENTRY_CLASS,
+                    datasource_range[segment_idx],
+                    util::guidance::TurnBearing(0),
+                    util::guidance::TurnBearing(0)});
+            }
+        };
 
-        std::vector<EdgeWeight> weight_vector;
-        std::vector<EdgeWeight> duration_vector;
-        std::vector<DatasourceID> datasource_vector;
         if (geometry_index.forward)
         {
-            id_vector = facade.GetUncompressedForwardGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedForwardWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedForwardDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedForwardDatasources(geometry_index.id);
+            append_segments(facade.GetUncompressedForwardGeometry(geometry_index.id),
+                            facade.GetUncompressedForwardWeights(geometry_index.id),
+                            facade.GetUncompressedForwardDurations(geometry_index.id),
+                            facade.GetUncompressedForwardDatasources(geometry_index.id));
         }
         else
         {
-            id_vector = facade.GetUncompressedReverseGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedReverseWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedReverseDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedReverseDatasources(geometry_index.id);
-        }
-        BOOST_ASSERT(id_vector.size() > 0);
-        BOOST_ASSERT(datasource_vector.size() > 0);
-        BOOST_ASSERT(weight_vector.size() == id_vector.size() - 1);
-        BOOST_ASSERT(duration_vector.size() == id_vector.size() - 1);
-        const bool is_first_segment = unpacked_path.empty();
-
-        const std::size_t start_index =
-            (is_first_segment ? ((start_traversed_in_reverse)
-                                     ? weight_vector.size() -
-                                           phantom_node_pair.source_phantom.fwd_segment_position - 1
-                                     : phantom_node_pair.source_phantom.fwd_segment_position)
-                              : 0);
-        const std::size_t end_index = weight_vector.size();
-
-        BOOST_ASSERT(start_index >= 0);
-        BOOST_ASSERT(start_index < end_index);
-        for (std::size_t segment_idx = start_index; segment_idx < end_index; ++segment_idx)
-        {
-            unpacked_path.push_back(PathData{id_vector[segment_idx + 1],
-                                             name_index,
-                                             weight_vector[segment_idx],
-                                             duration_vector[segment_idx],
-                                             extractor::guidance::TurnInstruction::NO_TURN(),
-                                             {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
-                                             travel_mode,
-                                             classes,
-                                             EMPTY_ENTRY_CLASS,
-                                             datasource_vector[segment_idx],
-                                             util::guidance::TurnBearing(0),
-                                             util::guidance::TurnBearing(0)});
+            append_segments(facade.GetUncompressedReverseGeometry(geometry_index.id),
+                            facade.GetUncompressedReverseWeights(geometry_index.id),
+                            facade.GetUncompressedReverseDurations(geometry_index.id),
+                            facade.GetUncompressedReverseDatasources(geometry_index.id));
         }
         BOOST_ASSERT(unpacked_path.size() > 0);
         if (facade.HasLaneData(turn_id))
@@ -202,50 +220,20 @@ void annotatePath(const FacadeT &facade,
 
         unpacked_path.back().entry_class = facade.GetEntryClass(turn_id);
         unpacked_path.back().turn_instruction = turn_instruction;
-        unpacked_path.back().duration_until_turn += facade.GetDurationPenaltyForEdgeID(turn_id);
-        unpacked_path.back().weight_until_turn += facade.GetWeightPenaltyForEdgeID(turn_id);
+        const EdgeDuration turn_duration = facade.GetDurationPenaltyForEdgeID(turn_id);
+        const EdgeWeight turn_weight = facade.GetWeightPenaltyForEdgeID(turn_id);
+        unpacked_path.back().duration_until_turn +=
+            customizer::applySpeedFactor(node_duration, turn_duration, factor);
+        unpacked_path.back().weight_until_turn +=
+            customizer::applySpeedFactor(node_weight, turn_weight, factor);
         unpacked_path.back().pre_turn_bearing = facade.PreTurnBearing(turn_id);
         unpacked_path.back().post_turn_bearing = facade.PostTurnBearing(turn_id);
     }
 
-    std::size_t start_index = 0, end_index = 0;
-    std::vector<unsigned> id_vector;
-    std::vector<EdgeWeight> weight_vector;
-    std::vector<EdgeWeight> duration_vector;
-    std::vector<DatasourceID> datasource_vector;
     const auto source_geometry_id = facade.GetGeometryIndex(source_node_id).id;
     const auto target_geometry_id = facade.GetGeometryIndex(target_node_id).id;
     const auto is_local_path = source_geometry_id == target_geometry_id && unpacked_path.empty();
 
-    if (target_traversed_in_reverse)
-    {
-        id_vector = facade.GetUncompressedReverseGeometry(target_geometry_id);
-        weight_vector = facade.GetUncompressedReverseWeights(target_geometry_id);
-        duration_vector = facade.GetUncompressedReverseDurations(target_geometry_id);
-        datasource_vector = facade.GetUncompressedReverseDatasources(target_geometry_id);
-
-        if (is_local_path)
-        {
-            start_index =
-                weight_vector.size() - phantom_node_pair.source_phantom.fwd_segment_position - 1;
-        }
-        end_index =
-            weight_vector.size() - phantom_node_pair.target_phantom.fwd_segment_position - 1;
-    }
-    else
-    {
-        if (is_local_path)
-        {
-            start_index = phantom_node_pair.source_phantom.fwd_segment_position;
-        }
-        end_index = phantom_node_pair.target_phantom.fwd_segment_position;
-
-        id_vector = facade.GetUncompressedForwardGeometry(target_geometry_id);
-        weight_vector = facade.GetUncompressedForwardWeights(target_geometry_id);
-        duration_vector = facade.GetUncompressedForwardDurations(target_geometry_id);
-        datasource_vector = facade.GetUncompressedForwardDatasources(target_geometry_id);
-    }
-
     // Given the following compressed geometry:
     // U---v---w---x---y---Z
     //    s           t
@@ -253,24 +241,75 @@ void annotatePath(const FacadeT &facade,
     // t: fwd_segment 3
     // -> (U, v), (v, w), (w, x)
     // note that (x, t) is _not_ included but needs to be added later.
-    for (std::size_t segment_idx = start_index; segment_idx != end_index;
-         (start_index < end_index ? ++segment_idx : --segment_idx))
+    const auto append_target_segments = [&](const std::size_t start_index,
+                                            const std::size_t end_index,
+                                            const auto &id_range,
+                                            const auto &weight_range,
+                                            const auto &duration_range,
+                                            const auto &datasource_range) {
+        const auto factor = facade.GetSpeedFactor(target_node_id);
+        // weight and duration of the segments before segment_idx
+        EdgeWeight weight_offset = std::accumulate(
+            weight_range.begin(), weight_range.begin() + start_index, EdgeWeight{0});
+        EdgeDuration duration_offset = std::accumulate(
+            duration_range.begin(), duration_range.begin() + start_index, EdgeDuration{0});
+        for (std::size_t segment_idx = start_index; segment_idx != end_index;
+             (start_index < end_index ? ++segment_idx : --segment_idx))
+        {
+            BOOST_ASSERT(segment_idx < static_cast<std::size_t>(id_range.size() - 1));
+            BOOST_ASSERT(facade.GetTravelMode(target_node_id) > 0);
+            const auto weight = static_cast<EdgeWeight>(weight_range[segment_idx]);
+            const auto duration = static_cast<EdgeDuration>(duration_range[segment_idx]);
+            unpacked_path.push_back(
+                PathData{id_range[start_index < end_index ? segment_idx + 1 : segment_idx - 1],
+                         facade.GetNameIndex(target_node_id),
+                         customizer::applySpeedFactor(weight_offset, weight, factor),
+                         customizer::applySpeedFactor(duration_offset, duration, factor),
+                         extractor::guidance::TurnInstruction::NO_TURN(),
+                         {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
+                         facade.GetTravelMode(target_node_id),
+                         facade.GetClassData(target_node_id),
+                         EMPTY_ENTRY_CLASS,
+                         datasource_range[segment_idx],
+                         util::guidance::TurnBearing(0),
+                         util::guidance::TurnBearing(0)});
+            if (start_index < end_index)
+            {
+                weight_offset += weight;
+                duration_offset += duration;
+            }
+            else
+            {
+                weight_offset -= static_cast<EdgeWeight>(weight_range[segment_idx - 1]);
+                duration_offset -= static_cast<EdgeDuration>(duration_range[segment_idx - 1]);
+            }
+        }
+    };
+
+    if (target_traversed_in_reverse)
+    {
+        const auto weight_range = facade.GetUncompressedReverseWeights(target_geometry_id);
+        const std::size_t num_segments = weight_range.size();
+
+        append_target_segments(
+            is_local_path
+                ? num_segments - phantom_node_pair.source_phantom.fwd_segment_position - 1
+                : 0,
+            num_segments - phantom_node_pair.target_phantom.fwd_segment_position - 1,
+            facade.GetUncompressedReverseGeometry(target_geometry_id),
+            weight_range,
+            facade.GetUncompressedReverseDurations(target_geometry_id),
+            facade.GetUncompressedReverseDatasources(target_geometry_id));
+    }
+    else
     {
-        BOOST_ASSERT(segment_idx < id_vector.size() - 1);
-        BOOST_ASSERT(facade.GetTravelMode(target_node_id) > 0);
-        unpacked_path.push_back(
-            PathData{id_vector[start_index < end_index ? segment_idx + 1 : segment_idx - 1],
-                     facade.GetNameIndex(target_node_id),
-                     weight_vector[segment_idx],
-                     duration_vector[segment_idx],
-                     extractor::guidance::TurnInstruction::NO_TURN(),
-                     {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
-                     facade.GetTravelMode(target_node_id),
-                     facade.GetClassData(target_node_id),
-                     EMPTY_ENTRY_CLASS,
-                     datasource_vector[segment_idx],
-                     util::guidance::TurnBearing(0),
-                     util::guidance::TurnBearing(0)});
+        append_target_segments(
+            is_local_path ? phantom_node_pair.source_phantom.fwd_segment_position : 0,
+            phantom_node_pair.target_phantom.fwd_segment_position,
+            facade.GetUncompressedForwardGeometry(target_geometry_id),
+            facade.GetUncompressedForwardWeights(target_geometry_id),
+            facade.GetUncompressedForwardDurations(target_geometry_id),
+            facade.GetUncompressedForwardDatasources(target_geometry_id));
     }
 
     if (unpacked_path.size() > 0)
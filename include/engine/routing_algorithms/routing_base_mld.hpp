@@ -5,6 +5,7 @@
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "engine/unpacking_cache.hpp"
 
 #include "util/typedefs.hpp"
 
@@ -13,6 +14,7 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -64,13 +66,28 @@ inline bool checkParentCellRestriction(CellID cell, LevelID, CellID parent)
 {
     return cell == parent;
 }
+
+// Level on which routingStep relaxes the overlay edges of the node, they have to be unpacked
+// on the same level. Cells with restricted turns are searched on the levels below, so every
+// overlay edge of a path belongs to a cell without restricted turns and its unpacked path
+// does not depend on the departure time of the request.
+template <typename... Args>
+inline LevelID getNodeSearchLevel(const partition::MultiLevelPartitionView &partition,
+                                  const ConditionalTurnFilter &conditional_turns,
+                                  NodeID node,
+                                  Args... args)
+{
+    return std::min(getNodeQueryLevel(partition, node, args...),
+                    conditional_turns.GetMaxLevel(partition, node));
+}
 }
 
 // Heaps only record for each node its predecessor ("parent") on the shortest path.
 // For re-constructing the actual path we need to trace back all parent "pointers".
 // In contrast to the CH code MLD needs to know the edges (with clique arc property).
 
-using PackedEdge = std::tuple</*from*/ NodeID, /*to*/ NodeID, /*from_clique_arc*/ bool>;
+using PackedEdge =
+    std::tuple</*from*/ NodeID, /*to*/ NodeID, /*from_clique_arc*/ bool, /*edge_id*/ EdgeID>;
 using PackedPath = std::vector<PackedEdge>;
 
 template <bool DIRECTION, typename OutIter>
@@ -87,12 +104,12 @@ inline void retrievePackedPathFromSingleHeap(const SearchEngineData<Algorithm>::
 
         if (DIRECTION == FORWARD_DIRECTION)
         {
-            *out = std::make_tuple(parent, current, data.from_clique_arc);
+            *out = std::make_tuple(parent, current, data.from_clique_arc, data.edge_id);
             ++out;
         }
         else if (DIRECTION == REVERSE_DIRECTION)
         {
-            *out = std::make_tuple(current, parent, data.from_clique_arc);
+            *out = std::make_tuple(current, parent, data.from_clique_arc, data.edge_id);
             ++out;
         }
 
@@ -130,6 +147,26 @@ retrievePackedPathFromHeap(const SearchEngineData<Algorithm>::QueryHeap &forward
     return packed_path;
 }
 
+// Returns the base graph edge source -> target of a packed path. The reverse search relaxes
+// the copy of an edge stored at its target node, which describes the same turn unless the
+// forward and backward edges of equal weight between two nodes were merged into one edge.
+// The merged edge keeps the turn of its forward direction, so we look up the other copy.
+inline EdgeID
+getPackedEdgeID(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                const PackedEdge &packed_edge)
+{
+    const NodeID source = std::get<0>(packed_edge);
+    const NodeID target = std::get<1>(packed_edge);
+    const EdgeID edge = std::get<3>(packed_edge);
+    BOOST_ASSERT(!std::get<2>(packed_edge));
+    BOOST_ASSERT(edge != SPECIAL_EDGEID);
+
+    if (facade.GetTarget(edge) == source && facade.GetEdgeData(edge).forward)
+        return facade.FindEdge(source, target);
+
+    return edge;
+}
+
 template <bool DIRECTION, typename... Args>
 void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                  SearchEngineData<Algorithm>::QueryHeap &forward_heap,
@@ -138,10 +175,12 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                  EdgeWeight &path_upper_bound,
                  const bool force_loop_forward,
                  const bool force_loop_reverse,
+                 const ConditionalTurnFilter &conditional_turns,
                  Args... args)
 {
     const auto &partition = facade.GetMultiLevelPartition();
     const auto &cells = facade.GetCellStorage();
+    const auto &metric = facade.GetCellMetric();
 
     const auto node = forward_heap.DeleteMin();
     const auto weight = forward_heap.GetKey(node);
@@ -166,84 +205,96 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
         }
     }
 
-    const auto level = getNodeQueryLevel(partition, node, args...);
+    // cells with restricted turns are searched on the lower levels
+    const auto query_level = getNodeQueryLevel(partition, node, args...);
+    const auto level = std::min(query_level, conditional_turns.GetMaxLevel(partition, node));
 
     if (level >= 1 && !forward_heap.GetData(node).from_clique_arc)
     {
-        if (DIRECTION == FORWARD_DIRECTION)
-        {
-            // Shortcuts in forward direction
-            const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
-            auto destination = cell.GetDestinationNodes().begin();
-            for (auto shortcut_weight : cell.GetOutWeight(node))
+        const auto relax_shortcuts = [&](const auto &cell) {
+            if (DIRECTION == FORWARD_DIRECTION)
             {
-                BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
-                const NodeID to = *destination;
-                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
+                // Shortcuts in forward direction
+                auto destination = cell.GetDestinationNodes().begin();
+                for (auto shortcut_weight : cell.GetOutWeight(node))
                 {
-                    const EdgeWeight to_weight = weight + shortcut_weight;
-                    BOOST_ASSERT(to_weight >= weight);
-                    if (!forward_heap.WasInserted(to))
-                    {
-                        forward_heap.Insert(to, to_weight, {node, true});
-                    }
-                    else if (to_weight < forward_heap.GetKey(to))
+                    BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
+                    const NodeID to = *destination;
+                    if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
                     {
-                        forward_heap.GetData(to) = {node, true};
-                        forward_heap.DecreaseKey(to, to_weight);
+                        const EdgeWeight to_weight = weight + shortcut_weight;
+                        BOOST_ASSERT(to_weight >= weight);
+                        if (!forward_heap.WasInserted(to))
+                        {
+                            forward_heap.Insert(to, to_weight, {node, true});
+                        }
+                        else if (to_weight < forward_heap.GetKey(to))
+                        {
+                            forward_heap.GetData(to) = {node, true};
+                            forward_heap.DecreaseKey(to, to_weight);
+                        }
                     }
+                    ++destination;
                 }
-                ++destination;
             }
-        }
-        else
-        {
-            // Shortcuts in backward direction
-            const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
-            auto source = cell.GetSourceNodes().begin();
-            for (auto shortcut_weight : cell.GetInWeight(node))
+            else
             {
-                BOOST_ASSERT(source != cell.GetSourceNodes().end());
-                const NodeID to = *source;
-                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
+                // Shortcuts in backward direction
+                auto source = cell.GetSourceNodes().begin();
+                for (auto shortcut_weight : cell.GetInWeight(node))
                 {
-                    const EdgeWeight to_weight = weight + shortcut_weight;
-                    BOOST_ASSERT(to_weight >= weight);
-                    if (!forward_heap.WasInserted(to))
+                    BOOST_ASSERT(source != cell.GetSourceNodes().end());
+                    const NodeID to = *source;
+                    if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
                     {
-                        forward_heap.Insert(to, to_weight, {node, true});
-                    }
-                    else if (to_weight < forward_heap.GetKey(to))
-                    {
-                        forward_heap.GetData(to) = {node, true};
-                        forward_heap.DecreaseKey(to, to_weight);
+                        const EdgeWeight to_weight = weight + shortcut_weight;
+                        BOOST_ASSERT(to_weight >= weight);
+                        if (!forward_heap.WasInserted(to))
+                        {
+                            forward_heap.Insert(to, to_weight, {node, true});
+                        }
+                        else if (to_weight < forward_heap.GetKey(to))
+                        {
+                            forward_heap.GetData(to) = {node, true};
+                            forward_heap.DecreaseKey(to, to_weight);
+                        }
                     }
+                    ++source;
                 }
-                ++source;
             }
-        }
+        };
+
+        const auto cell_id = partition.GetCell(level, node);
+        if (metric.IsQuantized())
+            relax_shortcuts(cells.GetQuantizedCell(metric, level, cell_id));
+        else
+            relax_shortcuts(cells.GetCell(metric, level, cell_id));
     }
 
     // Boundary edges
     for (const auto edge : facade.GetBorderEdgeRange(level, node))
     {
         const auto &edge_data = facade.GetEdgeData(edge);
-        if (DIRECTION == FORWARD_DIRECTION ? edge_data.forward : edge_data.backward)
+        if ((DIRECTION == FORWARD_DIRECTION ? edge_data.forward : edge_data.backward) &&
+            !conditional_turns.IsRestricted(facade, node, edge, DIRECTION == REVERSE_DIRECTION))
         {
             const NodeID to = facade.GetTarget(edge);
 
-            if (checkParentCellRestriction(partition.GetCell(level + 1, to), args...))
+            if (checkParentCellRestriction(partition.GetCell(query_level + 1, to), args...))
             {
-                BOOST_ASSERT_MSG(edge_data.weight > 0, "edge_weight invalid");
-                const EdgeWeight to_weight = weight + edge_data.weight;
+                // the weight of an edge belongs to the node it leaves
+                const EdgeWeight edge_weight =
+                    facade.GetEdgeWeight(edge, DIRECTION == FORWARD_DIRECTION ? node : to);
+                BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
+                const EdgeWeight to_weight = weight + edge_weight;
 
                 if (!forward_heap.WasInserted(to))
                 {
-                    forward_heap.Insert(to, to_weight, {node, false});
+                    forward_heap.Insert(to, to_weight, {node, false, edge});
                 }
                 else if (to_weight < forward_heap.GetKey(to))
                 {
-                    forward_heap.GetData(to) = {node, false};
+                    forward_heap.GetData(to) = {node, false, edge};
                     forward_heap.DecreaseKey(to, to_weight);
                 }
             }
@@ -260,6 +311,21 @@ using UnpackedNodes = std::vector<NodeID>;
 using UnpackedEdges = std::vector<EdgeID>;
 using UnpackedPath = std::tuple<EdgeWeight, UnpackedNodes, UnpackedEdges>;
 
+// Appends the base graph path of the overlay edge source -> target on the given level
+// to the unpacked nodes and edges, the source node is expected to be appended already.
+inline void
+unpackOverlayEdge(SearchEngineData<Algorithm> &engine_working_data,
+                  const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                  SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                  SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                  const bool force_loop_forward,
+                  const bool force_loop_reverse,
+                  const LevelID level,
+                  const NodeID source,
+                  const NodeID target,
+                  std::vector<NodeID> &unpacked_nodes,
+                  std::vector<EdgeID> &unpacked_edges);
+
 template <typename... Args>
 UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
@@ -297,6 +363,7 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                                            weight,
                                            force_loop_forward,
                                            force_loop_reverse,
+                                           engine_working_data.conditional_turns,
                                            args...);
             if (!forward_heap.Empty())
                 forward_heap_min = forward_heap.MinKey();
@@ -310,6 +377,7 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                                            weight,
                                            force_loop_reverse,
                                            force_loop_forward,
+                                           engine_working_data.conditional_turns,
                                            args...);
             if (!reverse_heap.Empty())
                 reverse_heap_min = reverse_heap.MinKey();
@@ -322,7 +390,7 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
         return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
     }
 
-    // Get packed path as edges {from node ID, to node ID, from_clique_arc}
+    // Get packed path as edges {from node ID, to node ID, from_clique_arc, edge ID}
     auto packed_path = retrievePackedPathFromHeap(forward_heap, reverse_heap, middle);
 
     // Beware the edge case when start, middle, end are all the same.
@@ -341,53 +409,93 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
     {
         NodeID source, target;
         bool overlay_edge;
-        std::tie(source, target, overlay_edge) = packed_edge;
+        std::tie(source, target, overlay_edge, std::ignore) = packed_edge;
         if (!overlay_edge)
         { // a base graph edge
             unpacked_nodes.push_back(target);
-            unpacked_edges.push_back(facade.FindEdge(source, target));
+            unpacked_edges.push_back(getPackedEdgeID(facade, packed_edge));
         }
         else
         { // an overlay graph edge
-            LevelID level = getNodeQueryLevel(partition, source, args...);
-            CellID parent_cell_id = partition.GetCell(level, source);
-            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-            LevelID sublevel = level - 1;
-
-            // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, 0, {source});
-            reverse_heap.Insert(target, 0, {target});
-
-            // TODO: when structured bindings will be allowed change to
-            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-            EdgeWeight subpath_weight;
-            std::vector<NodeID> subpath_nodes;
-            std::vector<EdgeID> subpath_edges;
-            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
-                                                                            facade,
-                                                                            forward_heap,
-                                                                            reverse_heap,
-                                                                            force_loop_forward,
-                                                                            force_loop_reverse,
-                                                                            INVALID_EDGE_WEIGHT,
-                                                                            sublevel,
-                                                                            parent_cell_id);
-            BOOST_ASSERT(!subpath_edges.empty());
-            BOOST_ASSERT(subpath_nodes.size() > 1);
-            BOOST_ASSERT(subpath_nodes.front() == source);
-            BOOST_ASSERT(subpath_nodes.back() == target);
-            unpacked_nodes.insert(
-                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+            unpackOverlayEdge(engine_working_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              force_loop_forward,
+                              force_loop_reverse,
+                              getNodeSearchLevel(partition,
+                                                 engine_working_data.conditional_turns,
+                                                 source,
+                                                 args...),
+                              source,
+                              target,
+                              unpacked_nodes,
+                              unpacked_edges);
         }
     }
 
     return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
 }
 
+inline void
+unpackOverlayEdge(SearchEngineData<Algorithm> &engine_working_data,
+                  const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                  SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                  SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                  const bool force_loop_forward,
+                  const bool force_loop_reverse,
+                  const LevelID level,
+                  const NodeID source,
+                  const NodeID target,
+                  std::vector<NodeID> &unpacked_nodes,
+                  std::vector<EdgeID> &unpacked_edges)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    CellID parent_cell_id = partition.GetCell(level, source);
+    BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
+
+    LevelID sublevel = level - 1;
+
+    // Popular overlay edges are unpacked once per dataset and metric
+    auto *const unpacking_cache = facade.GetUnpackingCache();
+    const UnpackingKey key{
+        level, parent_cell_id, source, target, force_loop_forward, force_loop_reverse};
+    auto subpath = unpacking_cache ? unpacking_cache->Get(key) : nullptr;
+    if (!subpath)
+    {
+        // Here heaps can be reused, let's go deeper!
+        forward_heap.Clear();
+        reverse_heap.Clear();
+        forward_heap.Insert(source, 0, {source});
+        reverse_heap.Insert(target, 0, {target});
+
+        auto unpacked_subpath = std::make_shared<UnpackedSubpath>();
+        std::tie(std::ignore, unpacked_subpath->nodes, unpacked_subpath->edges) =
+            search(engine_working_data,
+                   facade,
+                   forward_heap,
+                   reverse_heap,
+                   force_loop_forward,
+                   force_loop_reverse,
+                   INVALID_EDGE_WEIGHT,
+                   sublevel,
+                   parent_cell_id);
+        subpath = std::move(unpacked_subpath);
+        if (unpacking_cache)
+            unpacking_cache->Put(key, subpath);
+    }
+
+    const auto &subpath_nodes = subpath->nodes;
+    const auto &subpath_edges = subpath->edges;
+    BOOST_ASSERT(!subpath_edges.empty());
+    BOOST_ASSERT(subpath_nodes.size() > 1);
+    BOOST_ASSERT(subpath_nodes.front() == source);
+    BOOST_ASSERT(subpath_nodes.back() == target);
+    unpacked_nodes.insert(
+        unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+    unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+}
+
 // Alias to be compatible with the CH-based search
 inline void search(SearchEngineData<Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
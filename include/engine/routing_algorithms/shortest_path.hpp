@@ -20,6 +20,14 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
                    const boost::optional<bool> continue_straight_at_waypoint);
 
+// Searches independent routes, with request parallelism they are searched concurrently
+template <typename Algorithm>
+std::vector<InternalRouteResult>
+shortestPathSearches(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const std::vector<std::vector<PhantomNodes>> &routes,
+                     const boost::optional<bool> continue_straight_at_waypoint);
+
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
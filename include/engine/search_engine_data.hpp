@@ -4,9 +4,13 @@
 #include <boost/thread/tss.hpp>
 
 #include "engine/algorithm.hpp"
+#include "engine/conditional_turn_filter.hpp"
 #include "util/query_heap.hpp"
 #include "util/typedefs.hpp"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace osrm
 {
 namespace engine
@@ -21,6 +25,20 @@ template <typename Algorithm> struct SearchEngineData
 {
 };
 
+struct SearchEngineHeapStats
+{
+    // heaps of all threads, including the heaps waiting in the shared pools
+    std::size_t number_of_heaps = 0;
+    std::size_t number_of_pooled_heaps = 0;
+    std::size_t memory_usage = 0;
+    std::size_t peak_memory_usage = 0;
+    std::uint64_t number_of_trims = 0;
+};
+
+// Memory of the search heaps of all algorithms in bytes, every heap is sampled when it is
+// cleared for a new query
+SearchEngineHeapStats getSearchEngineHeapStats();
+
 struct HeapData
 {
     NodeID parent;
@@ -55,6 +73,18 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     static SearchEngineHeapPtr reverse_heap_3;
     static ManyToManyHeapPtr many_to_many_heap;
 
+    // number of threads a multi-leg request may use, legs are searched one by one with 1
+    unsigned request_parallelism = 1;
+
+    // heaps are shrunk to the largest query of the last heap_trim_interval queries on every
+    // heap_trim_interval-th query, 0 never shrinks them. Every InitializeOrClear* call that
+    // covers a heap counts as one query of it.
+    unsigned heap_trim_interval = 0;
+
+    // with a size > 0 the heaps of a thread go back to a shared pool after each request and
+    // the pool keeps at most heap_pool_size idle heaps per heap type
+    unsigned heap_pool_size = 0;
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes);
@@ -62,6 +92,9 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // Hands the heaps of this thread to the shared pool, does nothing without a pool
+    void ReleaseThreadLocalStorage();
 };
 
 template <>
@@ -74,8 +107,20 @@ struct MultiLayerDijkstraHeapData
 {
     NodeID parent;
     bool from_clique_arc;
-    MultiLayerDijkstraHeapData(NodeID p) : parent(p), from_clique_arc(false) {}
-    MultiLayerDijkstraHeapData(NodeID p, bool from) : parent(p), from_clique_arc(from) {}
+    // base graph edge from the parent, so unpacking needs no adjacency lookup
+    EdgeID edge_id;
+    MultiLayerDijkstraHeapData(NodeID p)
+        : parent(p), from_clique_arc(false), edge_id(SPECIAL_EDGEID)
+    {
+    }
+    MultiLayerDijkstraHeapData(NodeID p, bool from)
+        : parent(p), from_clique_arc(from), edge_id(SPECIAL_EDGEID)
+    {
+    }
+    MultiLayerDijkstraHeapData(NodeID p, bool from, EdgeID edge)
+        : parent(p), from_clique_arc(from), edge_id(edge)
+    {
+    }
 };
 
 struct ManyToManyMultiLayerDijkstraHeapData : MultiLayerDijkstraHeapData
@@ -113,9 +158,27 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
     static SearchEngineHeapPtr reverse_heap_1;
     static ManyToManyHeapPtr many_to_many_heap;
 
+    // turns restricted at the departure time of the request
+    ConditionalTurnFilter conditional_turns;
+
+    // number of threads a multi-leg request may use, legs are searched one by one with 1
+    unsigned request_parallelism = 1;
+
+    // heaps are shrunk to the largest query of the last heap_trim_interval queries on every
+    // heap_trim_interval-th query, 0 never shrinks them. Every InitializeOrClear* call that
+    // covers a heap counts as one query of it.
+    unsigned heap_trim_interval = 0;
+
+    // with a size > 0 the heaps of a thread go back to a shared pool after each request and
+    // the pool keeps at most heap_pool_size idle heaps per heap type
+    unsigned heap_pool_size = 0;
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // Hands the heaps of this thread to the shared pool, does nothing without a pool
+    void ReleaseThreadLocalStorage();
 };
 }
 }
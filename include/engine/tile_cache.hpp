@@ -0,0 +1,122 @@
+#ifndef OSRM_ENGINE_TILE_CACHE_HPP
+#define OSRM_ENGINE_TILE_CACHE_HPP
+
+#include <boost/functional/hash.hpp>
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Identifies a rendered tile. The timestamp is the one of the dataset the tile was
+// rendered from, so tiles of a previous dataset are never served after a data swap.
+struct TileKey
+{
+    unsigned x;
+    unsigned y;
+    unsigned z;
+    unsigned timestamp;
+
+    bool operator==(const TileKey &other) const
+    {
+        return std::tie(x, y, z, timestamp) == std::tie(other.x, other.y, other.z, other.timestamp);
+    }
+};
+
+struct TileKeyHash
+{
+    std::size_t operator()(const TileKey &key) const
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, key.x);
+        boost::hash_combine(seed, key.y);
+        boost::hash_combine(seed, key.z);
+        boost::hash_combine(seed, key.timestamp);
+        return seed;
+    }
+};
+
+// Thread-safe least recently used cache of encoded vector tiles, bounded by the
+// total size of the cached tiles in bytes
+class TileCache
+{
+  public:
+    explicit TileCache(const std::size_t max_size) : max_size(max_size), size(0) {}
+
+    // Copies the cached tile into pbf_buffer, returns false if the tile is not cached
+    bool Get(const TileKey &key, std::string &pbf_buffer)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const auto found = index.find(key);
+        if (found == index.end())
+            return false;
+
+        // move the tile to the front of the recently used list
+        tiles.splice(tiles.begin(), tiles, found->second);
+        pbf_buffer = found->second->second;
+        return true;
+    }
+
+    bool Contains(const TileKey &key) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return index.find(key) != index.end();
+    }
+
+    void Put(const TileKey &key, std::string pbf_buffer)
+    {
+        // never evict the whole cache for a single tile
+        if (pbf_buffer.size() > max_size)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const auto found = index.find(key);
+        if (found != index.end())
+        {
+            size -= found->second->second.size();
+            tiles.erase(found->second);
+            index.erase(found);
+        }
+
+        size += pbf_buffer.size();
+        tiles.emplace_front(key, std::move(pbf_buffer));
+        index[key] = tiles.begin();
+
+        while (size > max_size)
+        {
+            const auto &last = tiles.back();
+            size -= last.second.size();
+            index.erase(last.first);
+            tiles.pop_back();
+        }
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return size;
+    }
+
+  private:
+    using Tiles = std::list<std::pair<TileKey, std::string>>;
+
+    const std::size_t max_size;
+    mutable std::mutex mutex;
+    std::size_t size;
+    Tiles tiles;
+    std::unordered_map<TileKey, Tiles::iterator, TileKeyHash> index;
+};
+}
+}
+
+#endif
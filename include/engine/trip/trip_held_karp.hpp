@@ -0,0 +1,133 @@
+#ifndef TRIP_HELD_KARP_HPP
+#define TRIP_HELD_KARP_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// The dynamic programming table has (2^(n-1) * (n-1)) entries, 20 locations need about 50 MB
+const constexpr std::size_t HK_MAX_FEASIBLE = 20;
+
+// computes the optimal round trip with the Held-Karp dynamic programming algorithm
+inline std::vector<NodeID> HeldKarpTrip(const std::size_t number_of_locations,
+                                        const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    BOOST_ASSERT(number_of_locations > 0);
+    BOOST_ASSERT(number_of_locations <= HK_MAX_FEASIBLE);
+    BOOST_ASSERT_MSG(number_of_locations * number_of_locations == dist_table.size(),
+                     "number_of_locations and dist_table size do not match");
+
+    if (number_of_locations < 3)
+    {
+        std::vector<NodeID> route(number_of_locations);
+        std::iota(route.begin(), route.end(), 0);
+        return route;
+    }
+
+    // Every round trip visits location 0, so all paths start there. Location i > 0 is
+    // represented by bit (i - 1) of a subset, weights[subset * num_others + (i - 1)] is the
+    // weight of the shortest path that starts at 0, visits all locations of the subset and
+    // ends at location i.
+    const std::size_t num_others = number_of_locations - 1;
+    const std::uint32_t num_subsets = 1u << num_others;
+    const auto index = [num_others](const std::uint32_t subset, const std::size_t last) {
+        return static_cast<std::size_t>(subset) * num_others + last;
+    };
+
+    std::vector<EdgeWeight> weights(static_cast<std::size_t>(num_subsets) * num_others,
+                                    INVALID_EDGE_WEIGHT);
+    std::vector<std::uint8_t> parents(weights.size(), 0);
+
+    for (std::size_t last = 0; last < num_others; ++last)
+    {
+        weights[index(1u << last, last)] = dist_table(0, last + 1);
+        parents[index(1u << last, last)] = 0;
+    }
+
+    // subsets are processed in increasing order, so all subsets of a subset are final
+    for (std::uint32_t subset = 1; subset < num_subsets; ++subset)
+    {
+        for (std::size_t last = 0; last < num_others; ++last)
+        {
+            const auto weight = weights[index(subset, last)];
+            if (!(subset & (1u << last)) || weight == INVALID_EDGE_WEIGHT)
+                continue;
+
+            for (std::size_t next = 0; next < num_others; ++next)
+            {
+                if (subset & (1u << next))
+                    continue;
+
+                const auto edge_weight = dist_table(last + 1, next + 1);
+                if (edge_weight == INVALID_EDGE_WEIGHT)
+                    continue;
+
+                const std::int64_t new_weight = static_cast<std::int64_t>(weight) + edge_weight;
+                const auto next_index = index(subset | (1u << next), next);
+                if (new_weight < weights[next_index])
+                {
+                    weights[next_index] = static_cast<EdgeWeight>(new_weight);
+                    parents[next_index] = static_cast<std::uint8_t>(last + 1);
+                }
+            }
+        }
+    }
+
+    // close the round trip by returning to location 0
+    const std::uint32_t all_locations = num_subsets - 1;
+    std::int64_t min_route_weight = std::numeric_limits<std::int64_t>::max();
+    std::size_t min_last = 0;
+    for (std::size_t last = 0; last < num_others; ++last)
+    {
+        const auto weight = weights[index(all_locations, last)];
+        const auto edge_weight = dist_table(last + 1, 0);
+        if (weight == INVALID_EDGE_WEIGHT || edge_weight == INVALID_EDGE_WEIGHT)
+            continue;
+
+        const std::int64_t route_weight = static_cast<std::int64_t>(weight) + edge_weight;
+        if (route_weight < min_route_weight)
+        {
+            min_route_weight = route_weight;
+            min_last = last;
+        }
+    }
+
+    // unwind the parent pointers, this yields the round trip in reverse order
+    std::vector<NodeID> route;
+    route.reserve(number_of_locations);
+    std::uint32_t subset = all_locations;
+    std::size_t last = min_last + 1;
+    while (last != 0)
+    {
+        route.push_back(last);
+        const auto parent = parents[index(subset, last - 1)];
+        subset &= ~(1u << (last - 1));
+        last = parent;
+    }
+    route.push_back(0);
+    std::reverse(route.begin(), route.end());
+
+    BOOST_ASSERT(route.size() == number_of_locations);
+    return route;
+}
+
+} // namespace trip
+} // namespace engine
+} // namespace osrm
+
+#endif // TRIP_HELD_KARP_HPP
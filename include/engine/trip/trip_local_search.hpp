@@ -0,0 +1,271 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+namespace detail
+{
+// Moves are only evaluated towards the closest locations of each location
+const constexpr std::size_t NUMBER_OF_NEIGHBOURS = 8;
+// Longest sequence of locations that is moved by a single Or-opt move
+const constexpr std::size_t OR_OPT_MAX_LENGTH = 3;
+// Number of different initial round trips that are improved in parallel
+const constexpr std::size_t NUMBER_OF_START_TRIPS = 8;
+
+// Sums up weights in 64 bit, so invalid edges make a trip longer than any valid trip
+inline std::int64_t GetWeight(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                              const NodeID from,
+                              const NodeID to)
+{
+    return dist_table(from, to);
+}
+
+inline std::int64_t GetTripWeight(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                  const std::vector<NodeID> &trip)
+{
+    std::int64_t weight = 0;
+    for (std::size_t index = 0; index < trip.size(); ++index)
+        weight += GetWeight(dist_table, trip[index], trip[(index + 1) % trip.size()]);
+    return weight;
+}
+
+// Lists the closest locations for every location. Since the table is not symmetric the
+// weights of both directions are considered.
+inline std::vector<std::vector<NodeID>>
+GetNeighbours(const std::size_t number_of_locations,
+              const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    const auto number_of_neighbours = std::min(NUMBER_OF_NEIGHBOURS, number_of_locations - 1);
+
+    std::vector<std::vector<NodeID>> neighbours(number_of_locations);
+    for (NodeID location = 0; location < number_of_locations; ++location)
+    {
+        const auto round_trip_weight = [&](const NodeID other) {
+            return GetWeight(dist_table, location, other) + GetWeight(dist_table, other, location);
+        };
+
+        auto &candidates = neighbours[location];
+        candidates.resize(number_of_locations);
+        std::iota(candidates.begin(), candidates.end(), 0);
+        candidates.erase(candidates.begin() + location);
+        std::partial_sort(candidates.begin(),
+                          candidates.begin() + number_of_neighbours,
+                          candidates.end(),
+                          [&](const NodeID lhs, const NodeID rhs) {
+                              return round_trip_weight(lhs) < round_trip_weight(rhs);
+                          });
+        candidates.resize(number_of_neighbours);
+    }
+    return neighbours;
+}
+
+// Replaces the edges (a, b) and (c, d) by (a, c) and (b, d), which reverses the path b ... c.
+// Returns true if this improves the trip.
+inline bool TryTwoOptMove(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                          std::vector<NodeID> &trip,
+                          std::vector<std::size_t> &position,
+                          const std::size_t a_index,
+                          const std::size_t c_index)
+{
+    const auto size = trip.size();
+    const auto b_index = a_index + 1;
+    if (c_index <= b_index || c_index >= size)
+        return false;
+
+    const auto a = trip[a_index];
+    const auto b = trip[b_index];
+    const auto c = trip[c_index];
+    const auto d = trip[(c_index + 1) % size];
+    if (d == a)
+        return false;
+
+    std::int64_t delta = GetWeight(dist_table, a, c) + GetWeight(dist_table, b, d) -
+                         GetWeight(dist_table, a, b) - GetWeight(dist_table, c, d);
+    // the weights in the table are not symmetric, so the reversed path changes its weight
+    for (auto index = b_index; index < c_index; ++index)
+    {
+        delta += GetWeight(dist_table, trip[index + 1], trip[index]) -
+                 GetWeight(dist_table, trip[index], trip[index + 1]);
+    }
+
+    if (delta >= 0)
+        return false;
+
+    std::reverse(trip.begin() + b_index, trip.begin() + c_index + 1);
+    for (auto index = b_index; index <= c_index; ++index)
+        position[trip[index]] = index;
+    return true;
+}
+
+// Moves the path of length locations starting at first_index between the location at
+// target_index and its successor. Returns true if this improves the trip.
+inline bool TryOrOptMove(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                         std::vector<NodeID> &trip,
+                         std::vector<std::size_t> &position,
+                         const std::size_t first_index,
+                         const std::size_t length,
+                         const std::size_t target_index)
+{
+    const auto size = trip.size();
+    const auto last_index = first_index + length - 1;
+    if (first_index == 0 || last_index + 1 >= size)
+        return false;
+    if (target_index + 1 >= first_index && target_index <= last_index)
+        return false;
+
+    const auto prev = trip[first_index - 1];
+    const auto first = trip[first_index];
+    const auto last = trip[last_index];
+    const auto next = trip[last_index + 1];
+    const auto target = trip[target_index];
+    const auto target_next = trip[(target_index + 1) % size];
+
+    const std::int64_t delta =
+        GetWeight(dist_table, prev, next) + GetWeight(dist_table, target, first) +
+        GetWeight(dist_table, last, target_next) - GetWeight(dist_table, prev, first) -
+        GetWeight(dist_table, last, next) - GetWeight(dist_table, target, target_next);
+
+    if (delta >= 0)
+        return false;
+
+    const auto first_iter = trip.begin() + first_index;
+    const auto end_iter = first_iter + length;
+    if (target_index < first_index)
+    {
+        std::rotate(trip.begin() + target_index + 1, first_iter, end_iter);
+        for (auto index = target_index + 1; index <= last_index; ++index)
+            position[trip[index]] = index;
+    }
+    else
+    {
+        std::rotate(first_iter, end_iter, trip.begin() + target_index + 1);
+        for (auto index = first_index; index <= target_index; ++index)
+            position[trip[index]] = index;
+    }
+    return true;
+}
+}
+
+// Improves a round trip with 2-opt and Or-opt moves towards the closest neighbours of each
+// location until no improving move is left or the deadline has passed
+inline void ImproveTrip(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                        const std::vector<std::vector<NodeID>> &neighbours,
+                        const std::chrono::steady_clock::time_point deadline,
+                        std::vector<NodeID> &trip)
+{
+    const auto size = trip.size();
+    if (size < 4)
+        return;
+
+    std::vector<std::size_t> position(size);
+    for (std::size_t index = 0; index < size; ++index)
+        position[trip[index]] = index;
+
+    bool improved = true;
+    while (improved && std::chrono::steady_clock::now() < deadline)
+    {
+        improved = false;
+
+        for (std::size_t index = 0; index + 1 < size; ++index)
+        {
+            for (const auto neighbour : neighbours[trip[index]])
+            {
+                // connects the location and its neighbour in the order they appear in the trip
+                const auto neighbour_index = position[neighbour];
+                improved |= detail::TryTwoOptMove(dist_table,
+                                                  trip,
+                                                  position,
+                                                  std::min(index, neighbour_index),
+                                                  std::max(index, neighbour_index));
+            }
+        }
+
+        for (std::size_t length = 1; length <= detail::OR_OPT_MAX_LENGTH; ++length)
+        {
+            for (std::size_t index = 1; index + length < size; ++index)
+            {
+                for (const auto neighbour : neighbours[trip[index]])
+                {
+                    // inserting in front of the closest neighbour
+                    const auto target_index = (position[neighbour] + size - 1) % size;
+                    improved |= detail::TryOrOptMove(
+                        dist_table, trip, position, index, length, target_index);
+                }
+            }
+        }
+    }
+}
+
+// Builds farthest insertion trips from several start locations and improves all of them with
+// 2-opt and Or-opt moves in parallel. Returns the shortest of the improved trips.
+inline std::vector<NodeID> LocalSearchTrip(const std::size_t number_of_locations,
+                                           const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                           const std::chrono::milliseconds time_budget)
+{
+    BOOST_ASSERT(number_of_locations > 0);
+    BOOST_ASSERT_MSG(number_of_locations * number_of_locations == dist_table.size(),
+                     "number_of_locations and dist_table size do not match");
+
+    const auto deadline = std::chrono::steady_clock::now() + time_budget;
+    if (number_of_locations < 4)
+        return FarthestInsertionTrip(number_of_locations, dist_table);
+
+    const auto neighbours = detail::GetNeighbours(number_of_locations, dist_table);
+
+    // the first trip is the regular farthest insertion trip, the others start at locations
+    // spread evenly over the input together with the location farthest away from them
+    const auto number_of_trips = std::min(detail::NUMBER_OF_START_TRIPS, number_of_locations);
+    std::vector<std::vector<NodeID>> trips(number_of_trips);
+    tbb::parallel_for(std::size_t{0}, number_of_trips, [&](const std::size_t trip_index) {
+        auto &trip = trips[trip_index];
+        if (trip_index == 0)
+        {
+            trip = FarthestInsertionTrip(number_of_locations, dist_table);
+        }
+        else
+        {
+            const NodeID start = trip_index * number_of_locations / number_of_trips;
+            NodeID farthest = start == 0 ? 1 : 0;
+            for (NodeID other = 0; other < number_of_locations; ++other)
+            {
+                if (other != start && dist_table(start, other) > dist_table(start, farthest))
+                    farthest = other;
+            }
+            trip = FindRoute(number_of_locations, dist_table, start, farthest);
+        }
+        ImproveTrip(dist_table, neighbours, deadline, trip);
+    });
+
+    // ties are resolved by the order of the trips, so results do not depend on scheduling
+    const auto shortest_trip = std::min_element(
+        trips.begin(), trips.end(), [&](const auto &lhs, const auto &rhs) {
+            return detail::GetTripWeight(dist_table, lhs) < detail::GetTripWeight(dist_table, rhs);
+        });
+    return std::move(*shortest_trip);
+}
+
+} // namespace trip
+} // namespace engine
+} // namespace osrm
+
+#endif // TRIP_LOCAL_SEARCH_HPP
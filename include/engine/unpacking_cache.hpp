@@ -0,0 +1,176 @@
+#ifndef OSRM_ENGINE_UNPACKING_CACHE_HPP
+#define OSRM_ENGINE_UNPACKING_CACHE_HPP
+
+#include "util/log.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Identifies the unpacking of an overlay edge. The sub-search is restricted to the cell,
+// the loop flags change which middle nodes are accepted and are part of the key as well.
+struct UnpackingKey
+{
+    LevelID level;
+    CellID cell;
+    NodeID source;
+    NodeID target;
+    bool force_loop_forward;
+    bool force_loop_reverse;
+
+    bool operator==(const UnpackingKey &other) const
+    {
+        return std::tie(level, cell, source, target, force_loop_forward, force_loop_reverse) ==
+               std::tie(other.level,
+                        other.cell,
+                        other.source,
+                        other.target,
+                        other.force_loop_forward,
+                        other.force_loop_reverse);
+    }
+};
+
+struct UnpackingKeyHash
+{
+    std::size_t operator()(const UnpackingKey &key) const
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, key.level);
+        boost::hash_combine(seed, key.cell);
+        boost::hash_combine(seed, key.source);
+        boost::hash_combine(seed, key.target);
+        boost::hash_combine(seed, key.force_loop_forward);
+        boost::hash_combine(seed, key.force_loop_reverse);
+        return seed;
+    }
+};
+
+// Base graph nodes and edges of an unpacked overlay edge, including source and target
+struct UnpackedSubpath
+{
+    std::vector<NodeID> nodes;
+    std::vector<EdgeID> edges;
+};
+
+// Thread-safe least recently used cache of unpacked overlay edges, bounded by the size of
+// the cached paths in bytes. The cache is split into shards with a lock each, so concurrent
+// requests rarely wait for each other. It belongs to a single facade, that means to one
+// dataset and metric, and is dropped together with it.
+class UnpackingCache
+{
+  public:
+    explicit UnpackingCache(const std::size_t max_size)
+        : max_shard_size(max_size / NUM_SHARDS), hits(0), misses(0)
+    {
+    }
+
+    ~UnpackingCache()
+    {
+        const std::size_t lookups = hits + misses;
+        if (lookups > 0)
+        {
+            util::Log() << "unpacking cache: " << hits << " hits, " << misses << " misses ("
+                        << 100. * hits / lookups << "% hit ratio)";
+        }
+    }
+
+    UnpackingCache(const UnpackingCache &) = delete;
+    UnpackingCache &operator=(const UnpackingCache &) = delete;
+
+    // Returns nullptr if the overlay edge was not unpacked before
+    std::shared_ptr<const UnpackedSubpath> Get(const UnpackingKey &key)
+    {
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto found = shard.index.find(key);
+        if (found == shard.index.end())
+        {
+            ++misses;
+            return {};
+        }
+
+        ++hits;
+        // move the path to the front of the recently used list
+        shard.paths.splice(shard.paths.begin(), shard.paths, found->second);
+        return found->second->second;
+    }
+
+    void Put(const UnpackingKey &key, std::shared_ptr<const UnpackedSubpath> path)
+    {
+        const auto path_size = GetSize(*path);
+        // never evict a whole shard for a single path
+        if (path_size > max_shard_size)
+            return;
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // another request unpacked the same edge in the meantime
+        if (shard.index.find(key) != shard.index.end())
+            return;
+
+        shard.size += path_size;
+        shard.paths.emplace_front(key, std::move(path));
+        shard.index[key] = shard.paths.begin();
+
+        while (shard.size > max_shard_size)
+        {
+            const auto &last = shard.paths.back();
+            shard.size -= GetSize(*last.second);
+            shard.index.erase(last.first);
+            shard.paths.pop_back();
+        }
+    }
+
+  private:
+    static constexpr std::size_t NUM_SHARDS = 64;
+    // estimate of the list node, index entry and allocations of a cached path
+    static constexpr std::size_t ENTRY_OVERHEAD = 128;
+
+    using Paths = std::list<std::pair<UnpackingKey, std::shared_ptr<const UnpackedSubpath>>>;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::size_t size = 0;
+        Paths paths;
+        std::unordered_map<UnpackingKey, Paths::iterator, UnpackingKeyHash> index;
+    };
+
+    static std::size_t GetSize(const UnpackedSubpath &path)
+    {
+        return ENTRY_OVERHEAD + path.nodes.size() * sizeof(NodeID) +
+               path.edges.size() * sizeof(EdgeID);
+    }
+
+    Shard &GetShard(const UnpackingKey &key)
+    {
+        // spreads the boundary nodes of popular cells over all shards
+        return shards[(key.source ^ key.target * 31) % NUM_SHARDS];
+    }
+
+    const std::size_t max_shard_size;
+    std::array<Shard, NUM_SHARDS> shards;
+    std::atomic<std::size_t> hits;
+    std::atomic<std::size_t> misses;
+};
+}
+}
+
+#endif
@@ -2,14 +2,19 @@
 #define EXTRACTOR_CALLBACKS_HPP
 
 #include "extractor/class_data.hpp"
+#include "extractor/first_and_last_segment_of_way.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
+#include "extractor/internal_extractor_edge.hpp"
+#include "extractor/query_node.hpp"
+#include "extractor/restriction.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/functional/hash.hpp>
-#include <boost/optional/optional_fwd.hpp>
+#include <boost/optional.hpp>
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace osmium
 {
@@ -42,7 +47,6 @@ namespace extractor
 {
 
 class ExtractionContainers;
-struct InputRestrictionContainer;
 struct ExtractionNode;
 struct ExtractionWay;
 struct ProfileProperties;
@@ -52,7 +56,11 @@ struct ProfileProperties;
  * osmium based parsing and the customization through the lua profile.
  *
  * It mediates between the multi-threaded extraction process and the external memory containers.
- * Thus the synchronization is handled inside of the extractor.
+ * Processing is split in two phases: the Prepare* functions do the expensive per-object work
+ * (edge creation, lane parsing, name hashing) and are safe to call concurrently, each thread
+ * writing to its own PreparedBuffer. MergeBuffer then assigns the global ids (names, lanes,
+ * classes) and appends the results to the external memory containers. Calling MergeBuffer in
+ * input order makes the output independent of the number of threads.
  */
 class ExtractorCallbacks
 {
@@ -61,7 +69,24 @@ class ExtractorCallbacks
     // actually maps to name ids
     using MapKey = std::tuple<std::string, std::string, std::string, std::string, std::string>;
     using MapVal = unsigned;
-    std::unordered_map<MapKey, MapVal> string_map;
+
+    // the hash of the key is computed in the parallel stage to keep the merge cheap
+    struct HashedMapKey
+    {
+        MapKey key;
+        std::size_t hash;
+
+        bool operator==(const HashedMapKey &other) const
+        {
+            return hash == other.hash && key == other.key;
+        }
+    };
+    struct HashedMapKeyHash
+    {
+        std::size_t operator()(const HashedMapKey &key) const noexcept { return key.hash; }
+    };
+
+    std::unordered_map<HashedMapKey, MapVal, HashedMapKeyHash> string_map;
     ExtractionContainers &external_memory;
     std::unordered_map<std::string, ClassData> &classes_map;
     guidance::LaneDescriptionMap &lane_description_map;
@@ -71,6 +96,34 @@ class ExtractorCallbacks
   public:
     using ClassesMap = std::unordered_map<std::string, ClassData>;
 
+    // Way data that still needs global ids, the edges of the way are stored in
+    // [edges_begin, edges_end) of the buffer with placeholder name, class and lane ids.
+    struct PreparedWay
+    {
+        HashedMapKey name_key;
+        // boost::none maps to INVALID_LANE_DESCRIPTIONID
+        boost::optional<guidance::TurnLaneDescription> forward_lanes;
+        boost::optional<guidance::TurnLaneDescription> backward_lanes;
+        std::vector<std::string> forward_classes;
+        std::vector<std::string> backward_classes;
+        std::size_t edges_begin;
+        std::size_t forward_edges_end;
+        std::size_t edges_end;
+    };
+
+    // Thread-local results of one input buffer
+    struct PreparedBuffer
+    {
+        std::vector<QueryNode> nodes;
+        std::vector<OSMNodeID> barrier_nodes;
+        std::vector<OSMNodeID> traffic_lights;
+        std::vector<PreparedWay> ways;
+        std::vector<InternalExtractorEdge> edges;
+        std::vector<OSMNodeID> used_node_ids;
+        std::vector<FirstAndLastSegmentOfWay> way_start_end_ids;
+        std::vector<InputRestrictionContainer> restrictions;
+    };
+
     explicit ExtractorCallbacks(ExtractionContainers &extraction_containers,
                                 std::unordered_map<std::string, ClassData> &classes_map,
                                 guidance::LaneDescriptionMap &lane_description_map,
@@ -79,14 +132,22 @@ class ExtractorCallbacks
     ExtractorCallbacks(const ExtractorCallbacks &) = delete;
     ExtractorCallbacks &operator=(const ExtractorCallbacks &) = delete;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessNode(const osmium::Node &current_node, const ExtractionNode &result_node);
+    // thread-safe as long as every thread uses its own buffer
+    void PrepareNode(const osmium::Node &current_node,
+                     const ExtractionNode &result_node,
+                     PreparedBuffer &buffer) const;
+
+    // thread-safe as long as every thread uses its own buffer
+    void PrepareRestriction(const boost::optional<InputRestrictionContainer> &restriction,
+                            PreparedBuffer &buffer) const;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessRestriction(const boost::optional<InputRestrictionContainer> &restriction);
+    // thread-safe as long as every thread uses its own buffer
+    void PrepareWay(const osmium::Way &current_way,
+                    const ExtractionWay &result_way,
+                    PreparedBuffer &buffer) const;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessWay(const osmium::Way &current_way, const ExtractionWay &result_way);
+    // warning: caller needs to take care of synchronization and ordering!
+    void MergeBuffer(PreparedBuffer &buffer);
 };
 }
 }
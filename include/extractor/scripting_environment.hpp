@@ -56,6 +56,8 @@ class ScriptingEnvironment
     virtual std::vector<std::string> GetRestrictions() = 0;
     virtual void SetupSources() = 0;
     virtual void ProcessTurn(ExtractionTurn &turn) = 0;
+    // Processes all turns that enter an intersection through the same road at once
+    virtual void ProcessTurns(std::vector<ExtractionTurn> &turns) = 0;
     virtual void ProcessSegment(ExtractionSegment &segment) = 0;
 
     virtual void ProcessElements(
@@ -64,6 +66,9 @@ class ScriptingEnvironment
         std::vector<std::pair<const osmium::Node &, ExtractionNode>> &resulting_nodes,
         std::vector<std::pair<const osmium::Way &, ExtractionWay>> &resulting_ways,
         std::vector<boost::optional<InputRestrictionContainer>> &resulting_restrictions) = 0;
+
+    // logs profile related statistics, e.g. cache usage
+    virtual void PrintStatistics() = 0;
 };
 }
 }
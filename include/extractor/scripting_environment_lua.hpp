@@ -1,6 +1,7 @@
 #ifndef SCRIPTING_ENVIRONMENT_LUA_HPP
 #define SCRIPTING_ENVIRONMENT_LUA_HPP
 
+#include "extractor/extraction_way.hpp"
 #include "extractor/raster_source.hpp"
 #include "extractor/scripting_environment.hpp"
 
@@ -9,6 +10,8 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <sol2/sol.hpp>
 
@@ -17,10 +20,28 @@ namespace osrm
 namespace extractor
 {
 
+// Bytecode of the profile and of the modules it requires. Every file is compiled once and
+// all contexts load the shared bytecode instead of parsing the sources again.
+class LuaBytecodeCache
+{
+  public:
+    // Compiles the file on first use, throws if it can not be loaded
+    const std::string &Get(lua_State *state, const std::string &file_name);
+
+  private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::string> bytecode;
+};
+
 struct LuaScriptingContext final
 {
+    // Upper bound of memoized way_function results per context
+    static const constexpr std::size_t MAX_WAY_CACHE_SIZE = 1 << 16;
+
     void ProcessNode(const osmium::Node &, ExtractionNode &result);
     void ProcessWay(const osmium::Way &, ExtractionWay &result);
+    void ProcessTurn(ExtractionTurn &turn);
+    void ProcessTurns(std::vector<ExtractionTurn> &turns);
 
     ProfileProperties properties;
     SourceContainer sources;
@@ -30,13 +51,31 @@ struct LuaScriptingContext final
     bool has_node_function;
     bool has_way_function;
     bool has_segment_function;
+    bool has_turn_batch_function;
 
     sol::function turn_function;
+    sol::function turn_batch_function;
     sol::function way_function;
     sol::function node_function;
     sol::function segment_function;
 
     int api_version;
+
+    // Reused argument of turn_batch_function, holds references to the turns of a batch
+    sol::table turn_batch;
+    std::size_t turn_batch_size = 0;
+
+    // Sorted tag keys returned by the optional get_way_cache_keys function.
+    // If not empty the way_function result is memoized by the values of these tags.
+    std::vector<std::string> way_cache_keys;
+    std::unordered_map<std::string, ExtractionWay> way_cache;
+    std::string way_cache_key;
+    std::vector<std::pair<const char *, const char *>> way_cache_tags;
+    std::size_t way_cache_hits = 0;
+    std::size_t way_cache_misses = 0;
+
+  private:
+    void BuildWayCacheKey(const osmium::Way &way);
 };
 
 /**
@@ -44,7 +83,7 @@ struct LuaScriptingContext final
  * ExtractionWay and ExtractionNode to lua objects.
  *
  * Each thread has its own lua state which is implemented with thread specific
- * storage from TBB.
+ * storage from TBB. The states load the profile from a shared bytecode cache.
  */
 class Sol2ScriptingEnvironment final : public ScriptingEnvironment
 {
@@ -63,7 +102,9 @@ class Sol2ScriptingEnvironment final : public ScriptingEnvironment
     std::vector<std::string> GetRestrictions() override;
     void SetupSources() override;
     void ProcessTurn(ExtractionTurn &turn) override;
+    void ProcessTurns(std::vector<ExtractionTurn> &turns) override;
     void ProcessSegment(ExtractionSegment &segment) override;
+    void PrintStatistics() override;
 
     void ProcessElements(
         const osmium::memory::Buffer &buffer,
@@ -76,6 +117,7 @@ class Sol2ScriptingEnvironment final : public ScriptingEnvironment
     void InitContext(LuaScriptingContext &context);
     std::mutex init_mutex;
     std::string file_name;
+    LuaBytecodeCache bytecode_cache;
     tbb::enumerable_thread_specific<std::unique_ptr<LuaScriptingContext>> script_contexts;
 };
 }
@@ -5,11 +5,14 @@
 
 #include <nan.h>
 
+#include <cstddef>
 #include <memory>
 
 namespace node_osrm
 {
 
+class WorkerPool;
+
 struct Engine final : public Nan::ObjectWrap
 {
     using Base = Nan::ObjectWrap;
@@ -25,13 +28,16 @@ struct Engine final : public Nan::ObjectWrap
     static NAN_METHOD(match);
     static NAN_METHOD(trip);
 
-    Engine(osrm::EngineConfig &config);
+    Engine(osrm::EngineConfig &config, const std::size_t num_threads);
 
     // Thread-safe singleton accessor
     static Nan::Persistent<v8::Function> &constructor();
 
     // Ref-counted OSRM alive even after shutdown until last callback is done
     std::shared_ptr<osrm::OSRM> this_;
+
+    // Runs the requests of this instance, kept alive by the queued requests as well
+    std::shared_ptr<WorkerPool> pool;
 };
 
 } // ns node_osrm
@@ -18,6 +18,8 @@
 #include "osrm/tile_parameters.hpp"
 #include "osrm/trip_parameters.hpp"
 
+#include "util/json_renderer.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
 
@@ -25,6 +27,8 @@
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include <exception>
@@ -42,20 +46,54 @@ using match_parameters_ptr = std::unique_ptr<osrm::MatchParameters>;
 using nearest_parameters_ptr = std::unique_ptr<osrm::NearestParameters>;
 using table_parameters_ptr = std::unique_ptr<osrm::TableParameters>;
 
-template <typename ResultT> inline v8::Local<v8::Value> render(const ResultT &result);
+// Options of a single request that are handled by the bindings and not by the engine
+struct PluginParameters
+{
+    // Returns the response as a Buffer of rendered JSON instead of JavaScript objects
+    bool render_json_buffer = false;
+};
+
+// Hands the memory of the container over to a Buffer without copying it
+template <typename ContainerT> inline v8::Local<v8::Value> renderToBuffer(ContainerT &&container)
+{
+    using Container = typename std::decay<ContainerT>::type;
+    auto *const owner = new Container(std::move(container));
+    return Nan::NewBuffer(const_cast<char *>(owner->data()),
+                          owner->size(),
+                          [](char *, void *hint) { delete static_cast<Container *>(hint); },
+                          owner)
+        .ToLocalChecked();
+}
+
+template <typename ResultT> inline v8::Local<v8::Value> render(ResultT &result);
 
-template <> v8::Local<v8::Value> inline render(const std::string &result)
+template <> v8::Local<v8::Value> inline render(std::string &result)
 {
-    return Nan::CopyBuffer(result.data(), result.size()).ToLocalChecked();
+    return renderToBuffer(std::move(result));
 }
 
-template <> v8::Local<v8::Value> inline render(const osrm::json::Object &result)
+template <> v8::Local<v8::Value> inline render(std::vector<char> &result)
+{
+    return renderToBuffer(std::move(result));
+}
+
+template <> v8::Local<v8::Value> inline render(osrm::json::Object &result)
 {
     v8::Local<v8::Value> value;
     renderToV8(value, result);
     return value;
 }
 
+// Renders JSON results on the worker thread, so the event loop only wraps the bytes
+inline void renderToJSON(std::vector<char> &out, osrm::json::Object &result)
+{
+    osrm::util::json::render(out, result);
+    result.values.clear();
+}
+
+// Tiles are binary and always returned as a Buffer
+inline void renderToJSON(std::vector<char> & /*out*/, const std::string & /*unused*/) {}
+
 inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &result)
 {
     const auto code_iter = result.values.find("code");
@@ -237,6 +275,73 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
     return engine_config;
 }
 
+// Reads the size of the worker pool from the constructor options, keeps the default otherwise
+inline bool argumentsToNumberOfThreads(const Nan::FunctionCallbackInfo<v8::Value> &args,
+                                       std::size_t &num_threads)
+{
+    Nan::HandleScope scope;
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (args.Length() != 1 || !args[0]->IsObject())
+        return true;
+
+    auto params = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+    auto threads = params->Get(Nan::New("threads").ToLocalChecked());
+    if (threads.IsEmpty())
+        return false;
+
+    if (threads->IsUndefined())
+        return true;
+
+    if (!threads->IsNumber() || threads->NumberValue() < 1)
+    {
+        Nan::ThrowError("threads must be a positive integral number");
+        return false;
+    }
+
+    num_threads = static_cast<std::size_t>(threads->NumberValue());
+    return true;
+}
+
+inline bool argumentsToPluginParameters(const Nan::FunctionCallbackInfo<v8::Value> &args,
+                                        PluginParameters &parameters)
+{
+    if (args.Length() < 2 || !args[0]->IsObject())
+        return true;
+
+    v8::Local<v8::Object> obj = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+    if (!obj->Has(Nan::New("format").ToLocalChecked()))
+        return true;
+
+    v8::Local<v8::Value> format = obj->Get(Nan::New("format").ToLocalChecked());
+    if (format.IsEmpty())
+        return false;
+
+    if (!format->IsString())
+    {
+        Nan::ThrowError("Format must be a string: [object, buffer]");
+        return false;
+    }
+
+    std::string format_str = *v8::String::Utf8Value(format);
+
+    if (format_str == "object")
+    {
+        parameters.render_json_buffer = false;
+    }
+    else if (format_str == "buffer")
+    {
+        parameters.render_json_buffer = true;
+    }
+    else
+    {
+        Nan::ThrowError("'format' param must be one of [object, buffer]");
+        return false;
+    }
+
+    return true;
+}
+
 inline boost::optional<std::vector<osrm::Coordinate>>
 parseCoordinateArray(const v8::Local<v8::Array> &coordinates_array)
 {
@@ -585,6 +690,37 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
         params->generate_hints = generate_hints->BooleanValue();
     }
 
+    if (obj->Has(Nan::New("metric").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> metric = obj->Get(Nan::New("metric").ToLocalChecked());
+        if (metric.IsEmpty())
+            return false;
+
+        if (!metric->IsString())
+        {
+            Nan::ThrowError("metric must be a string");
+            return false;
+        }
+
+        params->metric = *v8::String::Utf8Value(metric);
+    }
+
+    if (obj->Has(Nan::New("departure_time").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> departure_time =
+            obj->Get(Nan::New("departure_time").ToLocalChecked());
+        if (departure_time.IsEmpty())
+            return false;
+
+        if (!departure_time->IsNumber())
+        {
+            Nan::ThrowError("departure_time must be a number");
+            return false;
+        }
+
+        params->departure_time = static_cast<std::time_t>(departure_time->NumberValue());
+    }
+
     return true;
 }
 
@@ -1087,6 +1223,39 @@ argumentsToTripParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("solver").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> solver = obj->Get(Nan::New("solver").ToLocalChecked());
+        if (solver.IsEmpty())
+            return trip_parameters_ptr();
+
+        if (!solver->IsString())
+        {
+            Nan::ThrowError("Solver must be a string: [auto, exact, heuristic]");
+            return trip_parameters_ptr();
+        }
+
+        std::string solver_str = *v8::String::Utf8Value(solver);
+
+        if (solver_str == "auto")
+        {
+            params->solver = osrm::TripParameters::SolverType::Auto;
+        }
+        else if (solver_str == "exact")
+        {
+            params->solver = osrm::TripParameters::SolverType::Exact;
+        }
+        else if (solver_str == "heuristic")
+        {
+            params->solver = osrm::TripParameters::SolverType::Heuristic;
+        }
+        else
+        {
+            Nan::ThrowError("'solver' param must be one of [auto, exact, heuristic]");
+            return trip_parameters_ptr();
+        }
+    }
+
     return params;
 }
 
@@ -0,0 +1,138 @@
+#ifndef OSRM_BINDINGS_NODE_WORKER_POOL_HPP
+#define OSRM_BINDINGS_NODE_WORKER_POOL_HPP
+
+#include <nan.h>
+#include <uv.h>
+
+#include <boost/assert.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace node_osrm
+{
+
+// Runs Nan::AsyncWorkers on dedicated threads instead of the libuv thread pool, which is
+// shared with file system and dns requests and only has four threads by default. Completed
+// workers are handed back to the event loop through an uv_async_t handle.
+class WorkerPool final : public std::enable_shared_from_this<WorkerPool>
+{
+  public:
+    explicit WorkerPool(const std::size_t num_threads)
+        : completion_handle(new uv_async_t), num_queued(0), shutdown(false)
+    {
+        BOOST_ASSERT(num_threads > 0);
+
+        uv_async_init(uv_default_loop(), completion_handle, OnComplete);
+        completion_handle->data = this;
+        // an idle pool must not keep the process alive
+        uv_unref(reinterpret_cast<uv_handle_t *>(completion_handle));
+
+        threads.reserve(num_threads);
+        for (std::size_t index = 0; index < num_threads; ++index)
+            threads.emplace_back([this] { Run(); });
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shutdown = true;
+        }
+        pending_condition.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+
+        uv_close(reinterpret_cast<uv_handle_t *>(completion_handle),
+                 [](uv_handle_t *handle) { delete reinterpret_cast<uv_async_t *>(handle); });
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Needs to be called from the event loop thread. Takes ownership of the worker, which is
+    // destroyed after its callback was called on the event loop thread.
+    void Queue(Nan::AsyncWorker *worker)
+    {
+        if (num_queued++ == 0)
+            uv_ref(reinterpret_cast<uv_handle_t *>(completion_handle));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(worker);
+        }
+        pending_condition.notify_one();
+    }
+
+  private:
+    void Run()
+    {
+        while (true)
+        {
+            Nan::AsyncWorker *worker = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                pending_condition.wait(lock, [this] { return shutdown || !pending.empty(); });
+                if (pending.empty())
+                    return;
+                worker = pending.front();
+                pending.pop_front();
+            }
+
+            worker->Execute();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back(worker);
+            }
+            uv_async_send(completion_handle);
+        }
+    }
+
+    static void OnComplete(uv_async_t *handle)
+    {
+        // the last reference to the pool might be held by one of the completed workers
+        const auto pool = static_cast<WorkerPool *>(handle->data)->shared_from_this();
+        pool->Complete();
+    }
+
+    void Complete()
+    {
+        // uv_async_send calls are coalesced, so several workers might have completed
+        std::deque<Nan::AsyncWorker *> done;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.swap(completed);
+        }
+
+        for (auto *worker : done)
+        {
+            worker->WorkComplete();
+            worker->Destroy();
+        }
+
+        BOOST_ASSERT(num_queued >= done.size());
+        num_queued -= done.size();
+        if (num_queued == 0)
+            uv_unref(reinterpret_cast<uv_handle_t *>(completion_handle));
+    }
+
+    uv_async_t *completion_handle;
+    // only accessed from the event loop thread
+    std::size_t num_queued;
+
+    std::mutex mutex;
+    std::condition_variable pending_condition;
+    std::deque<Nan::AsyncWorker *> pending;
+    std::deque<Nan::AsyncWorker *> completed;
+    bool shutdown;
+    std::vector<std::thread> threads;
+};
+}
+
+#endif
@@ -31,6 +31,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
+#include "engine/api/base_result.hpp"
+
 #include <memory>
 #include <string>
 
@@ -85,6 +87,15 @@ class OSRM final
      */
     Status Route(const RouteParameters &parameters, json::Object &result) const;
 
+    /**
+     * Shortest path queries for coordinates, supports binary output formats.
+     *
+     * \param parameters route query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, RouteParameters and engine::api::ResultT
+     */
+    Status Route(const RouteParameters &parameters, engine::api::ResultT &result) const;
+
     /**
      * Distance tables for coordinates.
      *
@@ -94,6 +105,15 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result) const;
 
+    /**
+     * Distance tables for coordinates, supports binary output formats.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and engine::api::ResultT
+     */
+    Status Table(const TableParameters &parameters, engine::api::ResultT &result) const;
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -1,6 +1,8 @@
 #ifndef OSRM_CUSTOMIZE_CELL_STORAGE_HPP
 #define OSRM_CUSTOMIZE_CELL_STORAGE_HPP
 
+#include "customizer/cell_metric.hpp"
+
 #include "partition/multi_level_partition.hpp"
 
 #include "util/assert.hpp"
@@ -189,6 +191,109 @@ template <storage::Ownership Ownership> class CellStorageImpl
         }
     };
 
+    // Read-only view of a cell of a quantized metric, values are decoded on access
+    class QuantizedCell
+    {
+      private:
+        template <typename T> struct Matrix
+        {
+            const customizer::QuantizedCode *codes;
+            const customizer::QuantizedOutlier<T> *outliers_begin;
+            const customizer::QuantizedOutlier<T> *outliers_end;
+            T base;
+
+            template <storage::Ownership MetricOwnership>
+            Matrix(const customizer::detail::QuantizedValuesImpl<T, MetricOwnership> &values,
+                   std::size_t cell_index)
+                : codes{values.codes.data()}, outliers_begin{values.outliers.data()},
+                  outliers_end{values.outliers.data() + values.outliers.size()},
+                  base{values.bases[cell_index]}
+            {
+            }
+
+            auto MakeIterator(std::size_t index, std::size_t stride) const
+            {
+                return customizer::QuantizedValueIterator<T>{
+                    codes + index, stride, base, codes, outliers_begin, outliers_end};
+            }
+        };
+
+        BoundarySize num_source_nodes;
+        BoundarySize num_destination_nodes;
+        ValueOffset value_offset;
+
+        Matrix<EdgeWeight> weights;
+        Matrix<EdgeDuration> durations;
+        const NodeID *const source_boundary;
+        const NodeID *const destination_boundary;
+
+        template <typename T> auto GetOutRange(const Matrix<T> &matrix, const NodeID node) const
+        {
+            auto iter = std::find(source_boundary, source_boundary + num_source_nodes, node);
+            if (iter == source_boundary + num_source_nodes)
+                return boost::make_iterator_range(matrix.MakeIterator(value_offset, 1),
+                                                  matrix.MakeIterator(value_offset, 1));
+
+            auto row = std::distance(source_boundary, iter);
+            auto begin = value_offset + num_destination_nodes * row;
+            auto end = begin + num_destination_nodes;
+            return boost::make_iterator_range(matrix.MakeIterator(begin, 1),
+                                              matrix.MakeIterator(end, 1));
+        }
+
+        template <typename T> auto GetInRange(const Matrix<T> &matrix, const NodeID node) const
+        {
+            auto iter =
+                std::find(destination_boundary, destination_boundary + num_destination_nodes, node);
+            if (iter == destination_boundary + num_destination_nodes)
+                return boost::make_iterator_range(matrix.MakeIterator(value_offset, 1),
+                                                  matrix.MakeIterator(value_offset, 1));
+
+            auto column = std::distance(destination_boundary, iter);
+            auto begin = value_offset + column;
+            auto end = begin + num_source_nodes * num_destination_nodes;
+            return boost::make_iterator_range(matrix.MakeIterator(begin, num_destination_nodes),
+                                              matrix.MakeIterator(end, num_destination_nodes));
+        }
+
+      public:
+        auto GetOutWeight(NodeID node) const { return GetOutRange(weights, node); }
+
+        auto GetInWeight(NodeID node) const { return GetInRange(weights, node); }
+
+        auto GetOutDuration(NodeID node) const { return GetOutRange(durations, node); }
+
+        auto GetInDuration(NodeID node) const { return GetInRange(durations, node); }
+
+        auto GetSourceNodes() const
+        {
+            return boost::make_iterator_range(source_boundary, source_boundary + num_source_nodes);
+        }
+
+        auto GetDestinationNodes() const
+        {
+            return boost::make_iterator_range(destination_boundary,
+                                              destination_boundary + num_destination_nodes);
+        }
+
+        template <storage::Ownership MetricOwnership>
+        QuantizedCell(const CellData &data,
+                      const std::size_t cell_index,
+                      const customizer::detail::CellMetricImpl<MetricOwnership> &metric,
+                      const NodeID *const all_sources,
+                      const NodeID *const all_destinations)
+            : num_source_nodes{data.num_source_nodes},
+              num_destination_nodes{data.num_destination_nodes}, value_offset{data.value_offset},
+              weights{metric.quantized_weights, cell_index},
+              durations{metric.quantized_durations, cell_index},
+              source_boundary{all_sources + data.source_boundary_offset},
+              destination_boundary{all_destinations + data.destination_boundary_offset}
+        {
+            BOOST_ASSERT(num_source_nodes == 0 || all_sources != nullptr);
+            BOOST_ASSERT(num_destination_nodes == 0 || all_destinations != nullptr);
+        }
+    };
+
     std::size_t LevelIDToIndex(LevelID level) const { return level - 1; }
 
   public:
@@ -323,26 +428,47 @@ template <storage::Ownership Ownership> class CellStorageImpl
             cell.value_offset = value_offset;
             value_offset += cell.num_source_nodes * cell.num_destination_nodes;
         }
-
-        weights.resize(value_offset + 1, INVALID_EDGE_WEIGHT);
-        durations.resize(value_offset + 1, MAXIMAL_EDGE_DURATION);
     }
 
     template <typename = std::enable_if<Ownership == storage::Ownership::View>>
-    CellStorageImpl(Vector<EdgeWeight> weights_,
-                    Vector<EdgeDuration> durations_,
-                    Vector<NodeID> source_boundary_,
+    CellStorageImpl(Vector<NodeID> source_boundary_,
                     Vector<NodeID> destination_boundary_,
                     Vector<CellData> cells_,
                     Vector<std::uint64_t> level_to_cell_offset_)
-        : weights(std::move(weights_)), durations(std::move(durations_)),
-          source_boundary(std::move(source_boundary_)),
+        : source_boundary(std::move(source_boundary_)),
           destination_boundary(std::move(destination_boundary_)), cells(std::move(cells_)),
           level_to_cell_offset(std::move(level_to_cell_offset_))
     {
     }
 
-    ConstCell GetCell(LevelID level, CellID id) const
+    // Number of weight (and duration) values a metric on this topology needs
+    std::size_t GetNumberOfValues() const
+    {
+        if (cells.empty())
+            return 0;
+
+        const auto &last_cell = cells.back();
+        return last_cell.value_offset +
+               last_cell.num_source_nodes * last_cell.num_destination_nodes;
+    }
+
+    // Allocates an uncustomized metric matching this cell topology
+    customizer::CellMetric MakeMetric(const customizer::MetricSource source) const
+    {
+        // the extra value keeps the data pointer valid for cells without boundary nodes
+        const auto number_of_values = GetNumberOfValues() + 1;
+
+        customizer::CellMetric metric;
+        metric.source = source;
+        metric.weights.resize(number_of_values, INVALID_EDGE_WEIGHT);
+        metric.durations.resize(number_of_values, MAXIMAL_EDGE_DURATION);
+        return metric;
+    }
+
+    template <storage::Ownership MetricOwnership>
+    ConstCell GetCell(const customizer::detail::CellMetricImpl<MetricOwnership> &metric,
+                      LevelID level,
+                      CellID id) const
     {
         const auto level_index = LevelIDToIndex(level);
         BOOST_ASSERT(level_index < level_to_cell_offset.size());
@@ -350,14 +476,52 @@ template <storage::Ownership Ownership> class CellStorageImpl
         const auto cell_index = offset + id;
         BOOST_ASSERT(cell_index < cells.size());
         return ConstCell{cells[cell_index],
-                         weights.data(),
-                         durations.data(),
+                         metric.weights.data(),
+                         metric.durations.data(),
                          source_boundary.empty() ? nullptr : source_boundary.data(),
                          destination_boundary.empty() ? nullptr : destination_boundary.data()};
     }
 
-    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
-    Cell GetCell(LevelID level, CellID id)
+    // Replaces the values of a customized metric by their quantized representation
+    void QuantizeMetric(customizer::CellMetric &metric) const
+    {
+        BOOST_ASSERT(!metric.IsQuantized());
+
+        std::vector<std::uint32_t> offsets;
+        offsets.reserve(cells.size() + 1);
+        for (const auto &cell : cells)
+            offsets.push_back(cell.value_offset);
+        offsets.push_back(GetNumberOfValues());
+
+        metric.quantized_weights = customizer::quantizeValues(metric.weights, offsets);
+        metric.quantized_durations = customizer::quantizeValues(metric.durations, offsets);
+
+        metric.weights.clear();
+        metric.weights.shrink_to_fit();
+        metric.durations.clear();
+        metric.durations.shrink_to_fit();
+    }
+
+    template <storage::Ownership MetricOwnership>
+    QuantizedCell
+    GetQuantizedCell(const customizer::detail::CellMetricImpl<MetricOwnership> &metric,
+                     LevelID level,
+                     CellID id) const
+    {
+        BOOST_ASSERT(metric.IsQuantized());
+        const auto level_index = LevelIDToIndex(level);
+        BOOST_ASSERT(level_index < level_to_cell_offset.size());
+        const auto offset = level_to_cell_offset[level_index];
+        const auto cell_index = offset + id;
+        BOOST_ASSERT(cell_index < cells.size());
+        return QuantizedCell{cells[cell_index],
+                             cell_index,
+                             metric,
+                             source_boundary.empty() ? nullptr : source_boundary.data(),
+                             destination_boundary.empty() ? nullptr : destination_boundary.data()};
+    }
+
+    Cell GetCell(customizer::CellMetric &metric, LevelID level, CellID id) const
     {
         const auto level_index = LevelIDToIndex(level);
         BOOST_ASSERT(level_index < level_to_cell_offset.size());
@@ -365,8 +529,8 @@ template <storage::Ownership Ownership> class CellStorageImpl
         const auto cell_index = offset + id;
         BOOST_ASSERT(cell_index < cells.size());
         return Cell{cells[cell_index],
-                    weights.data(),
-                    durations.data(),
+                    metric.weights.data(),
+                    metric.durations.data(),
                     source_boundary.data(),
                     destination_boundary.data()};
     }
@@ -377,8 +541,6 @@ template <storage::Ownership Ownership> class CellStorageImpl
                                                 const detail::CellStorageImpl<Ownership> &storage);
 
   private:
-    Vector<EdgeWeight> weights;
-    Vector<EdgeDuration> durations;
     Vector<NodeID> source_boundary;
     Vector<NodeID> destination_boundary;
     Vector<CellData> cells;
@@ -38,6 +38,10 @@ struct TripParametersGrammar final : public RouteParametersGrammar<Iterator, Sig
         destination_type.add("any", engine::api::TripParameters::DestinationType::Any)(
             "last", engine::api::TripParameters::DestinationType::Last);
 
+        solver_type.add("auto", engine::api::TripParameters::SolverType::Auto)(
+            "exact", engine::api::TripParameters::SolverType::Exact)(
+            "heuristic", engine::api::TripParameters::SolverType::Heuristic);
+
         source_rule = qi::lit("source=") >
                       source_type[ph::bind(&engine::api::TripParameters::source, qi::_r1) = qi::_1];
 
@@ -45,9 +49,13 @@ struct TripParametersGrammar final : public RouteParametersGrammar<Iterator, Sig
             qi::lit("destination=") >
             destination_type[ph::bind(&engine::api::TripParameters::destination, qi::_r1) = qi::_1];
 
+        solver_rule = qi::lit("solver=") >
+                      solver_type[ph::bind(&engine::api::TripParameters::solver, qi::_r1) = qi::_1];
+
         root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (roundtrip_rule(qi::_r1) | source_rule(qi::_r1) |
-                             destination_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) %
+                             destination_rule(qi::_r1) | solver_rule(qi::_r1) |
+                             BaseGrammar::base_rule(qi::_r1)) %
                                 '&');
     }
 
@@ -55,10 +63,12 @@ struct TripParametersGrammar final : public RouteParametersGrammar<Iterator, Sig
     qi::rule<Iterator, Signature> source_rule;
     qi::rule<Iterator, Signature> destination_rule;
     qi::rule<Iterator, Signature> roundtrip_rule;
+    qi::rule<Iterator, Signature> solver_rule;
     qi::rule<Iterator, Signature> root_rule;
 
     qi::symbols<char, engine::api::TripParameters::SourceType> source_type;
     qi::symbols<char, engine::api::TripParameters::DestinationType> destination_type;
+    qi::symbols<char, engine::api::TripParameters::SolverType> solver_type;
 };
 }
 }
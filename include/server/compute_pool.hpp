@@ -0,0 +1,214 @@
+#ifndef OSRM_SERVER_COMPUTE_POOL_HPP
+#define OSRM_SERVER_COMPUTE_POOL_HPP
+
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace osrm
+{
+namespace server
+{
+
+// Fixed set of threads that run the plugins of the requests, separate from the threads that
+// read and write the connections.
+//
+// Every thread has its own queue, submitted tasks are distributed round-robin over the queues.
+// A thread takes the oldest task of its own queue and steals the newest task of another queue
+// when its own queue is empty, so one long query does not hold up the requests queued behind it.
+// The threads live as long as the server, which keeps their thread-local search heaps warm.
+class ComputePool
+{
+  public:
+    using Task = std::function<void()>;
+
+    struct Stats
+    {
+        std::uint64_t executed = 0;
+        std::uint64_t stolen = 0;
+        std::size_t queued = 0;
+    };
+
+    // Pins thread i to core i modulo the number of cores if pin_threads is set (Linux only)
+    ComputePool(const std::size_t num_threads, const bool pin_threads)
+        : next_queue(0), num_pending(0), shutdown(false)
+    {
+        BOOST_ASSERT(num_threads > 0);
+
+        for (std::size_t index = 0; index < num_threads; ++index)
+            queues.push_back(std::make_unique<Queue>());
+
+        threads.reserve(num_threads);
+        for (std::size_t index = 0; index < num_threads; ++index)
+        {
+            threads.emplace_back([this, index] { Run(index); });
+            if (pin_threads)
+                Pin(threads.back(), index);
+        }
+    }
+
+    ~ComputePool() { Stop(); }
+
+    ComputePool(const ComputePool &) = delete;
+    ComputePool &operator=(const ComputePool &) = delete;
+
+    void Submit(Task task)
+    {
+        auto &queue = *queues[next_queue++ % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            ++num_pending;
+        }
+        idle_condition.notify_one();
+    }
+
+    // Waits for the running tasks, tasks that did not start yet are dropped
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            if (shutdown)
+                return;
+            shutdown = true;
+        }
+        idle_condition.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+
+        const auto stats = GetStats();
+        util::Log() << "compute pool: " << stats.executed << " tasks on " << threads.size()
+                    << " threads, " << stats.stolen << " stolen";
+    }
+
+    std::size_t GetNumberOfThreads() const { return threads.size(); }
+
+    Stats GetStats() const
+    {
+        Stats stats;
+        for (const auto &queue : queues)
+        {
+            stats.executed += queue->executed;
+            stats.stolen += queue->stolen;
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            stats.queued += queue->tasks.size();
+        }
+        return stats;
+    }
+
+  private:
+    struct Queue
+    {
+        mutable std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> stolen{0};
+    };
+
+    bool Pop(const std::size_t index, Task &task)
+    {
+        auto &own = *queues[index];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        for (std::size_t offset = 1; offset < queues.size(); ++offset)
+        {
+            auto &other = *queues[(index + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.tasks.empty())
+            {
+                task = std::move(other.tasks.back());
+                other.tasks.pop_back();
+                ++own.stolen;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Run(const std::size_t index)
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(idle_mutex);
+                idle_condition.wait(lock, [this] { return shutdown || num_pending > 0; });
+                if (shutdown)
+                    return;
+            }
+
+            Task task;
+            if (!Pop(index, task))
+                continue;
+            --num_pending;
+
+            try
+            {
+                task();
+            }
+            catch (const std::exception &e)
+            {
+                util::Log(logWARNING) << "[exception] " << e.what();
+            }
+            ++queues[index]->executed;
+        }
+    }
+
+    static void Pin(std::thread &thread, const std::size_t index)
+    {
+#ifdef __linux__
+        const auto num_cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % num_cores, &cpus);
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) != 0)
+            util::Log(logWARNING) << "could not pin compute thread " << index;
+#else
+        (void)thread;
+        (void)index;
+#endif
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<std::size_t> next_queue;
+    // can be negative for a moment when a task is taken before it was counted
+    std::atomic<std::int64_t> num_pending;
+
+    std::mutex idle_mutex;
+    std::condition_variable idle_condition;
+    bool shutdown;
+    std::vector<std::thread> threads;
+};
+}
+}
+
+#endif
@@ -32,12 +32,15 @@ namespace server
 {
 
 class RequestHandler;
+class ComputePool;
 
 /// Represents a single connection from a client.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        ComputePool &compute_pool);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -49,6 +52,12 @@ class Connection : public std::enable_shared_from_this<Connection>
   private:
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Runs the plugin and compresses the reply, called on a thread of the compute pool.
+    void handle_request(const http::compression_type compression_type);
+
+    /// Writes the reply, called on the I/O thread of the connection.
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
@@ -58,6 +67,7 @@ class Connection : public std::enable_shared_from_this<Connection>
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
     RequestHandler &request_handler;
+    ComputePool &compute_pool;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
     http::request current_request;
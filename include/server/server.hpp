@@ -1,6 +1,7 @@
 #ifndef SERVER_HPP
 #define SERVER_HPP
 
+#include "server/compute_pool.hpp"
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
@@ -33,48 +34,94 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned requested_io_threads = 1,
+                                                bool pin_threads = false,
+                                                bool reuse_port = false)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        const unsigned real_io_threads =
+            requested_io_threads == 0 ? hardware_threads
+                                      : std::min(hardware_threads, requested_io_threads);
+        return std::make_shared<Server>(
+            ip_address, ip_port, real_num_threads, real_io_threads, pin_threads, reuse_port);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    // The connections are served by io_threads threads with an io_service each, the plugins
+    // run on a separate pool of compute_threads threads.
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned compute_threads,
+                    const unsigned io_threads = 1,
+                    const bool pin_threads = false,
+                    const bool reuse_port = false)
+        : compute_pool(std::max(1u, compute_threads), pin_threads)
     {
+        const auto num_io_services = std::max(1u, io_threads);
+        for (unsigned index = 0; index < num_io_services; ++index)
+        {
+            io_services.push_back(std::make_unique<boost::asio::io_service>());
+            // keeps the io_services without an acceptor running until Stop()
+            io_service_work.push_back(
+                std::make_unique<boost::asio::io_service::work>(*io_services.back()));
+        }
+
         const auto port_string = std::to_string(port);
 
-        boost::asio::ip::tcp::resolver resolver(io_service);
+        boost::asio::ip::tcp::resolver resolver(*io_services.front());
         boost::asio::ip::tcp::resolver::query query(address, port_string);
         boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
 
-        acceptor.open(endpoint.protocol());
+        // With reuse_port every io_service accepts on its own SO_REUSEPORT socket and the kernel
+        // spreads the connections. Otherwise a single acceptor hands them out round-robin.
+        // SO_REUSEPORT also lets other processes bind the port, so it has to be asked for.
+#ifdef SO_REUSEPORT
+        const auto num_acceptors = reuse_port ? num_io_services : 1u;
+#else
+        if (reuse_port)
+            util::Log(logWARNING) << "SO_REUSEPORT is not supported, using a single acceptor";
+        const auto num_acceptors = 1u;
+#endif
+        for (unsigned index = 0; index < num_acceptors; ++index)
+        {
+            auto acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(*io_services[index]);
+            acceptor->open(endpoint.protocol());
 #ifdef SO_REUSEPORT
-        const int option = 1;
-        setsockopt(acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
+            if (reuse_port)
+            {
+                const int option = 1;
+                setsockopt(
+                    acceptor->native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
+            }
 #endif
-        acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor.bind(endpoint);
-        acceptor.listen();
+            acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            acceptor->bind(endpoint);
+            acceptor->listen();
+            // all acceptors share the port the first one got
+            endpoint = acceptor->local_endpoint();
+            acceptors.push_back(std::move(acceptor));
+        }
 
-        util::Log() << "Listening on: " << acceptor.local_endpoint();
+        util::Log() << "Listening on: " << endpoint;
+        util::Log() << "I/O threads: " << num_io_services
+                    << ", compute threads: " << compute_pool.GetNumberOfThreads();
 
-        acceptor.async_accept(
-            new_connection->socket(),
-            boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+        new_connections.resize(acceptors.size());
+        for (std::size_t index = 0; index < acceptors.size(); ++index)
+            Accept(index);
     }
 
     void Run()
     {
         std::vector<std::shared_ptr<std::thread>> threads;
-        for (unsigned i = 0; i < thread_pool_size; ++i)
+        for (auto &io_service : io_services)
         {
             std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
+                boost::bind(&boost::asio::io_service::run, io_service.get()));
             threads.push_back(thread);
         }
         for (auto thread : threads)
@@ -83,7 +130,13 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        io_service_work.clear();
+        for (auto &io_service : io_services)
+            io_service->stop();
+        compute_pool.Stop();
+    }
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler_)
     {
@@ -91,23 +144,39 @@ class Server
     }
 
   private:
-    void HandleAccept(const boost::system::error_code &e)
+    void Accept(const std::size_t index)
+    {
+        // connections of the single acceptor are spread over all io_services
+        auto &io_service =
+            acceptors.size() == io_services.size()
+                ? *io_services[index]
+                : *io_services[next_io_service++ % io_services.size()];
+        new_connections[index] =
+            std::make_shared<Connection>(io_service, request_handler, compute_pool);
+        acceptors[index]->async_accept(new_connections[index]->socket(),
+                                       boost::bind(&Server::HandleAccept,
+                                                   this,
+                                                   index,
+                                                   boost::asio::placeholders::error));
+    }
+
+    void HandleAccept(const std::size_t index, const boost::system::error_code &e)
     {
         if (!e)
         {
-            new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
-            acceptor.async_accept(
-                new_connection->socket(),
-                boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+            new_connections[index]->start();
+            Accept(index);
         }
     }
 
-    unsigned thread_pool_size;
-    boost::asio::io_service io_service;
-    boost::asio::ip::tcp::acceptor acceptor;
-    std::shared_ptr<Connection> new_connection;
+    std::vector<std::unique_ptr<boost::asio::io_service>> io_services;
+    std::vector<std::unique_ptr<boost::asio::io_service::work>> io_service_work;
+    std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> acceptors;
+    std::vector<std::shared_ptr<Connection>> new_connections;
+    std::size_t next_io_service = 0;
     RequestHandler request_handler;
+    // declared last so its threads are stopped before the handler is destroyed
+    ComputePool compute_pool;
 };
 }
 }
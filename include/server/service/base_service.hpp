@@ -1,12 +1,11 @@
 #ifndef SERVER_SERVICE_BASE_SERVICE_HPP
 #define SERVER_SERVICE_BASE_SERVICE_HPP
 
+#include "engine/api/base_result.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/coordinate.hpp"
 
-#include <mapbox/variant.hpp>
-
 #include <string>
 #include <vector>
 
@@ -20,7 +19,7 @@ namespace service
 class BaseService
 {
   public:
-    using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+    using ResultT = engine::api::ResultT;
 
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
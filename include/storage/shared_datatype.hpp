@@ -61,15 +61,30 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "MLD_LEVEL_DATA",
                                             "MLD_PARTITION",
                                             "MLD_CELL_TO_CHILDREN",
+                                            "MLD_CELL_METRICS",
+                                            "MLD_CELL_METRIC_TIME_SLICES",
                                             "MLD_CELL_WEIGHTS",
                                             "MLD_CELL_DURATIONS",
+                                            "MLD_CELL_WEIGHT_BASES",
+                                            "MLD_CELL_DURATION_BASES",
+                                            "MLD_CELL_WEIGHT_CODES",
+                                            "MLD_CELL_DURATION_CODES",
+                                            "MLD_CELL_WEIGHT_OUTLIERS",
+                                            "MLD_CELL_DURATION_OUTLIERS",
                                             "MLD_CELL_SOURCE_BOUNDARY",
                                             "MLD_CELL_DESTINATION_BOUNDARY",
                                             "MLD_CELLS",
                                             "MLD_CELL_LEVEL_OFFSETS",
                                             "MLD_GRAPH_NODE_LIST",
                                             "MLD_GRAPH_EDGE_LIST",
-                                            "MLD_GRAPH_NODE_TO_OFFSET"};
+                                            "MLD_GRAPH_NODE_TO_OFFSET",
+                                            "MLD_CONDITIONAL_TURNS",
+                                            "MLD_CONDITIONAL_TURN_OFFSETS",
+                                            "MLD_CONDITIONAL_INTERVALS",
+                                            "MLD_CONDITIONAL_INTERVAL_OFFSETS",
+                                            "MLD_SPEED_PROFILE_POINTS",
+                                            "MLD_SPEED_PROFILE_OFFSETS",
+                                            "MLD_NODE_SPEED_PROFILES"};
 
 struct DataLayout
 {
@@ -118,8 +133,16 @@ struct DataLayout
         MLD_LEVEL_DATA,
         MLD_PARTITION,
         MLD_CELL_TO_CHILDREN,
+        MLD_CELL_METRICS,
+        MLD_CELL_METRIC_TIME_SLICES,
         MLD_CELL_WEIGHTS,
         MLD_CELL_DURATIONS,
+        MLD_CELL_WEIGHT_BASES,
+        MLD_CELL_DURATION_BASES,
+        MLD_CELL_WEIGHT_CODES,
+        MLD_CELL_DURATION_CODES,
+        MLD_CELL_WEIGHT_OUTLIERS,
+        MLD_CELL_DURATION_OUTLIERS,
         MLD_CELL_SOURCE_BOUNDARY,
         MLD_CELL_DESTINATION_BOUNDARY,
         MLD_CELLS,
@@ -127,6 +150,13 @@ struct DataLayout
         MLD_GRAPH_NODE_LIST,
         MLD_GRAPH_EDGE_LIST,
         MLD_GRAPH_NODE_TO_OFFSET,
+        MLD_CONDITIONAL_TURNS,
+        MLD_CONDITIONAL_TURN_OFFSETS,
+        MLD_CONDITIONAL_INTERVALS,
+        MLD_CONDITIONAL_INTERVAL_OFFSETS,
+        MLD_SPEED_PROFILE_POINTS,
+        MLD_SPEED_PROFILE_OFFSETS,
+        MLD_NODE_SPEED_PROFILES,
         NUM_BLOCKS
     };
 
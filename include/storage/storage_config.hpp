@@ -72,7 +72,10 @@ struct StorageConfig final
     boost::filesystem::path turn_lane_description_path;
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
+    boost::filesystem::path mld_cell_metrics_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path mld_conditional_turns_path;
+    boost::filesystem::path mld_speed_profiles_path;
 };
 }
 }
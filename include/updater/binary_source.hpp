@@ -0,0 +1,83 @@
+#ifndef OSRM_UPDATER_BINARY_SOURCE_HPP
+#define OSRM_UPDATER_BINARY_SOURCE_HPP
+
+#include "updater/source.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+// Binary snapshots of segment speeds and turn penalties, written by osrm-traffic-convert.
+//
+// A snapshot is a header followed by a flat array of records sorted by key without
+// duplicated keys, in native byte order like all other OSRM files. The records can be used
+// directly from a memory mapped file and need no parsing.
+namespace binary
+{
+
+const constexpr char SNAPSHOT_MAGIC[8] = {'O', 'S', 'R', 'M', 'T', 'R', 'F', 'C'};
+// Bumped on every incompatible change of the header or record layouts
+const constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+enum class SnapshotType : std::uint32_t
+{
+    SegmentSpeeds = 1,
+    TurnPenalties = 2
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    SnapshotType type;
+    std::uint64_t number_of_records;
+};
+static_assert(sizeof(SnapshotHeader) == 24, "header layout is part of the file format");
+
+struct SegmentSpeedRecord
+{
+    std::uint64_t from;
+    std::uint64_t to;
+    // NaN if the weight should be computed from the speed
+    double rate;
+    std::uint32_t speed;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(SegmentSpeedRecord) == 32, "record layout is part of the file format");
+
+struct TurnPenaltyRecord
+{
+    std::uint64_t from;
+    std::uint64_t via;
+    std::uint64_t to;
+    double duration;
+    // NaN if the weight should be computed from the duration
+    double weight;
+};
+static_assert(sizeof(TurnPenaltyRecord) == 40, "record layout is part of the file format");
+
+// Checks the magic bytes at the beginning of the file
+bool isSnapshotFile(const std::string &path);
+
+// Return the values of a snapshot with the given source index
+std::vector<std::pair<Segment, SpeedSource>> readSegmentValues(const std::string &path,
+                                                               const std::size_t source);
+std::vector<std::pair<Turn, PenaltySource>> readTurnValues(const std::string &path,
+                                                           const std::size_t source);
+
+// The values need to be sorted by key without duplicates
+void writeSegmentValues(const std::string &path,
+                        const std::vector<std::pair<Segment, SpeedSource>> &values);
+void writeTurnValues(const std::string &path,
+                     const std::vector<std::pair<Turn, PenaltySource>> &values);
+}
+}
+}
+
+#endif
@@ -7,9 +7,6 @@
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
 
-#include <tbb/parallel_for.h>
-#include <tbb/spin_mutex.h>
-
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
@@ -23,66 +20,28 @@ namespace osrm
 namespace updater
 {
 
-// Functor to parse a list of CSV files using "key,value,comment" grammar.
+// Functor to parse a CSV file using "key,value,comment" grammar.
 // Key and Value structures must be a model of Random Access Sequence.
 // Also the Value structure must have source member that will be filled
-// with the corresponding file index in the CSV filenames vector.
+// with the given file index.
 template <typename Key, typename Value> struct CSVFilesParser
 {
     using Iterator = boost::iostreams::mapped_file_source::iterator;
     using KeyRule = boost::spirit::qi::rule<Iterator, Key()>;
     using ValueRule = boost::spirit::qi::rule<Iterator, Value()>;
 
-    CSVFilesParser(std::size_t start_index, const KeyRule &key_rule, const ValueRule &value_rule)
-        : start_index(start_index), key_rule(key_rule), value_rule(value_rule)
+    CSVFilesParser(const KeyRule &key_rule, const ValueRule &value_rule)
+        : key_rule(key_rule), value_rule(value_rule)
     {
     }
 
-    // Operator returns a lambda function that maps input Key to boost::optional<Value>.
-    auto operator()(const std::vector<std::string> &csv_filenames) const
+    // Operator returns the values of the file sorted by key. For duplicated keys
+    // only the value with the largest line number is kept.
+    auto operator()(const std::string &csv_filename, const std::size_t file_id) const
     {
-        try
-        {
-            tbb::spin_mutex mutex;
-            std::vector<std::pair<Key, Value>> lookup;
-            tbb::parallel_for(std::size_t{0},
-                              csv_filenames.size(),
-                              [&](const std::size_t idx) {
-                                  auto local = ParseCSVFile(csv_filenames[idx], start_index + idx);
-
-                                  { // Merge local CSV results into a flat global vector
-                                      tbb::spin_mutex::scoped_lock _{mutex};
-                                      lookup.insert(end(lookup),
-                                                    std::make_move_iterator(begin(local)),
-                                                    std::make_move_iterator(end(local)));
-                                  }
-                              });
-
-            // With flattened map-ish view of all the files, make a stable sort on key and source
-            // and unique them on key to keep only the value with the largest file index
-            // and the largest line number in a file.
-            // The operands order is swapped to make descending ordering on (key, source)
-            std::stable_sort(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                return rhs.first < lhs.first ||
-                       (rhs.first == lhs.first && rhs.second.source < lhs.second.source);
-            });
-
-            // Unique only on key to take the source precedence into account and remove duplicates.
-            const auto it =
-                std::unique(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                    return lhs.first == rhs.first;
-                });
-            lookup.erase(it, end(lookup));
-
-            util::Log() << "In total loaded " << csv_filenames.size() << " file(s) with a total of "
-                        << lookup.size() << " unique values";
-
-            return LookupTable<Key, Value>{lookup};
-        }
-        catch (const tbb::captured_exception &e)
-        {
-            throw util::exception(e.what() + SOURCE_REF);
-        }
+        auto values = ParseCSVFile(csv_filename, file_id);
+        sortUniqueValues(values);
+        return values;
     }
 
   private:
@@ -131,7 +90,6 @@ template <typename Key, typename Value> struct CSVFilesParser
         }
     }
 
-    const std::size_t start_index;
     const KeyRule key_rule;
     const ValueRule value_rule;
 };
@@ -3,14 +3,24 @@
 
 #include "updater/source.hpp"
 
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace osrm
 {
 namespace updater
 {
 namespace csv
 {
-SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths);
-TurnLookupTable readTurnValues(const std::vector<std::string> &paths);
+// Return the values of a file sorted by key with the given source index
+std::vector<std::pair<Segment, SpeedSource>> readSegmentValues(const std::string &path,
+                                                               const std::size_t source);
+std::vector<std::pair<Turn, PenaltySource>> readTurnValues(const std::string &path,
+                                                           const std::size_t source);
+std::vector<std::pair<Segment, SpeedProfileSource>>
+readSpeedProfileValues(const std::string &path, const std::size_t source);
 }
 }
 }
@@ -5,6 +5,12 @@
 
 #include <boost/optional.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -12,6 +18,7 @@ namespace osrm
 namespace updater
 {
 
+// Values sorted by key in ascending order without duplicated keys
 template <typename Key, typename Value> struct LookupTable
 {
     boost::optional<Value> operator()(const Key &key) const
@@ -19,9 +26,9 @@ template <typename Key, typename Value> struct LookupTable
         using Result = boost::optional<Value>;
         const auto it = std::lower_bound(
             lookup.begin(), lookup.end(), key, [](const auto &lhs, const auto &rhs) {
-                return rhs < lhs.first;
+                return lhs.first < rhs;
             });
-        return it != std::end(lookup) && !(it->first < key) ? Result(it->second) : Result();
+        return it != std::end(lookup) && !(key < it->first) ? Result(it->second) : Result();
     }
 
     std::vector<std::pair<Key, Value>> lookup;
@@ -86,8 +93,82 @@ struct PenaltySource final
     std::uint8_t source;
 };
 
+// Speeds in km/h sampled at evenly spaced times over the day, starting at midnight UTC
+struct SpeedProfileSource final
+{
+    std::vector<unsigned> speeds;
+    std::uint8_t source;
+};
+
 using SegmentLookupTable = LookupTable<Segment, SpeedSource>;
 using TurnLookupTable = LookupTable<Turn, PenaltySource>;
+using SpeedProfileLookupTable = LookupTable<Segment, SpeedProfileSource>;
+
+// Sorts the values of a single source by key, for duplicated keys the value read last is kept
+template <typename Key, typename Value>
+void sortUniqueValues(std::vector<std::pair<Key, Value>> &values)
+{
+    std::stable_sort(begin(values), end(values), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    auto output = begin(values);
+    for (auto current = begin(values); current != end(values); ++current)
+    {
+        const auto next = std::next(current);
+        if (next != end(values) && !(current->first < next->first))
+            continue;
+        if (output != current)
+            *output = std::move(*current);
+        ++output;
+    }
+    values.erase(output, end(values));
+}
+
+// Merges the sorted values of all sources into one lookup table. The sources are ordered by
+// precedence, for equal keys the value of the later source is kept.
+template <typename Key, typename Value>
+LookupTable<Key, Value> mergeValues(std::vector<std::vector<std::pair<Key, Value>>> sources)
+{
+    std::vector<std::pair<Key, Value>> lookup;
+    for (auto &values : sources)
+    {
+        if (lookup.empty())
+        {
+            lookup = std::move(values);
+            continue;
+        }
+
+        std::vector<std::pair<Key, Value>> merged;
+        merged.reserve(lookup.size() + values.size());
+        auto lhs = begin(lookup);
+        auto rhs = begin(values);
+        while (lhs != end(lookup) && rhs != end(values))
+        {
+            if (lhs->first < rhs->first)
+            {
+                merged.push_back(*lhs++);
+            }
+            else
+            {
+                if (!(rhs->first < lhs->first))
+                    ++lhs;
+                merged.push_back(*rhs++);
+            }
+        }
+        merged.insert(end(merged), lhs, end(lookup));
+        merged.insert(end(merged), rhs, end(values));
+        lookup = std::move(merged);
+    }
+
+    return LookupTable<Key, Value>{std::move(lookup)};
+}
+
+// Reads CSV or binary lookup files, the file index is stored as source of each value
+SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths);
+TurnLookupTable readTurnValues(const std::vector<std::string> &paths);
+// Speed profiles can only be read from CSV files
+SpeedProfileLookupTable readSpeedProfileValues(const std::vector<std::string> &paths);
 }
 }
 
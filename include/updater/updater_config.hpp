@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <chrono>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -55,6 +56,10 @@ struct UpdaterConfig final
         datasource_names_path = osrm_input_path.string() + ".datasource_names";
         profile_properties_path = osrm_input_path.string() + ".properties";
         turn_restrictions_path = osrm_input_path.string() + ".restrictions";
+        applied_state_path = osrm_input_path.string() + ".traffic_state";
+        changed_nodes_path = osrm_input_path.string() + ".changed_nodes";
+        conditional_turns_path = osrm_input_path.string() + ".conditional_turns";
+        speed_profiles_path = osrm_input_path.string() + ".speed_profiles";
     }
 
     boost::filesystem::path osrm_input_path;
@@ -79,6 +84,23 @@ struct UpdaterConfig final
     std::string profile_properties_path;
     std::string turn_restrictions_path;
     std::string tz_file_path;
+
+    // Apply the lookup files as changes to the edges of the previous update, which are kept
+    // in the applied state file. The changed edge-based nodes are written out for consumers
+    // that only want to reload or recompute the changed parts.
+    bool delta_update = false;
+    std::string applied_state_path;
+    std::string changed_nodes_path;
+
+    // Number of days after valid_now for which conditional turn restrictions are stored to be
+    // evaluated at query time. With 0 they are applied as turn penalties for valid_now.
+    unsigned conditional_turns_horizon = 0;
+    std::string conditional_turns_path;
+
+    // Lookup files with daily speed profiles of segments. The profiles of the edge-based nodes
+    // are written to speed_profiles_path, the static values of the edges are not changed.
+    std::vector<std::string> speed_profile_lookup_paths;
+    std::string speed_profiles_path;
 };
 }
 }
@@ -3,7 +3,10 @@
 
 #include <boost/date_time/gregorian/gregorian.hpp>
 
+#include <cstdint>
+#include <ctime>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -215,6 +218,15 @@ std::vector<OpeningHours> ParseOpeningHours(const std::string &str);
 
 bool CheckOpeningHours(const std::vector<OpeningHours> &input, const struct tm &time);
 
+// Returns the disjoint and sorted intervals [from, to) between begin and end in which
+// CheckOpeningHours is true. Times are seconds since the epoch, utc_offset is the offset of the
+// local time to UTC in seconds and is treated as constant between begin and end.
+std::vector<std::pair<std::time_t, std::time_t>>
+GetOpeningIntervals(const std::vector<OpeningHours> &input,
+                    const std::time_t begin,
+                    const std::time_t end,
+                    const std::int32_t utc_offset);
+
 } // util
 } // osrm
 
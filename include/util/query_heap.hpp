@@ -5,6 +5,7 @@
 #include <boost/heap/d_ary_heap.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <limits>
 #include <map>
 #include <unordered_map>
@@ -51,6 +52,15 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
         }
     }
 
+    // the arrays are sized by the number of nodes and can not shrink
+    void Trim(std::size_t) {}
+
+    std::size_t GetMemoryUsage() const
+    {
+        return positions.capacity() * sizeof(Key) +
+               generations.capacity() * sizeof(GenerationCounter);
+    }
+
   private:
     GenerationCounter generation;
     std::vector<GenerationCounter> generations;
@@ -70,6 +80,11 @@ template <typename NodeID, typename Key> class ArrayStorage
 
     void Clear() {}
 
+    // the array is sized by the number of nodes and can not shrink
+    void Trim(std::size_t) {}
+
+    std::size_t GetMemoryUsage() const { return positions.capacity() * sizeof(Key); }
+
   private:
     std::vector<Key> positions;
 };
@@ -83,6 +98,15 @@ template <typename NodeID, typename Key> class MapStorage
 
     void Clear() { nodes.clear(); }
 
+    // a cleared map holds no memory
+    void Trim(std::size_t) {}
+
+    std::size_t GetMemoryUsage() const
+    {
+        // rough size of a tree node with its three pointers and color
+        return nodes.size() * (sizeof(std::pair<const NodeID, Key>) + 4 * sizeof(void *));
+    }
+
     Key peek_index(const NodeID node) const
     {
         const auto iter = nodes.find(node);
@@ -122,6 +146,22 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     void Clear() { nodes.clear(); }
 
+    // Clearing the map keeps its buckets, a new map is sized for `size` nodes
+    void Trim(std::size_t size)
+    {
+        std::unordered_map<NodeID, Key> trimmed;
+        trimmed.rehash(1000);
+        trimmed.reserve(size);
+        nodes.swap(trimmed);
+    }
+
+    std::size_t GetMemoryUsage() const
+    {
+        // buckets plus the nodes of the entries with their next pointer and cached hash
+        return nodes.bucket_count() * sizeof(void *) +
+               nodes.size() * (sizeof(std::pair<const NodeID, Key>) + 2 * sizeof(void *));
+    }
+
   private:
     std::unordered_map<NodeID, Key> nodes;
 };
@@ -141,11 +181,55 @@ class QueryHeap
 
     void Clear()
     {
+        high_water_mark = std::max(high_water_mark, inserted_nodes.size());
+
         heap.clear();
         inserted_nodes.clear();
         node_index.Clear();
     }
 
+    // Releases the memory kept from queries larger than the largest query since the last
+    // trim. The vectors only grow, so without trimming a heap holds on to the memory of the
+    // largest query it ever saw.
+    void Trim()
+    {
+        BOOST_ASSERT(Empty());
+        inserted_nodes.clear();
+
+        std::vector<HeapNode> trimmed_nodes;
+        trimmed_nodes.reserve(high_water_mark);
+        inserted_nodes.swap(trimmed_nodes);
+
+        HeapContainer trimmed_heap;
+        trimmed_heap.reserve(high_water_mark);
+        heap.swap(trimmed_heap);
+
+        node_index.Trim(high_water_mark);
+
+        high_water_mark = 0;
+        queries_since_trim = 0;
+    }
+
+    // Most nodes inserted by one query since the last trim
+    std::size_t GetHighWaterMark() const
+    {
+        return std::max(high_water_mark, inserted_nodes.size());
+    }
+
+    // A query can clear the heap many times, e.g. once per leg, so queries are counted apart
+    void CountQuery() { ++queries_since_trim; }
+
+    std::size_t GetQueriesSinceTrim() const { return queries_since_trim; }
+
+    // Estimate of the memory held by the heap in bytes
+    std::size_t GetMemoryUsage() const
+    {
+        // the heap container keeps one handle per node, its elements are freed on clear
+        return inserted_nodes.capacity() * (sizeof(HeapNode) + sizeof(void *)) +
+               heap.size() * (sizeof(HeapData) + sizeof(std::size_t) + 2 * sizeof(void *)) +
+               node_index.GetMemoryUsage();
+    }
+
     std::size_t Size() const { return heap.size(); }
 
     bool Empty() const { return 0 == Size(); }
@@ -250,6 +334,9 @@ class QueryHeap
     std::vector<HeapNode> inserted_nodes;
     HeapContainer heap;
     IndexStorage node_index;
+
+    std::size_t high_water_mark = 0;
+    std::size_t queries_since_trim = 0;
 };
 }
 }
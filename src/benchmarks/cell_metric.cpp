@@ -0,0 +1,139 @@
+#include "customizer/quantized_values.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+struct Matrices
+{
+    std::vector<EdgeWeight> values;
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> row_lengths;
+};
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+// Square cell matrices with shortcut weights in the range seen on overlay levels
+// of a continental extract, a few entries are unreachable or far outside the range.
+Matrices make_matrices(const std::size_t num_cells)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<std::uint32_t> boundary_size(4, 64);
+    std::uniform_int_distribution<EdgeWeight> cell_base(0, 500000);
+    std::uniform_int_distribution<EdgeWeight> spread(0, 20000);
+    std::uniform_int_distribution<int> kind(0, 99);
+
+    Matrices matrices;
+    for (auto cell : util::irange<std::size_t>(0, num_cells))
+    {
+        (void)cell;
+        const auto num_nodes = boundary_size(generator);
+        const auto base = cell_base(generator);
+        matrices.offsets.push_back(matrices.values.size());
+        matrices.row_lengths.push_back(num_nodes);
+        for (auto index : util::irange<std::uint32_t>(0, num_nodes * num_nodes))
+        {
+            (void)index;
+            const auto value_kind = kind(generator);
+            if (value_kind < 2)
+                matrices.values.push_back(INVALID_EDGE_WEIGHT);
+            else if (value_kind < 3)
+                matrices.values.push_back(base + 100000 + spread(generator));
+            else
+                matrices.values.push_back(base + spread(generator));
+        }
+    }
+    matrices.offsets.push_back(matrices.values.size());
+
+    return matrices;
+}
+
+// Scans one row of random cells and keeps the minimum, like the shortcut
+// relaxation in the MLD routing step does
+template <typename RowFn>
+double measure_row_scans(const Matrices &matrices, const std::size_t num_scans, RowFn row_fn)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::size_t> random_cell(0, matrices.row_lengths.size() - 1);
+
+    TIMER_START(scan);
+    EdgeWeight sum = 0;
+    for (auto scan : util::irange<std::size_t>(0, num_scans))
+    {
+        (void)scan;
+        const auto cell = random_cell(generator);
+        const auto row = cell % matrices.row_lengths[cell];
+        sum += row_fn(cell, row);
+    }
+    dont_optimize_away(sum);
+    TIMER_STOP(scan);
+
+    return TIMER_MSEC(scan);
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    constexpr std::size_t num_cells = 20000;
+    constexpr std::size_t num_scans = 10000000;
+
+    const auto matrices = make_matrices(num_cells);
+
+    TIMER_START(quantize);
+    const auto quantized = customizer::quantizeValues(matrices.values, matrices.offsets);
+    TIMER_STOP(quantize);
+
+    const auto plain_bytes = matrices.values.size() * sizeof(EdgeWeight);
+    const auto quantized_bytes = quantized.GetSizeInBytes();
+    util::Log() << "values: " << matrices.values.size() << ", outliers "
+                << quantized.outliers.size() << ", quantization took " << TIMER_MSEC(quantize)
+                << " ms";
+    util::Log() << "memory: plain " << (plain_bytes / 1024) << " KiB, quantized "
+                << (quantized_bytes / 1024) << " KiB. "
+                << (static_cast<double>(quantized_bytes) / plain_bytes);
+
+    const auto plain_ms = measure_row_scans(matrices, num_scans, [&](auto cell, auto row) {
+        const auto row_length = matrices.row_lengths[cell];
+        const auto begin = matrices.values.begin() + matrices.offsets[cell] + row * row_length;
+        auto min_weight = INVALID_EDGE_WEIGHT;
+        for (auto iter = begin; iter != begin + row_length; ++iter)
+            min_weight = std::min(min_weight, *iter);
+        return min_weight;
+    });
+
+    const auto codes = quantized.codes.data();
+    const auto outliers_begin = quantized.outliers.data();
+    const auto outliers_end = outliers_begin + quantized.outliers.size();
+    const auto quantized_ms = measure_row_scans(matrices, num_scans, [&](auto cell, auto row) {
+        const auto row_length = matrices.row_lengths[cell];
+        const auto begin = codes + matrices.offsets[cell] + row * row_length;
+        const auto base = quantized.bases[cell];
+        const auto end = customizer::QuantizedValueIterator<EdgeWeight>{
+            begin + row_length, 1, base, codes, outliers_begin, outliers_end};
+        auto min_weight = INVALID_EDGE_WEIGHT;
+        for (auto iter = customizer::QuantizedValueIterator<EdgeWeight>{
+                 begin, 1, base, codes, outliers_begin, outliers_end};
+             iter != end;
+             ++iter)
+            min_weight = std::min(min_weight, *iter);
+        return min_weight;
+    });
+
+    util::Log() << "row scans: plain " << plain_ms << " ms, quantized " << quantized_ms << " ms. "
+                << (quantized_ms / plain_ms);
+}
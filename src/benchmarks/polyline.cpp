@@ -0,0 +1,184 @@
+#include "engine/polyline_compressor.hpp"
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+// The previous implementation, which encodes into a vector of integers and appends the
+// characters one by one. Kept as the baseline of this benchmark.
+namespace reference
+{
+std::string encode(int number_to_encode)
+{
+    std::string output;
+    while (number_to_encode >= 0x20)
+    {
+        const int next_value = (0x20 | (number_to_encode & 0x1f)) + 63;
+        output += static_cast<char>(next_value);
+        number_to_encode >>= 5;
+    }
+
+    number_to_encode += 63;
+    output += static_cast<char>(number_to_encode);
+    return output;
+}
+
+std::string encodePolyline(engine::CoordVectorForwardIter begin, engine::CoordVectorForwardIter end)
+{
+    const double coordinate_to_polyline = 100000 / COORDINATE_PRECISION;
+    std::vector<int> numbers;
+    int current_lat = 0;
+    int current_lon = 0;
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        const int lat_diff =
+            std::round(static_cast<int>(iter->lat) * coordinate_to_polyline) - current_lat;
+        const int lon_diff =
+            std::round(static_cast<int>(iter->lon) * coordinate_to_polyline) - current_lon;
+        numbers.emplace_back(lat_diff);
+        numbers.emplace_back(lon_diff);
+        current_lat += lat_diff;
+        current_lon += lon_diff;
+    }
+
+    std::string output;
+    for (auto number : numbers)
+    {
+        if (number < 0)
+        {
+            const unsigned binary = std::llabs(number);
+            const unsigned twos = (~binary) + 1u;
+            const unsigned shl = twos << 1u;
+            number = static_cast<int>(~shl);
+        }
+        else
+        {
+            number <<= 1u;
+        }
+        output += encode(number);
+    }
+    return output;
+}
+
+std::int32_t decodeInteger(std::string::const_iterator &first, std::string::const_iterator last)
+{
+    std::uint32_t result = 0;
+    for (std::uint32_t value = 0x20, shift = 0;
+         (value & 0x20) && (shift < CHAR_BIT * sizeof(result) - 1) && first != last;
+         ++first, shift += 5)
+    {
+        value = *first - 63;
+        result |= (value & 0x1f) << shift;
+    }
+    result = ((result & 1) == 1) ? ~(result >> 1) : (result >> 1);
+    return static_cast<std::int32_t>(result);
+}
+
+std::vector<util::Coordinate> decodePolyline(const std::string &polyline)
+{
+    const double polyline_to_coordinate = COORDINATE_PRECISION / 100000;
+    std::vector<util::Coordinate> coordinates;
+    std::int32_t latitude = 0, longitude = 0;
+
+    auto first = polyline.begin();
+    const auto last = polyline.end();
+    while (first != last)
+    {
+        latitude += decodeInteger(first, last);
+        longitude += decodeInteger(first, last);
+        coordinates.emplace_back(util::Coordinate{
+            util::FixedLongitude{static_cast<std::int32_t>(longitude * polyline_to_coordinate)},
+            util::FixedLatitude{static_cast<std::int32_t>(latitude * polyline_to_coordinate)}});
+    }
+    return coordinates;
+}
+}
+
+// A random walk with steps of up to 200 meters, the typical density of a long match trace
+std::vector<util::Coordinate> makeTrace(const std::size_t size)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<std::int32_t> step(-2000, 2000);
+
+    std::vector<util::Coordinate> coordinates;
+    coordinates.reserve(size);
+    std::int32_t lon = 13388860;
+    std::int32_t lat = 52517037;
+    for (auto index : util::irange<std::size_t>(0, size))
+    {
+        (void)index;
+        lon += step(generator);
+        lat += step(generator);
+        coordinates.push_back({util::FixedLongitude{lon}, util::FixedLatitude{lat}});
+    }
+    return coordinates;
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const auto num_rounds = 100;
+    const auto coordinates = makeTrace(100000);
+    const auto polyline = engine::encodePolyline(coordinates.begin(), coordinates.end());
+    if (reference::encodePolyline(coordinates.begin(), coordinates.end()) != polyline ||
+        reference::decodePolyline(polyline) != engine::decodePolyline(polyline))
+    {
+        util::Log(logERROR) << "results differ from the reference implementation";
+        return EXIT_FAILURE;
+    }
+
+    std::size_t checksum = 0;
+
+    TIMER_START(reference_encode);
+    for (auto round : util::irange(0, num_rounds))
+    {
+        (void)round;
+        checksum += reference::encodePolyline(coordinates.begin(), coordinates.end()).size();
+    }
+    TIMER_STOP(reference_encode);
+
+    TIMER_START(encode);
+    std::string buffer;
+    for (auto round : util::irange(0, num_rounds))
+    {
+        (void)round;
+        buffer.clear();
+        engine::encodePolyline(coordinates.begin(), coordinates.end(), buffer);
+        checksum += buffer.size();
+    }
+    TIMER_STOP(encode);
+
+    TIMER_START(reference_decode);
+    for (auto round : util::irange(0, num_rounds))
+    {
+        (void)round;
+        checksum += reference::decodePolyline(polyline).size();
+    }
+    TIMER_STOP(reference_decode);
+
+    TIMER_START(decode);
+    for (auto round : util::irange(0, num_rounds))
+    {
+        (void)round;
+        checksum += engine::decodePolyline(polyline).size();
+    }
+    TIMER_STOP(decode);
+
+    util::Log() << "checksum " << checksum;
+    util::Log() << "encode reference: " << TIMER_MSEC(reference_encode) / num_rounds << "ms";
+    util::Log() << "encode:           " << TIMER_MSEC(encode) / num_rounds << "ms";
+    util::Log() << "decode reference: " << TIMER_MSEC(reference_decode) / num_rounds << "ms";
+    util::Log() << "decode:           " << TIMER_MSEC(decode) / num_rounds << "ms";
+
+    return EXIT_SUCCESS;
+}
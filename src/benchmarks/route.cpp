@@ -0,0 +1,106 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|CoreCH|MLD]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2)
+    {
+        const std::string algorithm = argv[2];
+        if (algorithm == "CoreCH")
+            config.algorithm = EngineConfig::Algorithm::CoreCH;
+        else if (algorithm == "MLD")
+            config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+
+    OSRM osrm{config};
+
+    using osrm::util::Coordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    // Spread over monaco so the legs cover most of the network
+    const std::vector<Coordinate> coordinates = {
+        {FloatLongitude{7.419758}, FloatLatitude{43.731142}},
+        {FloatLongitude{7.419505}, FloatLatitude{43.736825}},
+        {FloatLongitude{7.435088}, FloatLatitude{43.747207}},
+        {FloatLongitude{7.417128}, FloatLatitude{43.727873}},
+        {FloatLongitude{7.429352}, FloatLatitude{43.739985}},
+        {FloatLongitude{7.412092}, FloatLatitude{43.733216}},
+        {FloatLongitude{7.426405}, FloatLatitude{43.741867}},
+        {FloatLongitude{7.415342}, FloatLatitude{43.733251}}};
+
+    constexpr int NUM = 1000;
+
+    RouteParameters route_params;
+    route_params.coordinates = coordinates;
+    route_params.steps = true;
+    route_params.annotations = true;
+    route_params.overview = RouteParameters::OverviewType::Full;
+
+    TIMER_START(routes);
+    for (int i = 0; i < NUM; ++i)
+    {
+        json::Object result;
+        const auto rc = osrm.Route(route_params, result);
+        if (rc != Status::Ok)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    TIMER_STOP(routes);
+    std::cout << "route: " << (TIMER_MSEC(routes) / NUM) << "ms/req at " << coordinates.size()
+              << " coordinates" << std::endl;
+
+    TableParameters table_params;
+    table_params.coordinates = coordinates;
+
+    TIMER_START(tables);
+    for (int i = 0; i < NUM; ++i)
+    {
+        json::Object result;
+        const auto rc = osrm.Table(table_params, result);
+        if (rc != Status::Ok)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    TIMER_STOP(tables);
+    std::cout << "table: " << (TIMER_MSEC(tables) / NUM) << "ms/req at " << coordinates.size()
+              << "x" << coordinates.size() << " coordinates" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
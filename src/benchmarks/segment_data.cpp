@@ -0,0 +1,147 @@
+#include "extractor/segment_data_container.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+// Counts heap allocations so the facade accessors can be compared by how much
+// they allocate per call and not only by their run time
+static std::atomic<std::size_t> num_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++num_allocations;
+    if (void *ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+// Geometries with 2 to 20 nodes each, which is the range of most compressed ways
+extractor::SegmentDataContainer make_segment_data(const std::size_t num_geometries)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<std::uint32_t> num_nodes(2, 20);
+    std::uniform_int_distribution<SegmentWeight> value(1, 1000);
+
+    std::vector<std::uint32_t> index{0};
+    std::vector<NodeID> nodes;
+    extractor::SegmentDataContainer::SegmentWeightVector fwd_weights, rev_weights;
+    extractor::SegmentDataContainer::SegmentDurationVector fwd_durations, rev_durations;
+    std::vector<DatasourceID> datasources;
+    for (auto geometry : util::irange<std::size_t>(0, num_geometries))
+    {
+        (void)geometry;
+        const auto size = num_nodes(generator);
+        for (auto node : util::irange<std::uint32_t>(0, size))
+        {
+            nodes.push_back(nodes.size() + node);
+            fwd_weights.push_back(value(generator));
+            rev_weights.push_back(value(generator));
+            fwd_durations.push_back(value(generator));
+            rev_durations.push_back(value(generator));
+            datasources.push_back(0);
+        }
+        index.push_back(nodes.size());
+    }
+
+    return extractor::SegmentDataContainer(std::move(index),
+                                           std::move(nodes),
+                                           std::move(fwd_weights),
+                                           std::move(rev_weights),
+                                           std::move(fwd_durations),
+                                           std::move(rev_durations),
+                                           std::move(datasources));
+}
+
+// Reads geometry, weights, durations and datasources of random geometries in both
+// directions, the access pattern of annotatePath and the tile plugin
+template <typename AccessFn>
+void measure_access(const std::string &name,
+                    const extractor::SegmentDataContainer &segment_data,
+                    const std::size_t num_lookups,
+                    AccessFn access)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::uint32_t> random_geometry(
+        0, segment_data.GetNumberOfGeometries() - 1);
+
+    const std::size_t allocations_before = num_allocations;
+    TIMER_START(access);
+    std::uint64_t sum = 0;
+    for (auto lookup : util::irange<std::size_t>(0, num_lookups))
+    {
+        (void)lookup;
+        sum += access(random_geometry(generator));
+    }
+    dont_optimize_away(sum);
+    TIMER_STOP(access);
+    const std::size_t allocations = num_allocations - allocations_before;
+
+    util::Log() << name << ": " << TIMER_MSEC(access) << " ms, "
+                << (static_cast<double>(allocations) / num_lookups) << " allocations per lookup";
+}
+
+template <typename RangeT> std::uint64_t sum_range(const RangeT &range)
+{
+    std::uint64_t sum = 0;
+    for (const auto value : range)
+        sum += value;
+    return sum;
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    constexpr std::size_t num_geometries = 1000000;
+    constexpr std::size_t num_lookups = 5000000;
+
+    const auto segment_data = make_segment_data(num_geometries);
+
+    // what the facade used to do: copy every range into a freshly allocated vector
+    measure_access("copy to vectors", segment_data, num_lookups, [&](const auto id) {
+        const auto copy = [](const auto &range) {
+            using ValueT = typename std::decay<decltype(*range.begin())>::type;
+            return sum_range(std::vector<ValueT>(range.begin(), range.end()));
+        };
+        return copy(segment_data.GetForwardGeometry(id)) +
+               copy(segment_data.GetReverseGeometry(id)) +
+               copy(segment_data.GetForwardWeights(id)) +
+               copy(segment_data.GetReverseWeights(id)) +
+               copy(segment_data.GetForwardDurations(id)) +
+               copy(segment_data.GetReverseDurations(id)) +
+               copy(segment_data.GetForwardDatasources(id)) +
+               copy(segment_data.GetReverseDatasources(id));
+    });
+
+    measure_access("ranges", segment_data, num_lookups, [&](const auto id) {
+        return sum_range(segment_data.GetForwardGeometry(id)) +
+               sum_range(segment_data.GetReverseGeometry(id)) +
+               sum_range(segment_data.GetForwardWeights(id)) +
+               sum_range(segment_data.GetReverseWeights(id)) +
+               sum_range(segment_data.GetForwardDurations(id)) +
+               sum_range(segment_data.GetReverseDurations(id)) +
+               sum_range(segment_data.GetForwardDatasources(id)) +
+               sum_range(segment_data.GetReverseDatasources(id));
+    });
+}
@@ -1,6 +1,7 @@
 #include "customizer/customizer.hpp"
 #include "customizer/cell_customizer.hpp"
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
 
 #include "partition/cell_storage.hpp"
 #include "partition/edge_based_graph_reader.hpp"
@@ -11,9 +12,12 @@
 
 #include "updater/updater.hpp"
 
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/timing_util.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 namespace osrm
 {
 namespace customizer
@@ -22,9 +26,11 @@ namespace customizer
 template <typename Graph, typename Partition, typename CellStorage>
 void CellStorageStatistics(const Graph &graph,
                            const Partition &partition,
-                           const CellStorage &storage)
+                           const CellStorage &storage,
+                           const CellMetric &metric)
 {
-    util::Log() << "Cells statistics per level";
+    util::Log() << "Cells statistics per level for metric " << toString(metric.source)
+                << (metric.IsTimeSlice() ? " at minute " + std::to_string(metric.time_slice) : "");
 
     for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
     {
@@ -38,7 +44,7 @@ void CellStorageStatistics(const Graph &graph,
         std::size_t invalid_sources = 0, invalid_destinations = 0;
         for (std::uint32_t cell_id = 0; cell_id < partition.GetNumberOfCells(level); ++cell_id)
         {
-            const auto &cell = storage.GetCell(level, cell_id);
+            const auto &cell = storage.GetCell(metric, level, cell_id);
             source += cell.GetSourceNodes().size();
             destination += cell.GetDestinationNodes().size();
             total += cell_nodes[cell_id];
@@ -71,6 +77,42 @@ void CellStorageStatistics(const Graph &graph,
     }
 }
 
+// Replaces the cell matrices of all metrics by their quantized representation. The outlier
+// tables are padded to the same size, so that all metrics can share one storage block.
+void QuantizeMetrics(const partition::CellStorage &storage, std::vector<CellMetric> &metrics)
+{
+    std::size_t max_weight_outliers = 0;
+    std::size_t max_duration_outliers = 0;
+    for (auto &metric : metrics)
+    {
+        const auto full_size = metric.weights.size() * sizeof(EdgeWeight) +
+                               metric.durations.size() * sizeof(EdgeDuration);
+
+        storage.QuantizeMetric(metric);
+
+        const auto quantized_size =
+            metric.quantized_weights.GetSizeInBytes() + metric.quantized_durations.GetSizeInBytes();
+        util::Log() << "Quantized metric " << toString(metric.source) << ": "
+                    << metric.quantized_weights.outliers.size() << " weight and "
+                    << metric.quantized_durations.outliers.size() << " duration outliers, "
+                    << (full_size / 1024 / 1024) << " MiB -> " << (quantized_size / 1024 / 1024)
+                    << " MiB";
+
+        max_weight_outliers =
+            std::max(max_weight_outliers, metric.quantized_weights.outliers.size());
+        max_duration_outliers =
+            std::max(max_duration_outliers, metric.quantized_durations.outliers.size());
+    }
+
+    for (auto &metric : metrics)
+    {
+        metric.quantized_weights.outliers.resize(
+            max_weight_outliers, QuantizedOutlier<EdgeWeight>{QUANTIZED_PADDING_INDEX, 0});
+        metric.quantized_durations.outliers.resize(
+            max_duration_outliers, QuantizedOutlier<EdgeDuration>{QUANTIZED_PADDING_INDEX, 0});
+    }
+}
+
 auto LoadAndUpdateEdgeExpandedGraph(const CustomizationConfig &config,
                                     const partition::MultiLevelPartition &mlp)
 {
@@ -109,12 +151,70 @@ int Customizer::Run(const CustomizationConfig &config)
 
     TIMER_START(cell_customize);
     CellCustomizer customizer(mlp);
-    customizer.Customize(*edge_based_graph, storage);
+    std::vector<CellMetric> metrics;
+    metrics.reserve(config.metric_sources.size());
+    for (const auto source : config.metric_sources)
+    {
+        metrics.push_back(storage.MakeMetric(source));
+        customizer.Customize(*edge_based_graph, storage, metrics.back());
+    }
+
+    // the profiles are only used if the updater built them for the current graph
+    const auto &updater_config = config.updater_config;
+    if (updater_config.speed_profile_lookup_paths.empty())
+    {
+        if (config.time_slices > 0)
+            util::Log(logWARNING) << "Time slices need speed profile files, only the static "
+                                     "metrics are customized";
+        boost::filesystem::remove(updater_config.speed_profiles_path);
+    }
+    else if (config.time_slices > 0)
+    {
+        SpeedProfiles profiles;
+        files::readSpeedProfiles(updater_config.speed_profiles_path, profiles);
+
+        // the time slices share the base graph and only add cell matrices
+        for (const auto slice : util::irange(0u, config.time_slices))
+        {
+            const auto minute =
+                static_cast<std::uint16_t>(slice * MINUTES_PER_DAY / config.time_slices);
+            const auto factors = profiles.GetFactors(minute);
+            std::vector<std::uint16_t> node_factors(edge_based_graph->GetNumberOfNodes());
+            for (const auto node : util::irange(0u, edge_based_graph->GetNumberOfNodes()))
+            {
+                const auto profile = profiles.GetProfile(node);
+                node_factors[node] = profile == INVALID_SPEED_PROFILE ? SPEED_PROFILE_BASE_FACTOR
+                                                                      : factors[profile];
+            }
+
+            CellCustomizer slice_customizer(mlp, std::move(node_factors));
+            for (const auto source : config.metric_sources)
+            {
+                metrics.push_back(storage.MakeMetric(source));
+                metrics.back().time_slice = minute;
+                slice_customizer.Customize(*edge_based_graph, storage, metrics.back());
+            }
+        }
+    }
     TIMER_STOP(cell_customize);
-    util::Log() << "Cells customization took " << TIMER_SEC(cell_customize) << " seconds";
+    util::Log() << "Cells customization of " << metrics.size() << " metric(s) took "
+                << TIMER_SEC(cell_customize) << " seconds";
+
+    for (const auto &metric : metrics)
+    {
+        CellStorageStatistics(*edge_based_graph, mlp, storage, metric);
+    }
+
+    if (config.quantize_cells)
+    {
+        TIMER_START(quantize);
+        QuantizeMetrics(storage, metrics);
+        TIMER_STOP(quantize);
+        util::Log() << "Cells quantization took " << TIMER_SEC(quantize) << " seconds";
+    }
 
     TIMER_START(writing_mld_data);
-    partition::files::writeCells(config.mld_storage_path, storage);
+    files::writeCellMetrics(config.mld_cell_metrics_path, metrics);
     TIMER_STOP(writing_mld_data);
     util::Log() << "MLD customization writing took " << TIMER_SEC(writing_mld_data) << " seconds";
 
@@ -123,8 +223,6 @@ int Customizer::Run(const CustomizationConfig &config)
     TIMER_STOP(writing_graph);
     util::Log() << "Graph writing took " << TIMER_SEC(writing_graph) << " seconds";
 
-    CellStorageStatistics(*edge_based_graph, mlp, storage);
-
     return 0;
 }
 
@@ -1,6 +1,5 @@
 #include "engine/douglas_peucker.hpp"
 #include "util/coordinate.hpp"
-#include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/web_mercator.hpp"
 
@@ -9,26 +8,47 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
-#include <stack>
 #include <utility>
+#include <vector>
 
 namespace osrm
 {
 namespace engine
 {
 
-// Normed to the thresholds table
-std::uint64_t fastPerpendicularDistance(const util::FloatCoordinate &projected_start,
-                                        const util::FloatCoordinate &projected_target,
-                                        const util::FloatCoordinate &projected)
+namespace
 {
-    util::FloatCoordinate projected_point_on_segment;
-    std::tie(std::ignore, projected_point_on_segment) =
-        util::coordinate_calculation::projectPointOnSegment(
-            projected_start, projected_target, projected);
-    auto squared_distance = util::coordinate_calculation::squaredEuclideanDistance(
-        projected, projected_point_on_segment);
-    return squared_distance;
+// Computes the squared distances of the points first+1 ... last-1 to the segment first-last in
+// fixed point units of the projected coordinates. The coordinates are stored in separate arrays
+// and the loop has no branches, so it can be vectorized.
+void perpendicularDistances(const std::vector<double> &xs,
+                            const std::vector<double> &ys,
+                            const std::size_t first,
+                            const std::size_t last,
+                            std::vector<double> &distances)
+{
+    const double source_x = xs[first];
+    const double source_y = ys[first];
+    const double slope_x = xs[last] - source_x;
+    const double slope_y = ys[last] - source_y;
+    const double squared_length = slope_x * slope_x + slope_y * slope_y;
+    // a degenerated segment is its source
+    const double inverse_squared_length = squared_length > 0. ? 1. / squared_length : 0.;
+
+    const double *x = xs.data();
+    const double *y = ys.data();
+    double *distance = distances.data();
+    for (auto idx = first + 1; idx < last; ++idx)
+    {
+        const double rel_x = x[idx] - source_x;
+        const double rel_y = y[idx] - source_y;
+        const double ratio = std::min(
+            1., std::max(0., (slope_x * rel_x + slope_y * rel_y) * inverse_squared_length));
+        const double offset_x = rel_x - ratio * slope_x;
+        const double offset_y = rel_y - ratio * slope_y;
+        distance[idx] = offset_x * offset_x + offset_y * offset_y;
+    }
+}
 }
 
 std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::const_iterator begin,
@@ -44,10 +64,17 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
         return {};
     }
 
-    std::vector<util::FloatCoordinate> projected_coordinates(size);
-    std::transform(begin, end, projected_coordinates.begin(), [](const util::Coordinate coord) {
-        return util::web_mercator::fromWGS84(coord);
-    });
+    // projected coordinates scaled to the fixed point precision the thresholds are normed to
+    std::vector<double> xs(size);
+    std::vector<double> ys(size);
+    for (auto idx : util::irange<std::size_t>(0UL, size))
+    {
+        const auto projected = util::web_mercator::fromWGS84(begin[idx]);
+        xs[idx] = static_cast<double>(projected.lon) * COORDINATE_PRECISION;
+        ys[idx] = static_cast<double>(projected.lat) * COORDINATE_PRECISION;
+    }
+    std::vector<double> distances(size);
+    const auto threshold = static_cast<double>(detail::DOUGLAS_PEUCKER_THRESHOLDS[zoom_level]);
 
     std::vector<bool> is_necessary(size, false);
     BOOST_ASSERT(is_necessary.size() >= 2);
@@ -55,54 +82,34 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
     is_necessary.back() = true;
     using GeometryRange = std::pair<std::size_t, std::size_t>;
 
-    std::stack<GeometryRange> recursion_stack;
-
-    recursion_stack.emplace(0UL, size - 1);
+    std::vector<GeometryRange> range_stack;
+    range_stack.emplace_back(0UL, size - 1);
 
     // mark locations as 'necessary' by divide-and-conquer
-    while (!recursion_stack.empty())
+    while (!range_stack.empty())
     {
-        // pop next element
-        const GeometryRange pair = recursion_stack.top();
-        recursion_stack.pop();
-        // sanity checks
-        BOOST_ASSERT_MSG(is_necessary[pair.first], "left border must be necessary");
-        BOOST_ASSERT_MSG(is_necessary[pair.second], "right border must be necessary");
-        BOOST_ASSERT_MSG(pair.second < size, "right border outside of geometry");
-        BOOST_ASSERT_MSG(pair.first <= pair.second, "left border on the wrong side");
-
-        std::uint64_t max_distance = 0;
-        auto farthest_entry_index = pair.second;
-
-        // sweep over range to find the maximum
-        for (auto idx = pair.first + 1; idx != pair.second; ++idx)
-        {
-            using namespace util::coordinate_calculation;
-            const auto distance = fastPerpendicularDistance(projected_coordinates[pair.first],
-                                                            projected_coordinates[pair.second],
-                                                            projected_coordinates[idx]);
-            // found new feasible maximum?
-            if (distance > max_distance &&
-                distance > detail::DOUGLAS_PEUCKER_THRESHOLDS[zoom_level])
-            {
-                farthest_entry_index = idx;
-                max_distance = distance;
-            }
-        }
+        const GeometryRange range = range_stack.back();
+        range_stack.pop_back();
+        BOOST_ASSERT_MSG(is_necessary[range.first], "left border must be necessary");
+        BOOST_ASSERT_MSG(is_necessary[range.second], "right border must be necessary");
+        BOOST_ASSERT_MSG(range.second < size, "right border outside of geometry");
+        BOOST_ASSERT_MSG(range.first <= range.second, "left border on the wrong side");
+
+        if (range.second - range.first < 2)
+            continue;
+
+        perpendicularDistances(xs, ys, range.first, range.second, distances);
+        // the first of several farthest locations is used
+        const auto farthest = std::max_element(distances.begin() + range.first + 1,
+                                               distances.begin() + range.second);
 
         // check if maximum violates a zoom level dependent threshold
-        if (max_distance > detail::DOUGLAS_PEUCKER_THRESHOLDS[zoom_level])
+        if (*farthest > threshold)
         {
-            //  mark idx as necessary
+            const std::size_t farthest_entry_index = std::distance(distances.begin(), farthest);
             is_necessary[farthest_entry_index] = true;
-            if (pair.first < farthest_entry_index)
-            {
-                recursion_stack.emplace(pair.first, farthest_entry_index);
-            }
-            if (farthest_entry_index < pair.second)
-            {
-                recursion_stack.emplace(farthest_entry_index, pair.second);
-            }
+            range_stack.emplace_back(range.first, farthest_entry_index);
+            range_stack.emplace_back(farthest_entry_index, range.second);
         }
     }
 
@@ -26,9 +26,17 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
                               unlimited_or_more_than(max_results_nearest, 0) &&
-                              max_alternatives >= 0;
+                              max_alternatives >= 0 && request_parallelism >= 1;
 
-    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
+    // pre-rendering only makes sense with a cache to render into
+    const bool tile_prerender_valid =
+        !tile_prerender_area ||
+        (tile_cache_size > 0 && tile_prerender_area->min_zoom <= tile_prerender_area->max_zoom &&
+         tile_prerender_area->southwest.lon <= tile_prerender_area->northeast.lon &&
+         tile_prerender_area->southwest.lat <= tile_prerender_area->northeast.lat);
+
+    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) &&
+           limits_valid && tile_prerender_valid;
 }
 }
 }
@@ -4,8 +4,6 @@
 
 #include <boost/assert.hpp>
 
-#include <algorithm>
-#include <iterator>
 #include <ostream>
 #include <tuple>
 
@@ -25,29 +23,15 @@ bool Hint::IsValid(const util::Coordinate new_input_coordinates,
     return is_same_input_coordinate && phantom.IsValid() && facade.GetCheckSum() == data_checksum;
 }
 
-std::string Hint::ToBase64() const
-{
-    auto base64 = encodeBase64Bytewise(*this);
-
-    // Make safe for usage as GET parameter in URLs
-    std::replace(begin(base64), end(base64), '+', '-');
-    std::replace(begin(base64), end(base64), '/', '_');
-
-    return base64;
-}
+// Uses the URL safe alphabet, so hints can be passed back as GET parameters
+std::string Hint::ToBase64() const { return encodeBase64URLBytewise(*this); }
 
 Hint Hint::FromBase64(const std::string &base64Hint)
 {
     BOOST_ASSERT_MSG(base64Hint.size() == ENCODED_HINT_SIZE, "Hint has invalid size");
 
-    // We need mutability but don't want to change the API
-    auto encoded = base64Hint;
-
-    // Reverses above encoding we need for GET parameters in URL
-    std::replace(begin(encoded), end(encoded), '-', '+');
-    std::replace(begin(encoded), end(encoded), '_', '/');
-
-    return decodeBase64Bytewise<Hint>(encoded);
+    // The decoder understands the URL safe alphabet as well
+    return decodeBase64Bytewise<Hint>(base64Hint);
 }
 
 bool operator==(const Hint &lhs, const Hint &rhs)
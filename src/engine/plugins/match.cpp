@@ -214,7 +214,7 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         return Error("NoMatch", "Could not match the trace.", json_result);
     }
 
-    std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
+    std::vector<std::vector<PhantomNodes>> sub_matching_legs(sub_matchings.size());
     for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
     {
         BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
@@ -228,16 +228,19 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
             current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
             BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
             BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
-            sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
+            sub_matching_legs[index].emplace_back(current_phantom_node_pair);
         }
-        // force uturns to be on, since we split the phantom nodes anyway and only have
-        // bi-directional
-        // phantom nodes for possible uturns
-        sub_routes[index] =
-            algorithms.ShortestPathSearch(sub_routes[index].segment_end_coordinates, {false});
-        BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
     }
 
+    // force uturns to be on, since we split the phantom nodes anyway and only have
+    // bi-directional phantom nodes for possible uturns. The sub-matchings are independent
+    // and are routed in parallel with request parallelism.
+    const auto sub_routes = algorithms.ShortestPathSearches(sub_matching_legs, {false});
+    BOOST_ASSERT(std::none_of(
+        sub_routes.begin(), sub_routes.end(), [](const InternalRouteResult &sub_route) {
+            return sub_route.shortest_path_weight == INVALID_EDGE_WEIGHT;
+        }));
+
     api::MatchAPI match_api{facade, parameters, tidied};
     match_api.MakeResponse(sub_matchings, sub_routes, json_result);
 
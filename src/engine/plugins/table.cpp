@@ -31,26 +31,30 @@ TablePlugin::TablePlugin(const int max_locations_distance_table)
 Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                                   const RoutingAlgorithmsInterface &algorithms,
                                   const api::TableParameters &params,
-                                  util::json::Object &result) const
+                                  api::ResultT &result) const
 {
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+
     if (!algorithms.HasManyToManySearch())
     {
         return Error("NotImplemented",
                      "Many to many search is not implemented for the chosen search algorithm.",
-                     result);
+                     json_result);
     }
 
     BOOST_ASSERT(params.IsValid());
 
     if (!CheckAllCoordinates(params.coordinates))
     {
-        return Error("InvalidOptions", "Coordinates are invalid", result);
+        return Error("InvalidOptions", "Coordinates are invalid", json_result);
     }
 
     if (params.bearings.size() > 0 && params.coordinates.size() != params.bearings.size())
     {
-        return Error(
-            "InvalidOptions", "Number of bearings does not match number of coordinates", result);
+        return Error("InvalidOptions",
+                     "Number of bearings does not match number of coordinates",
+                     json_result);
     }
 
     // Empty sources or destinations means the user wants all of them included, respectively
@@ -64,7 +68,7 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         ((num_sources * num_destinations) >
          static_cast<std::size_t>(max_locations_distance_table * max_locations_distance_table)))
     {
-        return Error("TooBig", "Too many table coordinates", result);
+        return Error("TooBig", "Too many table coordinates", json_result);
     }
 
     auto phantom_nodes = GetPhantomNodes(facade, params);
@@ -74,7 +78,7 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         return Error("NoSegment",
                      std::string("Could not find a matching segment for coordinate ") +
                          std::to_string(phantom_nodes.size()),
-                     result);
+                     json_result);
     }
 
     auto snapped_phantoms = SnapPhantomNodes(phantom_nodes);
@@ -83,11 +87,20 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
 
     if (result_table.empty())
     {
-        return Error("NoTable", "No table found", result);
+        return Error("NoTable", "No table found", json_result);
     }
 
     api::TableAPI table_api{facade, params};
-    table_api.MakeResponse(result_table, snapped_phantoms, result);
+    if (params.format == api::BaseParameters::OutputFormatType::PBF)
+    {
+        std::string pbf_result;
+        table_api.MakeResponse(result_table, snapped_phantoms, pbf_result);
+        result = std::move(pbf_result);
+    }
+    else
+    {
+        table_api.MakeResponse(result_table, snapped_phantoms, json_result);
+    }
 
     return Status::Ok;
 }
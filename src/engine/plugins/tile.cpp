@@ -14,6 +14,8 @@
 #include <protozero/pbf_writer.hpp>
 #include <protozero/varint.hpp>
 
+#include <tbb/parallel_invoke.h>
+
 #include <algorithm>
 #include <numeric>
 #include <string>
@@ -274,16 +276,13 @@ std::vector<std::size_t> getEdgeIndex(const std::vector<RTreeLeaf> &edges)
     return sorted_edge_indexes;
 }
 
-void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
-                      unsigned x,
-                      unsigned y,
-                      unsigned z,
-                      const std::vector<RTreeLeaf> &edges,
-                      const std::vector<std::size_t> &sorted_edge_indexes,
-                      const std::vector<routing_algorithms::TurnData> &all_turn_data,
-                      std::string &pbf_buffer)
+// Encodes the "speeds" layer with one line feature per direction of every segment
+void encodeSpeedsLayer(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                       const BBox &tile_bbox,
+                       const std::vector<RTreeLeaf> &edges,
+                       const std::vector<std::size_t> &sorted_edge_indexes,
+                       std::string &layer_buffer)
 {
-
     // Vector tiles encode properties as references to a common lookup table.
     // When we add a property to a "feature", we actually attach the index of the value
     // rather than the value itself.  Thus, we need to keep a list of the unique
@@ -300,18 +299,8 @@ void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &
     std::vector<util::StringView> names;
     std::unordered_map<util::StringView, std::size_t> name_offsets;
 
-    // And again for integer values used by points.
-    std::vector<int> used_point_ints;
-    std::unordered_map<int, std::size_t> point_int_offsets;
-
-    // And again for float values used by points
-    std::vector<float> used_point_floats;
-    std::unordered_map<float, std::size_t> point_float_offsets;
-
     std::uint8_t max_datasource_id = 0;
 
-    // This is where we accumulate information on turns
-
     // Helper function for adding a new value to the line_ints lookup table.  Returns
     // the index of the value in the table, adding the value if it doesn't already
     // exist
@@ -327,45 +316,6 @@ void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &
         return;
     };
 
-    // Same again
-    const auto use_point_int_value = [&used_point_ints, &point_int_offsets](const int value) {
-        const auto found = point_int_offsets.find(value);
-        std::size_t offset;
-
-        if (found == point_int_offsets.end())
-        {
-            used_point_ints.push_back(value);
-            offset = used_point_ints.size() - 1;
-            point_int_offsets[value] = offset;
-        }
-        else
-        {
-            offset = found->second;
-        }
-
-        return offset;
-    };
-
-    // And a third time, should probably template this....
-    const auto use_point_float_value = [&used_point_floats,
-                                        &point_float_offsets](const float value) {
-        const auto found = point_float_offsets.find(value);
-        std::size_t offset;
-
-        if (found == point_float_offsets.end())
-        {
-            used_point_floats.push_back(value);
-            offset = used_point_floats.size() - 1;
-            point_float_offsets[value] = offset;
-        }
-        else
-        {
-            offset = found->second;
-        }
-
-        return offset;
-    };
-
     const auto get_geometry_id = [&facade](auto edge) {
         return facade.GetGeometryIndex(edge.forward_segment_id.id).id;
     };
@@ -379,16 +329,16 @@ void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &
         const auto &edge = edges[edge_index];
 
         const auto geometry_id = get_geometry_id(edge);
-        const auto forward_datasource_vector =
-            facade.GetUncompressedForwardDatasources(geometry_id);
-        const auto reverse_datasource_vector =
-            facade.GetUncompressedReverseDatasources(geometry_id);
+        const auto forward_datasource_range = facade.GetUncompressedForwardDatasources(geometry_id);
+        const auto reverse_datasource_range = facade.GetUncompressedReverseDatasources(geometry_id);
 
-        BOOST_ASSERT(edge.fwd_segment_position < forward_datasource_vector.size());
-        const auto forward_datasource = forward_datasource_vector[edge.fwd_segment_position];
-        BOOST_ASSERT(edge.fwd_segment_position < reverse_datasource_vector.size());
-        const auto reverse_datasource = reverse_datasource_vector[reverse_datasource_vector.size() -
-                                                                  edge.fwd_segment_position - 1];
+        BOOST_ASSERT(edge.fwd_segment_position <
+                     static_cast<std::size_t>(forward_datasource_range.size()));
+        const auto forward_datasource = forward_datasource_range[edge.fwd_segment_position];
+        BOOST_ASSERT(edge.fwd_segment_position <
+                     static_cast<std::size_t>(reverse_datasource_range.size()));
+        const auto reverse_datasource = reverse_datasource_range[reverse_datasource_range.size() -
+                                                                 edge.fwd_segment_position - 1];
 
         // Keep track of the highest datasource seen so that we don't write unnecessary
         // data to the layer attribute values
@@ -396,33 +346,65 @@ void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &
         max_datasource_id = std::max(max_datasource_id, reverse_datasource);
     }
 
-    // Convert tile coordinates into mercator coordinates
-    double min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat;
-    util::web_mercator::xyzToMercator(
-        x, y, z, min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat);
-    const BBox tile_bbox{min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat};
-
     // Protobuf serializes blocks when objects go out of scope, hence
     // the extra scoping below.
-    protozero::pbf_writer tile_writer{pbf_buffer};
     {
+        protozero::pbf_writer line_layer_writer{layer_buffer};
+        // TODO: don't write a layer if there are no features
+
+        line_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2); // version
+        // Field 1 is the "layer name" field, it's a string
+        line_layer_writer.add_string(util::vector_tile::NAME_TAG, "speeds"); // name
+        // Field 5 is the tile extent.  It's a uint32 and should be set to 4096
+        // for normal vector tiles.
+        line_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                     util::vector_tile::EXTENT); // extent
+
+        // Because we need to know the indexes into the vector tile lookup table,
+        // we need to do an initial pass over the data and create the complete
+        // index of used values.
+        for (const auto &edge_index : sorted_edge_indexes)
         {
-            // Add a layer object to the PBF stream.  3=='layer' from the vector tile spec
-            // (2.1)
-            protozero::pbf_writer line_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
-            // TODO: don't write a layer if there are no features
-
-            line_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2); // version
-            // Field 1 is the "layer name" field, it's a string
-            line_layer_writer.add_string(util::vector_tile::NAME_TAG, "speeds"); // name
-            // Field 5 is the tile extent.  It's a uint32 and should be set to 4096
-            // for normal vector tiles.
-            line_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
-                                         util::vector_tile::EXTENT); // extent
-
-            // Because we need to know the indexes into the vector tile lookup table,
-            // we need to do an initial pass over the data and create the complete
-            // index of used values.
+            const auto &edge = edges[edge_index];
+            const auto geometry_id = get_geometry_id(edge);
+
+            // Get coordinates for start/end nodes of segment (NodeIDs u and v)
+            const auto a = facade.GetCoordinateOfNode(edge.u);
+            const auto b = facade.GetCoordinateOfNode(edge.v);
+            // Calculate the length in meters
+            const double length = osrm::util::coordinate_calculation::haversineDistance(a, b);
+
+            // Weight values
+            const auto forward_weight_range = facade.GetUncompressedForwardWeights(geometry_id);
+            const auto reverse_weight_range = facade.GetUncompressedReverseWeights(geometry_id);
+            const auto forward_weight = forward_weight_range[edge.fwd_segment_position];
+            const auto reverse_weight = reverse_weight_range[reverse_weight_range.size() -
+                                                             edge.fwd_segment_position - 1];
+            use_line_value(forward_weight);
+            use_line_value(reverse_weight);
+
+            std::uint32_t forward_rate =
+                static_cast<std::uint32_t>(round(length / forward_weight * 10.));
+            std::uint32_t reverse_rate =
+                static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
+
+            use_line_value(forward_rate);
+            use_line_value(reverse_rate);
+
+            // Duration values
+            const auto forward_duration_range = facade.GetUncompressedForwardDurations(geometry_id);
+            const auto reverse_duration_range = facade.GetUncompressedReverseDurations(geometry_id);
+            const auto forward_duration = forward_duration_range[edge.fwd_segment_position];
+            const auto reverse_duration = reverse_duration_range[reverse_duration_range.size() -
+                                                                 edge.fwd_segment_position - 1];
+            use_line_value(forward_duration);
+            use_line_value(reverse_duration);
+        }
+
+        // Begin the layer features block
+        {
+            // Each feature gets a unique id, starting at 1
+            unsigned id = 1;
             for (const auto &edge_index : sorted_edge_indexes)
             {
                 const auto &edge = edges[edge_index];
@@ -434,451 +416,434 @@ void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &
                 // Calculate the length in meters
                 const double length = osrm::util::coordinate_calculation::haversineDistance(a, b);
 
-                // Weight values
-                const auto forward_weight_vector =
-                    facade.GetUncompressedForwardWeights(geometry_id);
-                const auto reverse_weight_vector =
-                    facade.GetUncompressedReverseWeights(geometry_id);
-                const auto forward_weight = forward_weight_vector[edge.fwd_segment_position];
-                const auto reverse_weight = reverse_weight_vector[reverse_weight_vector.size() -
-                                                                  edge.fwd_segment_position - 1];
-                use_line_value(forward_weight);
-                use_line_value(reverse_weight);
-
-                std::uint32_t forward_rate =
-                    static_cast<std::uint32_t>(round(length / forward_weight * 10.));
-                std::uint32_t reverse_rate =
-                    static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
-
-                use_line_value(forward_rate);
-                use_line_value(reverse_rate);
-
-                // Duration values
-                const auto forward_duration_vector =
+                const auto forward_weight_range = facade.GetUncompressedForwardWeights(geometry_id);
+                const auto reverse_weight_range = facade.GetUncompressedReverseWeights(geometry_id);
+                const auto forward_duration_range =
                     facade.GetUncompressedForwardDurations(geometry_id);
-                const auto reverse_duration_vector =
+                const auto reverse_duration_range =
                     facade.GetUncompressedReverseDurations(geometry_id);
-                const auto forward_duration = forward_duration_vector[edge.fwd_segment_position];
-                const auto reverse_duration =
-                    reverse_duration_vector[reverse_duration_vector.size() -
-                                            edge.fwd_segment_position - 1];
-                use_line_value(forward_duration);
-                use_line_value(reverse_duration);
-            }
-
-            // Begin the layer features block
-            {
-                // Each feature gets a unique id, starting at 1
-                unsigned id = 1;
-                for (const auto &edge_index : sorted_edge_indexes)
-                {
-                    const auto &edge = edges[edge_index];
-                    const auto geometry_id = get_geometry_id(edge);
-
-                    // Get coordinates for start/end nodes of segment (NodeIDs u and v)
-                    const auto a = facade.GetCoordinateOfNode(edge.u);
-                    const auto b = facade.GetCoordinateOfNode(edge.v);
-                    // Calculate the length in meters
-                    const double length =
-                        osrm::util::coordinate_calculation::haversineDistance(a, b);
-
-                    const auto forward_weight_vector =
-                        facade.GetUncompressedForwardWeights(geometry_id);
-                    const auto reverse_weight_vector =
-                        facade.GetUncompressedReverseWeights(geometry_id);
-                    const auto forward_duration_vector =
-                        facade.GetUncompressedForwardDurations(geometry_id);
-                    const auto reverse_duration_vector =
-                        facade.GetUncompressedReverseDurations(geometry_id);
-                    const auto forward_datasource_vector =
-                        facade.GetUncompressedForwardDatasources(geometry_id);
-                    const auto reverse_datasource_vector =
-                        facade.GetUncompressedReverseDatasources(geometry_id);
-                    const auto forward_weight = forward_weight_vector[edge.fwd_segment_position];
-                    const auto reverse_weight =
-                        reverse_weight_vector[reverse_weight_vector.size() -
-                                              edge.fwd_segment_position - 1];
-                    const auto forward_duration =
-                        forward_duration_vector[edge.fwd_segment_position];
-                    const auto reverse_duration =
-                        reverse_duration_vector[reverse_duration_vector.size() -
-                                                edge.fwd_segment_position - 1];
-                    const auto forward_datasource_idx =
-                        forward_datasource_vector[edge.fwd_segment_position];
-                    const auto reverse_datasource_idx =
-                        reverse_datasource_vector[reverse_datasource_vector.size() -
-                                                  edge.fwd_segment_position - 1];
-
-                    const auto component_id = facade.GetComponentID(edge.forward_segment_id.id);
-                    const auto name_id = facade.GetNameIndex(edge.forward_segment_id.id);
-                    auto name = facade.GetNameForID(name_id);
-
-                    const auto name_offset = [&name, &names, &name_offsets]() {
-                        auto iter = name_offsets.find(name);
-                        if (iter == name_offsets.end())
-                        {
-                            auto offset = names.size();
-                            name_offsets[name] = offset;
-                            names.push_back(name);
-                            return offset;
-                        }
-                        return iter->second;
-                    }();
-
-                    const auto encode_tile_line = [&line_layer_writer,
-                                                   &edge,
-                                                   &component_id,
-                                                   &id,
-                                                   &max_datasource_id,
-                                                   &used_line_ints](
-                        const FixedLine &tile_line,
-                        const std::uint32_t speed_kmh_idx,
-                        const std::uint32_t rate_idx,
-                        const std::size_t weight_idx,
-                        const std::size_t duration_idx,
-                        const DatasourceID datasource_idx,
-                        const std::size_t name_idx,
-                        std::int32_t &start_x,
-                        std::int32_t &start_y) {
-                        // Here, we save the two attributes for our feature: the speed and
-                        // the is_small boolean.  We only serve up speeds from 0-139, so all we
-                        // do is save the first
-                        protozero::pbf_writer feature_writer(line_layer_writer,
-                                                             util::vector_tile::FEATURE_TAG);
-                        // Field 3 is the "geometry type" field.  Value 2 is "line"
-                        feature_writer.add_enum(
-                            util::vector_tile::GEOMETRY_TAG,
-                            util::vector_tile::GEOMETRY_TYPE_LINE); // geometry type
-                        // Field 1 for the feature is the "id" field.
-                        feature_writer.add_uint64(util::vector_tile::ID_TAG, id++); // id
-                        {
-                            // When adding attributes to a feature, we have to write
-                            // pairs of numbers.  The first value is the index in the
-                            // keys array (written later), and the second value is the
-                            // index into the "values" array (also written later).  We're
-                            // not writing the actual speed or bool value here, we're saving
-                            // an index into the "values" array.  This means many features
-                            // can share the same value data, leading to smaller tiles.
-                            protozero::packed_field_uint32 field(
-                                feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
-
-                            field.add_element(0); // "speed" tag key offset
-                            field.add_element(std::min(
-                                speed_kmh_idx, 127u)); // save the speed value, capped at 127
-                            field.add_element(1);      // "is_small" tag key offset
-                            field.add_element(
-                                128 + (component_id.is_tiny ? 0 : 1)); // is_small feature offset
-                            field.add_element(2);                    // "datasource" tag key offset
-                            field.add_element(130 + datasource_idx); // datasource value offset
-                            field.add_element(3);                    // "weight" tag key offset
-                            field.add_element(130 + max_datasource_id + 1 +
-                                              weight_idx); // weight value offset
-                            field.add_element(4);          // "duration" tag key offset
-                            field.add_element(130 + max_datasource_id + 1 +
-                                              duration_idx); // duration value offset
-                            field.add_element(5);            // "name" tag key offset
-
-                            field.add_element(130 + max_datasource_id + 1 + used_line_ints.size() +
-                                              name_idx); // name value offset
-
-                            field.add_element(6); // rate tag key offset
-                            field.add_element(130 + max_datasource_id + 1 +
-                                              rate_idx); // rate goes in used_line_ints
-                        }
-                        {
-
-                            // Encode the geometry for the feature
-                            protozero::packed_field_uint32 geometry(
-                                feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
-                            encodeLinestring(tile_line, geometry, start_x, start_y);
-                        }
-                    };
-
-                    // If this is a valid forward edge, go ahead and add it to the tile
-                    if (forward_duration != 0 && edge.forward_segment_id.enabled)
-                    {
-                        std::int32_t start_x = 0;
-                        std::int32_t start_y = 0;
-
-                        // Calculate the speed for this line
-                        // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
-                        // table index
-                        std::uint32_t speed_kmh_idx =
-                            static_cast<std::uint32_t>(round(length / forward_duration * 10 * 3.6));
-
-                        // Rate values are in meters per weight-unit - and similar to speeds, we
-                        // present 1 decimal place of precision (these values are added as
-                        // double/10) lower down
-                        std::uint32_t forward_rate =
-                            static_cast<std::uint32_t>(round(length / forward_weight * 10.));
-
-                        auto tile_line = coordinatesToTileLine(a, b, tile_bbox);
-                        if (!tile_line.empty())
-                        {
-                            encode_tile_line(tile_line,
-                                             speed_kmh_idx,
-                                             line_int_offsets[forward_rate],
-                                             line_int_offsets[forward_weight],
-                                             line_int_offsets[forward_duration],
-                                             forward_datasource_idx,
-                                             name_offset,
-                                             start_x,
-                                             start_y);
-                        }
-                    }
-
-                    // Repeat the above for the coordinates reversed and using the `reverse`
-                    // properties
-                    if (reverse_duration != 0 && edge.reverse_segment_id.enabled)
+                const auto forward_datasource_range =
+                    facade.GetUncompressedForwardDatasources(geometry_id);
+                const auto reverse_datasource_range =
+                    facade.GetUncompressedReverseDatasources(geometry_id);
+                const auto forward_weight = forward_weight_range[edge.fwd_segment_position];
+                const auto reverse_weight = reverse_weight_range[reverse_weight_range.size() -
+                                                                 edge.fwd_segment_position - 1];
+                const auto forward_duration = forward_duration_range[edge.fwd_segment_position];
+                const auto reverse_duration = reverse_duration_range[reverse_duration_range.size() -
+                                                                     edge.fwd_segment_position - 1];
+                const auto forward_datasource_idx =
+                    forward_datasource_range[edge.fwd_segment_position];
+                const auto reverse_datasource_idx =
+                    reverse_datasource_range[reverse_datasource_range.size() -
+                                             edge.fwd_segment_position - 1];
+
+                const auto component_id = facade.GetComponentID(edge.forward_segment_id.id);
+                const auto name_id = facade.GetNameIndex(edge.forward_segment_id.id);
+                auto name = facade.GetNameForID(name_id);
+
+                const auto name_offset = [&name, &names, &name_offsets]() {
+                    auto iter = name_offsets.find(name);
+                    if (iter == name_offsets.end())
                     {
-                        std::int32_t start_x = 0;
-                        std::int32_t start_y = 0;
-
-                        // Calculate the speed for this line
-                        // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
-                        // table index
-                        std::uint32_t speed_kmh_idx =
-                            static_cast<std::uint32_t>(round(length / reverse_duration * 10 * 3.6));
-
-                        // Rate values are in meters per weight-unit - and similar to speeds, we
-                        // present 1 decimal place of precision (these values are added as
-                        // double/10) lower down
-                        std::uint32_t reverse_rate =
-                            static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
-
-                        auto tile_line = coordinatesToTileLine(b, a, tile_bbox);
-                        if (!tile_line.empty())
-                        {
-                            encode_tile_line(tile_line,
-                                             speed_kmh_idx,
-                                             line_int_offsets[reverse_rate],
-                                             line_int_offsets[reverse_weight],
-                                             line_int_offsets[reverse_duration],
-                                             reverse_datasource_idx,
-                                             name_offset,
-                                             start_x,
-                                             start_y);
-                        }
+                        auto offset = names.size();
+                        name_offsets[name] = offset;
+                        names.push_back(name);
+                        return offset;
                     }
-                }
-            }
-
-            // Field id 3 is the "keys" attribute
-            // We need two "key" fields, these are referred to with 0 and 1 (their array
-            // indexes) earlier
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "speed");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "is_small");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "datasource");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "duration");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "name");
-            line_layer_writer.add_string(util::vector_tile::KEY_TAG, "rate");
-
-            // Now, we write out the possible speed value arrays and possible is_tiny
-            // values.  Field type 4 is the "values" field.  It's a variable type field,
-            // so requires a two-step write (create the field, then write its value)
-            for (std::size_t i = 0; i < 128; i++)
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 5 == uint64 type
-                values_writer.add_uint64(util::vector_tile::VARIANT_TYPE_UINT64, i);
-            }
-            {
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 7 == bool type
-                values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, true);
-            }
-            {
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 7 == bool type
-                values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, false);
-            }
-            for (std::size_t i = 0; i <= max_datasource_id; i++)
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 1 == string type
-                values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING,
-                                         facade.GetDatasourceName(i).to_string());
-            }
-            for (auto value : used_line_ints)
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 2 == float type
-                // Durations come out of OSRM in integer deciseconds, so we convert them
-                // to seconds with a simple /10 for display
-                values_writer.add_double(util::vector_tile::VARIANT_TYPE_DOUBLE, value / 10.);
-            }
-
-            for (const auto &name : names)
-            {
-                // Writing field type 4 == variant type
-                protozero::pbf_writer values_writer(line_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                // Attribute value 1 == string type
-                values_writer.add_string(
-                    util::vector_tile::VARIANT_TYPE_STRING, name.data(), name.size());
-            }
-        }
-
-        // Only add the turn layer to the tile if it has some features (we sometimes won't
-        // for tiles of z<16, and tiles that don't show any intersections)
-        if (!all_turn_data.empty())
-        {
-            // we need to pre-encode all values here because we need the full offsets later
-            // for encoding the actual features.
-            std::vector<std::tuple<util::Coordinate, unsigned, unsigned, unsigned, unsigned>>
-                encoded_turn_data(all_turn_data.size());
-            std::transform(all_turn_data.begin(),
-                           all_turn_data.end(),
-                           encoded_turn_data.begin(),
-                           [&](const routing_algorithms::TurnData &t) {
-                               auto angle_idx = use_point_int_value(t.in_angle);
-                               auto turn_idx = use_point_int_value(t.turn_angle);
-                               auto duration_idx = use_point_float_value(
-                                   t.duration / 10.0); // Note conversion to float here
-                               auto weight_idx = use_point_float_value(
-                                   t.weight / 10.0); // Note conversion to float here
-                               return std::make_tuple(
-                                   t.coordinate, angle_idx, turn_idx, duration_idx, weight_idx);
-                           });
-
-            // Now write the points layer for turn penalty data:
-            // Add a layer object to the PBF stream.  3=='layer' from the vector tile spec
-            // (2.1)
-            protozero::pbf_writer point_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
-            point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);    // version
-            point_layer_writer.add_string(util::vector_tile::NAME_TAG, "turns"); // name
-            point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
-                                          util::vector_tile::EXTENT); // extent
-
-            // Begin writing the set of point features
-            {
-                // Start each features with an ID starting at 1
-                int id = 1;
-
-                // Helper function to encode a new point feature on a vector tile.
-                const auto encode_tile_point = [&](const FixedPoint &tile_point,
-                                                   const auto &point_turn_data) {
-                    protozero::pbf_writer feature_writer(point_layer_writer,
+                    return iter->second;
+                }();
+
+                const auto encode_tile_line = [&line_layer_writer,
+                                               &edge,
+                                               &component_id,
+                                               &id,
+                                               &max_datasource_id,
+                                               &used_line_ints](
+                    const FixedLine &tile_line,
+                    const std::uint32_t speed_kmh_idx,
+                    const std::uint32_t rate_idx,
+                    const std::size_t weight_idx,
+                    const std::size_t duration_idx,
+                    const DatasourceID datasource_idx,
+                    const std::size_t name_idx,
+                    std::int32_t &start_x,
+                    std::int32_t &start_y) {
+                    // Here, we save the two attributes for our feature: the speed and
+                    // the is_small boolean.  We only serve up speeds from 0-139, so all we
+                    // do is save the first
+                    protozero::pbf_writer feature_writer(line_layer_writer,
                                                          util::vector_tile::FEATURE_TAG);
-                    // Field 3 is the "geometry type" field.  Value 1 is "point"
+                    // Field 3 is the "geometry type" field.  Value 2 is "line"
                     feature_writer.add_enum(
                         util::vector_tile::GEOMETRY_TAG,
-                        util::vector_tile::GEOMETRY_TYPE_POINT);                // geometry type
+                        util::vector_tile::GEOMETRY_TYPE_LINE); // geometry type
+                    // Field 1 for the feature is the "id" field.
                     feature_writer.add_uint64(util::vector_tile::ID_TAG, id++); // id
                     {
-                        // Write out the 4 properties we want on the feature.  These
-                        // refer to indexes in the properties lookup table, which we
-                        // add to the tile after we add all features.
+                        // When adding attributes to a feature, we have to write
+                        // pairs of numbers.  The first value is the index in the
+                        // keys array (written later), and the second value is the
+                        // index into the "values" array (also written later).  We're
+                        // not writing the actual speed or bool value here, we're saving
+                        // an index into the "values" array.  This means many features
+                        // can share the same value data, leading to smaller tiles.
                         protozero::packed_field_uint32 field(
                             feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
-                        field.add_element(0); // "bearing_in" tag key offset
-                        field.add_element(std::get<1>(point_turn_data));
-                        field.add_element(1); // "turn_angle" tag key offset
-                        field.add_element(std::get<2>(point_turn_data));
-                        field.add_element(2); // "cost" tag key offset
-                        field.add_element(used_point_ints.size() + std::get<3>(point_turn_data));
-                        field.add_element(3); // "weight" tag key offset
-                        field.add_element(used_point_ints.size() + std::get<4>(point_turn_data));
+
+                        field.add_element(0); // "speed" tag key offset
+                        field.add_element(std::min(
+                            speed_kmh_idx, 127u)); // save the speed value, capped at 127
+                        field.add_element(1);      // "is_small" tag key offset
+                        field.add_element(
+                            128 + (component_id.is_tiny ? 0 : 1)); // is_small feature offset
+                        field.add_element(2);                    // "datasource" tag key offset
+                        field.add_element(130 + datasource_idx); // datasource value offset
+                        field.add_element(3);                    // "weight" tag key offset
+                        field.add_element(130 + max_datasource_id + 1 +
+                                          weight_idx); // weight value offset
+                        field.add_element(4);          // "duration" tag key offset
+                        field.add_element(130 + max_datasource_id + 1 +
+                                          duration_idx); // duration value offset
+                        field.add_element(5);            // "name" tag key offset
+
+                        field.add_element(130 + max_datasource_id + 1 + used_line_ints.size() +
+                                          name_idx); // name value offset
+
+                        field.add_element(6); // rate tag key offset
+                        field.add_element(130 + max_datasource_id + 1 +
+                                          rate_idx); // rate goes in used_line_ints
                     }
                     {
-                        // Add the geometry as the last field in this feature
+
+                        // Encode the geometry for the feature
                         protozero::packed_field_uint32 geometry(
                             feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
-                        encodePoint(tile_point, geometry);
+                        encodeLinestring(tile_line, geometry, start_x, start_y);
                     }
                 };
 
-                // Loop over all the turns we found and add them as features to the layer
-                for (const auto &turndata : encoded_turn_data)
+                // If this is a valid forward edge, go ahead and add it to the tile
+                if (forward_duration != 0 && edge.forward_segment_id.enabled)
+                {
+                    std::int32_t start_x = 0;
+                    std::int32_t start_y = 0;
+
+                    // Calculate the speed for this line
+                    // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
+                    // table index
+                    std::uint32_t speed_kmh_idx =
+                        static_cast<std::uint32_t>(round(length / forward_duration * 10 * 3.6));
+
+                    // Rate values are in meters per weight-unit - and similar to speeds, we
+                    // present 1 decimal place of precision (these values are added as
+                    // double/10) lower down
+                    std::uint32_t forward_rate =
+                        static_cast<std::uint32_t>(round(length / forward_weight * 10.));
+
+                    auto tile_line = coordinatesToTileLine(a, b, tile_bbox);
+                    if (!tile_line.empty())
+                    {
+                        encode_tile_line(tile_line,
+                                         speed_kmh_idx,
+                                         line_int_offsets[forward_rate],
+                                         line_int_offsets[forward_weight],
+                                         line_int_offsets[forward_duration],
+                                         forward_datasource_idx,
+                                         name_offset,
+                                         start_x,
+                                         start_y);
+                    }
+                }
+
+                // Repeat the above for the coordinates reversed and using the `reverse`
+                // properties
+                if (reverse_duration != 0 && edge.reverse_segment_id.enabled)
                 {
-                    const auto tile_point =
-                        coordinatesToTilePoint(std::get<0>(turndata), tile_bbox);
-                    if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
+                    std::int32_t start_x = 0;
+                    std::int32_t start_y = 0;
+
+                    // Calculate the speed for this line
+                    // Speeds are looked up in a simple 1:1 table, so the speed value == lookup
+                    // table index
+                    std::uint32_t speed_kmh_idx =
+                        static_cast<std::uint32_t>(round(length / reverse_duration * 10 * 3.6));
+
+                    // Rate values are in meters per weight-unit - and similar to speeds, we
+                    // present 1 decimal place of precision (these values are added as
+                    // double/10) lower down
+                    std::uint32_t reverse_rate =
+                        static_cast<std::uint32_t>(round(length / reverse_weight * 10.));
+
+                    auto tile_line = coordinatesToTileLine(b, a, tile_bbox);
+                    if (!tile_line.empty())
                     {
-                        continue;
+                        encode_tile_line(tile_line,
+                                         speed_kmh_idx,
+                                         line_int_offsets[reverse_rate],
+                                         line_int_offsets[reverse_weight],
+                                         line_int_offsets[reverse_duration],
+                                         reverse_datasource_idx,
+                                         name_offset,
+                                         start_x,
+                                         start_y);
                     }
-                    encode_tile_point(tile_point, turndata);
                 }
             }
+        }
 
-            // Add the names of the three attributes we added to all the turn penalty
-            // features previously.  The indexes used there refer to these keys.
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "bearing_in");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "turn_angle");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "cost");
-            point_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
+        // Field id 3 is the "keys" attribute
+        // We need two "key" fields, these are referred to with 0 and 1 (their array
+        // indexes) earlier
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "speed");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "is_small");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "datasource");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "duration");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "name");
+        line_layer_writer.add_string(util::vector_tile::KEY_TAG, "rate");
+
+        // Now, we write out the possible speed value arrays and possible is_tiny
+        // values.  Field type 4 is the "values" field.  It's a variable type field,
+        // so requires a two-step write (create the field, then write its value)
+        for (std::size_t i = 0; i < 128; i++)
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer, util::vector_tile::VARIANT_TAG);
+            // Attribute value 5 == uint64 type
+            values_writer.add_uint64(util::vector_tile::VARIANT_TYPE_UINT64, i);
+        }
+        {
+            protozero::pbf_writer values_writer(line_layer_writer, util::vector_tile::VARIANT_TAG);
+            // Attribute value 7 == bool type
+            values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, true);
+        }
+        {
+            protozero::pbf_writer values_writer(line_layer_writer, util::vector_tile::VARIANT_TAG);
+            // Attribute value 7 == bool type
+            values_writer.add_bool(util::vector_tile::VARIANT_TYPE_BOOL, false);
+        }
+        for (std::size_t i = 0; i <= max_datasource_id; i++)
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer, util::vector_tile::VARIANT_TAG);
+            // Attribute value 1 == string type
+            values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING,
+                                     facade.GetDatasourceName(i).to_string());
+        }
+        for (auto value : used_line_ints)
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer, util::vector_tile::VARIANT_TAG);
+            // Attribute value 2 == float type
+            // Durations come out of OSRM in integer deciseconds, so we convert them
+            // to seconds with a simple /10 for display
+            values_writer.add_double(util::vector_tile::VARIANT_TYPE_DOUBLE, value / 10.);
+        }
+
+        for (const auto &name : names)
+        {
+            // Writing field type 4 == variant type
+            protozero::pbf_writer values_writer(line_layer_writer, util::vector_tile::VARIANT_TAG);
+            // Attribute value 1 == string type
+            values_writer.add_string(
+                util::vector_tile::VARIANT_TYPE_STRING, name.data(), name.size());
+        }
+    }
+}
+
+// Encodes the "turns" layer with one point feature per turn
+void encodeTurnsLayer(const BBox &tile_bbox,
+                      const std::vector<routing_algorithms::TurnData> &all_turn_data,
+                      std::string &layer_buffer)
+{
+    // And again for integer values used by points.
+    std::vector<int> used_point_ints;
+    std::unordered_map<int, std::size_t> point_int_offsets;
+
+    // And again for float values used by points
+    std::vector<float> used_point_floats;
+    std::unordered_map<float, std::size_t> point_float_offsets;
+
+    // Returns the offset of an integer value in the lookup table, adding it if needed
+    const auto use_point_int_value = [&used_point_ints, &point_int_offsets](const int value) {
+        const auto found = point_int_offsets.find(value);
+        std::size_t offset;
+
+        if (found == point_int_offsets.end())
+        {
+            used_point_ints.push_back(value);
+            offset = used_point_ints.size() - 1;
+            point_int_offsets[value] = offset;
+        }
+        else
+        {
+            offset = found->second;
+        }
+
+        return offset;
+    };
+
+    // And again for float values
+    const auto use_point_float_value = [&used_point_floats,
+                                        &point_float_offsets](const float value) {
+        const auto found = point_float_offsets.find(value);
+        std::size_t offset;
 
-            // Now, save the lists of integers and floats that our features refer to.
-            for (const auto &value : used_point_ints)
+        if (found == point_float_offsets.end())
+        {
+            used_point_floats.push_back(value);
+            offset = used_point_floats.size() - 1;
+            point_float_offsets[value] = offset;
+        }
+        else
+        {
+            offset = found->second;
+        }
+
+        return offset;
+    };
+
+    // we need to pre-encode all values here because we need the full offsets later
+    // for encoding the actual features.
+    std::vector<std::tuple<util::Coordinate, unsigned, unsigned, unsigned, unsigned>>
+        encoded_turn_data(all_turn_data.size());
+    std::transform(all_turn_data.begin(),
+                   all_turn_data.end(),
+                   encoded_turn_data.begin(),
+                   [&](const routing_algorithms::TurnData &t) {
+                       auto angle_idx = use_point_int_value(t.in_angle);
+                       auto turn_idx = use_point_int_value(t.turn_angle);
+                       auto duration_idx = use_point_float_value(
+                           t.duration / 10.0); // Note conversion to float here
+                       auto weight_idx = use_point_float_value(
+                           t.weight / 10.0); // Note conversion to float here
+                       return std::make_tuple(
+                           t.coordinate, angle_idx, turn_idx, duration_idx, weight_idx);
+                   });
+
+    protozero::pbf_writer point_layer_writer{layer_buffer};
+    point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);    // version
+    point_layer_writer.add_string(util::vector_tile::NAME_TAG, "turns"); // name
+    point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                  util::vector_tile::EXTENT); // extent
+
+    // Begin writing the set of point features
+    {
+        // Start each features with an ID starting at 1
+        int id = 1;
+
+        // Helper function to encode a new point feature on a vector tile.
+        const auto encode_tile_point = [&](const FixedPoint &tile_point,
+                                           const auto &point_turn_data) {
+            protozero::pbf_writer feature_writer(point_layer_writer,
+                                                 util::vector_tile::FEATURE_TAG);
+            // Field 3 is the "geometry type" field.  Value 1 is "point"
+            feature_writer.add_enum(
+                util::vector_tile::GEOMETRY_TAG,
+                util::vector_tile::GEOMETRY_TYPE_POINT);                // geometry type
+            feature_writer.add_uint64(util::vector_tile::ID_TAG, id++); // id
             {
-                protozero::pbf_writer values_writer(point_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                values_writer.add_sint64(util::vector_tile::VARIANT_TYPE_SINT64, value);
+                // Write out the 4 properties we want on the feature.  These
+                // refer to indexes in the properties lookup table, which we
+                // add to the tile after we add all features.
+                protozero::packed_field_uint32 field(
+                    feature_writer, util::vector_tile::FEATURE_ATTRIBUTES_TAG);
+                field.add_element(0); // "bearing_in" tag key offset
+                field.add_element(std::get<1>(point_turn_data));
+                field.add_element(1); // "turn_angle" tag key offset
+                field.add_element(std::get<2>(point_turn_data));
+                field.add_element(2); // "cost" tag key offset
+                field.add_element(used_point_ints.size() + std::get<3>(point_turn_data));
+                field.add_element(3); // "weight" tag key offset
+                field.add_element(used_point_ints.size() + std::get<4>(point_turn_data));
             }
-            for (const auto &value : used_point_floats)
             {
-                protozero::pbf_writer values_writer(point_layer_writer,
-                                                    util::vector_tile::VARIANT_TAG);
-                values_writer.add_float(util::vector_tile::VARIANT_TYPE_FLOAT, value);
+                // Add the geometry as the last field in this feature
+                protozero::packed_field_uint32 geometry(
+                    feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
+                encodePoint(tile_point, geometry);
             }
-        }
+        };
 
-        // OSM Node tile layer
+        // Loop over all the turns we found and add them as features to the layer
+        for (const auto &turndata : encoded_turn_data)
         {
-            protozero::pbf_writer point_layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
-            point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);       // version
-            point_layer_writer.add_string(util::vector_tile::NAME_TAG, "osmnodes"); // name
-            point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
-                                          util::vector_tile::EXTENT); // extent
-
-            std::vector<NodeID> internal_nodes;
-            internal_nodes.reserve(edges.size() * 2);
-            for (const auto &edge : edges)
+            const auto tile_point = coordinatesToTilePoint(std::get<0>(turndata), tile_bbox);
+            if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
             {
-                internal_nodes.push_back(edge.u);
-                internal_nodes.push_back(edge.v);
+                continue;
             }
-            std::sort(internal_nodes.begin(), internal_nodes.end());
-            auto new_end = std::unique(internal_nodes.begin(), internal_nodes.end());
-            internal_nodes.resize(new_end - internal_nodes.begin());
+            encode_tile_point(tile_point, turndata);
+        }
+    }
 
-            for (const auto &internal_node : internal_nodes)
-            {
-                const auto coord = facade.GetCoordinateOfNode(internal_node);
-                const auto tile_point = coordinatesToTilePoint(coord, tile_bbox);
-                if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
-                {
-                    continue;
-                }
-                protozero::pbf_writer feature_writer(point_layer_writer,
-                                                     util::vector_tile::FEATURE_TAG);
-                // Field 3 is the "geometry type" field.  Value 1 is "point"
-                feature_writer.add_enum(util::vector_tile::GEOMETRY_TAG,
-                                        util::vector_tile::GEOMETRY_TYPE_POINT); // geometry type
-                const auto osmid =
-                    static_cast<OSMNodeID::value_type>(facade.GetOSMNodeIDOfNode(internal_node));
-                feature_writer.add_uint64(util::vector_tile::ID_TAG, osmid); // id
-                // There are no additional properties, just the ID and the geometry
-                {
-                    // Add the geometry as the last field in this feature
-                    protozero::packed_field_uint32 geometry(
-                        feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
-                    encodePoint(tile_point, geometry);
-                }
-            }
+    // Add the names of the three attributes we added to all the turn penalty
+    // features previously.  The indexes used there refer to these keys.
+    point_layer_writer.add_string(util::vector_tile::KEY_TAG, "bearing_in");
+    point_layer_writer.add_string(util::vector_tile::KEY_TAG, "turn_angle");
+    point_layer_writer.add_string(util::vector_tile::KEY_TAG, "cost");
+    point_layer_writer.add_string(util::vector_tile::KEY_TAG, "weight");
+
+    // Now, save the lists of integers and floats that our features refer to.
+    for (const auto &value : used_point_ints)
+    {
+        protozero::pbf_writer values_writer(point_layer_writer, util::vector_tile::VARIANT_TAG);
+        values_writer.add_sint64(util::vector_tile::VARIANT_TYPE_SINT64, value);
+    }
+    for (const auto &value : used_point_floats)
+    {
+        protozero::pbf_writer values_writer(point_layer_writer, util::vector_tile::VARIANT_TAG);
+        values_writer.add_float(util::vector_tile::VARIANT_TYPE_FLOAT, value);
+    }
+}
+
+// Encodes the "osmnodes" layer with the OSM ids of all nodes in the tile
+void encodeOSMNodesLayer(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const BBox &tile_bbox,
+                         const std::vector<RTreeLeaf> &edges,
+                         std::string &layer_buffer)
+{
+    protozero::pbf_writer point_layer_writer{layer_buffer};
+    point_layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);       // version
+    point_layer_writer.add_string(util::vector_tile::NAME_TAG, "osmnodes"); // name
+    point_layer_writer.add_uint32(util::vector_tile::EXTENT_TAG,
+                                  util::vector_tile::EXTENT); // extent
+
+    std::vector<NodeID> internal_nodes;
+    internal_nodes.reserve(edges.size() * 2);
+    for (const auto &edge : edges)
+    {
+        internal_nodes.push_back(edge.u);
+        internal_nodes.push_back(edge.v);
+    }
+    std::sort(internal_nodes.begin(), internal_nodes.end());
+    auto new_end = std::unique(internal_nodes.begin(), internal_nodes.end());
+    internal_nodes.resize(new_end - internal_nodes.begin());
+
+    for (const auto &internal_node : internal_nodes)
+    {
+        const auto coord = facade.GetCoordinateOfNode(internal_node);
+        const auto tile_point = coordinatesToTilePoint(coord, tile_bbox);
+        if (!boost::geometry::within(point_t(tile_point.x, tile_point.y), clip_box))
+        {
+            continue;
+        }
+        protozero::pbf_writer feature_writer(point_layer_writer, util::vector_tile::FEATURE_TAG);
+        // Field 3 is the "geometry type" field.  Value 1 is "point"
+        feature_writer.add_enum(util::vector_tile::GEOMETRY_TAG,
+                                util::vector_tile::GEOMETRY_TYPE_POINT); // geometry type
+        const auto osmid =
+            static_cast<OSMNodeID::value_type>(facade.GetOSMNodeIDOfNode(internal_node));
+        feature_writer.add_uint64(util::vector_tile::ID_TAG, osmid); // id
+        // There are no additional properties, just the ID and the geometry
+        {
+            // Add the geometry as the last field in this feature
+            protozero::packed_field_uint32 geometry(
+                feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
+            encodePoint(tile_point, geometry);
         }
     }
-    // protozero serializes data during object destructors, so once the scope closes,
-    // our result buffer will have all the tile data encoded into it.
 }
 }
 
@@ -893,17 +858,51 @@ Status TilePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
 
     auto edge_index = getEdgeIndex(edges);
 
-    std::vector<routing_algorithms::TurnData> turns;
+    // Convert tile coordinates into mercator coordinates
+    double min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat;
+    util::web_mercator::xyzToMercator(parameters.x,
+                                      parameters.y,
+                                      parameters.z,
+                                      min_mercator_lon,
+                                      min_mercator_lat,
+                                      max_mercator_lon,
+                                      max_mercator_lat);
+    const BBox tile_bbox{min_mercator_lon, min_mercator_lat, max_mercator_lon, max_mercator_lat};
 
-    // If we're zooming into 16 or higher, include turn data.  Why?  Because turns make the map
-    // really cramped, so we don't bother including the data for tiles that span a large area.
-    if (parameters.z >= MIN_ZOOM_FOR_TURNS && algorithms.HasGetTileTurns())
+    // The layers do not depend on each other, so they are encoded into separate buffers in
+    // parallel. Turn generation is the most expensive part of large tiles and overlaps with
+    // encoding the other layers.
+    std::string speeds_layer;
+    std::string turns_layer;
+    std::string osmnodes_layer;
+    tbb::parallel_invoke(
+        [&] { encodeSpeedsLayer(facade, tile_bbox, edges, edge_index, speeds_layer); },
+        [&] {
+            // If we're zooming into 16 or higher, include turn data.  Why?  Because turns make
+            // the map really cramped, so we don't bother including the data for tiles that span
+            // a large area.
+            if (parameters.z >= MIN_ZOOM_FOR_TURNS && algorithms.HasGetTileTurns())
+            {
+                const auto turns = algorithms.GetTileTurns(edges, edge_index);
+
+                // Only add the turn layer to the tile if it has some features (we sometimes
+                // won't for tiles that don't show any intersections)
+                if (!turns.empty())
+                {
+                    encodeTurnsLayer(tile_bbox, turns, turns_layer);
+                }
+            }
+        },
+        [&] { encodeOSMNodesLayer(facade, tile_bbox, edges, osmnodes_layer); });
+
+    // Add the layer objects to the PBF stream.  3=='layer' from the vector tile spec (2.1)
+    protozero::pbf_writer tile_writer{pbf_buffer};
+    tile_writer.add_message(util::vector_tile::LAYER_TAG, speeds_layer);
+    if (!turns_layer.empty())
     {
-        turns = algorithms.GetTileTurns(edges, edge_index);
+        tile_writer.add_message(util::vector_tile::LAYER_TAG, turns_layer);
     }
-
-    encodeVectorTile(
-        facade, parameters.x, parameters.y, parameters.z, edges, edge_index, turns, pbf_buffer);
+    tile_writer.add_message(util::vector_tile::LAYER_TAG, osmnodes_layer);
 
     return Status::Ok;
 }
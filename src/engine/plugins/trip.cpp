@@ -4,6 +4,8 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 #include "util/json_container.hpp"
@@ -11,6 +13,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -187,6 +190,12 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
         return Error("TooBig", "Too many trip coordinates", json_result);
     }
 
+    if (parameters.solver == api::TripParameters::SolverType::Exact &&
+        number_of_locations > trip::HK_MAX_FEASIBLE)
+    {
+        return Error("TooBig", "Too many trip coordinates for the exact solver", json_result);
+    }
+
     if (!CheckAllCoordinates(parameters.coordinates))
     {
         return Error("InvalidValue", "Invalid coordinate value.", json_result);
@@ -222,6 +231,9 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
     }
 
     const constexpr std::size_t BF_MAX_FEASABLE = 10;
+    // exact trips of up to this size are computed in a few milliseconds
+    const constexpr std::size_t HK_MAX_AUTO = 14;
+    const constexpr std::chrono::milliseconds LOCAL_SEARCH_TIME_BUDGET{100};
     BOOST_ASSERT_MSG(result_table.size() == number_of_locations * number_of_locations,
                      "Distance Table has wrong size");
 
@@ -238,13 +250,19 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
     std::vector<NodeID> trip;
     trip.reserve(number_of_locations);
     // get an optimized order in which the destinations should be visited
-    if (number_of_locations < BF_MAX_FEASABLE)
+    using SolverType = api::TripParameters::SolverType;
+    if (parameters.solver != SolverType::Heuristic && number_of_locations < BF_MAX_FEASABLE)
     {
         trip = trip::BruteForceTrip(number_of_locations, result_table);
     }
+    else if (parameters.solver == SolverType::Exact ||
+             (parameters.solver == SolverType::Auto && number_of_locations <= HK_MAX_AUTO))
+    {
+        trip = trip::HeldKarpTrip(number_of_locations, result_table);
+    }
     else
     {
-        trip = trip::FarthestInsertionTrip(number_of_locations, result_table);
+        trip = trip::LocalSearchTrip(number_of_locations, result_table, LOCAL_SEARCH_TIME_BUDGET);
     }
 
     // rotate result such that roundtrip starts at node with index 0
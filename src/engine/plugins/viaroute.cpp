@@ -30,10 +30,20 @@ Status
 ViaRoutePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                               const RoutingAlgorithmsInterface &algorithms,
                               const api::RouteParameters &route_parameters,
-                              util::json::Object &json_result) const
+                              api::ResultT &result) const
 {
     BOOST_ASSERT(route_parameters.IsValid());
 
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+
+    const auto binary_response =
+        route_parameters.format == api::BaseParameters::OutputFormatType::PBF;
+    if (binary_response && route_parameters.steps)
+    {
+        return Error("InvalidOptions", "Steps are not supported by the binary format", json_result);
+    }
+
     if (!algorithms.HasShortestPathSearch() && route_parameters.coordinates.size() > 2)
     {
         return Error("NotImplemented",
@@ -127,7 +137,16 @@ ViaRoutePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFaca
 
     if (routes.routes[0].is_valid())
     {
-        route_api.MakeResponse(routes, json_result);
+        if (binary_response)
+        {
+            std::string pbf_result;
+            route_api.MakeResponse(routes, pbf_result);
+            result = std::move(pbf_result);
+        }
+        else
+        {
+            route_api.MakeResponse(routes, json_result);
+        }
     }
     else
     {
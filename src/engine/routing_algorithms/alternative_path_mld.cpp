@@ -1,6 +1,8 @@
+#include "engine/request_parallelism.hpp"
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
 
+#include "util/integer_range.hpp"
 #include "util/static_assert.hpp"
 
 #include <boost/assert.hpp>
@@ -9,6 +11,7 @@
 #include <iterator>
 #include <memory>
 #include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -350,16 +353,24 @@ RandIt filterPackedPathsByLocalOptimality(const WeightedViaNodePackedPath &path,
         const auto plateaux_length =
             forward_heap.GetKey(last_on_plateaux) - forward_heap.GetKey(first_on_plateaux);
 
+        // The same edge has different ids in the forward and reverse search spaces
+        const auto same_nodes = [](const PackedEdge &lhs, const PackedEdge &rhs) {
+            return std::get<0>(lhs) == std::get<0>(rhs) && std::get<1>(lhs) == std::get<1>(rhs) &&
+                   std::get<2>(lhs) == std::get<2>(rhs);
+        };
+
         // Find a/b as the first location where packed and path differ
         const auto a = std::get<0>(*std::mismatch(packed.path.begin(), //
                                                   packed.path.end(),
                                                   path.path.begin(),
-                                                  path.path.end())
+                                                  path.path.end(),
+                                                  same_nodes)
                                         .first);
         const auto b = std::get<1>(*std::mismatch(packed.path.rbegin(), //
                                                   packed.path.rend(),
                                                   path.path.rbegin(),
-                                                  path.path.rend())
+                                                  path.path.rend(),
+                                                  same_nodes)
                                         .first);
 
         BOOST_ASSERT(forward_heap.WasInserted(a));
@@ -375,7 +386,8 @@ RandIt filterPackedPathsByLocalOptimality(const WeightedViaNodePackedPath &path,
 
 // Filters unpacked paths compared to all other paths. Mutates range in-place.
 // Returns an iterator to the filtered range's new end.
-template <typename RandIt> RandIt filterUnpackedPathsBySharing(RandIt first, RandIt last)
+template <typename RandIt>
+RandIt filterUnpackedPathsBySharing(RandIt first, RandIt last, const Facade &facade)
 {
     util::static_assert_iter_category<RandIt, std::random_access_iterator_tag>();
     util::static_assert_iter_value<RandIt, WeightedViaNodeUnpackedPath>();
@@ -390,13 +402,21 @@ template <typename RandIt> RandIt filterUnpackedPathsBySharing(RandIt first, Ran
     if (shortest_path.edges.empty())
         return last;
 
-    std::unordered_set<EdgeID> edges;
-    edges.reserve(size * shortest_path.edges.size() * (1. + kAtMostLongerBy));
+    // Unpacked paths carry the edge ids relaxed by the forward or the reverse search, which
+    // differ for the same edge. Compare the turns of the edges instead.
+    const auto get_turn = [&facade](const EdgeID edge) { return facade.GetEdgeData(edge).turn_id; };
 
-    edges.insert(begin(shortest_path.edges), begin(shortest_path.edges));
+    std::unordered_set<NodeID> turns;
+    turns.reserve(size * shortest_path.edges.size() * (1. + kAtMostLongerBy));
+
+    const auto insert_turns = [&](auto edges_first, auto edges_last) {
+        std::transform(edges_first, edges_last, std::inserter(turns, turns.end()), get_turn);
+    };
+
+    insert_turns(begin(shortest_path.edges), begin(shortest_path.edges));
 
     const auto over_sharing_limit = [&](const auto &unpacked) {
-        const auto not_seen = [&](const EdgeID edge) { return edges.count(edge) < 1; };
+        const auto not_seen = [&](const EdgeID edge) { return turns.count(get_turn(edge)) < 1; };
         const auto different = std::count_if(begin(unpacked.edges), end(unpacked.edges), not_seen);
 
         const auto difference = different / static_cast<double>(unpacked.edges.size());
@@ -411,7 +431,7 @@ template <typename RandIt> RandIt filterUnpackedPathsBySharing(RandIt first, Ran
         }
         else
         {
-            edges.insert(begin(unpacked.edges), end(unpacked.edges));
+            insert_turns(begin(unpacked.edges), end(unpacked.edges));
             return false;
         }
     };
@@ -443,7 +463,12 @@ filterAnnotatedRoutesByStretch(RandIt first, RandIt last, const InternalRouteRes
 }
 
 // Unpacks a range of WeightedViaNodePackedPaths into a range of WeightedViaNodeUnpackedPaths.
-// Note: destroys search engine heaps for recursive unpacking. Extract heap data you need before.
+//
+// The candidate paths all start at s and end at t and mostly differ around their via nodes only,
+// so they share most of their overlay edges. Each distinct overlay edge is unpacked exactly once.
+// With a request parallelism the unpackings run in parallel and every task gets its own heaps,
+// otherwise they use the search engine heaps. The paths are assembled from the shared results
+// afterwards, which yields the same paths as unpacking one by one.
 template <typename InputIt, typename OutIt>
 void unpackPackedPaths(InputIt first,
                        InputIt last,
@@ -461,8 +486,77 @@ void unpackPackedPaths(InputIt first,
 
     const Partition &partition = facade.GetMultiLevelPartition();
 
-    Heap &forward_heap = *search_engine_data.forward_heap_1;
-    Heap &reverse_heap = *search_engine_data.reverse_heap_1;
+    const auto make_key = [&](const PackedEdge &packed_edge) {
+        const auto source = std::get<0>(packed_edge);
+        const auto level = getNodeSearchLevel(
+            partition, search_engine_data.conditional_turns, source, phantom_node_pair);
+        return UnpackingKey{level,
+                            partition.GetCell(level, source),
+                            source,
+                            std::get<1>(packed_edge),
+                            force_loop_forward,
+                            force_loop_backward};
+    };
+
+    // Collect the distinct overlay edges of all candidate paths
+    std::unordered_map<UnpackingKey, std::size_t, UnpackingKeyHash> overlay_edge_index;
+    std::vector<UnpackingKey> overlay_edges;
+    for (auto it = first; it != last; ++it)
+    {
+        for (const auto &packed_edge : it->path)
+        {
+            if (!std::get<2>(packed_edge))
+                continue;
+
+            const auto key = make_key(packed_edge);
+            if (overlay_edge_index.emplace(key, overlay_edges.size()).second)
+                overlay_edges.push_back(key);
+        }
+    }
+
+    std::vector<UnpackedSubpath> subpaths(overlay_edges.size());
+    const auto unpack_overlay_edges = [&](Heap &forward_heap,
+                                          Heap &reverse_heap,
+                                          const std::size_t begin,
+                                          const std::size_t end) {
+        for (const auto index : util::irange(begin, end))
+        {
+            const auto &key = overlay_edges[index];
+            auto &subpath = subpaths[index];
+            subpath.nodes.push_back(key.source);
+            unpackOverlayEdge(search_engine_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              force_loop_forward,
+                              force_loop_backward,
+                              key.level,
+                              key.source,
+                              key.target,
+                              subpath.nodes,
+                              subpath.edges);
+        }
+    };
+
+    const auto parallelism = search_engine_data.request_parallelism;
+    if (parallelism > 1 && overlay_edges.size() > 1)
+    {
+        const auto number_of_nodes = facade.GetNumberOfNodes();
+        parallelForRequest(
+            parallelism, overlay_edges.size(), [&](const std::size_t begin, const std::size_t end) {
+                Heap forward_heap(number_of_nodes);
+                Heap reverse_heap(number_of_nodes);
+                unpack_overlay_edges(forward_heap, reverse_heap, begin, end);
+            });
+    }
+    else
+    {
+        // destroys the search engine heaps, the candidate search is done with them
+        unpack_overlay_edges(*search_engine_data.forward_heap_1,
+                             *search_engine_data.reverse_heap_1,
+                             0,
+                             overlay_edges.size());
+    }
 
     for (auto it = first; it != last; ++it, ++out)
     {
@@ -471,11 +565,6 @@ void unpackPackedPaths(InputIt first,
 
         const auto &packed_path = it->path;
 
-        //
-        // Todo: dup. code with mld::search except for level entry: we run a slight mld::search
-        //       adaption here and then dispatch to mld::search for recursively descending down.
-        //
-
         std::vector<NodeID> unpacked_nodes;
         std::vector<EdgeID> unpacked_edges;
         unpacked_nodes.reserve(packed_path.size());
@@ -496,50 +585,19 @@ void unpackPackedPaths(InputIt first,
 
         for (auto const &packed_edge : packed_path)
         {
-            NodeID source, target;
-            bool overlay_edge;
-            std::tie(source, target, overlay_edge) = packed_edge;
-            if (!overlay_edge)
+            if (!std::get<2>(packed_edge))
             { // a base graph edge
-                unpacked_nodes.push_back(target);
-                unpacked_edges.push_back(facade.FindEdge(source, target));
+                unpacked_nodes.push_back(std::get<1>(packed_edge));
+                unpacked_edges.push_back(getPackedEdgeID(facade, packed_edge));
             }
             else
-            { // an overlay graph edge
-                LevelID level = getNodeQueryLevel(partition, source, phantom_node_pair); // XXX
-                CellID parent_cell_id = partition.GetCell(level, source);
-                BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-                LevelID sublevel = level - 1;
-
-                // Here heaps can be reused, let's go deeper!
-                forward_heap.Clear();
-                reverse_heap.Clear();
-                forward_heap.Insert(source, 0, {source});
-                reverse_heap.Insert(target, 0, {target});
-
-                // TODO: when structured bindings will be allowed change to
-                // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-                EdgeWeight subpath_weight;
-                std::vector<NodeID> subpath_nodes;
-                std::vector<EdgeID> subpath_edges;
-                std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(search_engine_data,
-                                                                                facade,
-                                                                                forward_heap,
-                                                                                reverse_heap,
-                                                                                force_loop_forward,
-                                                                                force_loop_backward,
-                                                                                INVALID_EDGE_WEIGHT,
-                                                                                sublevel,
-                                                                                parent_cell_id);
-                BOOST_ASSERT(!subpath_edges.empty());
-                BOOST_ASSERT(subpath_nodes.size() > 1);
-                BOOST_ASSERT(subpath_nodes.front() == source);
-                BOOST_ASSERT(subpath_nodes.back() == target);
-                unpacked_nodes.insert(
-                    unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+            { // an overlay graph edge, the subpath starts with the source node
+                const auto &subpath = subpaths[overlay_edge_index.at(make_key(packed_edge))];
+                unpacked_nodes.insert(unpacked_nodes.end(),
+                                      std::next(subpath.nodes.begin()),
+                                      subpath.nodes.end());
                 unpacked_edges.insert(
-                    unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+                    unpacked_edges.end(), subpath.edges.begin(), subpath.edges.end());
             }
         }
 
@@ -614,6 +672,7 @@ makeCandidateVias(SearchEngineData<Algorithm> &search_engine_data,
                                            overlap_weight,
                                            force_loop_forward,
                                            force_loop_backward,
+                                           search_engine_data.conditional_turns,
                                            phantom_node_pair);
 
             if (!forward_heap.Empty())
@@ -640,6 +699,7 @@ makeCandidateVias(SearchEngineData<Algorithm> &search_engine_data,
                                            overlap_weight,
                                            force_loop_forward,
                                            force_loop_backward,
+                                           search_engine_data.conditional_turns,
                                            phantom_node_pair);
 
             if (!reverse_heap.Empty())
@@ -874,7 +934,6 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
     std::vector<WeightedViaNodeUnpackedPath> unpacked_paths;
     unpacked_paths.reserve(number_of_packed_paths);
 
-    // Note: re-uses (read: destroys) heaps; we don't need them from here on anyway.
     unpackPackedPaths(paths_first,
                       paths_last,
                       std::back_inserter(unpacked_paths),
@@ -889,7 +948,8 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
 
     auto unpacked_paths_last = end(unpacked_paths);
 
-    unpacked_paths_last = filterUnpackedPathsBySharing(begin(unpacked_paths), end(unpacked_paths));
+    unpacked_paths_last =
+        filterUnpackedPathsBySharing(begin(unpacked_paths), end(unpacked_paths), facade);
 
     const auto unpacked_paths_first = begin(unpacked_paths);
     const auto number_of_unpacked_paths =
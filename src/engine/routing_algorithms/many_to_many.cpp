@@ -56,7 +56,8 @@ addLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm
 }
 
 template <bool DIRECTION>
-void relaxOutgoingEdges(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+void relaxOutgoingEdges(const SearchEngineData<ch::Algorithm> &,
+                        const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
                         const NodeID node,
                         const EdgeWeight weight,
                         const EdgeDuration duration,
@@ -107,6 +108,7 @@ inline bool addLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<m
 
 template <bool DIRECTION>
 void relaxOutgoingEdges(
+    const SearchEngineData<mld::Algorithm> &engine_working_data,
     const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
     const NodeID node,
     const EdgeWeight weight,
@@ -116,86 +118,99 @@ void relaxOutgoingEdges(
 {
     const auto &partition = facade.GetMultiLevelPartition();
     const auto &cells = facade.GetCellStorage();
+    const auto &metric = facade.GetCellMetric();
 
     auto highest_diffrent_level = [&partition, node](const SegmentID &phantom_node) {
         if (phantom_node.enabled)
             return partition.GetHighestDifferentLevel(phantom_node.id, node);
         return INVALID_LEVEL_ID;
     };
-    const auto level = std::min(highest_diffrent_level(phantom_node.forward_segment_id),
-                                highest_diffrent_level(phantom_node.reverse_segment_id));
+    const auto &conditional_turns = engine_working_data.conditional_turns;
+    const auto level = std::min({highest_diffrent_level(phantom_node.forward_segment_id),
+                                 highest_diffrent_level(phantom_node.reverse_segment_id),
+                                 conditional_turns.GetMaxLevel(partition, node)});
 
     const auto &node_data = query_heap.GetData(node);
 
     if (level >= 1 && !node_data.from_clique_arc)
     {
-        const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
-        if (DIRECTION == FORWARD_DIRECTION)
-        { // Shortcuts in forward direction
-            auto destination = cell.GetDestinationNodes().begin();
-            auto shortcut_durations = cell.GetOutDuration(node);
-            for (auto shortcut_weight : cell.GetOutWeight(node))
-            {
-                BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
-                BOOST_ASSERT(!shortcut_durations.empty());
-                const NodeID to = *destination;
-                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
+        const auto relax_shortcuts = [&](const auto &cell) {
+            if (DIRECTION == FORWARD_DIRECTION)
+            { // Shortcuts in forward direction
+                auto destination = cell.GetDestinationNodes().begin();
+                auto shortcut_durations = cell.GetOutDuration(node);
+                for (auto shortcut_weight : cell.GetOutWeight(node))
                 {
-                    const auto to_weight = weight + shortcut_weight;
-                    const auto to_duration = duration + shortcut_durations.front();
-                    if (!query_heap.WasInserted(to))
-                    {
-                        query_heap.Insert(to, to_weight, {node, true, to_duration});
-                    }
-                    else if (to_weight < query_heap.GetKey(to))
+                    BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
+                    BOOST_ASSERT(!shortcut_durations.empty());
+                    const NodeID to = *destination;
+                    if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
                     {
-                        query_heap.GetData(to) = {node, true, to_duration};
-                        query_heap.DecreaseKey(to, to_weight);
+                        const auto to_weight = weight + shortcut_weight;
+                        const auto to_duration = duration + shortcut_durations.front();
+                        if (!query_heap.WasInserted(to))
+                        {
+                            query_heap.Insert(to, to_weight, {node, true, to_duration});
+                        }
+                        else if (to_weight < query_heap.GetKey(to))
+                        {
+                            query_heap.GetData(to) = {node, true, to_duration};
+                            query_heap.DecreaseKey(to, to_weight);
+                        }
                     }
+                    ++destination;
+                    shortcut_durations.advance_begin(1);
                 }
-                ++destination;
-                shortcut_durations.advance_begin(1);
+                BOOST_ASSERT(shortcut_durations.empty());
             }
-            BOOST_ASSERT(shortcut_durations.empty());
-        }
-        else
-        { // Shortcuts in backward direction
-            auto source = cell.GetSourceNodes().begin();
-            auto shortcut_durations = cell.GetInDuration(node);
-            for (auto shortcut_weight : cell.GetInWeight(node))
-            {
-                BOOST_ASSERT(source != cell.GetSourceNodes().end());
-                BOOST_ASSERT(!shortcut_durations.empty());
-                const NodeID to = *source;
-                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
+            else
+            { // Shortcuts in backward direction
+                auto source = cell.GetSourceNodes().begin();
+                auto shortcut_durations = cell.GetInDuration(node);
+                for (auto shortcut_weight : cell.GetInWeight(node))
                 {
-                    const auto to_weight = weight + shortcut_weight;
-                    const auto to_duration = duration + shortcut_durations.front();
-                    if (!query_heap.WasInserted(to))
-                    {
-                        query_heap.Insert(to, to_weight, {node, true, to_duration});
-                    }
-                    else if (to_weight < query_heap.GetKey(to))
+                    BOOST_ASSERT(source != cell.GetSourceNodes().end());
+                    BOOST_ASSERT(!shortcut_durations.empty());
+                    const NodeID to = *source;
+                    if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
                     {
-                        query_heap.GetData(to) = {node, true, to_duration};
-                        query_heap.DecreaseKey(to, to_weight);
+                        const auto to_weight = weight + shortcut_weight;
+                        const auto to_duration = duration + shortcut_durations.front();
+                        if (!query_heap.WasInserted(to))
+                        {
+                            query_heap.Insert(to, to_weight, {node, true, to_duration});
+                        }
+                        else if (to_weight < query_heap.GetKey(to))
+                        {
+                            query_heap.GetData(to) = {node, true, to_duration};
+                            query_heap.DecreaseKey(to, to_weight);
+                        }
                     }
+                    ++source;
+                    shortcut_durations.advance_begin(1);
                 }
-                ++source;
-                shortcut_durations.advance_begin(1);
+                BOOST_ASSERT(shortcut_durations.empty());
             }
-            BOOST_ASSERT(shortcut_durations.empty());
-        }
+        };
+
+        const auto cell_id = partition.GetCell(level, node);
+        if (metric.IsQuantized())
+            relax_shortcuts(cells.GetQuantizedCell(metric, level, cell_id));
+        else
+            relax_shortcuts(cells.GetCell(metric, level, cell_id));
     }
 
     for (const auto edge : facade.GetBorderEdgeRange(level, node))
     {
         const auto &data = facade.GetEdgeData(edge);
-        if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
+        if ((DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward) &&
+            !conditional_turns.IsRestricted(facade, node, edge, DIRECTION == REVERSE_DIRECTION))
         {
             const NodeID to = facade.GetTarget(edge);
-            const EdgeWeight edge_weight = data.weight;
-            const EdgeWeight edge_duration = data.duration;
+            // the weight of an edge belongs to the node it leaves
+            const auto from = DIRECTION == FORWARD_DIRECTION ? node : to;
+            const EdgeWeight edge_weight = facade.GetEdgeWeight(edge, from);
+            const EdgeWeight edge_duration = facade.GetEdgeDuration(edge, from);
 
             BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
             const EdgeWeight to_weight = weight + edge_weight;
@@ -218,7 +233,8 @@ void relaxOutgoingEdges(
 }
 
 template <typename Algorithm>
-void forwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+void forwardRoutingStep(const SearchEngineData<Algorithm> &engine_working_data,
+                        const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                         const unsigned row_idx,
                         const unsigned number_of_targets,
                         typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
@@ -267,12 +283,18 @@ void forwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Alg
         }
     }
 
-    relaxOutgoingEdges<FORWARD_DIRECTION>(
-        facade, node, source_weight, source_duration, query_heap, phantom_node);
+    relaxOutgoingEdges<FORWARD_DIRECTION>(engine_working_data,
+                                          facade,
+                                          node,
+                                          source_weight,
+                                          source_duration,
+                                          query_heap,
+                                          phantom_node);
 }
 
 template <typename Algorithm>
-void backwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+void backwardRoutingStep(const SearchEngineData<Algorithm> &engine_working_data,
+                         const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                          const unsigned column_idx,
                          typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
                          SearchSpaceWithBuckets &search_space_with_buckets,
@@ -285,8 +307,13 @@ void backwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Al
     // store settled nodes in search space bucket
     search_space_with_buckets[node].emplace_back(column_idx, target_weight, target_duration);
 
-    relaxOutgoingEdges<REVERSE_DIRECTION>(
-        facade, node, target_weight, target_duration, query_heap, phantom_node);
+    relaxOutgoingEdges<REVERSE_DIRECTION>(engine_working_data,
+                                          facade,
+                                          node,
+                                          target_weight,
+                                          target_duration,
+                                          query_heap,
+                                          phantom_node);
 }
 }
 
@@ -322,7 +349,12 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
         // explore search space
         while (!query_heap.Empty())
         {
-            backwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets, phantom);
+            backwardRoutingStep(engine_working_data,
+                                facade,
+                                column_idx,
+                                query_heap,
+                                search_space_with_buckets,
+                                phantom);
         }
         ++column_idx;
     };
@@ -337,7 +369,8 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
         // explore search space
         while (!query_heap.Empty())
         {
-            forwardRoutingStep(facade,
+            forwardRoutingStep(engine_working_data,
+                               facade,
                                row_idx,
                                number_of_targets,
                                query_heap,
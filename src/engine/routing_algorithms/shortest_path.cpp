@@ -2,8 +2,12 @@
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
 
+#include "engine/request_parallelism.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
+
+#include <array>
 #include <memory>
 
 namespace osrm
@@ -177,28 +181,201 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
     }
 }
 
+// Shortest paths of a single leg that do not depend on the previous legs. With u-turns at the
+// waypoint this is one path from all source to all target nodes, otherwise the paths from each
+// source node to each target node, indexed by 0 for the forward and 1 for the reverse node.
+// The weights contain the phantom offsets but not the weights of the previous legs.
+struct IndependentLeg
+{
+    EdgeWeight uturn_weight = INVALID_EDGE_WEIGHT;
+    std::vector<NodeID> uturn_path;
+    std::array<std::array<EdgeWeight, 2>, 2> weights = {
+        {{{INVALID_EDGE_WEIGHT, INVALID_EDGE_WEIGHT}},
+         {{INVALID_EDGE_WEIGHT, INVALID_EDGE_WEIGHT}}}};
+    std::array<std::array<std::vector<NodeID>, 2>, 2> paths;
+};
+
+template <typename Algorithm>
+IndependentLeg
+searchIndependentLeg(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                     typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                     const bool allow_uturn_at_waypoint,
+                     const bool search_from_forward_node,
+                     const bool search_from_reverse_node,
+                     const PhantomNodes &phantom_node_pair)
+{
+    IndependentLeg leg;
+
+    const auto &source_phantom = phantom_node_pair.source_phantom;
+    const auto &target_phantom = phantom_node_pair.target_phantom;
+    const bool search_to_forward_node = target_phantom.IsValidForwardTarget();
+    const bool search_to_reverse_node = target_phantom.IsValidReverseTarget();
+
+    if (!search_to_forward_node && !search_to_reverse_node)
+        return leg;
+
+    if (allow_uturn_at_waypoint)
+    {
+        searchWithUTurn(engine_working_data,
+                        facade,
+                        forward_heap,
+                        reverse_heap,
+                        search_from_forward_node,
+                        search_from_reverse_node,
+                        search_to_forward_node,
+                        search_to_reverse_node,
+                        source_phantom,
+                        target_phantom,
+                        0,
+                        0,
+                        leg.uturn_weight,
+                        leg.uturn_path);
+        return leg;
+    }
+
+    // one search per source node, so the weights of the previous legs can be added later
+    for (const auto source : {0, 1})
+    {
+        if (!(source == 0 ? search_from_forward_node : search_from_reverse_node))
+            continue;
+
+        search(engine_working_data,
+               facade,
+               forward_heap,
+               reverse_heap,
+               source == 0,
+               source == 1,
+               search_to_forward_node,
+               search_to_reverse_node,
+               source_phantom,
+               target_phantom,
+               0,
+               0,
+               leg.weights[source][0],
+               leg.weights[source][1],
+               leg.paths[source][0],
+               leg.paths[source][1]);
+    }
+
+    return leg;
+}
+
+// Picks the paths to the target nodes of an independently searched leg that continue the
+// previous legs, this gives the weights a search from both source nodes would find.
+inline void connectIndependentLeg(IndependentLeg &leg,
+                                  const bool search_from_forward_node,
+                                  const bool search_from_reverse_node,
+                                  const int total_weight_to_forward,
+                                  const int total_weight_to_reverse,
+                                  int &new_total_weight_to_forward,
+                                  int &new_total_weight_to_reverse,
+                                  std::vector<NodeID> &leg_packed_path_forward,
+                                  std::vector<NodeID> &leg_packed_path_reverse)
+{
+    const std::array<bool, 2> search_from = {{search_from_forward_node, search_from_reverse_node}};
+    const std::array<int, 2> total_weight = {{total_weight_to_forward, total_weight_to_reverse}};
+
+    const auto connect = [&](const std::size_t target, int &new_total_weight, auto &path) {
+        for (const auto source : {0, 1})
+        {
+            if (!search_from[source] || leg.weights[source][target] == INVALID_EDGE_WEIGHT)
+                continue;
+
+            const auto weight = total_weight[source] + leg.weights[source][target];
+            if (weight < new_total_weight)
+            {
+                new_total_weight = weight;
+                path = std::move(leg.paths[source][target]);
+            }
+        }
+    };
+
+    connect(0, new_total_weight_to_forward, leg_packed_path_forward);
+    connect(1, new_total_weight_to_reverse, leg_packed_path_reverse);
+}
+
+// Searches all legs in parallel. The source nodes of a leg are the valid target nodes of the
+// previous leg, if a previous leg can not reach one of them the dynamic program skips it.
+template <typename Algorithm>
+std::vector<IndependentLeg>
+searchIndependentLegs(SearchEngineData<Algorithm> &engine_working_data,
+                      const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                      const std::vector<PhantomNodes> &phantom_nodes_vector,
+                      const bool allow_uturn_at_waypoint)
+{
+    std::vector<IndependentLeg> legs(phantom_nodes_vector.size());
+
+    parallelForRequest(
+        engine_working_data.request_parallelism,
+        legs.size(),
+        [&](const std::size_t begin, const std::size_t end) {
+            typename SearchEngineData<Algorithm>::QueryHeap forward_heap(
+                facade.GetNumberOfNodes());
+            typename SearchEngineData<Algorithm>::QueryHeap reverse_heap(
+                facade.GetNumberOfNodes());
+
+            for (const auto index : util::irange(begin, end))
+            {
+                const auto &source_phantom = phantom_nodes_vector[index].source_phantom;
+                const auto &previous_target_phantom =
+                    phantom_nodes_vector[index > 0 ? index - 1 : 0].target_phantom;
+                const bool search_from_forward_node =
+                    index == 0 ? source_phantom.IsValidForwardSource()
+                               : previous_target_phantom.IsValidForwardTarget();
+                const bool search_from_reverse_node =
+                    index == 0 ? source_phantom.IsValidReverseSource()
+                               : previous_target_phantom.IsValidReverseTarget();
+
+                legs[index] = searchIndependentLeg(engine_working_data,
+                                                   facade,
+                                                   forward_heap,
+                                                   reverse_heap,
+                                                   allow_uturn_at_waypoint,
+                                                   search_from_forward_node,
+                                                   search_from_reverse_node,
+                                                   phantom_nodes_vector[index]);
+            }
+        });
+
+    return legs;
+}
+
 template <typename Algorithm>
 void unpackLegs(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                 const std::vector<PhantomNodes> &phantom_nodes_vector,
                 const std::vector<NodeID> &total_packed_path,
                 const std::vector<std::size_t> &packed_leg_begin,
                 const EdgeWeight shortest_path_weight,
+                const unsigned request_parallelism,
                 InternalRouteResult &raw_route_data)
 {
-    raw_route_data.unpacked_path_segments.resize(packed_leg_begin.size() - 1);
+    const auto number_of_legs = packed_leg_begin.size() - 1;
+    raw_route_data.unpacked_path_segments.resize(number_of_legs);
 
     raw_route_data.shortest_path_weight = shortest_path_weight;
 
-    for (const auto current_leg : util::irange<std::size_t>(0UL, packed_leg_begin.size() - 1))
+    const auto unpack_legs = [&](const std::size_t begin, const std::size_t end) {
+        for (const auto current_leg : util::irange(begin, end))
+        {
+            unpackPath(facade,
+                       total_packed_path.begin() + packed_leg_begin[current_leg],
+                       total_packed_path.begin() + packed_leg_begin[current_leg + 1],
+                       phantom_nodes_vector[current_leg],
+                       raw_route_data.unpacked_path_segments[current_leg]);
+        }
+    };
+
+    if (request_parallelism > 1 && number_of_legs > 1)
+        parallelForRequest(request_parallelism, number_of_legs, unpack_legs);
+    else
+        unpack_legs(0, number_of_legs);
+
+    for (const auto current_leg : util::irange<std::size_t>(0UL, number_of_legs))
     {
         auto leg_begin = total_packed_path.begin() + packed_leg_begin[current_leg];
         auto leg_end = total_packed_path.begin() + packed_leg_begin[current_leg + 1];
-        const auto &unpack_phantom_node_pair = phantom_nodes_vector[current_leg];
-        unpackPath(facade,
-                   leg_begin,
-                   leg_end,
-                   unpack_phantom_node_pair,
-                   raw_route_data.unpacked_path_segments[current_leg]);
 
         raw_route_data.source_traversed_in_reverse.push_back(
             (*leg_begin != phantom_nodes_vector[current_leg].source_phantom.forward_segment_id.id));
@@ -207,14 +384,16 @@ void unpackLegs(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
              phantom_nodes_vector[current_leg].target_phantom.forward_segment_id.id));
     }
 }
-}
 
+// Searches a route with the given heaps, the legs searched in parallel use heaps of their own
 template <typename Algorithm>
 InternalRouteResult
-shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
-                   const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                   const std::vector<PhantomNodes> &phantom_nodes_vector,
-                   const boost::optional<bool> continue_straight_at_waypoint)
+searchRoute(SearchEngineData<Algorithm> &engine_working_data,
+            const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+            typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+            typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+            const std::vector<PhantomNodes> &phantom_nodes_vector,
+            const boost::optional<bool> continue_straight_at_waypoint)
 {
     InternalRouteResult raw_route_data;
     raw_route_data.segment_end_coordinates = phantom_nodes_vector;
@@ -222,10 +401,14 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
         !(continue_straight_at_waypoint ? *continue_straight_at_waypoint
                                         : facade.GetContinueStraightDefault());
 
-    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
-
-    auto &forward_heap = *engine_working_data.forward_heap_1;
-    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+    // The legs only depend on each other through the weights of the previous legs. With
+    // parallelism they are searched independently first and connected by the loop below.
+    std::vector<IndependentLeg> independent_legs;
+    if (engine_working_data.request_parallelism > 1 && phantom_nodes_vector.size() > 1)
+    {
+        independent_legs = searchIndependentLegs(
+            engine_working_data, facade, phantom_nodes_vector, allow_uturn_at_waypoint);
+    }
 
     int total_weight_to_forward = 0;
     int total_weight_to_reverse = 0;
@@ -266,20 +449,32 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
         {
             if (allow_uturn_at_waypoint)
             {
-                searchWithUTurn(engine_working_data,
-                                facade,
-                                forward_heap,
-                                reverse_heap,
-                                search_from_forward_node,
-                                search_from_reverse_node,
-                                search_to_forward_node,
-                                search_to_reverse_node,
-                                source_phantom,
-                                target_phantom,
-                                total_weight_to_forward,
-                                total_weight_to_reverse,
-                                new_total_weight_to_forward,
-                                packed_leg_to_forward);
+                if (!independent_legs.empty())
+                {
+                    auto &leg = independent_legs[current_leg];
+                    new_total_weight_to_forward = leg.uturn_weight;
+                    packed_leg_to_forward = std::move(leg.uturn_path);
+                    if (new_total_weight_to_forward != INVALID_EDGE_WEIGHT)
+                        new_total_weight_to_forward +=
+                            std::min(total_weight_to_forward, total_weight_to_reverse);
+                }
+                else
+                {
+                    searchWithUTurn(engine_working_data,
+                                    facade,
+                                    forward_heap,
+                                    reverse_heap,
+                                    search_from_forward_node,
+                                    search_from_reverse_node,
+                                    search_to_forward_node,
+                                    search_to_reverse_node,
+                                    source_phantom,
+                                    target_phantom,
+                                    total_weight_to_forward,
+                                    total_weight_to_reverse,
+                                    new_total_weight_to_forward,
+                                    packed_leg_to_forward);
+                }
                 // if only the reverse node is valid (e.g. when using the match plugin) we
                 // actually need to move
                 if (!target_phantom.IsValidForwardTarget())
@@ -300,6 +495,18 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                     packed_leg_to_reverse = packed_leg_to_forward;
                 }
             }
+            else if (!independent_legs.empty())
+            {
+                connectIndependentLeg(independent_legs[current_leg],
+                                      search_from_forward_node,
+                                      search_from_reverse_node,
+                                      total_weight_to_forward,
+                                      total_weight_to_reverse,
+                                      new_total_weight_to_forward,
+                                      new_total_weight_to_reverse,
+                                      packed_leg_to_forward,
+                                      packed_leg_to_reverse);
+            }
             else
             {
                 search(engine_working_data,
@@ -438,6 +645,7 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    total_packed_path_to_forward,
                    packed_leg_to_forward_begin,
                    total_weight_to_forward,
+                   engine_working_data.request_parallelism,
                    raw_route_data);
     }
     else
@@ -451,11 +659,75 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    total_packed_path_to_reverse,
                    packed_leg_to_reverse_begin,
                    total_weight_to_reverse,
+                   engine_working_data.request_parallelism,
                    raw_route_data);
     }
 
     return raw_route_data;
 }
+}
+
+template <typename Algorithm>
+InternalRouteResult
+shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
+                   const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                   const std::vector<PhantomNodes> &phantom_nodes_vector,
+                   const boost::optional<bool> continue_straight_at_waypoint)
+{
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+
+    return searchRoute(engine_working_data,
+                       facade,
+                       *engine_working_data.forward_heap_1,
+                       *engine_working_data.reverse_heap_1,
+                       phantom_nodes_vector,
+                       continue_straight_at_waypoint);
+}
+
+template <typename Algorithm>
+std::vector<InternalRouteResult>
+shortestPathSearches(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const std::vector<std::vector<PhantomNodes>> &routes,
+                     const boost::optional<bool> continue_straight_at_waypoint)
+{
+    std::vector<InternalRouteResult> results(routes.size());
+
+    if (engine_working_data.request_parallelism <= 1 || routes.size() <= 1)
+    {
+        for (const auto index : util::irange<std::size_t>(0UL, routes.size()))
+            results[index] = shortestPathSearch(
+                engine_working_data, facade, routes[index], continue_straight_at_waypoint);
+        return results;
+    }
+
+    // Every task owns its heaps: a thread waiting for the nested leg searches of one route
+    // may run another route meanwhile and would clear thread-local heaps still in use. The
+    // core heaps of Core-CH stay thread local, they are only used within a single search.
+    parallelForRequest(
+        engine_working_data.request_parallelism,
+        routes.size(),
+        [&](const std::size_t begin, const std::size_t end) {
+            typename SearchEngineData<Algorithm>::QueryHeap forward_heap(
+                facade.GetNumberOfNodes());
+            typename SearchEngineData<Algorithm>::QueryHeap reverse_heap(
+                facade.GetNumberOfNodes());
+
+            for (const auto index : util::irange(begin, end))
+            {
+                forward_heap.Clear();
+                reverse_heap.Clear();
+                results[index] = searchRoute(engine_working_data,
+                                             facade,
+                                             forward_heap,
+                                             reverse_heap,
+                                             routes[index],
+                                             continue_straight_at_waypoint);
+            }
+        });
+
+    return results;
+}
 
 template InternalRouteResult
 shortestPathSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
@@ -475,6 +747,24 @@ shortestPathSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
                    const boost::optional<bool> continue_straight_at_waypoint);
 
+template std::vector<InternalRouteResult>
+shortestPathSearches(SearchEngineData<ch::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                     const std::vector<std::vector<PhantomNodes>> &routes,
+                     const boost::optional<bool> continue_straight_at_waypoint);
+
+template std::vector<InternalRouteResult> shortestPathSearches(
+    SearchEngineData<corech::Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<corech::Algorithm> &facade,
+    const std::vector<std::vector<PhantomNodes>> &routes,
+    const boost::optional<bool> continue_straight_at_waypoint);
+
+template std::vector<InternalRouteResult>
+shortestPathSearches(SearchEngineData<mld::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+                     const std::vector<std::vector<PhantomNodes>> &routes,
+                     const boost::optional<bool> continue_straight_at_waypoint);
+
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
@@ -1,132 +1,256 @@
 #include "engine/search_engine_data.hpp"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
 {
 
-// CH heaps
-using CH = routing_algorithms::ch::Algorithm;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_1;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
-SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
-
-void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
+namespace
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
+// Counters over the heaps of all threads. A heap only touches the shared memory counters when
+// its memory changed since it was last cleared, so clearing a warm heap takes no lock.
+class HeapCounters
+{
+  public:
+    void Update(std::size_t &sampled_memory_usage, const std::size_t new_memory_usage)
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        if (new_memory_usage > sampled_memory_usage)
+        {
+            const auto grown = new_memory_usage - sampled_memory_usage;
+            const auto total = memory_usage.fetch_add(grown, std::memory_order_relaxed) + grown;
+            auto peak = peak_memory_usage.load(std::memory_order_relaxed);
+            while (peak < total &&
+                   !peak_memory_usage.compare_exchange_weak(peak, total, std::memory_order_relaxed))
+            {
+            }
+        }
+        else if (new_memory_usage < sampled_memory_usage)
+        {
+            memory_usage.fetch_sub(sampled_memory_usage - new_memory_usage,
+                                   std::memory_order_relaxed);
+        }
+        sampled_memory_usage = new_memory_usage;
     }
 
-    if (reverse_heap_1.get())
+    SearchEngineHeapStats GetStats() const
     {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        SearchEngineHeapStats stats;
+        stats.number_of_heaps = number_of_heaps;
+        stats.number_of_pooled_heaps = number_of_pooled_heaps;
+        stats.memory_usage = memory_usage;
+        stats.peak_memory_usage = peak_memory_usage;
+        stats.number_of_trims = number_of_trims;
+        return stats;
     }
+
+    std::atomic<std::size_t> number_of_heaps{0};
+    std::atomic<std::size_t> number_of_pooled_heaps{0};
+    std::atomic<std::uint64_t> number_of_trims{0};
+
+  private:
+    std::atomic<std::size_t> memory_usage{0};
+    std::atomic<std::size_t> peak_memory_usage{0};
+};
+
+// Never destroyed, the heaps of other threads can outlive the static objects of this file
+HeapCounters &heapCounters()
+{
+    static auto *counters = new HeapCounters;
+    return *counters;
 }
 
-void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+// All heaps behind the thread-local pointers are created here and remember their last sample
+template <typename Heap> struct SampledHeap final : Heap
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
+    using Heap::Heap;
+    std::size_t sampled_memory_usage = 0;
+};
+
+template <typename Heap> Heap *createHeap(const unsigned number_of_nodes)
+{
+    ++heapCounters().number_of_heaps;
+    return new SampledHeap<Heap>(number_of_nodes);
+}
+
+template <typename Heap> void sampleHeap(Heap &heap)
+{
+    heapCounters().Update(static_cast<SampledHeap<Heap> &>(heap).sampled_memory_usage,
+                          heap.GetMemoryUsage());
+}
+
+template <typename Heap> void destroyHeap(Heap *heap)
+{
+    auto sampled_heap = static_cast<SampledHeap<Heap> *>(heap);
+    heapCounters().Update(sampled_heap->sampled_memory_usage, 0);
+    --heapCounters().number_of_heaps;
+    delete sampled_heap;
+}
+
+// Idle heaps of one type shared by all threads
+template <typename Heap> class HeapPool
+{
+  public:
+    ~HeapPool()
     {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
+        for (auto heap : heaps)
+            destroyHeap(heap);
     }
 
-    if (reverse_heap_2.get())
+    Heap *Take()
     {
-        reverse_heap_2->Clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (heaps.empty())
+            return nullptr;
+        auto heap = heaps.back();
+        heaps.pop_back();
+        --heapCounters().number_of_pooled_heaps;
+        return heap;
     }
-    else
+
+    void Return(Heap *heap, const std::size_t max_size)
     {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (heaps.size() < max_size)
+            {
+                heaps.push_back(heap);
+                ++heapCounters().number_of_pooled_heaps;
+                return;
+            }
+        }
+        destroyHeap(heap);
     }
+
+  private:
+    std::mutex mutex;
+    std::vector<Heap *> heaps;
+};
+
+template <typename Heap> HeapPool<Heap> &heapPool()
+{
+    static HeapPool<Heap> pool;
+    return pool;
 }
 
-void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
+template <typename Heap>
+void initializeOrClearHeap(boost::thread_specific_ptr<Heap> &heap,
+                           const unsigned number_of_nodes,
+                           const unsigned heap_trim_interval)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
+    if (!heap.get())
     {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
+        auto pooled = heapPool<Heap>().Take();
+        heap.reset(pooled ? pooled : createHeap<Heap>(number_of_nodes));
     }
 
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
+    heap->Clear();
+    heap->CountQuery();
+    if (heap_trim_interval > 0 && heap->GetQueriesSinceTrim() >= heap_trim_interval)
     {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
+        heap->Trim();
+        ++heapCounters().number_of_trims;
     }
+
+    sampleHeap(*heap);
+}
+
+template <typename Heap>
+void releaseHeap(boost::thread_specific_ptr<Heap> &heap, const unsigned heap_pool_size)
+{
+    if (heap.get())
+        heapPool<Heap>().Return(heap.release(), heap_pool_size);
+}
+}
+
+SearchEngineHeapStats getSearchEngineHeapStats() { return heapCounters().GetStats(); }
+
+// CH heaps
+using CH = routing_algorithms::ch::Algorithm;
+SearchEngineData<CH>::SearchEngineHeapPtr
+    SearchEngineData<CH>::forward_heap_1(&destroyHeap<QueryHeap>);
+SearchEngineData<CH>::SearchEngineHeapPtr
+    SearchEngineData<CH>::reverse_heap_1(&destroyHeap<QueryHeap>);
+SearchEngineData<CH>::SearchEngineHeapPtr
+    SearchEngineData<CH>::forward_heap_2(&destroyHeap<QueryHeap>);
+SearchEngineData<CH>::SearchEngineHeapPtr
+    SearchEngineData<CH>::reverse_heap_2(&destroyHeap<QueryHeap>);
+SearchEngineData<CH>::SearchEngineHeapPtr
+    SearchEngineData<CH>::forward_heap_3(&destroyHeap<QueryHeap>);
+SearchEngineData<CH>::SearchEngineHeapPtr
+    SearchEngineData<CH>::reverse_heap_3(&destroyHeap<QueryHeap>);
+SearchEngineData<CH>::ManyToManyHeapPtr
+    SearchEngineData<CH>::many_to_many_heap(&destroyHeap<ManyToManyQueryHeap>);
+
+void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_1, number_of_nodes, heap_trim_interval);
+    initializeOrClearHeap(reverse_heap_1, number_of_nodes, heap_trim_interval);
+}
+
+void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_2, number_of_nodes, heap_trim_interval);
+    initializeOrClearHeap(reverse_heap_2, number_of_nodes, heap_trim_interval);
+}
+
+void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_3, number_of_nodes, heap_trim_interval);
+    initializeOrClearHeap(reverse_heap_3, number_of_nodes, heap_trim_interval);
 }
 
 void SearchEngineData<CH>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(many_to_many_heap, number_of_nodes, heap_trim_interval);
+}
+
+void SearchEngineData<CH>::ReleaseThreadLocalStorage()
+{
+    if (heap_pool_size == 0)
+        return;
+
+    releaseHeap(forward_heap_1, heap_pool_size);
+    releaseHeap(reverse_heap_1, heap_pool_size);
+    releaseHeap(forward_heap_2, heap_pool_size);
+    releaseHeap(reverse_heap_2, heap_pool_size);
+    releaseHeap(forward_heap_3, heap_pool_size);
+    releaseHeap(reverse_heap_3, heap_pool_size);
+    releaseHeap(many_to_many_heap, heap_pool_size);
 }
 
 // MLD
 using MLD = routing_algorithms::mld::Algorithm;
-SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_1;
-SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_1;
-SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_heap;
+SearchEngineData<MLD>::SearchEngineHeapPtr
+    SearchEngineData<MLD>::forward_heap_1(&destroyHeap<QueryHeap>);
+SearchEngineData<MLD>::SearchEngineHeapPtr
+    SearchEngineData<MLD>::reverse_heap_1(&destroyHeap<QueryHeap>);
+SearchEngineData<MLD>::ManyToManyHeapPtr
+    SearchEngineData<MLD>::many_to_many_heap(&destroyHeap<ManyToManyQueryHeap>);
 
 void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(forward_heap_1, number_of_nodes, heap_trim_interval);
+    initializeOrClearHeap(reverse_heap_1, number_of_nodes, heap_trim_interval);
 }
 
 void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(many_to_many_heap, number_of_nodes, heap_trim_interval);
+}
+
+void SearchEngineData<MLD>::ReleaseThreadLocalStorage()
+{
+    if (heap_pool_size == 0)
+        return;
+
+    releaseHeap(forward_heap_1, heap_pool_size);
+    releaseHeap(reverse_heap_1, heap_pool_size);
+    releaseHeap(many_to_many_heap, heap_pool_size);
 }
 }
 }
@@ -432,6 +432,9 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                 if (buffer->nodes_processed == 0)
                     return buffer;
 
+                // penalties of all turns entering through the same edge are computed in one batch
+                std::vector<ExtractionTurn> extracted_turns;
+
                 for (auto node_at_center_of_intersection = intersection_node_range.begin(),
                           end = intersection_node_range.end();
                      node_at_center_of_intersection < end;
@@ -514,6 +517,25 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                         bearing_class_by_node_based_node[node_at_center_of_intersection] =
                             bearing_class_id;
 
+                        // compute weight and duration penalties
+                        const auto is_traffic_light =
+                            m_traffic_lights.count(node_at_center_of_intersection) > 0;
+                        const EdgeData &incoming_data =
+                            m_node_based_graph->GetEdgeData(incoming_edge);
+                        extracted_turns.clear();
+                        for (const auto &turn : intersection)
+                        {
+                            if (!turn.entry_allowed)
+                                continue;
+
+                            extracted_turns.emplace_back(turn, is_traffic_light);
+                            extracted_turns.back().source_restricted = incoming_data.restricted;
+                            extracted_turns.back().target_restricted =
+                                m_node_based_graph->GetEdgeData(turn.eid).restricted;
+                        }
+                        scripting_environment.ProcessTurns(extracted_turns);
+
+                        auto extracted_turn = extracted_turns.begin();
                         for (const auto &turn : intersection)
                         {
                             // only keep valid turns
@@ -537,20 +559,15 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                                  util::guidance::TurnBearing(intersection[0].bearing),
                                  util::guidance::TurnBearing(turn.bearing)});
 
-                            // compute weight and duration penalties
-                            auto is_traffic_light =
-                                m_traffic_lights.count(node_at_center_of_intersection);
-                            ExtractionTurn extracted_turn(turn, is_traffic_light);
-                            extracted_turn.source_restricted = edge_data1.restricted;
-                            extracted_turn.target_restricted = edge_data2.restricted;
-                            scripting_environment.ProcessTurn(extracted_turn);
+                            BOOST_ASSERT(extracted_turn != extracted_turns.end());
+                            const auto &penalties = *extracted_turn++;
 
                             // turn penalties are limited to [-2^15, 2^15) which roughly
                             // translates to 54 minutes and fits signed 16bit deci-seconds
                             auto weight_penalty = boost::numeric_cast<TurnPenalty>(
-                                extracted_turn.weight * weight_multiplier);
+                                penalties.weight * weight_multiplier);
                             auto duration_penalty =
-                                boost::numeric_cast<TurnPenalty>(extracted_turn.duration * 10.);
+                                boost::numeric_cast<TurnPenalty>(penalties.duration * 10.);
 
                             BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
                             BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
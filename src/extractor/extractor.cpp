@@ -259,10 +259,10 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     using SharedBuffer = std::shared_ptr<const osmium::memory::Buffer>;
     struct ParsedBuffer
     {
-        SharedBuffer buffer;
-        std::vector<std::pair<const osmium::Node &, ExtractionNode>> resulting_nodes;
-        std::vector<std::pair<const osmium::Way &, ExtractionWay>> resulting_ways;
-        std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+        std::size_t number_of_nodes = 0;
+        std::size_t number_of_ways = 0;
+        std::size_t number_of_relations = 0;
+        ExtractorCallbacks::PreparedBuffer prepared;
     };
 
     tbb::filter_t<void, SharedBuffer> buffer_reader(
@@ -282,36 +282,46 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
             if (!buffer)
                 return std::shared_ptr<ParsedBuffer>{};
 
-            auto parsed_buffer = std::make_shared<ParsedBuffer>();
-            parsed_buffer->buffer = buffer;
+            std::vector<std::pair<const osmium::Node &, ExtractionNode>> resulting_nodes;
+            std::vector<std::pair<const osmium::Way &, ExtractionWay>> resulting_ways;
+            std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
             scripting_environment.ProcessElements(*buffer,
                                                   restriction_parser,
-                                                  parsed_buffer->resulting_nodes,
-                                                  parsed_buffer->resulting_ways,
-                                                  parsed_buffer->resulting_restrictions);
-            return parsed_buffer;
-        });
-    tbb::filter_t<std::shared_ptr<ParsedBuffer>, void> buffer_storage(
-        tbb::filter::serial_in_order, [&](const std::shared_ptr<ParsedBuffer> parsed_buffer) {
-            if (!parsed_buffer)
-                return;
+                                                  resulting_nodes,
+                                                  resulting_ways,
+                                                  resulting_restrictions);
 
-            number_of_nodes += parsed_buffer->resulting_nodes.size();
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : parsed_buffer->resulting_nodes)
+            // put parsed objects thru the thread-safe part of the extractor callbacks
+            auto parsed_buffer = std::make_shared<ParsedBuffer>();
+            parsed_buffer->number_of_nodes = resulting_nodes.size();
+            for (const auto &result : resulting_nodes)
             {
-                extractor_callbacks->ProcessNode(result.first, result.second);
+                extractor_callbacks->PrepareNode(
+                    result.first, result.second, parsed_buffer->prepared);
             }
-            number_of_ways += parsed_buffer->resulting_ways.size();
-            for (const auto &result : parsed_buffer->resulting_ways)
+            parsed_buffer->number_of_ways = resulting_ways.size();
+            for (const auto &result : resulting_ways)
             {
-                extractor_callbacks->ProcessWay(result.first, result.second);
+                extractor_callbacks->PrepareWay(
+                    result.first, result.second, parsed_buffer->prepared);
             }
-            number_of_relations += parsed_buffer->resulting_restrictions.size();
-            for (const auto &result : parsed_buffer->resulting_restrictions)
+            parsed_buffer->number_of_relations = resulting_restrictions.size();
+            for (const auto &result : resulting_restrictions)
             {
-                extractor_callbacks->ProcessRestriction(result);
+                extractor_callbacks->PrepareRestriction(result, parsed_buffer->prepared);
             }
+            return parsed_buffer;
+        });
+    // Merging in input order keeps name, class and lane ids deterministic
+    tbb::filter_t<std::shared_ptr<ParsedBuffer>, void> buffer_storage(
+        tbb::filter::serial_in_order, [&](const std::shared_ptr<ParsedBuffer> parsed_buffer) {
+            if (!parsed_buffer)
+                return;
+
+            number_of_nodes += parsed_buffer->number_of_nodes;
+            number_of_ways += parsed_buffer->number_of_ways;
+            number_of_relations += parsed_buffer->number_of_relations;
+            extractor_callbacks->MergeBuffer(parsed_buffer->prepared);
         });
 
     // Number of pipeline tokens that yielded the best speedup was about 1.5 * num_cores
@@ -323,6 +333,7 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
 
     util::Log() << "Raw input contains " << number_of_nodes << " nodes, " << number_of_ways
                 << " ways, and " << number_of_relations << " relations";
+    scripting_environment.PrintStatistics();
 
     extractor_callbacks.reset();
 
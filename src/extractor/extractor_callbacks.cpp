@@ -19,6 +19,7 @@
 
 #include "osrm/coordinate.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <iterator>
 #include <limits>
@@ -43,42 +44,42 @@ ExtractorCallbacks::ExtractorCallbacks(ExtractionContainers &extraction_containe
       force_split_edges(properties.force_split_edges)
 {
     // we reserved 0, 1, 2, 3, 4 for the empty case
-    string_map[MapKey("", "", "", "", "")] = 0;
+    const auto empty_key = MapKey("", "", "", "", "");
+    string_map[HashedMapKey{empty_key, std::hash<MapKey>()(empty_key)}] = 0;
     lane_description_map.data[TurnLaneDescription()] = 0;
 }
 
 /**
  * Takes the node position from osmium and the filtered properties from the lua
- * profile and saves them to external memory.
- *
- * warning: caller needs to take care of synchronization!
+ * profile and saves them to the thread-local buffer.
  */
-void ExtractorCallbacks::ProcessNode(const osmium::Node &input_node,
-                                     const ExtractionNode &result_node)
+void ExtractorCallbacks::PrepareNode(const osmium::Node &input_node,
+                                     const ExtractionNode &result_node,
+                                     PreparedBuffer &buffer) const
 {
     const auto id = OSMNodeID{static_cast<std::uint64_t>(input_node.id())};
 
-    external_memory.all_nodes_list.push_back(
+    buffer.nodes.push_back(
         QueryNode{util::toFixed(util::UnsafeFloatLongitude{input_node.location().lon()}),
                   util::toFixed(util::UnsafeFloatLatitude{input_node.location().lat()}),
                   id});
 
     if (result_node.barrier)
     {
-        external_memory.barrier_nodes.push_back(id);
+        buffer.barrier_nodes.push_back(id);
     }
     if (result_node.traffic_lights)
     {
-        external_memory.traffic_lights.push_back(id);
+        buffer.traffic_lights.push_back(id);
     }
 }
 
-void ExtractorCallbacks::ProcessRestriction(
-    const boost::optional<InputRestrictionContainer> &restriction)
+void ExtractorCallbacks::PrepareRestriction(
+    const boost::optional<InputRestrictionContainer> &restriction, PreparedBuffer &buffer) const
 {
     if (restriction)
     {
-        external_memory.restrictions_list.push_back(restriction.get());
+        buffer.restrictions.push_back(restriction.get());
         // util::Log() << "from: " << restriction.get().restriction.from.node <<
         //                           ",via: " << restriction.get().restriction.via.node <<
         //                           ", to: " << restriction.get().restriction.to.node <<
@@ -93,9 +94,12 @@ void ExtractorCallbacks::ProcessRestriction(
  * Depending on the forward/backwards weights the edges are split into forward
  * and backward edges.
  *
- * warning: caller needs to take care of synchronization!
+ * Name, class and lane ids are only known after MergeBuffer, the edges are
+ * stored with placeholder values until then.
  */
-void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const ExtractionWay &parsed_way)
+void ExtractorCallbacks::PrepareWay(const osmium::Way &input_way,
+                                    const ExtractionWay &parsed_way,
+                                    PreparedBuffer &buffer) const
 {
     if ((parsed_way.forward_travel_mode == TRAVEL_MODE_INACCESSIBLE ||
          parsed_way.forward_speed <= 0) &&
@@ -187,37 +191,25 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
         }
     }
 
-    const auto classStringToMask = [this](const std::string &class_name) {
-        auto iter = classes_map.find(class_name);
-        if (iter == classes_map.end())
-        {
-            if (classes_map.size() > MAX_CLASS_INDEX)
-            {
-                throw util::exception("Maximum number of classes if " +
-                                      std::to_string(MAX_CLASS_INDEX + 1));
-            }
-            ClassData class_mask = 1u << classes_map.size();
-            classes_map[class_name] = class_mask;
-            return class_mask;
-        }
-        else
-        {
-            return iter->second;
-        }
-    };
-    const auto classesToMask = [&](const auto &classes) {
-        ClassData mask = 0;
+    // class masks are assigned on merge, keep the class names in iteration order
+    const auto activeClasses = [](const auto &classes) {
+        std::vector<std::string> names;
         for (const auto &name_and_flag : classes)
         {
             if (name_and_flag.second)
             {
-                mask |= classStringToMask(name_and_flag.first);
+                names.push_back(name_and_flag.first);
             }
         }
-        return mask;
+        return names;
+    };
+    auto forward_classes = activeClasses(parsed_way.forward_classes);
+    auto backward_classes = activeClasses(parsed_way.backward_classes);
+    const auto sameClasses = [](std::vector<std::string> lhs, std::vector<std::string> rhs) {
+        std::sort(lhs.begin(), lhs.end());
+        std::sort(rhs.begin(), rhs.end());
+        return lhs == rhs;
     };
-    const ClassData forward_classes = classesToMask(parsed_way.forward_classes);
-    const ClassData backward_classes = classesToMask(parsed_way.backward_classes);
 
     const auto laneStringToDescription = [](const std::string &lane_string) -> TurnLaneDescription {
         if (lane_string.empty())
@@ -288,75 +280,25 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
         return lane_description;
     };
 
-    // convert the lane description into an ID and, if necessary, remember the description in the
-    // description_map
-    const auto requestId = [&](const std::string &lane_string) {
+    // the lane description is converted into an ID on merge
+    const auto parseLanes =
+        [&](const std::string &lane_string) -> boost::optional<TurnLaneDescription> {
         if (lane_string.empty())
-            return INVALID_LANE_DESCRIPTIONID;
-        TurnLaneDescription lane_description = laneStringToDescription(std::move(lane_string));
-
-        return lane_description_map.ConcurrentFindOrAdd(lane_description);
+            return boost::none;
+        return laneStringToDescription(lane_string);
     };
 
-    // Deduplicates street names, refs, destinations, pronunciation, exits.
-    // In case we do not already store the key, inserts (key, id) tuple and return id.
-    // Otherwise fetches the id based on the name and returns it without insertion.
-    const auto turn_lane_id_forward = requestId(parsed_way.turn_lanes_forward);
-    const auto turn_lane_id_backward = requestId(parsed_way.turn_lanes_backward);
+    auto forward_lanes = parseLanes(parsed_way.turn_lanes_forward);
+    auto backward_lanes = parseLanes(parsed_way.turn_lanes_backward);
 
     const auto road_classification = parsed_way.road_classification;
 
-    // Get the unique identifier for the street name, destination, and ref
-    const auto name_iterator = string_map.find(MapKey(parsed_way.name,
-                                                      parsed_way.destinations,
-                                                      parsed_way.ref,
-                                                      parsed_way.pronunciation,
-                                                      parsed_way.exits));
-    NameID name_id = EMPTY_NAMEID;
-    if (string_map.end() == name_iterator)
-    {
-        // name_offsets has a sentinel element with the total name data size
-        // take the sentinels index as the name id of the new name data pack
-        // (name [name_id], destination [+1], pronunciation [+2], ref [+3], exits [+4])
-        name_id = external_memory.name_offsets.size() - 1;
-
-        std::copy(parsed_way.name.begin(),
-                  parsed_way.name.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.destinations.begin(),
-                  parsed_way.destinations.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.pronunciation.begin(),
-                  parsed_way.pronunciation.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.ref.begin(),
-                  parsed_way.ref.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.exits.begin(),
-                  parsed_way.exits.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        auto k = MapKey{parsed_way.name,
-                        parsed_way.destinations,
-                        parsed_way.ref,
-                        parsed_way.pronunciation,
-                        parsed_way.exits};
-        auto v = MapVal{name_id};
-        string_map.emplace(std::move(k), std::move(v));
-    }
-    else
-    {
-        name_id = name_iterator->second;
-    }
+    auto name_key = MapKey{parsed_way.name,
+                           parsed_way.destinations,
+                           parsed_way.ref,
+                           parsed_way.pronunciation,
+                           parsed_way.exits};
+    const auto name_hash = std::hash<MapKey>()(name_key);
 
     const bool in_forward_direction =
         (parsed_way.forward_speed > 0 || parsed_way.forward_rate > 0 || parsed_way.duration > 0 ||
@@ -374,7 +316,9 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
         (force_split_edges || (parsed_way.forward_rate != parsed_way.backward_rate) ||
          (parsed_way.forward_speed != parsed_way.backward_speed) ||
          (parsed_way.forward_travel_mode != parsed_way.backward_travel_mode) ||
-         (turn_lane_id_forward != turn_lane_id_backward) || (forward_classes != backward_classes));
+         (forward_lanes != backward_lanes) || !sameClasses(forward_classes, backward_classes));
+
+    const auto edges_begin = buffer.edges.size();
 
     if (in_forward_direction)
     { // add (forward) segments or (forward,backward) for non-split edges in backward direction
@@ -382,10 +326,10 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
             nodes.cbegin(),
             nodes.cend(),
             [&](const osmium::NodeRef &first_node, const osmium::NodeRef &last_node) {
-                external_memory.all_edges_list.push_back(
+                buffer.edges.push_back(
                     InternalExtractorEdge(OSMNodeID{static_cast<std::uint64_t>(first_node.ref())},
                                           OSMNodeID{static_cast<std::uint64_t>(last_node.ref())},
-                                          name_id,
+                                          EMPTY_NAMEID,
                                           forward_weight_data,
                                           forward_duration_data,
                                           true,
@@ -396,23 +340,25 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
                                           parsed_way.forward_restricted,
                                           split_edge,
                                           parsed_way.forward_travel_mode,
-                                          forward_classes,
-                                          turn_lane_id_forward,
+                                          0,
+                                          INVALID_LANE_DESCRIPTIONID,
                                           road_classification,
                                           {}));
             });
     }
 
+    const auto forward_edges_end = buffer.edges.size();
+
     if (in_backward_direction && (!in_forward_direction || split_edge))
     { // add (backward) segments for split edges or not in forward direction
         util::for_each_pair(
             nodes.cbegin(),
             nodes.cend(),
             [&](const osmium::NodeRef &first_node, const osmium::NodeRef &last_node) {
-                external_memory.all_edges_list.push_back(
+                buffer.edges.push_back(
                     InternalExtractorEdge(OSMNodeID{static_cast<std::uint64_t>(first_node.ref())},
                                           OSMNodeID{static_cast<std::uint64_t>(last_node.ref())},
-                                          name_id,
+                                          EMPTY_NAMEID,
                                           backward_weight_data,
                                           backward_duration_data,
                                           false,
@@ -423,21 +369,30 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
                                           parsed_way.backward_restricted,
                                           split_edge,
                                           parsed_way.backward_travel_mode,
-                                          backward_classes,
-                                          turn_lane_id_backward,
+                                          0,
+                                          INVALID_LANE_DESCRIPTIONID,
                                           road_classification,
                                           {}));
             });
     }
 
+    buffer.ways.push_back(PreparedWay{HashedMapKey{std::move(name_key), name_hash},
+                                      std::move(forward_lanes),
+                                      std::move(backward_lanes),
+                                      std::move(forward_classes),
+                                      std::move(backward_classes),
+                                      edges_begin,
+                                      forward_edges_end,
+                                      buffer.edges.size()});
+
     std::transform(nodes.begin(),
                    nodes.end(),
-                   std::back_inserter(external_memory.used_node_id_list),
+                   std::back_inserter(buffer.used_node_ids),
                    [](const osmium::NodeRef &ref) {
                        return OSMNodeID{static_cast<std::uint64_t>(ref.ref())};
                    });
 
-    external_memory.way_start_end_id_list.push_back(
+    buffer.way_start_end_ids.push_back(
         {OSMWayID{static_cast<std::uint32_t>(input_way.id())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[0].ref())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[1].ref())},
@@ -445,5 +400,126 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
          OSMNodeID{static_cast<std::uint64_t>(nodes.back().ref())}});
 }
 
+/**
+ * Assigns the global name, class and lane ids to the prepared ways of a buffer
+ * and moves all prepared data to external memory.
+ *
+ * warning: caller needs to take care of synchronization and ordering!
+ */
+void ExtractorCallbacks::MergeBuffer(PreparedBuffer &buffer)
+{
+    const auto classStringToMask = [this](const std::string &class_name) {
+        auto iter = classes_map.find(class_name);
+        if (iter == classes_map.end())
+        {
+            if (classes_map.size() > MAX_CLASS_INDEX)
+            {
+                throw util::exception("Maximum number of classes if " +
+                                      std::to_string(MAX_CLASS_INDEX + 1));
+            }
+            ClassData class_mask = 1u << classes_map.size();
+            classes_map[class_name] = class_mask;
+            return class_mask;
+        }
+        else
+        {
+            return iter->second;
+        }
+    };
+    const auto classesToMask = [&](const std::vector<std::string> &classes) {
+        ClassData mask = 0;
+        for (const auto &class_name : classes)
+        {
+            mask |= classStringToMask(class_name);
+        }
+        return mask;
+    };
+
+    // convert the lane description into an ID and, if necessary, remember the description in the
+    // description_map
+    const auto requestId = [&](const boost::optional<TurnLaneDescription> &lane_description) {
+        if (!lane_description)
+            return INVALID_LANE_DESCRIPTIONID;
+
+        return lane_description_map.ConcurrentFindOrAdd(*lane_description);
+    };
+
+    // Deduplicates street names, refs, destinations, pronunciation, exits.
+    // In case we do not already store the key, inserts (key, id) tuple and return id.
+    // Otherwise fetches the id based on the name and returns it without insertion.
+    const auto requestNameId = [&](HashedMapKey &name_key) {
+        const auto name_iterator = string_map.find(name_key);
+        if (string_map.end() != name_iterator)
+        {
+            return name_iterator->second;
+        }
+
+        // name_offsets has a sentinel element with the total name data size
+        // take the sentinels index as the name id of the new name data pack
+        // (name [name_id], destination [+1], pronunciation [+2], ref [+3], exits [+4])
+        const NameID name_id = external_memory.name_offsets.size() - 1;
+
+        const auto appendString = [this](const std::string &value) {
+            std::copy(value.begin(), value.end(), std::back_inserter(external_memory.name_char_data));
+            external_memory.name_offsets.push_back(external_memory.name_char_data.size());
+        };
+        appendString(std::get<0>(name_key.key)); // name
+        appendString(std::get<1>(name_key.key)); // destinations
+        appendString(std::get<3>(name_key.key)); // pronunciation
+        appendString(std::get<2>(name_key.key)); // ref
+        appendString(std::get<4>(name_key.key)); // exits
+
+        string_map.emplace(std::move(name_key), MapVal{name_id});
+        return name_id;
+    };
+
+    const auto assignIds = [&](const std::size_t begin,
+                               const std::size_t end,
+                               const NameID name_id,
+                               const ClassData classes,
+                               const LaneDescriptionID lane_description_id) {
+        for (auto index = begin; index < end; ++index)
+        {
+            auto &edge = buffer.edges[index].result;
+            edge.name_id = name_id;
+            edge.classes = classes;
+            edge.lane_description_id = lane_description_id;
+        }
+    };
+
+    for (auto &way : buffer.ways)
+    {
+        const ClassData forward_classes = classesToMask(way.forward_classes);
+        const ClassData backward_classes = classesToMask(way.backward_classes);
+        const auto turn_lane_id_forward = requestId(way.forward_lanes);
+        const auto turn_lane_id_backward = requestId(way.backward_lanes);
+        const auto name_id = requestNameId(way.name_key);
+
+        assignIds(way.edges_begin,
+                  way.forward_edges_end,
+                  name_id,
+                  forward_classes,
+                  turn_lane_id_forward);
+        assignIds(way.forward_edges_end,
+                  way.edges_end,
+                  name_id,
+                  backward_classes,
+                  turn_lane_id_backward);
+    }
+
+    const auto append = [](auto &target, auto &source) {
+        target.insert(target.end(),
+                      std::make_move_iterator(source.begin()),
+                      std::make_move_iterator(source.end()));
+    };
+    append(external_memory.all_nodes_list, buffer.nodes);
+    append(external_memory.barrier_nodes, buffer.barrier_nodes);
+    append(external_memory.traffic_lights, buffer.traffic_lights);
+    append(external_memory.all_edges_list, buffer.edges);
+    append(external_memory.used_node_id_list, buffer.used_node_ids);
+    append(external_memory.way_start_end_id_list, buffer.way_start_end_ids);
+    append(external_memory.restrictions_list, buffer.restrictions);
+}
+
 } // namespace extractor
 } // namespace osrm
@@ -18,8 +18,13 @@
 
 #include <osmium/osm.hpp>
 
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem/operations.hpp>
+
 #include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <sstream>
 
@@ -76,6 +81,120 @@ template <class T> double lonToDouble(T const &object)
     return static_cast<double>(util::toFloating(object.lon));
 }
 
+namespace
+{
+int appendBytecode(lua_State *, const void *data, std::size_t size, void *bytecode)
+{
+    static_cast<std::string *>(bytecode)->append(static_cast<const char *>(data), size);
+    return 0;
+}
+
+// Pops the error message of a failed load or call and throws it
+[[noreturn]] void throwLuaError(lua_State *state, const std::string &file_name)
+{
+    const char *message = lua_tostring(state, -1);
+    const std::string error = message ? message : "unknown error";
+    lua_pop(state, 1);
+    throw util::exception("Failed to load " + file_name + ": " + error + SOURCE_REF);
+}
+
+// Resolves a module name against package.path, package.searchpath is not available in Lua 5.1
+std::string findModule(lua_State *state, std::string name)
+{
+    lua_getglobal(state, "package");
+    lua_getfield(state, -1, "path");
+    const char *path = lua_tostring(state, -1);
+    std::istringstream templates(path ? path : "");
+    lua_pop(state, 2);
+
+    std::replace(name.begin(), name.end(), '.', '/');
+    std::string candidate;
+    while (std::getline(templates, candidate, ';'))
+    {
+        boost::replace_all(candidate, "?", name);
+        boost::system::error_code error;
+        if (!candidate.empty() && boost::filesystem::is_regular_file(candidate, error))
+            return candidate;
+    }
+    return {};
+}
+
+// Searcher for require() that loads modules from the bytecode cache given as upvalue
+int searchBytecodeCache(lua_State *state)
+{
+    auto &cache = *static_cast<LuaBytecodeCache *>(lua_touserdata(state, lua_upvalueindex(1)));
+    {
+        const auto file_name = findModule(state, luaL_checkstring(state, 1));
+        if (file_name.empty())
+        {
+            // let the default searchers report the paths they tried
+            lua_pushnil(state);
+            return 1;
+        }
+
+        try
+        {
+            const auto &bytecode = cache.Get(state, file_name);
+            if (luaL_loadbuffer(state, bytecode.data(), bytecode.size(), file_name.c_str()) == 0)
+            {
+                lua_pushstring(state, file_name.c_str());
+                return 2;
+            }
+        }
+        catch (const util::exception &exception)
+        {
+            lua_pushstring(state, exception.what());
+        }
+    }
+    // lua_error does not return, all C++ objects have to be destroyed at this point
+    return lua_error(state);
+}
+
+// Adds the bytecode cache as the second searcher, right after the one for package.preload
+void addBytecodeSearcher(lua_State *state, LuaBytecodeCache &cache)
+{
+    lua_getglobal(state, "package");
+#if LUA_VERSION_NUM >= 502
+    lua_getfield(state, -1, "searchers");
+    const auto num_searchers = static_cast<int>(lua_rawlen(state, -1));
+#else
+    lua_getfield(state, -1, "loaders");
+    const auto num_searchers = static_cast<int>(lua_objlen(state, -1));
+#endif
+    for (int index = num_searchers; index >= 2; --index)
+    {
+        lua_rawgeti(state, -1, index);
+        lua_rawseti(state, -2, index + 1);
+    }
+    lua_pushlightuserdata(state, &cache);
+    lua_pushcclosure(state, searchBytecodeCache, 1);
+    lua_rawseti(state, -2, 2);
+    lua_pop(state, 2);
+}
+}
+
+const std::string &LuaBytecodeCache::Get(lua_State *state, const std::string &file_name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = bytecode.find(file_name);
+    if (iter == bytecode.end())
+    {
+        if (luaL_loadfile(state, file_name.c_str()) != 0)
+            throwLuaError(state, file_name);
+
+        // keeps the debug information, so errors still report the file and line
+        std::string compiled;
+#if LUA_VERSION_NUM >= 503
+        lua_dump(state, appendBytecode, &compiled, 0);
+#else
+        lua_dump(state, appendBytecode, &compiled);
+#endif
+        lua_pop(state, 1);
+        iter = bytecode.emplace(file_name, std::move(compiled)).first;
+    }
+    return iter->second;
+}
+
 Sol2ScriptingEnvironment::Sol2ScriptingEnvironment(const std::string &file_name)
     : file_name(file_name)
 {
@@ -429,11 +548,21 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
     //
 
     util::luaAddScriptFolderToLoadPath(context.state.lua_state(), file_name.c_str());
+    addBytecodeSearcher(context.state.lua_state(), bytecode_cache);
 
-    context.state.script_file(file_name);
+    {
+        auto *state = context.state.lua_state();
+        const auto &bytecode = bytecode_cache.Get(state, file_name);
+        if (luaL_loadbuffer(state, bytecode.data(), bytecode.size(), file_name.c_str()) != 0 ||
+            lua_pcall(state, 0, 0, 0) != 0)
+        {
+            throwLuaError(state, file_name);
+        }
+    }
 
     // cache references to functions for faster execution
     context.turn_function = context.state["turn_function"];
+    context.turn_batch_function = context.state["turn_batch_function"];
     context.node_function = context.state["node_function"];
     context.way_function = context.state["way_function"];
     context.segment_function = context.state["segment_function"];
@@ -442,6 +571,19 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
     context.has_node_function = context.node_function.valid();
     context.has_way_function = context.way_function.valid();
     context.has_segment_function = context.segment_function.valid();
+    context.turn_batch = context.state.create_table();
+
+    // Opt-in memoization of way_function results, the profile guarantees that the result
+    // only depends on the values of the returned tags
+    sol::function get_way_cache_keys = context.state["get_way_cache_keys"];
+    if (get_way_cache_keys.valid())
+    {
+        get_way_cache_keys(context.way_cache_keys);
+        std::sort(context.way_cache_keys.begin(), context.way_cache_keys.end());
+        context.way_cache_keys.erase(
+            std::unique(context.way_cache_keys.begin(), context.way_cache_keys.end()),
+            context.way_cache_keys.end());
+    }
 
     // Check profile API version
     auto maybe_version = context.state.get<sol::optional<int>>("api_version");
@@ -470,6 +612,10 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
         BOOST_ASSERT(context.properties.GetWeightName() == "duration");
         break;
     }
+
+    // batches of turns are only supported by the current profile API
+    context.has_turn_batch_function =
+        context.turn_batch_function.valid() && context.api_version > 0;
 }
 
 const ProfileProperties &Sol2ScriptingEnvironment::GetProfileProperties()
@@ -479,13 +625,14 @@ const ProfileProperties &Sol2ScriptingEnvironment::GetProfileProperties()
 
 LuaScriptingContext &Sol2ScriptingEnvironment::GetSol2Context()
 {
-    std::lock_guard<std::mutex> lock(init_mutex);
-    bool initialized = false;
-    auto &ref = script_contexts.local(initialized);
-    if (!initialized)
+    // Called for every turn and segment, only the creation of a context needs the lock
+    auto &ref = script_contexts.local();
+    if (!ref)
     {
-        ref = std::make_unique<LuaScriptingContext>();
-        InitContext(*ref);
+        std::lock_guard<std::mutex> lock(init_mutex);
+        auto context = std::make_unique<LuaScriptingContext>();
+        InitContext(*context);
+        ref = std::move(context);
     }
 
     return *ref;
@@ -542,6 +689,31 @@ void Sol2ScriptingEnvironment::ProcessElements(
     }
 }
 
+void Sol2ScriptingEnvironment::PrintStatistics()
+{
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t entries = 0;
+    bool has_cache_keys = false;
+    for (const auto &context : script_contexts)
+    {
+        if (!context)
+            continue;
+        has_cache_keys |= !context->way_cache_keys.empty();
+        hits += context->way_cache_hits;
+        misses += context->way_cache_misses;
+        entries += context->way_cache.size();
+    }
+
+    if (has_cache_keys)
+    {
+        const auto lookups = hits + misses;
+        util::Log() << "way_function cache: " << hits << " hits, " << misses << " misses ("
+                    << (lookups > 0 ? 100. * hits / lookups : 0.) << "% hit ratio), " << entries
+                    << " cached results";
+    }
+}
+
 std::vector<std::string> Sol2ScriptingEnvironment::GetNameSuffixList()
 {
     auto &context = GetSol2Context();
@@ -588,35 +760,72 @@ void Sol2ScriptingEnvironment::SetupSources()
 }
 
 void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
+{
+    GetSol2Context().ProcessTurn(turn);
+}
+
+void Sol2ScriptingEnvironment::ProcessTurns(std::vector<ExtractionTurn> &turns)
+{
+    GetSol2Context().ProcessTurns(turns);
+}
+
+void Sol2ScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
 {
     auto &context = GetSol2Context();
 
-    switch (context.api_version)
+    if (context.has_segment_function)
+    {
+        switch (context.api_version)
+        {
+        case 1:
+            context.segment_function(segment);
+            break;
+        case 0:
+            context.segment_function(
+                segment.source, segment.target, segment.distance, segment.duration);
+            segment.weight = segment.duration; // back-compatibility fallback to duration
+            break;
+        }
+    }
+}
+
+void LuaScriptingContext::ProcessNode(const osmium::Node &node, ExtractionNode &result)
+{
+    BOOST_ASSERT(state.lua_state() != nullptr);
+
+    node_function(node, result);
+}
+
+void LuaScriptingContext::ProcessTurn(ExtractionTurn &turn)
+{
+    BOOST_ASSERT(state.lua_state() != nullptr);
+
+    switch (api_version)
     {
     case 1:
-        if (context.has_turn_penalty_function)
+        if (has_turn_penalty_function)
         {
-            context.turn_function(turn);
+            turn_function(turn);
 
             // Turn weight falls back to the duration value in deciseconds
             // or uses the extracted unit-less weight value
-            if (context.properties.fallback_to_duration)
+            if (properties.fallback_to_duration)
                 turn.weight = turn.duration;
         }
 
         break;
     case 0:
-        if (context.has_turn_penalty_function)
+        if (has_turn_penalty_function)
         {
             if (turn.turn_type != guidance::TurnType::NoTurn)
             {
                 // Get turn duration and convert deci-seconds to seconds
-                turn.duration = static_cast<double>(context.turn_function(turn.angle)) / 10.;
+                turn.duration = static_cast<double>(turn_function(turn.angle)) / 10.;
                 BOOST_ASSERT(turn.weight == 0);
 
                 // add U-turn penalty
                 if (turn.direction_modifier == guidance::DirectionModifier::UTurn)
-                    turn.duration += context.properties.GetUturnPenalty();
+                    turn.duration += properties.GetUturnPenalty();
             }
             else
             {
@@ -628,7 +837,7 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
 
         // Add traffic light penalty, back-compatibility of api_version=0
         if (turn.has_traffic_light)
-            turn.duration += context.properties.GetTrafficSignalPenalty();
+            turn.duration += properties.GetTrafficSignalPenalty();
 
         // Turn weight falls back to the duration value in deciseconds
         turn.weight = turn.duration;
@@ -636,38 +845,84 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
     }
 }
 
-void Sol2ScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
+void LuaScriptingContext::ProcessTurns(std::vector<ExtractionTurn> &turns)
 {
-    auto &context = GetSol2Context();
+    BOOST_ASSERT(state.lua_state() != nullptr);
 
-    if (context.has_segment_function)
+    if (!has_turn_batch_function)
     {
-        switch (context.api_version)
-        {
-        case 1:
-            context.segment_function(segment);
-            break;
-        case 0:
-            context.segment_function(
-                segment.source, segment.target, segment.distance, segment.duration);
-            segment.weight = segment.duration; // back-compatibility fallback to duration
-            break;
-        }
+        for (auto &turn : turns)
+            ProcessTurn(turn);
+        return;
     }
-}
 
-void LuaScriptingContext::ProcessNode(const osmium::Node &node, ExtractionNode &result)
-{
-    BOOST_ASSERT(state.lua_state() != nullptr);
+    // entries of a previous larger batch are cleared, so #turns is the size of this batch
+    for (std::size_t index = 0; index < turns.size(); ++index)
+        turn_batch[index + 1] = &turns[index];
+    for (std::size_t index = turns.size(); index < turn_batch_size; ++index)
+        turn_batch[index + 1] = sol::lua_nil;
+    turn_batch_size = turns.size();
 
-    node_function(node, result);
+    turn_batch_function(turn_batch);
+
+    if (properties.fallback_to_duration)
+    {
+        for (auto &turn : turns)
+            turn.weight = turn.duration;
+    }
 }
 
 void LuaScriptingContext::ProcessWay(const osmium::Way &way, ExtractionWay &result)
 {
     BOOST_ASSERT(state.lua_state() != nullptr);
 
+    if (way_cache_keys.empty())
+    {
+        way_function(way, result);
+        return;
+    }
+
+    BuildWayCacheKey(way);
+    const auto cached = way_cache.find(way_cache_key);
+    if (cached != way_cache.end())
+    {
+        ++way_cache_hits;
+        result = cached->second;
+        return;
+    }
+
+    ++way_cache_misses;
     way_function(way, result);
+    if (way_cache.size() < MAX_WAY_CACHE_SIZE)
+    {
+        way_cache.emplace(way_cache_key, result);
+    }
+}
+
+// Serializes the values of all cache-relevant tags of the way, sorted by key
+void LuaScriptingContext::BuildWayCacheKey(const osmium::Way &way)
+{
+    way_cache_tags.clear();
+    for (const auto &tag : way.tags())
+    {
+        if (std::binary_search(way_cache_keys.begin(), way_cache_keys.end(), tag.key()))
+        {
+            way_cache_tags.emplace_back(tag.key(), tag.value());
+        }
+    }
+    std::sort(way_cache_tags.begin(), way_cache_tags.end(), [](const auto &lhs, const auto &rhs) {
+        return std::strcmp(lhs.first, rhs.first) < 0;
+    });
+
+    // tag keys and values can not contain '\0' so it is used as a separator
+    way_cache_key.clear();
+    for (const auto &tag : way_cache_tags)
+    {
+        way_cache_key.append(tag.first);
+        way_cache_key.push_back('\0');
+        way_cache_key.append(tag.second);
+        way_cache_key.push_back('\0');
+    }
 }
 }
 }
@@ -14,11 +14,16 @@
 
 #include "nodejs/node_osrm.hpp"
 #include "nodejs/node_osrm_support.hpp"
+#include "nodejs/worker_pool.hpp"
 
 namespace node_osrm
 {
 
-Engine::Engine(osrm::EngineConfig &config) : Base(), this_(std::make_shared<osrm::OSRM>(config)) {}
+Engine::Engine(osrm::EngineConfig &config, const std::size_t num_threads)
+    : Base(), this_(std::make_shared<osrm::OSRM>(config)),
+      pool(std::make_shared<WorkerPool>(num_threads))
+{
+}
 
 Nan::Persistent<v8::Function> &Engine::constructor()
 {
@@ -72,6 +77,8 @@ NAN_MODULE_INIT(Engine::Init)
  * @param {Boolean} [options.shared_memory] Connects to the persistent shared memory datastore.
  *        This requires you to run `osrm-datastore` prior to creating an `OSRM` object.
  * @param {String} [options.path] The path to the `.osrm` files. This is mutually exclusive with setting {options.shared_memory} to true.
+ * @param {Number} [options.threads] Number of threads that compute requests of this instance. Defaults to the number of cores.
+ *        Requests do not run on the libuv thread pool, so they do not compete with file system and dns requests.
  *
  * @class OSRM
  *
@@ -87,7 +94,11 @@ NAN_METHOD(Engine::New)
             if (!config)
                 return;
 
-            auto *const self = new Engine(*config);
+            std::size_t num_threads;
+            if (!argumentsToNumberOfThreads(info, num_threads))
+                return;
+
+            auto *const self = new Engine(*config, num_threads);
             self->Wrap(info.This());
         }
         catch (const std::exception &ex)
@@ -116,6 +127,10 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 
     BOOST_ASSERT(params->IsValid());
 
+    PluginParameters plugin_params;
+    if (!argumentsToPluginParameters(info, plugin_params))
+        return;
+
     if (!info[info.Length() - 1]->IsFunction())
         return Nan::ThrowTypeError("last argument must be a callback function");
 
@@ -127,11 +142,14 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
         using Base = Nan::AsyncWorker;
 
         Worker(std::shared_ptr<osrm::OSRM> osrm_,
+               std::shared_ptr<WorkerPool> pool_,
                ParamPtr params_,
+               const PluginParameters &plugin_params_,
                ServiceMemFn service,
                Nan::Callback *callback)
-            : Base(callback), osrm{std::move(osrm_)}, service{std::move(service)},
-              params{std::move(params_)}
+            : Base(callback), osrm{std::move(osrm_)}, pool{std::move(pool_)},
+              service{std::move(service)}, params{std::move(params_)},
+              plugin_params{plugin_params_}
         {
         }
 
@@ -139,6 +157,8 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
         {
             const auto status = ((*osrm).*(service))(*params, result);
             ParseResult(status, result);
+            if (plugin_params.render_json_buffer)
+                renderToJSON(json_buffer, result);
         }
         catch (const std::exception &e)
         {
@@ -150,15 +170,19 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
             Nan::HandleScope scope;
 
             const constexpr auto argc = 2u;
-            v8::Local<v8::Value> argv[argc] = {Nan::Null(), render(result)};
+            // an empty buffer means the result was not rendered to JSON on the worker thread
+            v8::Local<v8::Value> argv[argc] = {
+                Nan::Null(), json_buffer.empty() ? render(result) : render(json_buffer)};
 
             callback->Call(argc, argv);
         }
 
         // Keeps the OSRM object alive even after shutdown until we're done with callback
         std::shared_ptr<osrm::OSRM> osrm;
+        std::shared_ptr<WorkerPool> pool;
         ServiceMemFn service;
         const ParamPtr params;
+        const PluginParameters plugin_params;
 
         // All services return json::Object .. except for Tile!
         using ObjectOrString =
@@ -167,10 +191,12 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
                                       osrm::json::Object>::type;
 
         ObjectOrString result;
+        std::vector<char> json_buffer;
     };
 
     auto *callback = new Nan::Callback{info[info.Length() - 1].As<v8::Function>()};
-    Nan::AsyncQueueWorker(new Worker{self->this_, std::move(params), service, callback});
+    self->pool->Queue(
+        new Worker{self->this_, self->pool, std::move(params), plugin_params, service, callback});
 }
 
 // clang-format off
@@ -194,6 +220,7 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Boolean} [options.continue_straight] Forces the route to keep going straight at waypoints and don't do a uturn even if it would be faster. Default value depends on the profile.
  *                  `null`/`true`/`false`
+ * @param {String} [options.format=object] Return the response as JavaScript `object` or as `buffer` of the rendered JSON. Buffers are rendered off the event loop, which helps with large responses.
  * @param {Function} callback
  *
  * @returns {Object} An array of [Waypoint](#waypoint) objects representing all waypoints in order AND an array of [`Route`](#route) objects ordered by descending recommendation rank.
@@ -209,7 +236,10 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 // clang-format on
 NAN_METHOD(Engine::route) //
 {
-    async(info, &argumentsToRouteParameter, &osrm::OSRM::Route, true);
+    // the bindings only produce JSON, so select the JSON overload
+    using RouteFn = osrm::engine::Status (osrm::OSRM::*)(const osrm::RouteParameters &,
+                                                         osrm::json::Object &) const;
+    async(info, &argumentsToRouteParameter, static_cast<RouteFn>(&osrm::OSRM::Route), true);
 }
 
 // clang-format off
@@ -228,6 +258,7 @@ NAN_METHOD(Engine::route) //
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
  * @param {Number} [options.number=1] Number of nearest segments that should be returned.
  * Must be an integer greater than or equal to `1`.
+ * @param {String} [options.format=object] Return the response as JavaScript `object` or as `buffer` of the rendered JSON. Buffers are rendered off the event loop, which helps with large responses.
  * @param {Function} callback
  *
  * @returns {Object} containing `waypoints`.
@@ -269,6 +300,7 @@ NAN_METHOD(Engine::nearest) //
  * location with given index as source. Default is to use all.
  * @param {Array} [options.destinations] An array of `index` elements (`0 <= integer <
  * #coordinates`) to use location with given index as destination. Default is to use all.
+ * @param {String} [options.format=object] Return the response as JavaScript `object` or as `buffer` of the rendered JSON. Buffers are rendered off the event loop, which helps with large responses.
  * @param {Function} callback
  *
  * @returns {Object} containing `durations`, `sources`, and `destinations`.
@@ -295,7 +327,10 @@ NAN_METHOD(Engine::nearest) //
 // clang-format on
 NAN_METHOD(Engine::table) //
 {
-    async(info, &argumentsToTableParameter, &osrm::OSRM::Table, true);
+    // the bindings only produce JSON, so select the JSON overload
+    using TableFn = osrm::engine::Status (osrm::OSRM::*)(const osrm::TableParameters &,
+                                                         osrm::json::Object &) const;
+    async(info, &argumentsToTableParameter, static_cast<TableFn>(&osrm::OSRM::Table), true);
 }
 
 // clang-format off
@@ -350,6 +385,7 @@ NAN_METHOD(Engine::tile)
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Array<Number>} [options.timestamps] Timestamp of the input location (integers, UNIX-like timestamp).
  * @param {Array} [options.radiuses] Standard deviation of GPS precision used for map matching. If applicable use GPS accuracy. Can be `null` for default value `5` meters or `double >= 0`.
+ * @param {String} [options.format=object] Return the response as JavaScript `object` or as `buffer` of the rendered JSON. Buffers are rendered off the event loop, which helps with large responses.
  * @param {Function} callback
  *
  * @returns {Object} containing `tracepoints` and `matchings`.
@@ -414,10 +450,12 @@ NAN_METHOD(Engine::match) //
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified`
+ * @param {String} [options.format=object] Return the response as JavaScript `object` or as `buffer` of the rendered JSON. Buffers are rendered off the event loop, which helps with large responses.
  * @param {Function} callback
  * @param {Boolean} [options.roundtrip=true] Return route is a roundtrip.
  * @param {String} [options.source=any] Return route starts at `any` or `first` coordinate.
  * @param {String} [options.destination=any] Return route ends at `any` or `last` coordinate.
+ * @param {String} [options.solver=auto] Compute the trip with the `exact` solver, the `heuristic` or let `auto` choose depending on the number of coordinates.
  *
  * @returns {Object} containing `waypoints` and `trips`.
  * **`waypoints`**: an array of [`Waypoint`](#waypoint) objects representing all waypoints in input order.
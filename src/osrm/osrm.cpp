@@ -8,8 +8,10 @@
 #include "engine/engine.hpp"
 #include "engine/engine_config.hpp"
 #include "engine/status.hpp"
+#include "util/exception.hpp"
 
 #include <memory>
+#include <utility>
 
 namespace osrm
 {
@@ -99,13 +101,45 @@ OSRM &OSRM::operator=(OSRM &&) noexcept = default;
 
 // Forward to implementation
 
+namespace
+{
+// The JSON overloads predate the binary formats and can not return them
+template <typename ParametersT>
+void checkJSONFormat(const ParametersT &params)
+{
+    if (params.format != engine::api::BaseParameters::OutputFormatType::JSON)
+        throw util::exception("Binary formats need a result of type engine::api::ResultT");
+}
+}
+
+engine::Status OSRM::Route(const engine::api::RouteParameters &params,
+                           util::json::Object &json_result) const
+{
+    checkJSONFormat(params);
+    engine::api::ResultT result;
+    const auto status = engine_->Route(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
 engine::Status OSRM::Route(const engine::api::RouteParameters &params,
-                           util::json::Object &result) const
+                           engine::api::ResultT &result) const
 {
     return engine_->Route(params, result);
 }
 
-engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Object &result) const
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                           json::Object &json_result) const
+{
+    checkJSONFormat(params);
+    engine::api::ResultT result;
+    const auto status = engine_->Table(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                           engine::api::ResultT &result) const
 {
     return engine_->Table(params, result);
 }
@@ -1,4 +1,5 @@
 #include "server/connection.hpp"
+#include "server/compute_pool.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
 
@@ -16,8 +17,11 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       ComputePool &compute_pool)
+    : strand(io_service), TCP_socket(io_service), request_handler(handler),
+      compute_pool(compute_pool)
 {
 }
 
@@ -53,41 +57,10 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     if (result == RequestParser::RequestStatus::valid)
     {
         current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
-
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
-        {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
-            output_buffer = current_reply.to_buffers();
-            break;
-        }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
+
+        // long queries must not hold up reading and writing the other connections
+        auto self = this->shared_from_this();
+        compute_pool.Submit([self, compression_type] { self->handle_request(compression_type); });
     }
     else if (result == RequestParser::RequestStatus::invalid)
     { // request is not parseable
@@ -111,6 +84,51 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     }
 }
 
+void Connection::handle_request(const http::compression_type compression_type)
+{
+    request_handler.HandleRequest(current_request, current_reply);
+
+    // compress the result w/ gzip/deflate if requested
+    switch (compression_type)
+    {
+    case http::deflate_rfc1951:
+        // use deflate for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "deflate"});
+        compressed_output = compress_buffers(current_reply.content, compression_type);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::gzip_rfc1952:
+        // use gzip for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "gzip"});
+        compressed_output = compress_buffers(current_reply.content, compression_type);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::no_compression:
+        // don't use any compression
+        current_reply.set_uncompressed_size();
+        output_buffer = current_reply.to_buffers();
+        break;
+    }
+
+    strand.post(boost::bind(&Connection::write_reply, this->shared_from_this()));
+}
+
+void Connection::write_reply()
+{
+    // write result to stream
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
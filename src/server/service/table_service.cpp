@@ -87,7 +87,7 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Table(*parameters, json_result);
+    return BaseService::routing_machine.Table(*parameters, result);
 }
 }
 }
@@ -9,7 +9,9 @@
 #include "contractor/files.hpp"
 #include "contractor/query_graph.hpp"
 
+#include "customizer/cell_metric.hpp"
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
 
 #include "extractor/class_data.hpp"
 #include "extractor/compressed_edge_container.hpp"
@@ -51,6 +53,7 @@
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <algorithm>
 #include <cstdint>
 
 #include <fstream>
@@ -71,6 +74,36 @@ using EdgeBasedGraph = util::StaticGraph<extractor::EdgeBasedEdge::EdgeData>;
 
 using Monitor = SharedMonitor<SharedDataTimestamp>;
 
+namespace
+{
+// Quantized values of all metrics are stored back to back, each metric gets an equal slice
+template <typename T>
+void initializeQuantizedValues(const DataLayout &layout,
+                               char *memory_ptr,
+                               const DataLayout::BlockID bases_block,
+                               const DataLayout::BlockID codes_block,
+                               const DataLayout::BlockID outliers_block,
+                               const std::size_t index,
+                               const std::size_t num_metrics,
+                               customizer::QuantizedValuesView<T> &values)
+{
+    const auto bases_count = layout.GetBlockEntries(bases_block) / num_metrics;
+    const auto codes_count = layout.GetBlockEntries(codes_block) / num_metrics;
+    const auto outliers_count = layout.GetBlockEntries(outliers_block) / num_metrics;
+
+    auto bases_ptr = layout.GetBlockPtr<T, true>(memory_ptr, bases_block);
+    auto codes_ptr = layout.GetBlockPtr<customizer::QuantizedCode, true>(memory_ptr, codes_block);
+    auto outliers_ptr =
+        layout.GetBlockPtr<customizer::QuantizedOutlier<T>, true>(memory_ptr, outliers_block);
+
+    values.bases = util::vector_view<T>(bases_ptr + index * bases_count, bases_count);
+    values.codes =
+        util::vector_view<customizer::QuantizedCode>(codes_ptr + index * codes_count, codes_count);
+    values.outliers = util::vector_view<customizer::QuantizedOutlier<T>>(
+        outliers_ptr + index * outliers_count, outliers_count);
+}
+}
+
 Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
 
 int Storage::Run(int max_wait)
@@ -446,10 +479,6 @@ void Storage::PopulateLayout(DataLayout &layout)
         {
             io::FileReader reader(config.mld_storage_path, io::FileReader::VerifyFingerprint);
 
-            const auto weights_count = reader.ReadVectorSize<EdgeWeight>();
-            layout.SetBlockSize<EdgeWeight>(DataLayout::MLD_CELL_WEIGHTS, weights_count);
-            const auto durations_count = reader.ReadVectorSize<EdgeDuration>();
-            layout.SetBlockSize<EdgeDuration>(DataLayout::MLD_CELL_DURATIONS, durations_count);
             const auto source_node_count = reader.ReadVectorSize<NodeID>();
             layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_SOURCE_BOUNDARY, source_node_count);
             const auto destination_node_count = reader.ReadVectorSize<NodeID>();
@@ -464,14 +493,75 @@ void Storage::PopulateLayout(DataLayout &layout)
         }
         else
         {
-            layout.SetBlockSize<char>(DataLayout::MLD_CELL_WEIGHTS, 0);
-            layout.SetBlockSize<char>(DataLayout::MLD_CELL_DURATIONS, 0);
             layout.SetBlockSize<char>(DataLayout::MLD_CELL_SOURCE_BOUNDARY, 0);
             layout.SetBlockSize<char>(DataLayout::MLD_CELL_DESTINATION_BOUNDARY, 0);
             layout.SetBlockSize<char>(DataLayout::MLD_CELLS, 0);
             layout.SetBlockSize<char>(DataLayout::MLD_CELL_LEVEL_OFFSETS, 0);
         }
 
+        if (boost::filesystem::exists(config.mld_cell_metrics_path))
+        {
+            io::FileReader reader(config.mld_cell_metrics_path, io::FileReader::VerifyFingerprint);
+
+            // all metrics are customized on the same cells, so their weights and
+            // durations are stored back to back in one block each
+            const auto num_metrics = reader.ReadElementCount64();
+            std::uint64_t weights_count = 0;
+            std::uint64_t durations_count = 0;
+            std::uint64_t weight_bases_count = 0;
+            std::uint64_t duration_bases_count = 0;
+            std::uint64_t weight_codes_count = 0;
+            std::uint64_t duration_codes_count = 0;
+            std::uint64_t weight_outliers_count = 0;
+            std::uint64_t duration_outliers_count = 0;
+            for (std::uint64_t index = 0; index < num_metrics; ++index)
+            {
+                reader.Skip<customizer::MetricSource>(1);
+                reader.Skip<std::uint16_t>(1);
+                weights_count += reader.ReadVectorSize<EdgeWeight>();
+                durations_count += reader.ReadVectorSize<EdgeDuration>();
+                weight_bases_count += reader.ReadVectorSize<EdgeWeight>();
+                weight_codes_count += reader.ReadVectorSize<customizer::QuantizedCode>();
+                weight_outliers_count +=
+                    reader.ReadVectorSize<customizer::QuantizedOutlier<EdgeWeight>>();
+                duration_bases_count += reader.ReadVectorSize<EdgeDuration>();
+                duration_codes_count += reader.ReadVectorSize<customizer::QuantizedCode>();
+                duration_outliers_count +=
+                    reader.ReadVectorSize<customizer::QuantizedOutlier<EdgeDuration>>();
+            }
+
+            layout.SetBlockSize<customizer::MetricSource>(DataLayout::MLD_CELL_METRICS,
+                                                          num_metrics);
+            layout.SetBlockSize<std::uint16_t>(DataLayout::MLD_CELL_METRIC_TIME_SLICES,
+                                               num_metrics);
+            layout.SetBlockSize<EdgeWeight>(DataLayout::MLD_CELL_WEIGHTS, weights_count);
+            layout.SetBlockSize<EdgeDuration>(DataLayout::MLD_CELL_DURATIONS, durations_count);
+            layout.SetBlockSize<EdgeWeight>(DataLayout::MLD_CELL_WEIGHT_BASES, weight_bases_count);
+            layout.SetBlockSize<EdgeDuration>(DataLayout::MLD_CELL_DURATION_BASES,
+                                              duration_bases_count);
+            layout.SetBlockSize<customizer::QuantizedCode>(DataLayout::MLD_CELL_WEIGHT_CODES,
+                                                           weight_codes_count);
+            layout.SetBlockSize<customizer::QuantizedCode>(DataLayout::MLD_CELL_DURATION_CODES,
+                                                           duration_codes_count);
+            layout.SetBlockSize<customizer::QuantizedOutlier<EdgeWeight>>(
+                DataLayout::MLD_CELL_WEIGHT_OUTLIERS, weight_outliers_count);
+            layout.SetBlockSize<customizer::QuantizedOutlier<EdgeDuration>>(
+                DataLayout::MLD_CELL_DURATION_OUTLIERS, duration_outliers_count);
+        }
+        else
+        {
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_METRICS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_METRIC_TIME_SLICES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_WEIGHTS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_DURATIONS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_WEIGHT_BASES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_DURATION_BASES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_WEIGHT_CODES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_DURATION_CODES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_WEIGHT_OUTLIERS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_DURATION_OUTLIERS, 0);
+        }
+
         if (boost::filesystem::exists(config.mld_graph_path))
         {
             io::FileReader reader(config.mld_graph_path, io::FileReader::VerifyFingerprint);
@@ -499,6 +589,58 @@ void Storage::PopulateLayout(DataLayout &layout)
             layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::EdgeOffset>(
                 DataLayout::MLD_GRAPH_NODE_TO_OFFSET, 0);
         }
+
+        if (boost::filesystem::exists(config.mld_conditional_turns_path))
+        {
+            io::FileReader reader(config.mld_conditional_turns_path,
+                                  io::FileReader::VerifyFingerprint);
+
+            const auto num_turns = reader.ReadVectorSize<customizer::ConditionalTurn>();
+            const auto num_turn_offsets = reader.ReadVectorSize<std::uint32_t>();
+            const auto num_intervals = reader.ReadVectorSize<customizer::ConditionalInterval>();
+            const auto num_interval_offsets = reader.ReadVectorSize<std::uint32_t>();
+
+            layout.SetBlockSize<customizer::ConditionalTurn>(DataLayout::MLD_CONDITIONAL_TURNS,
+                                                             num_turns);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CONDITIONAL_TURN_OFFSETS,
+                                               num_turn_offsets);
+            layout.SetBlockSize<customizer::ConditionalInterval>(
+                DataLayout::MLD_CONDITIONAL_INTERVALS, num_intervals);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CONDITIONAL_INTERVAL_OFFSETS,
+                                               num_interval_offsets);
+        }
+        else
+        {
+            layout.SetBlockSize<customizer::ConditionalTurn>(DataLayout::MLD_CONDITIONAL_TURNS, 0);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CONDITIONAL_TURN_OFFSETS, 0);
+            layout.SetBlockSize<customizer::ConditionalInterval>(
+                DataLayout::MLD_CONDITIONAL_INTERVALS, 0);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CONDITIONAL_INTERVAL_OFFSETS, 0);
+        }
+
+        if (boost::filesystem::exists(config.mld_speed_profiles_path))
+        {
+            io::FileReader reader(config.mld_speed_profiles_path,
+                                  io::FileReader::VerifyFingerprint);
+
+            const auto num_points = reader.ReadVectorSize<customizer::SpeedProfilePoint>();
+            const auto num_profile_offsets = reader.ReadVectorSize<std::uint32_t>();
+            const auto num_node_profiles = reader.ReadVectorSize<std::uint32_t>();
+
+            layout.SetBlockSize<customizer::SpeedProfilePoint>(
+                DataLayout::MLD_SPEED_PROFILE_POINTS, num_points);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_SPEED_PROFILE_OFFSETS,
+                                               num_profile_offsets);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_NODE_SPEED_PROFILES,
+                                               num_node_profiles);
+        }
+        else
+        {
+            layout.SetBlockSize<customizer::SpeedProfilePoint>(
+                DataLayout::MLD_SPEED_PROFILE_POINTS, 0);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_SPEED_PROFILE_OFFSETS, 0);
+            layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_NODE_SPEED_PROFILES, 0);
+        }
     }
 }
 
@@ -893,10 +1035,6 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
 
-            auto mld_cell_weights_ptr = layout.GetBlockPtr<EdgeWeight, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto mld_cell_duration_ptr = layout.GetBlockPtr<EdgeDuration, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_DURATIONS);
             auto mld_source_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
                 memory_ptr, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
             auto mld_destination_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
@@ -906,10 +1044,6 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             auto mld_cell_level_offsets_ptr = layout.GetBlockPtr<std::uint64_t, true>(
                 memory_ptr, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
 
-            auto weight_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto duration_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS);
             auto source_boundary_entries_count =
                 layout.GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
             auto destination_boundary_entries_count =
@@ -918,9 +1052,6 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             auto cell_level_offsets_entries_count =
                 layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
 
-            util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
-            util::vector_view<EdgeDuration> durations(mld_cell_duration_ptr,
-                                                      duration_entries_count);
             util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
                                                       source_boundary_entries_count);
             util::vector_view<NodeID> destination_boundary(mld_destination_boundary_ptr,
@@ -930,15 +1061,69 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
                                                            cell_level_offsets_entries_count);
 
-            partition::CellStorageView storage{std::move(weights),
-                                               std::move(durations),
-                                               std::move(source_boundary),
+            partition::CellStorageView storage{std::move(source_boundary),
                                                std::move(destination_boundary),
                                                std::move(cells),
                                                std::move(level_offsets)};
             partition::files::readCells(config.mld_storage_path, storage);
         }
 
+        if (boost::filesystem::exists(config.mld_cell_metrics_path))
+        {
+            BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_METRICS) > 0);
+
+            auto mld_cell_weights_ptr = layout.GetBlockPtr<EdgeWeight, true>(
+                memory_ptr, storage::DataLayout::MLD_CELL_WEIGHTS);
+            auto mld_cell_duration_ptr = layout.GetBlockPtr<EdgeDuration, true>(
+                memory_ptr, storage::DataLayout::MLD_CELL_DURATIONS);
+
+            const auto num_metrics = layout.GetBlockEntries(storage::DataLayout::MLD_CELL_METRICS);
+            const auto weights_per_metric =
+                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS) / num_metrics;
+            const auto durations_per_metric =
+                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS) / num_metrics;
+
+            std::vector<customizer::CellMetricView> metrics(num_metrics);
+            for (std::size_t index = 0; index < num_metrics; ++index)
+            {
+                metrics[index].weights = util::vector_view<EdgeWeight>(
+                    mld_cell_weights_ptr + index * weights_per_metric, weights_per_metric);
+                metrics[index].durations = util::vector_view<EdgeDuration>(
+                    mld_cell_duration_ptr + index * durations_per_metric, durations_per_metric);
+                initializeQuantizedValues(layout,
+                                          memory_ptr,
+                                          DataLayout::MLD_CELL_WEIGHT_BASES,
+                                          DataLayout::MLD_CELL_WEIGHT_CODES,
+                                          DataLayout::MLD_CELL_WEIGHT_OUTLIERS,
+                                          index,
+                                          num_metrics,
+                                          metrics[index].quantized_weights);
+                initializeQuantizedValues(layout,
+                                          memory_ptr,
+                                          DataLayout::MLD_CELL_DURATION_BASES,
+                                          DataLayout::MLD_CELL_DURATION_CODES,
+                                          DataLayout::MLD_CELL_DURATION_OUTLIERS,
+                                          index,
+                                          num_metrics,
+                                          metrics[index].quantized_durations);
+            }
+            customizer::files::readCellMetrics(config.mld_cell_metrics_path, metrics);
+
+            auto mld_cell_metrics_ptr = layout.GetBlockPtr<customizer::MetricSource, true>(
+                memory_ptr, storage::DataLayout::MLD_CELL_METRICS);
+            std::transform(metrics.begin(),
+                           metrics.end(),
+                           mld_cell_metrics_ptr,
+                           [](const auto &metric) { return metric.source; });
+
+            auto mld_cell_time_slices_ptr = layout.GetBlockPtr<std::uint16_t, true>(
+                memory_ptr, storage::DataLayout::MLD_CELL_METRIC_TIME_SLICES);
+            std::transform(metrics.begin(),
+                           metrics.end(),
+                           mld_cell_time_slices_ptr,
+                           [](const auto &metric) { return metric.time_slice; });
+        }
+
         if (boost::filesystem::exists(config.mld_graph_path))
         {
 
@@ -964,6 +1149,59 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
                 std::move(node_list), std::move(edge_list), std::move(node_to_offset));
             partition::files::readGraph(config.mld_graph_path, graph_view);
         }
+
+        if (boost::filesystem::exists(config.mld_conditional_turns_path))
+        {
+            auto turns_ptr = layout.GetBlockPtr<customizer::ConditionalTurn, true>(
+                memory_ptr, storage::DataLayout::MLD_CONDITIONAL_TURNS);
+            auto turn_offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                memory_ptr, storage::DataLayout::MLD_CONDITIONAL_TURN_OFFSETS);
+            auto intervals_ptr = layout.GetBlockPtr<customizer::ConditionalInterval, true>(
+                memory_ptr, storage::DataLayout::MLD_CONDITIONAL_INTERVALS);
+            auto interval_offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                memory_ptr, storage::DataLayout::MLD_CONDITIONAL_INTERVAL_OFFSETS);
+
+            util::vector_view<customizer::ConditionalTurn> turns(
+                turns_ptr, layout.num_entries[storage::DataLayout::MLD_CONDITIONAL_TURNS]);
+            util::vector_view<std::uint32_t> turn_offsets(
+                turn_offsets_ptr,
+                layout.num_entries[storage::DataLayout::MLD_CONDITIONAL_TURN_OFFSETS]);
+            util::vector_view<customizer::ConditionalInterval> intervals(
+                intervals_ptr, layout.num_entries[storage::DataLayout::MLD_CONDITIONAL_INTERVALS]);
+            util::vector_view<std::uint32_t> interval_offsets(
+                interval_offsets_ptr,
+                layout.num_entries[storage::DataLayout::MLD_CONDITIONAL_INTERVAL_OFFSETS]);
+
+            customizer::ConditionalTurnsView conditional_turns{std::move(turns),
+                                                               std::move(turn_offsets),
+                                                               std::move(intervals),
+                                                               std::move(interval_offsets)};
+            customizer::files::readConditionalTurns(config.mld_conditional_turns_path,
+                                                    conditional_turns);
+        }
+
+        if (boost::filesystem::exists(config.mld_speed_profiles_path))
+        {
+            auto points_ptr = layout.GetBlockPtr<customizer::SpeedProfilePoint, true>(
+                memory_ptr, storage::DataLayout::MLD_SPEED_PROFILE_POINTS);
+            auto profile_offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                memory_ptr, storage::DataLayout::MLD_SPEED_PROFILE_OFFSETS);
+            auto node_profiles_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                memory_ptr, storage::DataLayout::MLD_NODE_SPEED_PROFILES);
+
+            util::vector_view<customizer::SpeedProfilePoint> points(
+                points_ptr, layout.num_entries[storage::DataLayout::MLD_SPEED_PROFILE_POINTS]);
+            util::vector_view<std::uint32_t> profile_offsets(
+                profile_offsets_ptr,
+                layout.num_entries[storage::DataLayout::MLD_SPEED_PROFILE_OFFSETS]);
+            util::vector_view<std::uint32_t> node_profiles(
+                node_profiles_ptr,
+                layout.num_entries[storage::DataLayout::MLD_NODE_SPEED_PROFILES]);
+
+            customizer::SpeedProfilesView speed_profiles{
+                std::move(points), std::move(profile_offsets), std::move(node_profiles)};
+            customizer::files::readSpeedProfiles(config.mld_speed_profiles_path, speed_profiles);
+        }
     }
 }
 }
@@ -54,6 +54,11 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
             &contractor_config.updater_config.turn_penalty_lookup_paths)
             ->composing(),
         "Lookup files containing from_, to_, via_nodes, and turn penalties to adjust turn weights")(
+        "delta-update",
+        boost::program_options::bool_switch(&contractor_config.updater_config.delta_update)
+            ->default_value(false),
+        "Apply the lookup files as changes to the previous delta update. Only changed geometries "
+        "are recomputed and the changed edge-based nodes are written to .osrm.changed_nodes")(
         "level-cache,o",
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
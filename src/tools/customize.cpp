@@ -10,6 +10,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace osrm;
@@ -46,7 +47,14 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
                 &customization_config.updater_config.turn_penalty_lookup_paths)
                 ->composing(),
             "Lookup files containing from_, to_, via_nodes, and turn penalties to adjust turn "
-            "weights")("edge-weight-updates-over-factor",
+            "weights")(
+            "delta-update",
+            boost::program_options::bool_switch(
+                &customization_config.updater_config.delta_update)
+                ->default_value(false),
+            "Apply the lookup files as changes to the previous delta update. Only changed "
+            "geometries are recomputed and the changed edge-based nodes are written to "
+            ".osrm.changed_nodes")("edge-weight-updates-over-factor",
                        boost::program_options::value<double>(
                            &customization_config.updater_config.log_edge_updates_factor)
                            ->default_value(0.0),
@@ -65,7 +73,34 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
                 &customization_config.updater_config.tz_file_path)
                 ->default_value(""),
             "Required for conditional turn restriction parsing, provide a geojson file containing "
-            "time zone boundaries");
+            "time zone boundaries")(
+            "conditional-turns-horizon",
+            boost::program_options::value<unsigned>(
+                &customization_config.updater_config.conditional_turns_horizon)
+                ->default_value(0),
+            "Use with `--parse-conditionals-from-now`. Store the conditional turn restrictions "
+            "for this many days to evaluate them for the departure time of each request instead "
+            "of applying them for the given time stamp")(
+            "metrics",
+            boost::program_options::value<std::vector<std::string>>()->multitoken(),
+            "Metrics to customize on the shared partition: weight, duration. The first one is used "
+            "by requests that do not select a metric. Defaults to weight")(
+            "quantize-cells",
+            boost::program_options::bool_switch(&customization_config.quantize_cells)
+                ->default_value(false),
+            "Store the cell matrices as 16 bit differences to a per-cell base value. Reduces the "
+            "memory used by the overlay at a small cost in query speed")(
+            "speed-profile-file",
+            boost::program_options::value<std::vector<std::string>>(
+                &customization_config.updater_config.speed_profile_lookup_paths)
+                ->composing(),
+            "Lookup files containing nodeA, nodeB and space separated speeds sampled evenly "
+            "over the day starting at midnight UTC")(
+            "time-slices",
+            boost::program_options::value<unsigned>(&customization_config.time_slices)
+                ->default_value(0),
+            "Use with `--speed-profile-file`. Customize every metric for this many evenly spaced "
+            "times of the day, requests with a departure time use the closest one");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
@@ -118,6 +153,34 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
 
     boost::program_options::notify(option_variables);
 
+    if (option_variables.count("metrics"))
+    {
+        customization_config.metric_sources.clear();
+        for (const auto &name : option_variables["metrics"].as<std::vector<std::string>>())
+        {
+            const auto source = customizer::metricSourceFromString(name);
+            if (!source)
+            {
+                util::Log(logERROR) << "Unknown metric " << name
+                                    << ", valid metrics are weight and duration";
+                return return_code::fail;
+            }
+            if (std::find(customization_config.metric_sources.begin(),
+                          customization_config.metric_sources.end(),
+                          *source) == customization_config.metric_sources.end())
+            {
+                customization_config.metric_sources.push_back(*source);
+            }
+        }
+    }
+
+    if (customization_config.time_slices > customizer::MINUTES_PER_DAY)
+    {
+        util::Log(logERROR) << "At most " << customizer::MINUTES_PER_DAY
+                            << " time slices can be customized";
+        return return_code::fail;
+    }
+
     if (!option_variables.count("input"))
     {
         std::cout << visible_options;
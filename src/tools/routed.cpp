@@ -1,3 +1,4 @@
+#include "engine/search_engine_data.hpp"
 #include "server/server.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
@@ -18,14 +19,18 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <exception>
 #include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -65,6 +70,16 @@ static EngineConfig::Algorithm stringToAlgorithm(std::string algorithm)
     throw util::RuntimeError(algorithm, ErrorCode::UnknownAlgorithm, SOURCE_REF);
 }
 
+static void logSearchEngineHeapStats()
+{
+    const auto heap_stats = engine::getSearchEngineHeapStats();
+    util::Log() << "search heaps: " << heap_stats.number_of_heaps << " heaps ("
+                << heap_stats.number_of_pooled_heaps << " pooled), "
+                << heap_stats.memory_usage / 1024 / 1024 << " MiB, "
+                << heap_stats.peak_memory_usage / 1024 / 1024 << " MiB at peak, "
+                << heap_stats.number_of_trims << " trims";
+}
+
 // generate boost::program_options object for the routing part
 inline unsigned generateServerProgramOptions(const int argc,
                                              const char *argv[],
@@ -72,6 +87,9 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              std::string &ip_address,
                                              int &ip_port,
                                              int &requested_num_threads,
+                                             int &requested_io_threads,
+                                             bool &pin_threads,
+                                             bool &reuse_port,
                                              bool &use_shared_memory,
                                              std::string &algorithm,
                                              bool &trial,
@@ -80,7 +98,15 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
                                              int &max_results_nearest,
-                                             int &max_alternatives)
+                                             int &max_alternatives,
+                                             int &tile_cache_size,
+                                             std::vector<double> &tile_prerender_bbox,
+                                             std::vector<unsigned> &tile_prerender_zoom,
+                                             int &unpacking_cache_size,
+                                             unsigned &request_parallelism,
+                                             unsigned &heap_trim_interval,
+                                             unsigned &heap_pool_size,
+                                             unsigned &heap_stats_interval)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -102,7 +128,17 @@ inline unsigned generateServerProgramOptions(const int argc,
          "TCP/IP port") //
         ("threads,t",
          value<int>(&requested_num_threads)->default_value(8),
-         "Number of threads to use") //
+         "Number of threads that compute the responses") //
+        ("io-threads",
+         value<int>(&requested_io_threads)->default_value(0),
+         "Number of threads that accept, read and write connections, 0 uses one per core") //
+        ("pin-threads",
+         value<bool>(&pin_threads)->implicit_value(true)->default_value(false),
+         "Pin the threads that compute the responses to cores (Linux only)") //
+        ("reuse-port",
+         value<bool>(&reuse_port)->implicit_value(true)->default_value(false),
+         "Accept connections on a SO_REUSEPORT socket per I/O thread. Other processes can bind "
+         "the same port then") //
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
@@ -126,7 +162,39 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. results supported in nearest query") //
         ("max-alternatives",
          value<int>(&max_alternatives)->default_value(3),
-         "Max. number of alternatives supported in the MLD route query");
+         "Max. number of alternatives supported in the MLD route query") //
+        ("tile-cache-size",
+         value<int>(&tile_cache_size)->default_value(0),
+         "Size of the cache for /tile responses in MiB, 0 disables the cache") //
+        ("tile-prerender-bbox",
+         value<std::vector<double>>(&tile_prerender_bbox)->multitoken(),
+         "Render the tiles of this area into the tile cache whenever a dataset is loaded: "
+         "min_lon min_lat max_lon max_lat") //
+        ("tile-prerender-zoom",
+         value<std::vector<unsigned>>(&tile_prerender_zoom)
+             ->multitoken()
+             ->default_value(std::vector<unsigned>{12, 14}, "12 14"),
+         "Zoom range of the pre-rendered tiles: min_zoom max_zoom") //
+        ("unpacking-cache-size",
+         value<int>(&unpacking_cache_size)->default_value(0),
+         "Size of the cache for unpacked MLD overlay edges per metric in MiB, 0 disables the "
+         "cache") //
+        ("request-parallelism",
+         value<unsigned>(&request_parallelism)->default_value(1),
+         "Max. number of threads a single route or match request uses to search its legs in "
+         "parallel, 1 searches them one after another") //
+        ("heap-trim-interval",
+         value<unsigned>(&heap_trim_interval)->default_value(0),
+         "Shrink every search heap to the largest of its last N queries after N queries, "
+         "0 never shrinks them") //
+        ("heap-pool-size",
+         value<unsigned>(&heap_pool_size)->default_value(0),
+         "Max. number of idle search heaps per type shared by all threads, 0 keeps the heaps "
+         "of every thread until the thread exits") //
+        ("heap-stats-interval",
+         value<unsigned>(&heap_stats_interval)->default_value(0),
+         "Log the number and memory of the search heaps every N seconds, 0 logs them at "
+         "shutdown only");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -176,6 +244,18 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if ((!tile_prerender_bbox.empty() && tile_prerender_bbox.size() != 4) ||
+        tile_prerender_zoom.size() != 2)
+    {
+        util::Log(logERROR) << "--tile-prerender-bbox needs 4 and --tile-prerender-zoom 2 values";
+        return INIT_FAILED;
+    }
+    if (!tile_prerender_bbox.empty() && tile_cache_size <= 0)
+    {
+        util::Log(logERROR) << "--tile-prerender-bbox requires a --tile-cache-size";
+        return INIT_FAILED;
+    }
+
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -199,17 +279,26 @@ int main(int argc, const char *argv[]) try
 
     bool trial_run = false;
     std::string ip_address;
-    int ip_port, requested_thread_num;
+    int ip_port, requested_thread_num, requested_io_threads;
+    bool pin_threads, reuse_port;
 
     EngineConfig config;
     boost::filesystem::path base_path;
     std::string algorithm;
+    int tile_cache_size;
+    std::vector<double> tile_prerender_bbox;
+    std::vector<unsigned> tile_prerender_zoom;
+    int unpacking_cache_size;
+    unsigned heap_stats_interval;
     const unsigned init_result = generateServerProgramOptions(argc,
                                                               argv,
                                                               base_path,
                                                               ip_address,
                                                               ip_port,
                                                               requested_thread_num,
+                                                              requested_io_threads,
+                                                              pin_threads,
+                                                              reuse_port,
                                                               config.use_shared_memory,
                                                               algorithm,
                                                               trial_run,
@@ -218,7 +307,15 @@ int main(int argc, const char *argv[]) try
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
                                                               config.max_results_nearest,
-                                                              config.max_alternatives);
+                                                              config.max_alternatives,
+                                                              tile_cache_size,
+                                                              tile_prerender_bbox,
+                                                              tile_prerender_zoom,
+                                                              unpacking_cache_size,
+                                                              config.request_parallelism,
+                                                              config.heap_trim_interval,
+                                                              config.heap_pool_size,
+                                                              heap_stats_interval);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -231,6 +328,19 @@ int main(int argc, const char *argv[]) try
     {
         config.storage_config = storage::StorageConfig(base_path);
     }
+    config.tile_cache_size = static_cast<std::size_t>(std::max(tile_cache_size, 0)) * 1024 * 1024;
+    config.unpacking_cache_size =
+        static_cast<std::size_t>(std::max(unpacking_cache_size, 0)) * 1024 * 1024;
+    if (!tile_prerender_bbox.empty())
+    {
+        config.tile_prerender_area = EngineConfig::TilePrerenderArea{
+            util::Coordinate{util::FloatLongitude{tile_prerender_bbox[0]},
+                             util::FloatLatitude{tile_prerender_bbox[1]}},
+            util::Coordinate{util::FloatLongitude{tile_prerender_bbox[2]},
+                             util::FloatLatitude{tile_prerender_bbox[3]}},
+            tile_prerender_zoom[0],
+            tile_prerender_zoom[1]};
+    }
     if (!config.use_shared_memory && !config.storage_config.IsValid())
     {
         util::Log(logERROR) << "Required files are missing, cannot continue";
@@ -266,7 +376,12 @@ int main(int argc, const char *argv[]) try
 #endif
 
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       requested_thread_num,
+                                                       std::max(requested_io_threads, 0),
+                                                       pin_threads,
+                                                       reuse_port);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
@@ -283,6 +398,21 @@ int main(int argc, const char *argv[]) try
         auto future = server_task.get_future();
         std::thread server_thread(std::move(server_task));
 
+        std::mutex heap_stats_mutex;
+        std::condition_variable heap_stats_condition;
+        bool stop_heap_stats = false;
+        std::thread heap_stats_thread;
+        if (heap_stats_interval > 0)
+        {
+            heap_stats_thread = std::thread([&] {
+                std::unique_lock<std::mutex> lock(heap_stats_mutex);
+                while (!heap_stats_condition.wait_for(lock,
+                                                      std::chrono::seconds(heap_stats_interval),
+                                                      [&] { return stop_heap_stats; }))
+                    logSearchEngineHeapStats();
+            });
+        }
+
 #ifndef _WIN32
         sigset_t wait_mask;
         pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
@@ -305,6 +435,15 @@ int main(int argc, const char *argv[]) try
         routing_server->Run();
 #endif
         util::Log() << "initiating shutdown";
+        if (heap_stats_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(heap_stats_mutex);
+                stop_heap_stats = true;
+            }
+            heap_stats_condition.notify_one();
+            heap_stats_thread.join();
+        }
         routing_server->Stop();
         util::Log() << "stopping threads";
 
@@ -319,6 +458,8 @@ int main(int argc, const char *argv[]) try
             util::Log(logWARNING) << "Didn't exit within 2 seconds. Hard abort!";
             std::exit(EXIT_FAILURE);
         }
+
+        logSearchEngineHeapStats();
     }
 
     util::Log() << "freeing objects";
@@ -0,0 +1,139 @@
+#include "updater/binary_source.hpp"
+#include "updater/source.hpp"
+
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct ConvertConfig
+{
+    std::vector<std::string> segment_speed_paths;
+    std::vector<std::string> turn_penalty_paths;
+    std::string output_path;
+};
+
+return_code parseArguments(int argc, char *argv[], ConvertConfig &config)
+{
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "segment-speed-file",
+        boost::program_options::value<std::vector<std::string>>(&config.segment_speed_paths)
+            ->composing(),
+        "Lookup files containing nodeA, nodeB, speed data to convert")(
+        "turn-penalty-file",
+        boost::program_options::value<std::vector<std::string>>(&config.turn_penalty_paths)
+            ->composing(),
+        "Lookup files containing from_, to_, via_nodes, and turn penalties to convert")(
+        "output,o",
+        boost::program_options::value<std::string>(&config.output_path),
+        "Output snapshot file");
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() +
+        " (--segment-speed-file <speeds.csv> | --turn-penalty-file <penalties.csv>)... "
+        "-o <output> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::command_line_parser(argc, argv).options(visible_options).run(),
+            option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (config.segment_speed_paths.empty() == config.turn_penalty_paths.empty())
+    {
+        util::Log(logERROR) << "Either segment speed or turn penalty files need to be given";
+        return return_code::fail;
+    }
+
+    if (config.output_path.empty())
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    ConvertConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    // Files are merged like the updater merges them, later files take precedence
+    TIMER_START(convert);
+    if (!config.segment_speed_paths.empty())
+    {
+        const auto lookup = updater::readSegmentValues(config.segment_speed_paths);
+        updater::binary::writeSegmentValues(config.output_path, lookup.lookup);
+    }
+    else
+    {
+        const auto lookup = updater::readTurnValues(config.turn_penalty_paths);
+        updater::binary::writeTurnValues(config.output_path, lookup.lookup);
+    }
+    TIMER_STOP(convert);
+
+    util::Log() << "Wrote " << config.output_path << " in " << TIMER_SEC(convert) << " seconds";
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
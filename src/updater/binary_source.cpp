@@ -0,0 +1,185 @@
+#include "updater/binary_source.hpp"
+
+#include "storage/io.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/format.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace osrm
+{
+namespace updater
+{
+namespace binary
+{
+namespace
+{
+
+SnapshotHeader makeHeader(const SnapshotType type, const std::size_t number_of_records)
+{
+    SnapshotHeader header;
+    std::copy(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC), header.magic);
+    header.version = SNAPSHOT_VERSION;
+    header.type = type;
+    header.number_of_records = number_of_records;
+    return header;
+}
+
+// Maps the snapshot and converts its records in parallel, the records are validated
+// to be sorted so a corrupt file can not break the lookups silently.
+template <typename Record, typename Key, typename Value, typename Convert>
+std::vector<std::pair<Key, Value>>
+readSnapshot(const std::string &path, const SnapshotType type, Convert convert)
+{
+    try
+    {
+        boost::iostreams::mapped_file_source mmap(path);
+
+        SnapshotHeader header;
+        if (mmap.size() < sizeof(header))
+            throw util::exception("Traffic snapshot " + path + " is truncated" + SOURCE_REF);
+        std::memcpy(&header, mmap.data(), sizeof(header));
+
+        if (!std::equal(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC), header.magic))
+            throw util::exception(path + " is not a traffic snapshot" + SOURCE_REF);
+        if (header.version != SNAPSHOT_VERSION)
+            throw util::exception(
+                (boost::format("Traffic snapshot %1% has version %2%, expected version %3%") %
+                 path % header.version % SNAPSHOT_VERSION)
+                    .str() +
+                SOURCE_REF);
+        if (header.type != type)
+            throw util::exception("Traffic snapshot " + path +
+                                  " contains the wrong kind of values" + SOURCE_REF);
+        if (mmap.size() != sizeof(header) + header.number_of_records * sizeof(Record))
+            throw util::exception("Traffic snapshot " + path + " is truncated" + SOURCE_REF);
+
+        const auto *records = reinterpret_cast<const Record *>(mmap.data() + sizeof(header));
+        std::vector<std::pair<Key, Value>> values(header.number_of_records);
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, values.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                                  values[index] = convert(records[index]);
+                          });
+
+        const auto unsorted =
+            std::adjacent_find(values.begin(), values.end(), [](const auto &lhs, const auto &rhs) {
+                return !(lhs.first < rhs.first);
+            });
+        if (unsorted != values.end())
+            throw util::exception("Traffic snapshot " + path +
+                                  " is not sorted or has duplicated keys" + SOURCE_REF);
+
+        util::Log() << "Loaded " << path << " with " << values.size() << " values";
+
+        return values;
+    }
+    catch (const std::ios_base::failure &e)
+    {
+        throw util::exception("exception in loading " + path + ": " + e.what() + SOURCE_REF);
+    }
+}
+
+template <typename Record, typename Key, typename Value, typename Convert>
+void writeSnapshot(const std::string &path,
+                   const SnapshotType type,
+                   const std::vector<std::pair<Key, Value>> &values,
+                   Convert convert)
+{
+    BOOST_ASSERT(std::adjacent_find(values.begin(),
+                                    values.end(),
+                                    [](const auto &lhs, const auto &rhs) {
+                                        return !(lhs.first < rhs.first);
+                                    }) == values.end());
+
+    storage::io::FileWriter writer(path, storage::io::FileWriter::HasNoFingerprint);
+    writer.WriteOne(makeHeader(type, values.size()));
+
+    // convert in blocks to bound the memory next to the values
+    const constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+    std::vector<Record> block;
+    block.reserve(std::min(BLOCK_SIZE, values.size()));
+    for (std::size_t begin = 0; begin < values.size(); begin += BLOCK_SIZE)
+    {
+        const auto end = std::min(begin + BLOCK_SIZE, values.size());
+        block.clear();
+        std::transform(
+            values.begin() + begin, values.begin() + end, std::back_inserter(block), convert);
+        writer.WriteFrom(block);
+    }
+}
+}
+
+bool isSnapshotFile(const std::string &path)
+{
+    std::ifstream input(path, std::ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    return input.read(magic, sizeof(magic)) &&
+           std::equal(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC), magic);
+}
+
+std::vector<std::pair<Segment, SpeedSource>> readSegmentValues(const std::string &path,
+                                                               const std::size_t source)
+{
+    BOOST_ASSERT(source <= std::numeric_limits<std::uint8_t>::max());
+    return readSnapshot<SegmentSpeedRecord, Segment, SpeedSource>(
+        path, SnapshotType::SegmentSpeeds, [source](const SegmentSpeedRecord &record) {
+            SpeedSource value;
+            value.speed = record.speed;
+            value.rate = record.rate;
+            value.source = static_cast<std::uint8_t>(source);
+            return std::make_pair(Segment{record.from, record.to}, value);
+        });
+}
+
+std::vector<std::pair<Turn, PenaltySource>> readTurnValues(const std::string &path,
+                                                           const std::size_t source)
+{
+    BOOST_ASSERT(source <= std::numeric_limits<std::uint8_t>::max());
+    return readSnapshot<TurnPenaltyRecord, Turn, PenaltySource>(
+        path, SnapshotType::TurnPenalties, [source](const TurnPenaltyRecord &record) {
+            PenaltySource value;
+            value.duration = record.duration;
+            value.weight = record.weight;
+            value.source = static_cast<std::uint8_t>(source);
+            return std::make_pair(Turn{record.from, record.via, record.to}, value);
+        });
+}
+
+void writeSegmentValues(const std::string &path,
+                        const std::vector<std::pair<Segment, SpeedSource>> &values)
+{
+    writeSnapshot<SegmentSpeedRecord>(
+        path, SnapshotType::SegmentSpeeds, values, [](const auto &value) {
+            return SegmentSpeedRecord{
+                value.first.from, value.first.to, value.second.rate, value.second.speed, 0};
+        });
+}
+
+void writeTurnValues(const std::string &path,
+                     const std::vector<std::pair<Turn, PenaltySource>> &values)
+{
+    writeSnapshot<TurnPenaltyRecord>(
+        path, SnapshotType::TurnPenalties, values, [](const auto &value) {
+            return TurnPenaltyRecord{value.first.from,
+                                     value.first.via,
+                                     value.first.to,
+                                     value.second.duration,
+                                     value.second.weight};
+        });
+}
+}
+}
+}
@@ -31,21 +31,32 @@ namespace updater
 {
 namespace csv
 {
-SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths)
+std::vector<std::pair<Segment, SpeedSource>> readSegmentValues(const std::string &path,
+                                                               const std::size_t source)
 {
-    CSVFilesParser<Segment, SpeedSource> parser(
-        1, qi::ulong_long >> ',' >> qi::ulong_long, qi::uint_ >> -(',' >> qi::double_));
+    CSVFilesParser<Segment, SpeedSource> parser(qi::ulong_long >> ',' >> qi::ulong_long,
+                                                qi::uint_ >> -(',' >> qi::double_));
 
-    return parser(paths);
+    return parser(path, source);
 }
 
-TurnLookupTable readTurnValues(const std::vector<std::string> &paths)
+std::vector<std::pair<Turn, PenaltySource>> readTurnValues(const std::string &path,
+                                                           const std::size_t source)
 {
-    CSVFilesParser<Turn, PenaltySource> parser(1,
-                                               qi::ulong_long >> ',' >> qi::ulong_long >> ',' >>
+    CSVFilesParser<Turn, PenaltySource> parser(qi::ulong_long >> ',' >> qi::ulong_long >> ',' >>
                                                    qi::ulong_long,
                                                qi::double_ >> -(',' >> qi::double_));
-    return parser(paths);
+    return parser(path, source);
+}
+
+std::vector<std::pair<Segment, SpeedProfileSource>>
+readSpeedProfileValues(const std::string &path, const std::size_t source)
+{
+    // the samples of a profile are separated by spaces: from,to,speed speed ... speed
+    CSVFilesParser<Segment, SpeedProfileSource> parser(
+        qi::ulong_long >> ',' >> qi::ulong_long,
+        (qi::uint_ % ' ')[boost::phoenix::bind(&SpeedProfileSource::speeds, qi::_val) = qi::_1]);
+    return parser(path, source);
 }
 }
 }
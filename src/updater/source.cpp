@@ -0,0 +1,71 @@
+#include "updater/source.hpp"
+#include "updater/binary_source.hpp"
+#include "updater/csv_source.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+
+#include <tbb/parallel_for.h>
+
+namespace osrm
+{
+namespace updater
+{
+namespace
+{
+
+// Reads every file with the binary or the CSV reader and merges the values, the file index
+// plus one is the source of a value. Files are read in parallel and sorted on their own, so
+// binary snapshots are never sorted again.
+template <typename Key, typename Value, typename BinaryReader, typename CSVReader>
+LookupTable<Key, Value> readValues(const std::vector<std::string> &paths,
+                                   BinaryReader read_binary,
+                                   CSVReader read_csv)
+{
+    try
+    {
+        std::vector<std::vector<std::pair<Key, Value>>> sources(paths.size());
+        tbb::parallel_for(std::size_t{0}, paths.size(), [&](const std::size_t index) {
+            const auto &path = paths[index];
+            sources[index] = binary::isSnapshotFile(path) ? read_binary(path, index + 1)
+                                                          : read_csv(path, index + 1);
+        });
+
+        auto lookup = mergeValues(std::move(sources));
+
+        util::Log() << "In total loaded " << paths.size() << " file(s) with a total of "
+                    << lookup.lookup.size() << " unique values";
+
+        return lookup;
+    }
+    catch (const tbb::captured_exception &e)
+    {
+        throw util::exception(e.what() + SOURCE_REF);
+    }
+}
+}
+
+SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths)
+{
+    return readValues<Segment, SpeedSource>(
+        paths, binary::readSegmentValues, csv::readSegmentValues);
+}
+
+TurnLookupTable readTurnValues(const std::vector<std::string> &paths)
+{
+    return readValues<Turn, PenaltySource>(paths, binary::readTurnValues, csv::readTurnValues);
+}
+
+SpeedProfileLookupTable readSpeedProfileValues(const std::vector<std::string> &paths)
+{
+    const auto read_binary = [](const std::string &path, const std::size_t)
+        -> std::vector<std::pair<Segment, SpeedProfileSource>> {
+        throw util::exception("Speed profiles can not be read from the snapshot " + path +
+                              SOURCE_REF);
+    };
+    return readValues<Segment, SpeedProfileSource>(
+        paths, read_binary, csv::readSpeedProfileValues);
+}
+}
+}
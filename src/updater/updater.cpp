@@ -1,5 +1,7 @@
 #include "updater/updater.hpp"
-#include "updater/csv_source.hpp"
+#include "updater/source.hpp"
+
+#include "customizer/files.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
@@ -26,6 +28,7 @@
 
 #include <boost/assert.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/geometry.hpp>
 #include <boost/geometry/index/rtree.hpp>
 #include <boost/interprocess/file_mapping.hpp>
@@ -43,9 +46,11 @@
 #include <cstdint>
 #include <fstream>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace std
@@ -142,6 +147,64 @@ void checkWeightsConsistency(
 }
 #endif
 
+// The applied state keeps the edges and node weights of the last delta update, so that the
+// next delta update only needs to touch the changed parts of the graph.
+void readAppliedState(const std::string &path,
+                      EdgeID &max_edge_id,
+                      std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                      std::vector<EdgeWeight> &node_weights)
+{
+    storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+    max_edge_id = reader.ReadElementCount64();
+    storage::serialization::read(reader, edge_based_edge_list);
+    storage::serialization::read(reader, node_weights);
+}
+
+void writeAppliedState(const std::string &path,
+                       const EdgeID max_edge_id,
+                       const std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                       const std::vector<EdgeWeight> &node_weights)
+{
+    storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+    writer.WriteElementCount64(max_edge_id);
+    storage::serialization::write(writer, edge_based_edge_list);
+    storage::serialization::write(writer, node_weights);
+}
+
+void writeChangedNodes(const std::string &path, const std::vector<NodeID> &changed_nodes)
+{
+    storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+    storage::serialization::write(writer, changed_nodes);
+}
+
+// Marks the nodes that are an endpoint of a segment in the lookup. With a delta update only
+// geometries that contain a marked node can change, all other geometries are skipped.
+std::vector<std::uint8_t> markLookupNodes(const SegmentLookupTable &segment_speed_lookup,
+                                          const extractor::PackedOSMIDs &osm_node_ids)
+{
+    std::vector<std::uint64_t> lookup_nodes;
+    lookup_nodes.reserve(2 * segment_speed_lookup.lookup.size());
+    for (const auto &value : segment_speed_lookup.lookup)
+    {
+        lookup_nodes.push_back(value.first.from);
+        lookup_nodes.push_back(value.first.to);
+    }
+    std::sort(lookup_nodes.begin(), lookup_nodes.end());
+    lookup_nodes.erase(std::unique(lookup_nodes.begin(), lookup_nodes.end()), lookup_nodes.end());
+
+    std::vector<std::uint8_t> is_lookup_node(osm_node_ids.size(), false);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, osm_node_ids.size()),
+                      [&](const auto &range) {
+                          for (auto node = range.begin(); node < range.end(); ++node)
+                          {
+                              const auto osm_id = static_cast<std::uint64_t>(osm_node_ids[node]);
+                              is_lookup_node[node] = std::binary_search(
+                                  lookup_nodes.begin(), lookup_nodes.end(), osm_id);
+                          }
+                      });
+    return is_lookup_node;
+}
+
 tbb::concurrent_vector<GeometryID>
 updateSegmentData(const UpdaterConfig &config,
                   const extractor::ProfileProperties &profile_properties,
@@ -194,6 +257,12 @@ updateSegmentData(const UpdaterConfig &config,
         segment_data_backup = std::make_unique<extractor::SegmentDataContainer>(segment_data);
     }
 
+    std::vector<std::uint8_t> is_lookup_node;
+    if (config.delta_update)
+    {
+        is_lookup_node = markLookupNodes(segment_speed_lookup, osm_node_ids);
+    }
+
     tbb::concurrent_vector<GeometryID> updated_segments;
 
     using DirectionalGeometryID = extractor::SegmentDataContainer::DirectionalGeometryID;
@@ -204,6 +273,13 @@ updateSegmentData(const UpdaterConfig &config,
         for (auto geometry_id = range.begin(); geometry_id < range.end(); geometry_id++)
         {
             auto nodes_range = segment_data.GetForwardGeometry(geometry_id);
+            if (config.delta_update &&
+                std::none_of(nodes_range.begin(), nodes_range.end(), [&](const NodeID node) {
+                    return is_lookup_node[node];
+                }))
+            {
+                continue;
+            }
 
             segment_lengths.clear();
             segment_lengths.reserve(nodes_range.size() + 1);
@@ -225,7 +301,10 @@ updateSegmentData(const UpdaterConfig &config,
                     auto segment_length = segment_lengths[segment_offset];
                     auto new_duration = convertToDuration(value->speed, segment_length);
                     auto new_weight = convertToWeight(*value, segment_length);
-                    fwd_was_updated = true;
+                    // a delta update only recomputes geometries with changed values
+                    fwd_was_updated = fwd_was_updated || !config.delta_update ||
+                                      new_weight != fwd_weights_range[segment_offset] ||
+                                      new_duration != fwd_durations_range[segment_offset];
 
                     fwd_weights_range[segment_offset] = new_weight;
                     fwd_durations_range[segment_offset] = new_duration;
@@ -258,7 +337,10 @@ updateSegmentData(const UpdaterConfig &config,
                     auto segment_length = segment_lengths[segment_offset];
                     auto new_duration = convertToDuration(value->speed, segment_length);
                     auto new_weight = convertToWeight(*value, segment_length);
-                    rev_was_updated = true;
+                    // a delta update only recomputes geometries with changed values
+                    rev_was_updated = rev_was_updated || !config.delta_update ||
+                                      new_weight != rev_weights_range[segment_offset] ||
+                                      new_duration != rev_durations_range[segment_offset];
 
                     rev_weights_range[segment_offset] = new_weight;
                     rev_durations_range[segment_offset] = new_duration;
@@ -288,8 +370,10 @@ updateSegmentData(const UpdaterConfig &config,
     {
         if (i == LUA_SOURCE)
         {
-            util::Log() << "Used " << merged_counters[LUA_SOURCE]
-                        << " speeds from LUA profile or input map";
+            // a delta update skips the unchanged geometries, so this count is not meaningful
+            if (!config.delta_update)
+                util::Log() << "Used " << merged_counters[LUA_SOURCE]
+                            << " speeds from LUA profile or input map";
         }
         else
         {
@@ -421,15 +505,23 @@ updateTurnPenalties(const UpdaterConfig &config,
 
         if (auto value = turn_penalty_lookup(osm_turn))
         {
-            turn_duration_penalty =
+            const auto new_duration_penalty =
                 boost::numeric_cast<TurnPenalty>(std::round(value->duration * 10.));
-            turn_weight_penalty = boost::numeric_cast<TurnPenalty>(std::round(
+            const auto new_weight_penalty = boost::numeric_cast<TurnPenalty>(std::round(
                 std::isfinite(value->weight) ? value->weight * weight_multiplier
-                                             : turn_duration_penalty * weight_multiplier / 10.));
+                                             : new_duration_penalty * weight_multiplier / 10.));
+
+            // a delta update only recomputes turns with changed values
+            if (!config.delta_update || new_duration_penalty != turn_duration_penalty ||
+                new_weight_penalty != turn_weight_penalty)
+            {
+                updated_turns.push_back(edge_index);
+            }
 
+            turn_duration_penalty = new_duration_penalty;
+            turn_weight_penalty = new_weight_penalty;
             turn_duration_penalties[edge_index] = turn_duration_penalty;
             turn_weight_penalties[edge_index] = turn_weight_penalty;
-            updated_turns.push_back(edge_index);
         }
 
         if (turn_weight_penalty < 0)
@@ -545,6 +637,252 @@ updateConditionalTurns(const UpdaterConfig &config,
 
     return updated_turns;
 }
+
+// Offset of the local time of the restriction to UTC in seconds
+std::int32_t getUTCOffset(struct tm local_time, const std::time_t utc_time)
+{
+#if defined(_WIN32)
+    const auto local_as_utc = _mkgmtime(&local_time);
+#else
+    const auto local_as_utc = timegm(&local_time);
+#endif
+    return static_cast<std::int32_t>(local_as_utc - utc_time);
+}
+
+// Expands the conditions of the restrictions into intervals between valid_now and the end of
+// the horizon and attaches them to the turns they restrict. The conditions are evaluated at
+// query time instead of being applied as turn penalties.
+customizer::ConditionalTurns
+buildConditionalTurns(const UpdaterConfig &config,
+                      const std::vector<extractor::TurnRestriction> &conditional_turns,
+                      const std::vector<util::Coordinate> &coordinates,
+                      const extractor::PackedOSMIDs &osm_node_ids,
+                      const std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                      const Timezoner &time_zone_handler)
+{
+    BOOST_ASSERT(config.conditional_turns_horizon > 0);
+    const std::time_t begin = config.valid_now;
+    const std::time_t end =
+        begin + static_cast<std::time_t>(config.conditional_turns_horizon) * 24 * 60 * 60;
+    if (end > std::numeric_limits<std::uint32_t>::max())
+        throw util::exception("Conditional turn horizon ends after the year 2106" + SOURCE_REF);
+
+    std::vector<customizer::ConditionalInterval> intervals;
+    std::vector<std::uint32_t> interval_offsets = {0};
+    // restrictions are matched to turns like in updateConditionalTurns
+    std::unordered_map<std::tuple<NodeID, NodeID, NodeID>,
+                       std::vector<std::uint32_t>,
+                       std::hash<std::tuple<NodeID, NodeID, NodeID>>>
+        is_no_conditions;
+    std::unordered_map<std::tuple<NodeID, NodeID>,
+                       std::vector<std::pair<NodeID, std::uint32_t>>,
+                       std::hash<std::tuple<NodeID, NodeID>>>
+        is_only_conditions;
+    for (const auto &c : conditional_turns)
+    {
+        if (c.condition.empty())
+        {
+            util::Log(logWARNING) << "Condition parsing failed for the turn "
+                                  << osm_node_ids[c.from.node] << " -> "
+                                  << osm_node_ids[c.via.node] << " -> "
+                                  << osm_node_ids[c.to.node];
+            continue;
+        }
+
+        const auto lon = static_cast<double>(toFloating(coordinates[c.via.node].lon));
+        const auto lat = static_cast<double>(toFloating(coordinates[c.via.node].lat));
+        const auto local_time = time_zone_handler(point_t{lon, lat});
+        if (!local_time)
+            continue;
+
+        // the offset at valid_now is used for the whole horizon
+        const auto utc_offset = getUTCOffset(*local_time, config.valid_now);
+        const auto condition_intervals =
+            util::GetOpeningIntervals(c.condition, begin, end, utc_offset);
+        if (condition_intervals.empty())
+            continue;
+
+        const auto condition = static_cast<std::uint32_t>(interval_offsets.size() - 1);
+        for (const auto &interval : condition_intervals)
+        {
+            intervals.push_back({static_cast<std::uint32_t>(interval.first),
+                                 static_cast<std::uint32_t>(interval.second)});
+        }
+        interval_offsets.push_back(intervals.size());
+
+        if (c.flags.is_only)
+            is_only_conditions[std::make_tuple(c.from.node, c.via.node)].emplace_back(c.to.node,
+                                                                                     condition);
+        else
+            is_no_conditions[std::make_tuple(c.from.node, c.via.node, c.to.node)].push_back(
+                condition);
+    }
+
+    boost::iostreams::mapped_file_source turn_index_region;
+    auto turn_index_blocks = util::mmapFile<extractor::lookup::TurnIndexBlock>(
+        config.turn_penalties_index_path, turn_index_region);
+
+    std::vector<customizer::ConditionalTurn> turns;
+    for (const auto &edge : edge_based_edge_list)
+    {
+        const auto &internal_turn = turn_index_blocks[edge.data.turn_id];
+        const auto add_turn = [&](const std::uint32_t condition) {
+            turns.push_back({edge.data.turn_id, edge.source, edge.target, condition});
+        };
+
+        const auto is_no = is_no_conditions.find(
+            std::make_tuple(internal_turn.from_id, internal_turn.via_id, internal_turn.to_id));
+        if (is_no != is_no_conditions.end())
+            std::for_each(is_no->second.begin(), is_no->second.end(), add_turn);
+
+        // with only_* restrictions, the turn on which the restriction is tagged is valid
+        const auto is_only =
+            is_only_conditions.find(std::make_tuple(internal_turn.from_id, internal_turn.via_id));
+        if (is_only != is_only_conditions.end())
+        {
+            for (const auto &to_and_condition : is_only->second)
+            {
+                if (to_and_condition.first != internal_turn.to_id)
+                    add_turn(to_and_condition.second);
+            }
+        }
+    }
+
+    std::sort(turns.begin(), turns.end(), [](const auto &lhs, const auto &rhs) {
+        return std::tie(lhs.condition, lhs.turn_id) < std::tie(rhs.condition, rhs.turn_id);
+    });
+    std::vector<std::uint32_t> turn_offsets;
+    turn_offsets.reserve(interval_offsets.size());
+    for (const auto condition : util::irange<std::uint32_t>(0, interval_offsets.size()))
+    {
+        const auto first = std::lower_bound(
+            turns.begin(), turns.end(), condition, [](const auto &turn, const auto condition) {
+                return turn.condition < condition;
+            });
+        turn_offsets.push_back(std::distance(turns.begin(), first));
+    }
+
+    util::Log() << "Found " << turns.size() << " conditionally restricted turns for "
+                << interval_offsets.size() - 1 << " conditions";
+
+    return customizer::ConditionalTurns{std::move(turns),
+                                        std::move(turn_offsets),
+                                        std::move(intervals),
+                                        std::move(interval_offsets)};
+}
+
+// Speed of the evenly spaced samples of a day at the minute, interpolated linearly
+double interpolateSpeed(const std::vector<unsigned> &speeds, const double minute)
+{
+    BOOST_ASSERT(!speeds.empty());
+    const auto position = minute * speeds.size() / customizer::MINUTES_PER_DAY;
+    const auto index = static_cast<std::size_t>(position) % speeds.size();
+    const auto next = (index + 1) % speeds.size();
+    const auto ratio = position - std::floor(position);
+    return speeds[index] + ratio * (static_cast<double>(speeds[next]) - speeds[index]);
+}
+
+// Combines the speed profiles of the segments of every edge-based node into one profile of
+// duration factors relative to the static duration of the node. The factors are sampled at
+// the sample times of all profiles of the node, equal profiles are stored only once.
+customizer::SpeedProfiles
+buildSpeedProfiles(const SpeedProfileLookupTable &speed_profile_lookup,
+                   const extractor::SegmentDataContainer &segment_data,
+                   const extractor::EdgeBasedNodeDataContainer &node_data,
+                   const std::vector<util::Coordinate> &coordinates,
+                   const extractor::PackedOSMIDs &osm_node_ids,
+                   const NodeID number_of_nodes)
+{
+    struct ProfiledSegment
+    {
+        double length;
+        std::vector<unsigned> speeds;
+    };
+
+    customizer::SpeedProfilesBuilder builder;
+    std::vector<std::uint32_t> node_profiles(number_of_nodes, customizer::INVALID_SPEED_PROFILE);
+    std::vector<ProfiledSegment> profiled_segments;
+    std::vector<std::uint16_t> minutes;
+    std::vector<customizer::SpeedProfilePoint> profile;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        const auto geometry_id = node_data.GetGeometryID(node);
+        const auto nodes_range = segment_data.GetForwardGeometry(geometry_id.id);
+        const auto forward_durations = segment_data.GetForwardDurations(geometry_id.id);
+        // oriented against the direction of the geometry
+        const auto reverse_durations = segment_data.GetReverseDurations(geometry_id.id);
+        const auto num_segments = forward_durations.size();
+
+        profiled_segments.clear();
+        double static_duration = 0;
+        double total_duration = 0;
+        for (const auto segment_offset : util::irange<std::size_t>(0, num_segments))
+        {
+            const double duration = geometry_id.forward
+                                        ? forward_durations[segment_offset]
+                                        : reverse_durations[num_segments - segment_offset - 1];
+            total_duration += duration;
+
+            const auto u = nodes_range[segment_offset];
+            const auto v = nodes_range[segment_offset + 1];
+            const auto from_id = osm_node_ids[geometry_id.forward ? u : v];
+            const auto to_id = osm_node_ids[geometry_id.forward ? v : u];
+            auto value = speed_profile_lookup({from_id, to_id});
+            if (!value || value->speeds.empty())
+            {
+                static_duration += duration;
+                continue;
+            }
+
+            profiled_segments.push_back(ProfiledSegment{
+                util::coordinate_calculation::greatCircleDistance(coordinates[u], coordinates[v]),
+                std::move(value->speeds)});
+        }
+
+        if (profiled_segments.empty() || total_duration <= 0)
+            continue;
+
+        minutes.clear();
+        for (const auto &segment : profiled_segments)
+        {
+            const auto samples = segment.speeds.size();
+            for (const auto sample : util::irange<std::size_t>(0, samples))
+                minutes.push_back(sample * customizer::MINUTES_PER_DAY / samples);
+        }
+        std::sort(minutes.begin(), minutes.end());
+        minutes.erase(std::unique(minutes.begin(), minutes.end()), minutes.end());
+
+        profile.clear();
+        for (const auto minute : minutes)
+        {
+            auto duration = static_duration;
+            for (const auto &segment : profiled_segments)
+            {
+                // durations are in deci-seconds, stopped traffic is clamped to 1 km/h
+                const auto speed = std::max(1., interpolateSpeed(segment.speeds, minute));
+                duration += segment.length * 36. / speed;
+            }
+            const auto factor = std::round(customizer::SPEED_PROFILE_BASE_FACTOR * duration /
+                                           total_duration);
+            profile.push_back(
+                {minute,
+                 static_cast<std::uint16_t>(std::min<double>(
+                     std::max<double>(factor, 1),
+                     std::numeric_limits<std::uint16_t>::max() - 1))});
+        }
+        node_profiles[node] = builder.Add(profile);
+    }
+
+    util::Log() << "Found " << builder.GetNumberOfProfiles() << " distinct speed profiles for "
+                << std::count_if(node_profiles.begin(),
+                                 node_profiles.end(),
+                                 [](const auto profile) {
+                                     return profile != customizer::INVALID_SPEED_PROFILE;
+                                 })
+                << " edge-based nodes";
+
+    return builder.Build(std::move(node_profiles));
+}
 }
 
 Updater::NumNodesAndEdges Updater::LoadAndUpdateEdgeExpandedGraph() const
@@ -565,17 +903,81 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
     std::vector<util::Coordinate> coordinates;
     extractor::PackedOSMIDs osm_node_ids;
 
-    extractor::files::readEdgeBasedGraph(
-        config.edge_based_graph_path, max_edge_id, edge_based_edge_list);
+    // The applied state can only be used if it is newer than the extracted graph and has the
+    // node weights the caller needs
+    bool use_applied_state = false;
+    if (config.delta_update && boost::filesystem::exists(config.applied_state_path) &&
+        boost::filesystem::last_write_time(config.applied_state_path) >=
+            boost::filesystem::last_write_time(config.edge_based_graph_path))
+    {
+        std::vector<EdgeWeight> applied_node_weights;
+        readAppliedState(
+            config.applied_state_path, max_edge_id, edge_based_edge_list, applied_node_weights);
+        use_applied_state =
+            node_weights.empty() || applied_node_weights.size() == node_weights.size();
+        if (use_applied_state && !node_weights.empty())
+            node_weights = std::move(applied_node_weights);
+    }
+
+    if (!use_applied_state)
+    {
+        extractor::files::readEdgeBasedGraph(
+            config.edge_based_graph_path, max_edge_id, edge_based_edge_list);
+    }
     extractor::files::readNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
 
-    const bool update_conditional_turns =
-        !config.turn_restrictions_path.empty() && config.valid_now;
+    // With a horizon the conditions are evaluated at query time and not applied here
+    const bool build_conditional_turns = !config.turn_restrictions_path.empty() &&
+                                         config.valid_now && config.conditional_turns_horizon > 0;
+    const bool update_conditional_turns = !config.turn_restrictions_path.empty() &&
+                                          config.valid_now && !build_conditional_turns;
     const bool update_edge_weights = !config.segment_speed_lookup_paths.empty();
     const bool update_turn_penalties = !config.turn_penalty_lookup_paths.empty();
+    const bool build_speed_profiles = !config.speed_profile_lookup_paths.empty();
+    // The geometry keeps the values of all earlier updates, without the applied state every
+    // edge needs to be derived from it again
+    const bool update_all_edges = config.delta_update && !use_applied_state;
+    if (update_all_edges)
+    {
+        util::Log(logWARNING) << "No applied state in " << config.applied_state_path
+                              << ", the delta update recomputes all edges";
+    }
 
-    if (!update_edge_weights && !update_turn_penalties && !update_conditional_turns)
+    if (build_conditional_turns)
     {
+        if (config.valid_now <= 0)
+        {
+            throw util::exception("Given UTC time is invalid: " +
+                                  std::to_string(config.valid_now) + SOURCE_REF);
+        }
+        const Timezoner time_zone_handler = Timezoner(config.tz_file_path, config.valid_now);
+
+        std::vector<extractor::TurnRestriction> conditional_turns;
+        {
+            using storage::io::FileReader;
+            FileReader reader(config.turn_restrictions_path, FileReader::VerifyFingerprint);
+            extractor::serialization::read(reader, conditional_turns);
+        }
+
+        customizer::files::writeConditionalTurns(config.conditional_turns_path,
+                                                 buildConditionalTurns(config,
+                                                                       conditional_turns,
+                                                                       coordinates,
+                                                                       osm_node_ids,
+                                                                       edge_based_edge_list,
+                                                                       time_zone_handler));
+    }
+    else if (update_conditional_turns && boost::filesystem::exists(config.conditional_turns_path))
+    {
+        // conditions of an earlier run would be applied on top of the new penalties
+        boost::filesystem::remove(config.conditional_turns_path);
+    }
+
+    if (!update_edge_weights && !update_turn_penalties && !update_conditional_turns &&
+        !update_all_edges && !build_speed_profiles)
+    {
+        if (config.delta_update)
+            writeChangedNodes(config.changed_nodes_path, {});
         saveDatasourcesNames(config);
         return max_edge_id;
     }
@@ -590,7 +992,8 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
     extractor::ProfileProperties profile_properties;
     std::vector<TurnPenalty> turn_weight_penalties;
     std::vector<TurnPenalty> turn_duration_penalties;
-    if (update_edge_weights || update_turn_penalties || update_conditional_turns)
+    if (update_edge_weights || update_turn_penalties || update_conditional_turns ||
+        update_all_edges || build_speed_profiles)
     {
         const auto load_segment_data = [&] {
             extractor::files::readSegmentData(config.geometry_path, segment_data);
@@ -642,7 +1045,7 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
     tbb::concurrent_vector<GeometryID> updated_segments;
     if (update_edge_weights)
     {
-        auto segment_speed_lookup = csv::readSegmentValues(config.segment_speed_lookup_paths);
+        auto segment_speed_lookup = readSegmentValues(config.segment_speed_lookup_paths);
 
         TIMER_START(segment);
         updated_segments = updateSegmentData(config,
@@ -657,7 +1060,24 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
         util::Log() << "Updating segment data took " << TIMER_MSEC(segment) << "ms.";
     }
 
-    auto turn_penalty_lookup = csv::readTurnValues(config.turn_penalty_lookup_paths);
+    if (build_speed_profiles)
+    {
+        // the profiles are relative to the updated static durations
+        const auto speed_profile_lookup = readSpeedProfileValues(config.speed_profile_lookup_paths);
+
+        TIMER_START(speed_profiles);
+        customizer::files::writeSpeedProfiles(config.speed_profiles_path,
+                                              buildSpeedProfiles(speed_profile_lookup,
+                                                                 segment_data,
+                                                                 node_data,
+                                                                 coordinates,
+                                                                 osm_node_ids,
+                                                                 max_edge_id + 1));
+        TIMER_STOP(speed_profiles);
+        util::Log() << "Building speed profiles took " << TIMER_MSEC(speed_profiles) << "ms.";
+    }
+
+    auto turn_penalty_lookup = readTurnValues(config.turn_penalty_lookup_paths);
     if (update_turn_penalties)
     {
         auto updated_turn_penalties = updateTurnPenalties(config,
@@ -708,11 +1128,22 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                        });
     }
 
-    tbb::parallel_sort(updated_segments.begin(),
-                       updated_segments.end(),
-                       [](const GeometryID lhs, const GeometryID rhs) {
-                           return std::tie(lhs.id, lhs.forward) < std::tie(rhs.id, rhs.forward);
-                       });
+    if (update_all_edges)
+    {
+        using DirectionalGeometryID = extractor::SegmentDataContainer::DirectionalGeometryID;
+        updated_segments.clear();
+        for (const auto id :
+             util::irange<DirectionalGeometryID>(0, segment_data.GetNumberOfGeometries()))
+        {
+            updated_segments.push_back(GeometryID{id, true});
+            updated_segments.push_back(GeometryID{id, false});
+        }
+    }
+
+    const auto geometry_less = [](const GeometryID lhs, const GeometryID rhs) {
+        return std::tie(lhs.id, lhs.forward) < std::tie(rhs.id, rhs.forward);
+    };
+    tbb::parallel_sort(updated_segments.begin(), updated_segments.end(), geometry_less);
 
     using WeightAndDuration = std::tuple<EdgeWeight, EdgeWeight>;
     const auto compute_new_weight_and_duration =
@@ -765,13 +1196,8 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
     const auto update_edge = [&](extractor::EdgeBasedEdge &edge) {
         const auto node_id = edge.source;
         const auto geometry_id = node_data.GetGeometryID(node_id);
-        auto updated_iter = std::lower_bound(updated_segments.begin(),
-                                             updated_segments.end(),
-                                             geometry_id,
-                                             [](const GeometryID lhs, const GeometryID rhs) {
-                                                 return std::tie(lhs.id, lhs.forward) <
-                                                        std::tie(rhs.id, rhs.forward);
-                                             });
+        auto updated_iter = std::lower_bound(
+            updated_segments.begin(), updated_segments.end(), geometry_id, geometry_less);
         if (updated_iter != updated_segments.end() && updated_iter->id == geometry_id.id &&
             updated_iter->forward == geometry_id.forward)
         {
@@ -849,6 +1275,35 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
             [&] { save_penalties(config.turn_duration_penalties_path, turn_duration_penalties); });
     }
 
+    if (config.delta_update)
+    {
+        // the nodes of the changed geometries are exactly the sources of the changed edges
+        std::vector<NodeID> changed_nodes;
+        for (const auto node_id : util::irange<NodeID>(0, max_edge_id + 1))
+        {
+            if (std::binary_search(updated_segments.begin(),
+                                   updated_segments.end(),
+                                   node_data.GetGeometryID(node_id),
+                                   geometry_less))
+            {
+                changed_nodes.push_back(node_id);
+            }
+        }
+        util::Log() << "Delta update changed " << changed_nodes.size() << " edge-based nodes";
+
+        tbb::parallel_invoke(
+            [&] { writeChangedNodes(config.changed_nodes_path, changed_nodes); },
+            [&] {
+                writeAppliedState(
+                    config.applied_state_path, max_edge_id, edge_based_edge_list, node_weights);
+            });
+    }
+    else
+    {
+        // a full update invalidates the state of earlier delta updates
+        boost::filesystem::remove(config.applied_state_path);
+    }
+
 #if !defined(NDEBUG)
     if (config.turn_penalty_lookup_paths.empty())
     { // don't check weights consistency with turn updates that can break assertion
@@ -9,6 +9,7 @@
 #include <cctype>
 #include <iomanip>
 #include <iterator>
+#include <time.h>
 
 namespace osrm
 {
@@ -431,5 +432,67 @@ bool CheckOpeningHours(const std::vector<OpeningHours> &input, const struct tm &
     return is_open;
 }
 
+std::vector<std::pair<std::time_t, std::time_t>>
+GetOpeningIntervals(const std::vector<OpeningHours> &input,
+                    const std::time_t begin,
+                    const std::time_t end,
+                    const std::int32_t utc_offset)
+{
+    const constexpr std::int32_t MINUTES_PER_DAY = 24 * 60;
+    const constexpr std::time_t SECONDS_PER_DAY = MINUTES_PER_DAY * 60;
+
+    // The result can only change at local midnight and at the bounds of the time spans,
+    // so it is enough to check these minutes of every day
+    std::vector<std::int32_t> day_minutes = {0};
+    for (const auto &opening_hours : input)
+    {
+        for (const auto &span : opening_hours.times)
+        {
+            for (const auto minutes : {span.from.minutes, span.to.minutes})
+                day_minutes.push_back((minutes % MINUTES_PER_DAY + MINUTES_PER_DAY) %
+                                      MINUTES_PER_DAY);
+        }
+    }
+    std::sort(day_minutes.begin(), day_minutes.end());
+    day_minutes.erase(std::unique(day_minutes.begin(), day_minutes.end()), day_minutes.end());
+
+    std::vector<std::time_t> changes = {begin};
+    const auto local_begin = begin + utc_offset;
+    const auto first_day =
+        local_begin - (local_begin % SECONDS_PER_DAY + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+    for (auto day = first_day; day < end + utc_offset; day += SECONDS_PER_DAY)
+    {
+        for (const auto minute : day_minutes)
+        {
+            const auto change = day + minute * 60 - utc_offset;
+            if (begin < change && change < end)
+                changes.push_back(change);
+        }
+    }
+
+    std::vector<std::pair<std::time_t, std::time_t>> intervals;
+    for (std::size_t index = 0; index < changes.size(); ++index)
+    {
+        // the broken down UTC time of the shifted value is the local time
+        const std::time_t local_time = changes[index] + utc_offset;
+        struct tm time;
+#if defined(_WIN32)
+        gmtime_s(&time, &local_time);
+#else
+        gmtime_r(&local_time, &time);
+#endif
+        if (!CheckOpeningHours(input, time))
+            continue;
+
+        const auto interval_end = index + 1 < changes.size() ? changes[index + 1] : end;
+        if (!intervals.empty() && intervals.back().second == changes[index])
+            intervals.back().second = interval_end;
+        else
+            intervals.emplace_back(changes[index], interval_end);
+    }
+
+    return intervals;
+}
+
 } // util
 } // osrm
@@ -67,6 +67,20 @@ test('constructor: throws if given an invalid algorithm', function(assert) {
         /algorithm option must be a string and one of 'CH', 'CoreCH', or 'MLD'/);
 });
 
+test('constructor: takes a threads argument', function(assert) {
+    assert.plan(1);
+    var osrm = new OSRM({path: monaco_path, threads: 2});
+    assert.ok(osrm);
+});
+
+test('constructor: throws if given an invalid threads option', function(assert) {
+    assert.plan(2);
+    assert.throws(function() { new OSRM({path: monaco_path, threads: 0}); },
+        /threads must be a positive integral number/);
+    assert.throws(function() { new OSRM({path: monaco_path, threads: 'a'}); },
+        /threads must be a positive integral number/);
+});
+
 test('constructor: loads MLD if given as algorithm', function(assert) {
     assert.plan(1);
     var osrm = new OSRM({algorithm: 'MLD', path: monaco_mld_path});
@@ -166,3 +166,28 @@ test('table: distance table in Monaco without hints', function(assert) {
         table.destinations.map(assertHasNoHints);
     });
 });
+
+test('table: returns a buffer of rendered JSON', function(assert) {
+    assert.plan(4);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: two_test_coordinates,
+        format: 'buffer'
+    };
+    osrm.table(options, function(err, buffer) {
+        assert.ifError(err);
+        assert.ok(Buffer.isBuffer(buffer), 'result must be a buffer');
+        var table = JSON.parse(buffer.toString());
+        assert.ok(Array.isArray(table.durations), 'result must contain durations');
+        assert.equal(table.durations.length, two_test_coordinates.length);
+    });
+});
+
+test('table: throws on invalid format', function(assert) {
+    assert.plan(2);
+    var osrm = new OSRM(data_path);
+    assert.throws(function() { osrm.table({coordinates: two_test_coordinates, format: 'xml'}, function(err, res) {}); },
+        /'format' param must be one of \[object, buffer\]/);
+    assert.throws(function() { osrm.table({coordinates: two_test_coordinates, format: 1}, function(err, res) {}); },
+        /Format must be a string/);
+});
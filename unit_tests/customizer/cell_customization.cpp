@@ -59,11 +59,12 @@ BOOST_AUTO_TEST_CASE(two_level_test)
     auto graph = makeGraph(mlp, edges);
 
     CellStorage storage(mlp, graph);
+    auto metric = storage.MakeMetric(MetricSource::Weight);
     CellCustomizer customizer(mlp);
     CellCustomizer::Heap heap(graph.GetNumberOfNodes());
 
-    auto cell_1_0 = storage.GetCell(1, 0);
-    auto cell_1_1 = storage.GetCell(1, 1);
+    auto cell_1_0 = storage.GetCell(metric, 1, 0);
+    auto cell_1_1 = storage.GetCell(metric, 1, 1);
 
     REQUIRE_SIZE_RANGE(cell_1_0.GetSourceNodes(), 1);
     REQUIRE_SIZE_RANGE(cell_1_0.GetDestinationNodes(), 1);
@@ -82,8 +83,8 @@ BOOST_AUTO_TEST_CASE(two_level_test)
     REQUIRE_SIZE_RANGE(cell_1_1.GetOutWeight(2), 2);
     REQUIRE_SIZE_RANGE(cell_1_1.GetInWeight(3), 2);
 
-    customizer.Customize(graph, heap, storage, 1, 0);
-    customizer.Customize(graph, heap, storage, 1, 1);
+    customizer.Customize(graph, heap, storage, metric, 1, 0);
+    customizer.Customize(graph, heap, storage, metric, 1, 1);
 
     // cell 0
     // check row source -> destination
@@ -137,14 +138,15 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     auto graph = makeGraph(mlp, edges);
 
     CellStorage storage(mlp, graph);
+    auto metric = storage.MakeMetric(MetricSource::Weight);
 
-    auto cell_1_0 = storage.GetCell(1, 0);
-    auto cell_1_1 = storage.GetCell(1, 1);
-    auto cell_1_2 = storage.GetCell(1, 2);
-    auto cell_1_3 = storage.GetCell(1, 3);
-    auto cell_2_0 = storage.GetCell(2, 0);
-    auto cell_2_1 = storage.GetCell(2, 1);
-    auto cell_3_0 = storage.GetCell(3, 0);
+    auto cell_1_0 = storage.GetCell(metric, 1, 0);
+    auto cell_1_1 = storage.GetCell(metric, 1, 1);
+    auto cell_1_2 = storage.GetCell(metric, 1, 2);
+    auto cell_1_3 = storage.GetCell(metric, 1, 3);
+    auto cell_2_0 = storage.GetCell(metric, 2, 0);
+    auto cell_2_1 = storage.GetCell(metric, 2, 1);
+    auto cell_3_0 = storage.GetCell(metric, 3, 0);
 
     REQUIRE_SIZE_RANGE(cell_1_0.GetSourceNodes(), 1);
     REQUIRE_SIZE_RANGE(cell_1_0.GetDestinationNodes(), 1);
@@ -207,13 +209,13 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     CellCustomizer customizer(mlp);
     CellCustomizer::Heap heap(graph.GetNumberOfNodes());
 
-    customizer.Customize(graph, heap, storage, 1, 0);
-    customizer.Customize(graph, heap, storage, 1, 1);
-    customizer.Customize(graph, heap, storage, 1, 2);
-    customizer.Customize(graph, heap, storage, 1, 3);
+    customizer.Customize(graph, heap, storage, metric, 1, 0);
+    customizer.Customize(graph, heap, storage, metric, 1, 1);
+    customizer.Customize(graph, heap, storage, metric, 1, 2);
+    customizer.Customize(graph, heap, storage, metric, 1, 3);
 
-    customizer.Customize(graph, heap, storage, 2, 0);
-    customizer.Customize(graph, heap, storage, 2, 1);
+    customizer.Customize(graph, heap, storage, metric, 2, 0);
+    customizer.Customize(graph, heap, storage, metric, 2, 1);
 
     // level 1
     // cell 0
@@ -261,13 +263,114 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     CHECK_EQUAL_RANGE(cell_2_1.GetInDuration(12), INVALID_EDGE_WEIGHT, 20);
 
     CellStorage storage_rec(mlp, graph);
-    customizer.Customize(graph, storage_rec);
+    auto metric_rec = storage_rec.MakeMetric(MetricSource::Weight);
+    customizer.Customize(graph, storage_rec, metric_rec);
+
+    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetOutWeight(9), storage_rec.GetCell(metric_rec, 2, 1).GetOutWeight(9));
+    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetOutWeight(13), storage_rec.GetCell(metric_rec, 2, 1).GetOutWeight(13));
+    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(8), storage_rec.GetCell(metric_rec, 2, 1).GetInWeight(8));
+    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(9), storage_rec.GetCell(metric_rec, 2, 1).GetInWeight(9));
+    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(12), storage_rec.GetCell(metric_rec, 2, 1).GetInWeight(12));
+}
+
+BOOST_AUTO_TEST_CASE(duration_metric_test)
+{
+    // node:                0  1  2  3
+    std::vector<CellID> l1{{0, 0, 1, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {{0, 1, 1}, {0, 2, 1}, {2, 3, 1}, {3, 1, 1}, {3, 2, 1}};
+
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+
+    // both metrics share the cell topology, the mock durations are twice the weights
+    auto weight_metric = storage.MakeMetric(MetricSource::Weight);
+    auto duration_metric = storage.MakeMetric(MetricSource::Duration);
+    customizer.Customize(graph, storage, weight_metric);
+    customizer.Customize(graph, storage, duration_metric);
+
+    auto weight_cell = storage.GetCell(weight_metric, 1, 1);
+    auto duration_cell = storage.GetCell(duration_metric, 1, 1);
+
+    CHECK_EQUAL_RANGE(weight_cell.GetOutWeight(2), 0, 1);
+    CHECK_EQUAL_RANGE(weight_cell.GetOutWeight(3), 1, 0);
+    CHECK_EQUAL_RANGE(duration_cell.GetOutWeight(2), 0, 2);
+    CHECK_EQUAL_RANGE(duration_cell.GetOutWeight(3), 2, 0);
+    CHECK_EQUAL_COLLECTIONS(duration_cell.GetOutWeight(2), weight_cell.GetOutDuration(2));
+    CHECK_EQUAL_COLLECTIONS(duration_cell.GetOutDuration(3), weight_cell.GetOutDuration(3));
+}
+
+BOOST_AUTO_TEST_CASE(time_slice_test)
+{
+    // node:                0  1  2  3
+    std::vector<CellID> l1{{0, 0, 1, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {{0, 1, 1}, {0, 2, 1}, {2, 3, 1}, {3, 1, 1}, {3, 2, 1}};
+
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    // edges are scaled by the factor of the node they leave
+    CellCustomizer customizer(mlp, {100, 100, 300, 250});
+
+    auto metric = storage.MakeMetric(MetricSource::Weight);
+    metric.time_slice = 8 * 60;
+    customizer.Customize(graph, storage, metric);
+
+    auto cell = storage.GetCell(metric, 1, 1);
+    CHECK_EQUAL_RANGE(cell.GetOutWeight(2), 0, 3);
+    CHECK_EQUAL_RANGE(cell.GetOutWeight(3), 3, 0);
+    CHECK_EQUAL_RANGE(cell.GetOutDuration(2), 0, 6);
+    CHECK_EQUAL_RANGE(cell.GetOutDuration(3), 5, 0);
+}
+
+BOOST_AUTO_TEST_CASE(large_cells_test)
+{
+    // two level 1 cells of 40 nodes each with every node on the boundary,
+    // so the searches of one cell are split into several tasks
+    const NodeID cell_size = 40;
+    std::vector<CellID> l1(2 * cell_size);
+    std::vector<CellID> l2(2 * cell_size, 0);
+    for (NodeID node = 0; node < 2 * cell_size; ++node)
+        l1[node] = node / cell_size;
+    MultiLevelPartition mlp{{l1, l2}, {2, 1}};
+
+    std::vector<MockEdge> edges;
+    for (NodeID node = 0; node < cell_size; ++node)
+    {
+        const auto next = (node + 1) % cell_size;
+        edges.push_back({node, next, static_cast<EdgeWeight>(node + 1)});
+        edges.push_back({cell_size + node, cell_size + next, 1});
+        edges.push_back({node, cell_size + node, 1});
+    }
+
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    CellCustomizer::Heap heap(graph.GetNumberOfNodes());
 
-    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetOutWeight(9), storage_rec.GetCell(2, 1).GetOutWeight(9));
-    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetOutWeight(13), storage_rec.GetCell(2, 1).GetOutWeight(13));
-    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(8), storage_rec.GetCell(2, 1).GetInWeight(8));
-    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(9), storage_rec.GetCell(2, 1).GetInWeight(9));
-    CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(12), storage_rec.GetCell(2, 1).GetInWeight(12));
+    auto metric_seq = storage.MakeMetric(MetricSource::Weight);
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+            customizer.Customize(graph, heap, storage, metric_seq, level, id);
+
+    auto metric_par = storage.MakeMetric(MetricSource::Weight);
+    customizer.Customize(graph, storage, metric_par);
+
+    REQUIRE_SIZE_RANGE(storage.GetCell(metric_seq, 1, 0).GetSourceNodes(), cell_size);
+    BOOST_CHECK_EQUAL_COLLECTIONS(metric_seq.weights.begin(),
+                                  metric_seq.weights.end(),
+                                  metric_par.weights.begin(),
+                                  metric_par.weights.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(metric_seq.durations.begin(),
+                                  metric_seq.durations.end(),
+                                  metric_par.durations.begin(),
+                                  metric_par.durations.end());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,158 @@
+#include "common/range_tools.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "customizer/cell_customizer.hpp"
+#include "customizer/quantized_values.hpp"
+#include "partition/multi_level_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/static_graph.hpp"
+
+#include <limits>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::customizer;
+using namespace osrm::partition;
+using namespace osrm::util;
+
+namespace
+{
+struct MockEdge
+{
+    NodeID start;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+auto makeGraph(const MultiLevelPartition &mlp, const std::vector<MockEdge> &mock_edges)
+{
+    struct EdgeData
+    {
+        EdgeWeight weight;
+        EdgeDuration duration;
+        bool forward;
+        bool backward;
+    };
+    using Edge = static_graph_details::SortableEdgeWithData<EdgeData>;
+    std::vector<Edge> edges;
+    std::size_t max_id = 0;
+    for (const auto &m : mock_edges)
+    {
+        max_id = std::max<std::size_t>(max_id, std::max(m.start, m.target));
+        edges.push_back(Edge{m.start, m.target, m.weight, 2 * m.weight, true, false});
+        edges.push_back(Edge{m.target, m.start, m.weight, 2 * m.weight, false, true});
+    }
+    std::sort(edges.begin(), edges.end());
+    return partition::MultiLevelGraph<EdgeData, osrm::storage::Ownership::Container>(
+        mlp, max_id + 1, edges);
+}
+
+template <typename T>
+std::vector<T>
+decode(const QuantizedValues<T> &quantized, std::size_t begin, std::size_t end, T base)
+{
+    const auto outliers_begin = quantized.outliers.data();
+    const auto outliers_end = outliers_begin + quantized.outliers.size();
+    const auto codes = quantized.codes.data();
+    return std::vector<T>(
+        QuantizedValueIterator<T>{codes + begin, 1, base, codes, outliers_begin, outliers_end},
+        QuantizedValueIterator<T>{codes + end, 1, base, codes, outliers_begin, outliers_end});
+}
+}
+
+BOOST_AUTO_TEST_SUITE(quantized_values_tests)
+
+BOOST_AUTO_TEST_CASE(round_trip_test)
+{
+    const auto invalid = std::numeric_limits<EdgeWeight>::max();
+
+    // cell 0: [0, 4), cell 1: [4, 7), cell 2 is empty, the last value belongs to no cell
+    std::vector<EdgeWeight> values = {100, 5, invalid, 70000, invalid, invalid, invalid, 7};
+    std::vector<std::uint32_t> offsets = {0, 4, 7, 7};
+
+    const auto quantized = quantizeValues(values, offsets);
+
+    BOOST_REQUIRE_EQUAL(quantized.bases.size(), 3);
+    BOOST_CHECK_EQUAL(quantized.bases[0], 5);
+    BOOST_CHECK_EQUAL(quantized.bases[1], 0);
+    BOOST_CHECK_EQUAL(quantized.bases[2], 0);
+
+    BOOST_REQUIRE_EQUAL(quantized.codes.size(), values.size());
+    BOOST_CHECK_EQUAL(quantized.codes[0], 95);
+    BOOST_CHECK_EQUAL(quantized.codes[1], 0);
+    BOOST_CHECK_EQUAL(quantized.codes[2], QUANTIZED_INVALID);
+    BOOST_CHECK_EQUAL(quantized.codes[3], QUANTIZED_ESCAPE);
+    BOOST_CHECK_EQUAL(quantized.codes[4], QUANTIZED_INVALID);
+    BOOST_CHECK_EQUAL(quantized.codes[7], 7);
+
+    BOOST_REQUIRE_EQUAL(quantized.outliers.size(), 1);
+    BOOST_CHECK_EQUAL(quantized.outliers[0].index, 3);
+    BOOST_CHECK_EQUAL(quantized.outliers[0].value, 70000);
+
+    CHECK_EQUAL_RANGE(decode(quantized, 0, 4, quantized.bases[0]), 100, 5, invalid, 70000);
+    CHECK_EQUAL_RANGE(decode(quantized, 4, 7, quantized.bases[1]), invalid, invalid, invalid);
+    CHECK_EQUAL_RANGE(decode(quantized, 7, 8, 0), 7);
+}
+
+BOOST_AUTO_TEST_CASE(quantized_cell_test)
+{
+    // node:                0  1  2  3  4  5  6  7
+    std::vector<CellID> l1{{0, 0, 0, 0, 1, 1, 1, 1}};
+    std::vector<CellID> l2{{0, 0, 0, 0, 0, 0, 0, 0}};
+    MultiLevelPartition mlp{{l1, l2}, {2, 1}};
+
+    // the long edges produce shortcuts that do not fit into 16 bit
+    std::vector<MockEdge> edges = {{0, 1, 1},
+                                   {1, 2, 100000},
+                                   {2, 3, 1},
+                                   {3, 0, 1},
+                                   {4, 5, 3},
+                                   {5, 6, 1},
+                                   {6, 7, 70000},
+                                   {7, 4, 2},
+                                   {3, 4, 1},
+                                   {6, 1, 1},
+                                   {2, 5, 5}};
+
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    auto metric = storage.MakeMetric(MetricSource::Weight);
+    customizer.Customize(graph, storage, metric);
+
+    auto quantized_metric = metric;
+    storage.QuantizeMetric(quantized_metric);
+    BOOST_CHECK(quantized_metric.IsQuantized());
+    BOOST_CHECK(quantized_metric.weights.empty());
+    BOOST_CHECK(!quantized_metric.quantized_weights.outliers.empty());
+    BOOST_CHECK(!quantized_metric.quantized_durations.outliers.empty());
+
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = storage.GetCell(metric, level, id);
+            const auto quantized_cell = storage.GetQuantizedCell(quantized_metric, level, id);
+
+            CHECK_EQUAL_COLLECTIONS(cell.GetSourceNodes(), quantized_cell.GetSourceNodes());
+            CHECK_EQUAL_COLLECTIONS(cell.GetDestinationNodes(),
+                                    quantized_cell.GetDestinationNodes());
+
+            for (auto node : cell.GetSourceNodes())
+            {
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutWeight(node), quantized_cell.GetOutWeight(node));
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutDuration(node),
+                                        quantized_cell.GetOutDuration(node));
+            }
+            for (auto node : cell.GetDestinationNodes())
+            {
+                CHECK_EQUAL_COLLECTIONS(cell.GetInWeight(node), quantized_cell.GetInWeight(node));
+                CHECK_EQUAL_COLLECTIONS(cell.GetInDuration(node),
+                                        quantized_cell.GetInDuration(node));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+#include <boost/test/unit_test.hpp>
+
+#include "customizer/speed_profiles.hpp"
+
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::customizer;
+
+BOOST_AUTO_TEST_SUITE(speed_profiles_tests)
+
+BOOST_AUTO_TEST_CASE(interpolate_factors)
+{
+    SpeedProfilesBuilder builder;
+    // slow in the morning, back to normal at noon
+    const auto profile = builder.Add({{12 * 60, 100}, {6 * 60, 100}, {8 * 60, 200}});
+    BOOST_REQUIRE_EQUAL(profile, 0);
+    const auto profiles = builder.Build({profile, INVALID_SPEED_PROFILE});
+
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 6 * 60), 100);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 7 * 60), 150);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 8 * 60), 200);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 10 * 60), 150);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 18 * 60), 100);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(INVALID_SPEED_PROFILE, 7 * 60), 100);
+
+    BOOST_CHECK_EQUAL(profiles.GetProfile(0), profile);
+    BOOST_CHECK_EQUAL(profiles.GetProfile(1), INVALID_SPEED_PROFILE);
+    BOOST_CHECK_EQUAL(profiles.GetProfile(2), INVALID_SPEED_PROFILE);
+}
+
+BOOST_AUTO_TEST_CASE(interpolate_over_midnight)
+{
+    SpeedProfilesBuilder builder;
+    const auto profile = builder.Add({{60, 100}, {23 * 60, 300}});
+    const auto profiles = builder.Build({profile});
+
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 0), 200);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 23 * 60 + 30), 250);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(profile, 30), 150);
+    const auto factors = profiles.GetFactors(0);
+    BOOST_REQUIRE_EQUAL(factors.size(), 1);
+    BOOST_CHECK_EQUAL(factors.front(), 200);
+
+    SpeedProfilesBuilder single_builder;
+    const auto single = single_builder.Add({{600, 120}});
+    BOOST_CHECK_EQUAL(single_builder.Build({single}).GetFactor(single, 0), 120);
+}
+
+BOOST_AUTO_TEST_CASE(deduplicate_profiles)
+{
+    SpeedProfilesBuilder builder;
+    const auto first = builder.Add({{0, 100}, {480, 180}});
+    const auto second = builder.Add({{480, 180}, {0, 100}});
+    const auto third = builder.Add({{0, 100}, {480, 170}});
+    const auto unchanged = builder.Add({{0, 100}, {480, 100}});
+
+    BOOST_CHECK_EQUAL(first, second);
+    BOOST_CHECK_NE(first, third);
+    BOOST_CHECK_EQUAL(unchanged, INVALID_SPEED_PROFILE);
+    BOOST_CHECK_EQUAL(builder.GetNumberOfProfiles(), 2);
+
+    const auto profiles = builder.Build({first, second, third, unchanged});
+    BOOST_CHECK_EQUAL(profiles.GetNumberOfProfiles(), 2);
+    BOOST_CHECK_EQUAL(profiles.GetPoints(third).size(), 2);
+    BOOST_CHECK_EQUAL(profiles.GetFactor(third, 480), 170);
+}
+
+BOOST_AUTO_TEST_CASE(apply_factors)
+{
+    BOOST_CHECK_EQUAL(applySpeedFactor<EdgeWeight>(10, 100), 10);
+    BOOST_CHECK_EQUAL(applySpeedFactor<EdgeWeight>(10, 150), 15);
+    BOOST_CHECK_EQUAL(applySpeedFactor<EdgeWeight>(3, 50), 2);
+    BOOST_CHECK_EQUAL(applySpeedFactor<EdgeWeight>(1, 10), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -36,6 +36,35 @@ BOOST_AUTO_TEST_CASE(rfc4648_test_vectors_roundtrip)
     BOOST_CHECK_EQUAL(decodeBase64(encodeBase64("foobar")), "foobar");
 }
 
+BOOST_AUTO_TEST_CASE(decoding_accepts_both_alphabets_and_missing_padding)
+{
+    using namespace osrm::engine;
+
+    // 0xfb 0xff 0xbf encodes to "+/+/" and "-_-_" in the URL safe alphabet
+    BOOST_CHECK_EQUAL(decodeBase64("+/+/"), "\xfb\xff\xbf");
+    BOOST_CHECK_EQUAL(decodeBase64("-_-_"), "\xfb\xff\xbf");
+    BOOST_CHECK_EQUAL(decodeBase64("Zm9vYg"), "foob");
+    BOOST_CHECK_EQUAL(decodeBase64("Zm9vYmE"), "fooba");
+    BOOST_CHECK_EQUAL(decodeBase64(""), "");
+}
+
+BOOST_AUTO_TEST_CASE(all_byte_values_roundtrip)
+{
+    using namespace osrm::engine;
+
+    std::string bytes;
+    for (int value = 0; value < 256; ++value)
+        bytes.push_back(static_cast<char>(value));
+
+    for (std::size_t size = 0; size <= bytes.size(); ++size)
+    {
+        const auto prefix = bytes.substr(0, size);
+        const auto encoded = encodeBase64(prefix);
+        BOOST_CHECK_EQUAL(encoded.size() % 4, 0);
+        BOOST_CHECK_EQUAL(decodeBase64(encoded), prefix);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(hint_encoding_decoding_roundtrip)
 {
     using namespace osrm::engine;
@@ -0,0 +1,157 @@
+#include "engine/conditional_turn_filter.hpp"
+#include "customizer/conditional_turns.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(conditional_turn_filter)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::customizer;
+
+namespace
+{
+ConditionalTurns makeConditionalTurns()
+{
+    // condition 0 restricts turns 5 and 9, condition 1 restricts turn 70000
+    std::vector<ConditionalTurn> turns = {{5, 0, 1, 0}, {9, 1, 2, 0}, {70000, 3, 4, 1}};
+    std::vector<std::uint32_t> turn_offsets = {0, 2, 3};
+    std::vector<ConditionalInterval> intervals = {{100, 200}, {300, 400}, {150, 160}};
+    std::vector<std::uint32_t> interval_offsets = {0, 2, 3};
+    return ConditionalTurns{std::move(turns),
+                            std::move(turn_offsets),
+                            std::move(intervals),
+                            std::move(interval_offsets)};
+}
+
+partition::MultiLevelPartition makePartition()
+{
+    // node:                0  1  2  3  4  5  6  7
+    std::vector<CellID> l1{{0, 0, 1, 1, 2, 2, 3, 3}};
+    std::vector<CellID> l2{{0, 0, 0, 0, 1, 1, 1, 1}};
+    return partition::MultiLevelPartition{{l1, l2}, {4, 2}};
+}
+
+// Base graph edges with the flags and turn ids of the edge-based graph
+struct MockFacade
+{
+    struct EdgeData
+    {
+        bool forward;
+        bool backward;
+        EdgeID turn_id;
+    };
+
+    const EdgeData &GetEdgeData(const EdgeID edge) const { return edges[edge]; }
+    NodeID GetTarget(const EdgeID edge) const { return targets[edge]; }
+    EdgeID FindEdge(const NodeID from, const NodeID to) const
+    {
+        for (EdgeID edge = 0; edge < edges.size(); ++edge)
+            if (sources[edge] == from && targets[edge] == to)
+                return edge;
+        return SPECIAL_EDGEID;
+    }
+
+    std::vector<NodeID> sources;
+    std::vector<NodeID> targets;
+    std::vector<EdgeData> edges;
+};
+}
+
+BOOST_AUTO_TEST_CASE(conditions_are_active_in_their_intervals)
+{
+    const auto conditional_turns = makeConditionalTurns();
+    BOOST_REQUIRE_EQUAL(conditional_turns.GetNumberOfConditions(), 2);
+
+    BOOST_CHECK(!conditional_turns.IsActive(0, 99));
+    BOOST_CHECK(conditional_turns.IsActive(0, 100));
+    BOOST_CHECK(conditional_turns.IsActive(0, 199));
+    BOOST_CHECK(!conditional_turns.IsActive(0, 200));
+    BOOST_CHECK(conditional_turns.IsActive(0, 300));
+    BOOST_CHECK(!conditional_turns.IsActive(0, 400));
+    BOOST_CHECK(!conditional_turns.IsActive(1, 120));
+    BOOST_CHECK(conditional_turns.IsActive(1, 155));
+
+    BOOST_CHECK_EQUAL(conditional_turns.GetTurns(0).size(), 2);
+    BOOST_CHECK_EQUAL(conditional_turns.GetTurns(1).front().turn_id, 70000);
+}
+
+BOOST_AUTO_TEST_CASE(filter_restricts_turns_and_cells)
+{
+    const auto partition = makePartition();
+    const auto conditional_turns = makeConditionalTurns();
+    BOOST_REQUIRE_EQUAL(partition.GetNumberOfLevels(), 3);
+
+    const ConditionalTurnFilter filter(partition, conditional_turns, 155);
+    BOOST_CHECK(!filter.Empty());
+    BOOST_CHECK(filter.IsRestricted(5));
+    BOOST_CHECK(filter.IsRestricted(9));
+    BOOST_CHECK(filter.IsRestricted(70000));
+    BOOST_CHECK(!filter.IsRestricted(6));
+    // shares the bit of 70000 in the mask
+    BOOST_CHECK(!filter.IsRestricted(70000 % (1 << 16)));
+
+    // turn 5 is inside of cell 0 on level 1, turn 9 only inside of cell 0 on level 2
+    BOOST_CHECK_EQUAL(filter.GetMaxLevel(partition, 0), 0);
+    BOOST_CHECK_EQUAL(filter.GetMaxLevel(partition, 2), 1);
+    BOOST_CHECK_EQUAL(filter.GetMaxLevel(partition, 4), INVALID_LEVEL_ID);
+}
+
+BOOST_AUTO_TEST_CASE(filter_without_active_conditions)
+{
+    const auto partition = makePartition();
+    const auto conditional_turns = makeConditionalTurns();
+
+    const ConditionalTurnFilter filter(partition, conditional_turns, 250);
+    BOOST_CHECK(filter.Empty());
+    BOOST_CHECK(!filter.IsRestricted(5));
+    BOOST_CHECK_EQUAL(filter.GetMaxLevel(partition, 0), INVALID_LEVEL_ID);
+
+    const ConditionalTurnFilter later_filter(partition, conditional_turns, 350);
+    BOOST_CHECK(later_filter.IsRestricted(5));
+    BOOST_CHECK(!later_filter.IsRestricted(70000));
+    BOOST_CHECK_EQUAL(later_filter.GetMaxLevel(partition, 4), INVALID_LEVEL_ID);
+}
+
+BOOST_AUTO_TEST_CASE(cached_filters_are_evaluated_at_the_start_of_the_minute)
+{
+    const auto partition = makePartition();
+    const auto conditional_turns = makeConditionalTurns();
+    ConditionalTurnFilterCache cache;
+
+    // both fall into the minute starting at 120, condition 1 is only active from 150 to 160
+    for (const auto time : {130u, 179u})
+    {
+        const auto filter = cache.Get(partition, conditional_turns, time);
+        BOOST_CHECK(filter.IsRestricted(5));
+        BOOST_CHECK(!filter.IsRestricted(70000));
+    }
+
+    BOOST_CHECK(cache.Get(partition, conditional_turns, 250).Empty());
+    BOOST_CHECK(cache.Get(partition, conditional_turns, 370).IsRestricted(9));
+
+    // a later minute in the same slot replaces the cached filter
+    BOOST_CHECK(cache.Get(partition, conditional_turns, 18 * 60 + 10).Empty());
+    BOOST_CHECK(cache.Get(partition, conditional_turns, 130).IsRestricted(5));
+}
+
+BOOST_AUTO_TEST_CASE(filter_checks_the_turn_of_merged_edges_in_search_direction)
+{
+    const auto partition = makePartition();
+    const auto conditional_turns = makeConditionalTurns();
+    const ConditionalTurnFilter filter(partition, conditional_turns, 155);
+
+    // the merged edge 0 -> 1 keeps turn 5, its copy at node 1 keeps the turn 6 of 1 -> 0
+    const MockFacade facade{{0, 1}, {1, 0}, {{true, true, 5}, {true, true, 6}}};
+
+    BOOST_CHECK(filter.IsRestricted(facade, 0, 0, false));
+    BOOST_CHECK(!filter.IsRestricted(facade, 0, 0, true));
+    BOOST_CHECK(!filter.IsRestricted(facade, 1, 1, false));
+    BOOST_CHECK(filter.IsRestricted(facade, 1, 1, true));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+#include "engine/api/pbf_factory.hpp"
+
+#include <protozero/pbf_reader.hpp>
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(pbf_factory)
+
+using namespace osrm;
+using namespace osrm::engine::api;
+
+BOOST_AUTO_TEST_CASE(geometry_is_delta_encoded)
+{
+    const std::vector<util::Coordinate> coordinates = {
+        {util::FixedLongitude{13388860}, util::FixedLatitude{52517037}},
+        {util::FixedLongitude{13397634}, util::FixedLatitude{52529407}},
+        {util::FixedLongitude{13397634}, util::FixedLatitude{52517037}}};
+
+    std::string buffer;
+    {
+        protozero::pbf_writer writer(buffer);
+        pbf::writeGeometry(writer, pbf::route::geometry, coordinates.begin(), coordinates.end());
+    }
+
+    protozero::pbf_reader reader(buffer);
+    BOOST_REQUIRE(reader.next(pbf::route::geometry));
+    const auto range = reader.get_packed_sint32();
+    const std::vector<std::int32_t> deltas(range.begin(), range.end());
+    const std::vector<std::int32_t> expected = {13388860, 52517037, 8774, 12370, 0, -12370};
+    BOOST_CHECK_EQUAL_COLLECTIONS(deltas.begin(), deltas.end(), expected.begin(), expected.end());
+    BOOST_CHECK(!reader.next());
+}
+
+BOOST_AUTO_TEST_CASE(waypoint_without_hint)
+{
+    std::string buffer;
+    {
+        protozero::pbf_writer writer(buffer);
+        pbf::writeWaypoint(writer,
+                           pbf::response::waypoints,
+                           {util::FixedLongitude{-1000000}, util::FixedLatitude{2000000}},
+                           "Unter den Linden",
+                           boost::none);
+    }
+
+    protozero::pbf_reader response(buffer);
+    BOOST_REQUIRE(response.next(pbf::response::waypoints));
+    auto waypoint = response.get_message();
+    BOOST_REQUIRE(waypoint.next(pbf::waypoint::longitude));
+    BOOST_CHECK_EQUAL(waypoint.get_sint32(), -1000000);
+    BOOST_REQUIRE(waypoint.next(pbf::waypoint::latitude));
+    BOOST_CHECK_EQUAL(waypoint.get_sint32(), 2000000);
+    BOOST_REQUIRE(waypoint.next(pbf::waypoint::name));
+    BOOST_CHECK_EQUAL(waypoint.get_string(), "Unter den Linden");
+    BOOST_CHECK(!waypoint.next());
+}
+
+BOOST_AUTO_TEST_CASE(waypoint_hint_is_raw_bytes)
+{
+    engine::Hint hint;
+    hint.data_checksum = 0xdeadbeef;
+
+    std::string buffer;
+    {
+        protozero::pbf_writer writer(buffer);
+        pbf::writeWaypoint(writer, pbf::response::sources, {}, "", hint);
+    }
+
+    protozero::pbf_reader response(buffer);
+    BOOST_REQUIRE(response.next(pbf::response::sources));
+    auto waypoint = response.get_message();
+    BOOST_REQUIRE(waypoint.next(pbf::waypoint::hint));
+    const auto bytes = waypoint.get_view();
+    BOOST_REQUIRE_EQUAL(bytes.size(), sizeof(engine::Hint));
+
+    engine::Hint decoded;
+    std::copy(bytes.data(), bytes.data() + bytes.size(), reinterpret_cast<char *>(&decoded));
+    BOOST_CHECK_EQUAL(decoded, hint);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -46,4 +46,36 @@ BOOST_AUTO_TEST_CASE(polyline6_test_case)
         decodePolyline<1000000>(encodePolyline<1000000>(coords.begin(), coords.end())).begin()));
 }
 
+BOOST_AUTO_TEST_CASE(polyline_append_test_case)
+{
+    using namespace osrm::engine;
+    using namespace osrm::util;
+
+    const std::vector<Coordinate> coords({{FixedLongitude{-73990171}, FixedLatitude{40714701}},
+                                          {FixedLongitude{-73991801}, FixedLatitude{40717571}},
+                                          {FixedLongitude{-73985751}, FixedLatitude{40715651}}});
+
+    std::string buffer = "polyline(";
+    encodePolyline(coords.begin(), coords.end(), buffer);
+    BOOST_CHECK_EQUAL(buffer, "polyline({aowFperbM}PdI~Jyd@");
+}
+
+BOOST_AUTO_TEST_CASE(polyline_long_test_case)
+{
+    using namespace osrm::engine;
+    using namespace osrm::util;
+
+    // long enough for the decoder to skip the bound checks, with large and small deltas
+    std::vector<Coordinate> coords;
+    for (int index = 0; index < 100; ++index)
+    {
+        const auto sign = index % 2 == 0 ? 1 : -1;
+        coords.push_back({FixedLongitude{sign * 179000000 + index}, FixedLatitude{index * 1000}});
+    }
+
+    const auto polyline = encodePolyline<1000000>(coords.begin(), coords.end());
+    const auto decoded = decodePolyline<1000000>(polyline);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decoded.begin(), decoded.end(), coords.begin(), coords.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+#include "engine/request_parallelism.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(request_parallelism)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(visits_every_index_once)
+{
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto &visit : visits)
+        visit = 0;
+
+    parallelForRequest(4, visits.size(), [&](const std::size_t begin, const std::size_t end) {
+        for (auto index = begin; index < end; ++index)
+            ++visits[index];
+    });
+
+    for (const auto &visit : visits)
+        BOOST_CHECK_EQUAL(visit, 1);
+}
+
+BOOST_AUTO_TEST_CASE(nested_calls_share_the_bound)
+{
+    std::atomic<int> max_concurrency{0};
+    std::atomic<int> inner_calls{0};
+
+    parallelForRequest(2, 8, [&](const std::size_t begin, const std::size_t end) {
+        for (auto index = begin; index < end; ++index)
+        {
+            parallelForRequest(2, 8, [&](const std::size_t first, const std::size_t last) {
+                inner_calls += static_cast<int>(last - first);
+                const int current = tbb::this_task_arena::max_concurrency();
+                int seen = max_concurrency;
+                while (current > seen && !max_concurrency.compare_exchange_weak(seen, current))
+                    ;
+            });
+        }
+    });
+
+    BOOST_CHECK_EQUAL(inner_calls, 64);
+    BOOST_CHECK_LE(max_concurrency, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
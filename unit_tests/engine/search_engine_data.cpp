@@ -0,0 +1,93 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+using MLD = routing_algorithms::mld::Algorithm;
+
+BOOST_AUTO_TEST_CASE(heaps_are_trimmed_after_interval)
+{
+    SearchEngineData<MLD> heaps;
+    heaps.heap_trim_interval = 2;
+
+    heaps.InitializeOrClearFirstThreadLocalStorage(100);
+    for (NodeID node = 0; node < 100; ++node)
+        heaps.forward_heap_1->Insert(node, node, node);
+
+    // the searches of one query clear the heaps many times but count once
+    const auto trims = getSearchEngineHeapStats().number_of_trims;
+    heaps.forward_heap_1->Clear();
+    heaps.forward_heap_1->Clear();
+    BOOST_CHECK_EQUAL(heaps.forward_heap_1->GetQueriesSinceTrim(), 1);
+    BOOST_CHECK_EQUAL(getSearchEngineHeapStats().number_of_trims, trims);
+
+    heaps.InitializeOrClearFirstThreadLocalStorage(100);
+    BOOST_CHECK_EQUAL(heaps.forward_heap_1->GetHighWaterMark(), 0);
+    BOOST_CHECK_EQUAL(getSearchEngineHeapStats().number_of_trims, trims + 2);
+
+    const auto stats = getSearchEngineHeapStats();
+    BOOST_CHECK_GE(stats.number_of_heaps, 2);
+    BOOST_CHECK_GT(stats.memory_usage, 0);
+    BOOST_CHECK_GE(stats.peak_memory_usage, stats.memory_usage);
+}
+
+BOOST_AUTO_TEST_CASE(released_heaps_are_shared_through_the_pool)
+{
+    SearchEngineData<MLD> heaps;
+    heaps.heap_pool_size = 1;
+
+    const SearchEngineData<MLD>::QueryHeap *released_heap = nullptr;
+    std::thread thread([&] {
+        heaps.InitializeOrClearManyToManyThreadLocalStorage(100);
+        heaps.InitializeOrClearFirstThreadLocalStorage(100);
+        released_heap = heaps.forward_heap_1.get();
+        heaps.ReleaseThreadLocalStorage();
+        BOOST_CHECK(!heaps.forward_heap_1.get());
+    });
+    thread.join();
+
+    // one of the query heaps fits into the pool next to the many-to-many heap
+    BOOST_CHECK_EQUAL(getSearchEngineHeapStats().number_of_pooled_heaps, 2);
+
+    // the heaps of a new thread come from the pool
+    std::thread other_thread([&] {
+        heaps.InitializeOrClearFirstThreadLocalStorage(100);
+        BOOST_CHECK(heaps.forward_heap_1.get() == released_heap);
+        heaps.ReleaseThreadLocalStorage();
+    });
+    other_thread.join();
+}
+
+BOOST_AUTO_TEST_CASE(heaps_of_finished_threads_leave_the_stats)
+{
+    SearchEngineData<MLD> heaps;
+
+    SearchEngineHeapStats during;
+    std::size_t thread_memory_usage = 0;
+    std::thread thread([&] {
+        heaps.InitializeOrClearFirstThreadLocalStorage(100);
+        for (NodeID node = 0; node < 100; ++node)
+            heaps.forward_heap_1->Insert(node, node, node);
+        heaps.InitializeOrClearFirstThreadLocalStorage(100);
+
+        during = getSearchEngineHeapStats();
+        thread_memory_usage =
+            heaps.forward_heap_1->GetMemoryUsage() + heaps.reverse_heap_1->GetMemoryUsage();
+    });
+    thread.join();
+
+    BOOST_CHECK_GT(thread_memory_usage, 0);
+    BOOST_CHECK_GE(during.peak_memory_usage, during.memory_usage);
+
+    const auto after = getSearchEngineHeapStats();
+    BOOST_CHECK_EQUAL(after.number_of_heaps, during.number_of_heaps - 2);
+    BOOST_CHECK_EQUAL(after.memory_usage, during.memory_usage - thread_memory_usage);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
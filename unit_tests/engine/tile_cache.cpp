@@ -0,0 +1,58 @@
+#include "engine/tile_cache.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(tile_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(get_put_test)
+{
+    TileCache cache(100);
+
+    std::string pbf_buffer;
+    BOOST_CHECK(!cache.Get({1, 2, 14, 0}, pbf_buffer));
+
+    cache.Put({1, 2, 14, 0}, "tile");
+    BOOST_CHECK(cache.Contains({1, 2, 14, 0}));
+    BOOST_CHECK(cache.Get({1, 2, 14, 0}, pbf_buffer));
+    BOOST_CHECK_EQUAL(pbf_buffer, "tile");
+
+    // the same tile of another dataset
+    BOOST_CHECK(!cache.Contains({1, 2, 14, 1}));
+
+    // replacing a tile updates the size
+    cache.Put({1, 2, 14, 0}, "new tile");
+    BOOST_CHECK(cache.Get({1, 2, 14, 0}, pbf_buffer));
+    BOOST_CHECK_EQUAL(pbf_buffer, "new tile");
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(eviction_test)
+{
+    TileCache cache(10);
+
+    cache.Put({0, 0, 12, 0}, "aaaa");
+    cache.Put({1, 0, 12, 0}, "bbbb");
+
+    // makes the first tile the most recently used one
+    std::string pbf_buffer;
+    BOOST_CHECK(cache.Get({0, 0, 12, 0}, pbf_buffer));
+
+    cache.Put({2, 0, 12, 0}, "cccc");
+    BOOST_CHECK(cache.Contains({0, 0, 12, 0}));
+    BOOST_CHECK(!cache.Contains({1, 0, 12, 0}));
+    BOOST_CHECK(cache.Contains({2, 0, 12, 0}));
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 8);
+
+    // tiles larger than the cache are not stored
+    cache.Put({3, 0, 12, 0}, "ddddddddddd");
+    BOOST_CHECK(!cache.Contains({3, 0, 12, 0}));
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+#include "engine/trip/trip_local_search.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_solvers)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// asymmetric table of random weights
+util::DistTableWrapper<EdgeWeight> makeTable(const std::size_t number_of_locations,
+                                             std::mt19937 &generator)
+{
+    std::uniform_int_distribution<EdgeWeight> weight(1, 1000);
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+            if (from != to)
+                table[from * number_of_locations + to] = weight(generator);
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+EdgeWeight getWeight(const util::DistTableWrapper<EdgeWeight> &table,
+                     const std::vector<NodeID> &route)
+{
+    return trip::ReturnDistance(table, route, INVALID_EDGE_WEIGHT, route.size());
+}
+
+bool isPermutation(const std::vector<NodeID> &route, const std::size_t number_of_locations)
+{
+    std::vector<NodeID> ids(number_of_locations);
+    std::iota(ids.begin(), ids.end(), 0);
+    return std::is_permutation(route.begin(), route.end(), ids.begin(), ids.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(held_karp_is_optimal)
+{
+    std::mt19937 generator(1337);
+    for (std::size_t number_of_locations = 1; number_of_locations < 9; ++number_of_locations)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            const auto table = makeTable(number_of_locations, generator);
+            const auto route = trip::HeldKarpTrip(number_of_locations, table);
+            BOOST_REQUIRE(isPermutation(route, number_of_locations));
+            BOOST_CHECK_EQUAL(getWeight(table, route),
+                              getWeight(table, trip::BruteForceTrip(number_of_locations, table)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(held_karp_avoids_invalid_edges)
+{
+    // only the round trip 0 -> 2 -> 1 -> 3 -> 0 is possible
+    const auto X = INVALID_EDGE_WEIGHT;
+    std::vector<EdgeWeight> table = {0, X, 5, X, X, 0, X, 7, X, 3, 0, X, 1, X, X, 0};
+    util::DistTableWrapper<EdgeWeight> dist_table(table, 4);
+
+    const auto route = trip::HeldKarpTrip(4, dist_table);
+    const std::vector<NodeID> expected = {0, 2, 1, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(route.begin(), route.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(local_search_improves_farthest_insertion)
+{
+    std::mt19937 generator(42);
+    for (const std::size_t number_of_locations : {4, 9, 30, 100})
+    {
+        const auto table = makeTable(number_of_locations, generator);
+        const auto route =
+            trip::LocalSearchTrip(number_of_locations, table, std::chrono::milliseconds{1000});
+        BOOST_REQUIRE(isPermutation(route, number_of_locations));
+
+        const auto farthest_insertion = trip::FarthestInsertionTrip(number_of_locations, table);
+        BOOST_CHECK_LE(getWeight(table, route), getWeight(table, farthest_insertion));
+
+        if (number_of_locations < 10)
+        {
+            const auto optimal = trip::BruteForceTrip(number_of_locations, table);
+            BOOST_CHECK_GE(getWeight(table, route), getWeight(table, optimal));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(improve_trip_keeps_valid_trips)
+{
+    std::mt19937 generator(7);
+    const std::size_t number_of_locations = 20;
+    auto table = makeTable(number_of_locations, generator);
+    // forbid all edges from 0 except the one to 1
+    for (NodeID to = 2; to < number_of_locations; ++to)
+        table.SetValue(0, to, INVALID_EDGE_WEIGHT);
+
+    std::vector<NodeID> route(number_of_locations);
+    std::iota(route.begin(), route.end(), 0);
+    std::shuffle(route.begin() + 2, route.end(), generator);
+    const auto initial_weight = getWeight(table, route);
+
+    const auto neighbours = trip::detail::GetNeighbours(number_of_locations, table);
+    trip::ImproveTrip(table, neighbours, std::chrono::steady_clock::time_point::max(), route);
+
+    BOOST_REQUIRE(isPermutation(route, number_of_locations));
+    const auto weight = getWeight(table, route);
+    BOOST_CHECK_NE(weight, INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_LT(weight, initial_weight);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+#include "engine/unpacking_cache.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(unpacking_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+std::shared_ptr<const UnpackedSubpath> makeSubpath(const NodeID source, const NodeID target)
+{
+    auto subpath = std::make_shared<UnpackedSubpath>();
+    subpath->nodes = {source, target};
+    subpath->edges = {42};
+    return subpath;
+}
+}
+
+BOOST_AUTO_TEST_CASE(get_put_test)
+{
+    UnpackingCache cache(1024 * 1024);
+
+    const UnpackingKey key{1, 7, 10, 20, false, false};
+    BOOST_CHECK(!cache.Get(key));
+
+    cache.Put(key, makeSubpath(10, 20));
+    const auto subpath = cache.Get(key);
+    BOOST_REQUIRE(subpath);
+    BOOST_CHECK_EQUAL(subpath->nodes.front(), 10);
+    BOOST_CHECK_EQUAL(subpath->nodes.back(), 20);
+    BOOST_CHECK_EQUAL(subpath->edges.size(), 1);
+
+    // the same edge unpacked on another level or with forced loops is a different entry
+    BOOST_CHECK(!cache.Get({2, 7, 10, 20, false, false}));
+    BOOST_CHECK(!cache.Get({1, 7, 10, 20, true, false}));
+    BOOST_CHECK(!cache.Get({1, 7, 10, 20, false, true}));
+}
+
+BOOST_AUTO_TEST_CASE(eviction_test)
+{
+    // every shard holds two of the paths below, keys with source % 64 == 0 share a shard
+    UnpackingCache cache(64 * 300);
+
+    const UnpackingKey first{1, 0, 0, 0, false, false};
+    const UnpackingKey second{1, 0, 64, 0, false, false};
+    const UnpackingKey third{1, 0, 128, 0, false, false};
+
+    cache.Put(first, makeSubpath(0, 0));
+    cache.Put(second, makeSubpath(64, 0));
+
+    // makes the first path the most recently used one
+    BOOST_CHECK(cache.Get(first));
+
+    cache.Put(third, makeSubpath(128, 0));
+    BOOST_CHECK(cache.Get(first));
+    BOOST_CHECK(!cache.Get(second));
+    BOOST_CHECK(cache.Get(third));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -64,4 +64,66 @@ BOOST_AUTO_TEST_CASE(test_match)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_match_parallel_sub_matchings_match_sequential_sub_matchings)
+{
+    using namespace osrm;
+
+    const auto get_matchings = [](const EngineConfig::Algorithm algorithm,
+                                  const std::string &path,
+                                  const unsigned request_parallelism) {
+        EngineConfig config;
+        config.storage_config = {path};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        config.request_parallelism = request_parallelism;
+        const OSRM osrm{config};
+
+        // the time gap splits the trace into two sub-matchings with two legs each
+        MatchParameters params;
+        unsigned timestamp = 0;
+        for (const auto gap : {0u, 1000u})
+        {
+            timestamp += gap;
+            for (const auto &location : get_locations_in_big_component())
+            {
+                params.coordinates.push_back(location);
+                params.timestamps.push_back(timestamp);
+                timestamp += 10;
+            }
+        }
+
+        json::Object result;
+        BOOST_REQUIRE(osrm.Match(params, result) == Status::Ok);
+
+        std::vector<double> matchings;
+        for (const auto &matching : result.values.at("matchings").get<json::Array>().values)
+        {
+            const auto &values = matching.get<json::Object>().values;
+            matchings.push_back(values.at("legs").get<json::Array>().values.size());
+            matchings.push_back(values.at("weight").get<json::Number>().value);
+        }
+        return matchings;
+    };
+
+    const auto ch_matchings =
+        get_matchings(EngineConfig::Algorithm::CH, OSRM_TEST_DATA_DIR "/ch/monaco.osrm", 1);
+    const auto ch_parallel_matchings =
+        get_matchings(EngineConfig::Algorithm::CH, OSRM_TEST_DATA_DIR "/ch/monaco.osrm", 4);
+    BOOST_CHECK_GE(ch_matchings.size(), 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ch_matchings.begin(),
+                                  ch_matchings.end(),
+                                  ch_parallel_matchings.begin(),
+                                  ch_parallel_matchings.end());
+
+    const auto mld_matchings =
+        get_matchings(EngineConfig::Algorithm::MLD, OSRM_TEST_DATA_DIR "/mld/monaco.osrm", 1);
+    const auto mld_parallel_matchings =
+        get_matchings(EngineConfig::Algorithm::MLD, OSRM_TEST_DATA_DIR "/mld/monaco.osrm", 4);
+    BOOST_CHECK_GE(mld_matchings.size(), 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(mld_matchings.begin(),
+                                  mld_matchings.end(),
+                                  mld_parallel_matchings.begin(),
+                                  mld_parallel_matchings.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
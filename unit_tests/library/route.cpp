@@ -414,6 +414,61 @@ BOOST_AUTO_TEST_CASE(speed_annotation_matches_duration_and_distance)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_route_parallel_legs_match_sequential_legs)
+{
+    using namespace osrm;
+
+    const auto get_weights = [](const EngineConfig::Algorithm algorithm,
+                                const std::string &path,
+                                const unsigned request_parallelism) {
+        EngineConfig config;
+        config.storage_config = {path};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        config.request_parallelism = request_parallelism;
+        const OSRM osrm{config};
+
+        std::vector<double> weights;
+        for (const bool continue_straight : {true, false})
+        {
+            RouteParameters params;
+            params.continue_straight = continue_straight;
+            for (const auto &location : get_locations_in_big_component())
+                params.coordinates.push_back(location);
+            for (const auto &location : get_locations_in_big_component())
+                params.coordinates.push_back(location);
+
+            json::Object result;
+            BOOST_REQUIRE(osrm.Route(params, result) == Status::Ok);
+
+            const auto &route = result.values.at("routes").get<json::Array>().values.at(0);
+            const auto &legs = route.get<json::Object>().values.at("legs").get<json::Array>();
+            BOOST_CHECK_EQUAL(legs.values.size(), params.coordinates.size() - 1);
+            const auto &weight = route.get<json::Object>().values.at("weight");
+            weights.push_back(weight.get<json::Number>().value);
+        }
+        return weights;
+    };
+
+    const auto ch_weights =
+        get_weights(EngineConfig::Algorithm::CH, OSRM_TEST_DATA_DIR "/ch/monaco.osrm", 1);
+    const auto ch_parallel_weights =
+        get_weights(EngineConfig::Algorithm::CH, OSRM_TEST_DATA_DIR "/ch/monaco.osrm", 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ch_weights.begin(),
+                                  ch_weights.end(),
+                                  ch_parallel_weights.begin(),
+                                  ch_parallel_weights.end());
+
+    const auto mld_weights =
+        get_weights(EngineConfig::Algorithm::MLD, OSRM_TEST_DATA_DIR "/mld/monaco.osrm", 1);
+    const auto mld_parallel_weights =
+        get_weights(EngineConfig::Algorithm::MLD, OSRM_TEST_DATA_DIR "/mld/monaco.osrm", 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(mld_weights.begin(),
+                                  mld_weights.end(),
+                                  mld_parallel_weights.begin(),
+                                  mld_parallel_weights.end());
+}
+
 BOOST_AUTO_TEST_CASE(test_manual_setting_of_annotations_property)
 {
     auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
@@ -4,6 +4,7 @@
 // implements all data storage when shared memory _IS_ used
 
 #include "contractor/query_edge.hpp"
+#include "customizer/speed_profiles.hpp"
 #include "extractor/class_data.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
@@ -50,41 +51,47 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     {
         return 0;
     }
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
+    std::uint16_t GetSpeedFactor(const NodeID /* id */) const override final
     {
-        return {};
+        return customizer::SPEED_PROFILE_BASE_FACTOR;
     }
-    std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID /* id */) const override
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID /* id */) const override
     {
         return {};
     }
-    std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID /* id */) const override
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override
     {
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(1);
-        result_weights[0] = 1;
-        return result_weights;
+        return NodeReverseRange(GetUncompressedForwardGeometry(id));
     }
-    std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const override
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID /* id */) const override
     {
-        return GetUncompressedForwardWeights(id);
+        using WeightVector = extractor::SegmentDataView::SegmentWeightVector;
+        // a single segment with weight 1, stored in the lowest bits of the first word
+        static std::uint64_t data[WeightVector::BLOCK_ELEMENTS] = {1};
+        static const WeightVector weights(
+            util::vector_view<std::uint64_t>(data, WeightVector::BLOCK_ELEMENTS), 1);
+        return WeightForwardRange(weights.cbegin(), weights.cend());
     }
-    std::vector<EdgeWeight> GetUncompressedForwardDurations(const EdgeID id) const override
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return WeightReverseRange(GetUncompressedForwardWeights(id));
     }
-    std::vector<EdgeWeight> GetUncompressedReverseDurations(const EdgeID id) const override
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const override
     {
         return GetUncompressedForwardWeights(id);
     }
-    std::vector<DatasourceID> GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override
     {
-        return {};
+        return DurationReverseRange(GetUncompressedForwardDurations(id));
     }
-    std::vector<DatasourceID> GetUncompressedReverseDatasources(const EdgeID /*id*/) const override
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
     {
         return {};
     }
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override
+    {
+        return DatasourceReverseRange(GetUncompressedForwardDatasources(id));
+    }
 
     StringView GetDatasourceName(const DatasourceID) const override final { return {}; }
 
@@ -0,0 +1,79 @@
+#include "server/compute_pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(compute_pool)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(runs_all_tasks)
+{
+    std::atomic<int> executed{0};
+    {
+        ComputePool pool(4, false);
+        BOOST_CHECK_EQUAL(pool.GetNumberOfThreads(), 4);
+
+        for (int index = 0; index < 1000; ++index)
+            pool.Submit([&] { ++executed; });
+
+        while (executed < 1000)
+            std::this_thread::yield();
+        pool.Stop();
+
+        const auto stats = pool.GetStats();
+        BOOST_CHECK_EQUAL(stats.executed, 1000);
+        BOOST_CHECK_EQUAL(stats.queued, 0);
+    }
+    BOOST_CHECK_EQUAL(executed, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(steals_from_blocked_threads)
+{
+    ComputePool pool(2, false);
+
+    std::promise<void> started;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    pool.Submit([&started, released] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    // half of the tasks are queued behind the blocked task
+    std::atomic<int> executed{0};
+    for (int index = 0; index < 10; ++index)
+        pool.Submit([&] { ++executed; });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (executed < 10 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    BOOST_CHECK_EQUAL(executed, 10);
+    BOOST_CHECK_GT(pool.GetStats().stolen, 0);
+
+    release.set_value();
+    pool.Stop();
+    BOOST_CHECK_EQUAL(pool.GetStats().executed, 11);
+}
+
+BOOST_AUTO_TEST_CASE(tasks_may_throw)
+{
+    ComputePool pool(1, true);
+    std::atomic<bool> done{false};
+    pool.Submit([] { throw std::runtime_error("failed"); });
+    pool.Submit([&] { done = true; });
+
+    while (!done)
+        std::this_thread::yield();
+    pool.Stop();
+    BOOST_CHECK_EQUAL(pool.GetStats().executed, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
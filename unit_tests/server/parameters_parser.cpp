@@ -53,6 +53,7 @@ BOOST_AUTO_TEST_CASE(invalid_route_urls)
                       32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?generate_hints=notboolean"),
                       23UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?departure_time=now"), 23UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?overview=false&geometries=foo"),
                       34UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?overview=false&overview=foo"),
@@ -66,6 +67,7 @@ BOOST_AUTO_TEST_CASE(invalid_route_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4.json?nooptions"), 13);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4..json?nooptions"), 14);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4.0.json?nooptions"), 15);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4.pbf"), 10);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>(std::string{"1,2;3,4"} + '\0' + ".json"),
                       7);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>(std::string{"1,2;3,"} + '\0'), 6);
@@ -336,6 +338,11 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     auto result_13 = parseParameters<RouteParameters>("1,2;3,4");
     BOOST_CHECK(result_13);
     BOOST_CHECK_EQUAL(result_13->generate_hints, true);
+    BOOST_CHECK(!result_13->departure_time);
+
+    auto result_departure = parseParameters<RouteParameters>("1,2;3,4?departure_time=1483340400");
+    BOOST_CHECK(result_departure);
+    BOOST_CHECK_EQUAL(*result_departure->departure_time, 1483340400);
 
     // parse none annotations value correctly
     RouteParameters reference_14{};
@@ -471,6 +478,12 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     CHECK_EQUAL_RANGE(reference_20.approaches, result_20->approaches);
     CHECK_EQUAL_RANGE(reference_20.coordinates, result_20->coordinates);
     CHECK_EQUAL_RANGE(reference_20.hints, result_20->hints);
+
+    auto result_21 = parseParameters<RouteParameters>("1,2;3,4.pb?overview=full");
+    BOOST_CHECK(result_21);
+    BOOST_CHECK(result_21->format == RouteParameters::OutputFormatType::PBF);
+    BOOST_CHECK_EQUAL(result_21->overview, RouteParameters::OverviewType::Full);
+    BOOST_CHECK(result_1->format == RouteParameters::OutputFormatType::JSON);
 }
 
 BOOST_AUTO_TEST_CASE(valid_table_urls)
@@ -510,6 +523,16 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4.pb?sources=0");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(result_4->format == TableParameters::OutputFormatType::PBF);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_4->coordinates);
+
+    auto result_5 = parseParameters<TableParameters>("1,2;3.5,4.5.json");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(result_5->format == TableParameters::OutputFormatType::JSON);
+    BOOST_CHECK_EQUAL(result_5->coordinates.back().lat, util::toFixed(util::FloatLatitude{4.5}));
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -628,11 +651,20 @@ BOOST_AUTO_TEST_CASE(valid_trip_urls)
     auto param_nr = parseParameters<TripParameters>("1,2;3,4?roundtrip=false");
     BOOST_CHECK(param_nr->IsValid());
 
+    auto param_solver = parseParameters<TripParameters>("1,2;3,4?solver=exact");
+    BOOST_CHECK(param_solver);
+    BOOST_CHECK(param_solver->solver == TripParameters::SolverType::Exact);
+    param_solver = parseParameters<TripParameters>("1,2;3,4?solver=heuristic&roundtrip=false");
+    BOOST_CHECK(param_solver);
+    BOOST_CHECK(param_solver->solver == TripParameters::SolverType::Heuristic);
+
     auto param_fail_1 =
         testInvalidOptions<TripParameters>("1,2;3,4?source=blubb&destination=random");
     BOOST_CHECK_EQUAL(param_fail_1, 15UL);
     auto param_fail_2 = testInvalidOptions<TripParameters>("1,2;3,4?source=first&destination=nah");
     BOOST_CHECK_EQUAL(param_fail_2, 33UL);
+    auto param_fail_3 = testInvalidOptions<TripParameters>("1,2;3,4?solver=random");
+    BOOST_CHECK_EQUAL(param_fail_3, 15UL);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+#include "updater/binary_source.hpp"
+#include "updater/source.hpp"
+
+#include "util/exception.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(binary_source)
+
+using namespace osrm;
+using namespace osrm::updater;
+
+namespace
+{
+struct TemporaryFile
+{
+    TemporaryFile()
+        : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+                   .string())
+    {
+    }
+    ~TemporaryFile() { boost::filesystem::remove(path); }
+
+    std::string path;
+};
+
+SpeedSource makeSpeed(unsigned speed, double rate)
+{
+    SpeedSource value;
+    value.speed = speed;
+    value.rate = rate;
+    value.source = 0;
+    return value;
+}
+}
+
+BOOST_AUTO_TEST_CASE(sort_unique_keeps_last_value)
+{
+    std::vector<std::pair<Segment, SpeedSource>> values = {{{2, 3}, makeSpeed(10, 1.)},
+                                                           {{1, 2}, makeSpeed(20, 1.)},
+                                                           {{2, 3}, makeSpeed(30, 1.)}};
+    sortUniqueValues(values);
+
+    BOOST_REQUIRE_EQUAL(values.size(), 2);
+    BOOST_CHECK(values[0].first == Segment(1, 2));
+    BOOST_CHECK(values[1].first == Segment(2, 3));
+    BOOST_CHECK_EQUAL(values[1].second.speed, 30);
+}
+
+BOOST_AUTO_TEST_CASE(merge_prefers_later_sources)
+{
+    std::vector<std::vector<std::pair<Segment, SpeedSource>>> sources = {
+        {{{1, 2}, makeSpeed(10, 1.)}, {{2, 3}, makeSpeed(10, 1.)}},
+        {{{0, 1}, makeSpeed(20, 1.)}, {{2, 3}, makeSpeed(20, 1.)}, {{3, 4}, makeSpeed(20, 1.)}}};
+    const auto lookup = mergeValues(std::move(sources));
+
+    BOOST_REQUIRE_EQUAL(lookup.lookup.size(), 4);
+    BOOST_CHECK_EQUAL(lookup({0, 1})->speed, 20);
+    BOOST_CHECK_EQUAL(lookup({1, 2})->speed, 10);
+    BOOST_CHECK_EQUAL(lookup({2, 3})->speed, 20);
+    BOOST_CHECK_EQUAL(lookup({3, 4})->speed, 20);
+    BOOST_CHECK(!lookup({4, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(segment_snapshot_roundtrip)
+{
+    TemporaryFile file;
+    const std::vector<std::pair<Segment, SpeedSource>> values = {
+        {{1, 2}, makeSpeed(10, 2.5)}, {{1, 3}, makeSpeed(0, 0.)}, {{4, 1}, makeSpeed(27, NAN)}};
+    binary::writeSegmentValues(file.path, values);
+
+    BOOST_CHECK(binary::isSnapshotFile(file.path));
+    const auto loaded = binary::readSegmentValues(file.path, 3);
+    BOOST_REQUIRE_EQUAL(loaded.size(), values.size());
+    for (std::size_t index = 0; index < values.size(); ++index)
+    {
+        BOOST_CHECK(loaded[index].first == values[index].first);
+        BOOST_CHECK_EQUAL(loaded[index].second.speed, values[index].second.speed);
+        BOOST_CHECK_EQUAL(loaded[index].second.source, 3);
+    }
+    BOOST_CHECK_EQUAL(loaded[0].second.rate, 2.5);
+    BOOST_CHECK(std::isnan(loaded[2].second.rate));
+}
+
+BOOST_AUTO_TEST_CASE(turn_snapshot_roundtrip)
+{
+    TemporaryFile file;
+    PenaltySource penalty;
+    penalty.duration = 4.5;
+    penalty.weight = 3.;
+    const std::vector<std::pair<Turn, PenaltySource>> values = {{{1, 2, 3}, penalty},
+                                                                {{3, 2, 1}, penalty}};
+    binary::writeTurnValues(file.path, values);
+
+    const auto loaded = binary::readTurnValues(file.path, 1);
+    BOOST_REQUIRE_EQUAL(loaded.size(), 2);
+    BOOST_CHECK(loaded[1].first == Turn(3, 2, 1));
+    BOOST_CHECK_EQUAL(loaded[1].second.duration, 4.5);
+    BOOST_CHECK_EQUAL(loaded[1].second.weight, 3.);
+
+    // a turn snapshot can not be used as segment speeds
+    BOOST_CHECK_THROW(binary::readSegmentValues(file.path, 1), util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(mixed_csv_and_snapshot_files)
+{
+    TemporaryFile snapshot;
+    binary::writeSegmentValues(snapshot.path,
+                               {{{1, 2}, makeSpeed(10, NAN)}, {{2, 3}, makeSpeed(10, NAN)}});
+
+    TemporaryFile csv;
+    {
+        std::ofstream output(csv.path);
+        output << "2,3,20\n3,4,20,5.5\n";
+    }
+    BOOST_CHECK(!binary::isSnapshotFile(csv.path));
+
+    const auto lookup = readSegmentValues({snapshot.path, csv.path});
+    BOOST_REQUIRE_EQUAL(lookup.lookup.size(), 3);
+    BOOST_CHECK_EQUAL(lookup({1, 2})->source, 1);
+    BOOST_CHECK_EQUAL(lookup({2, 3})->speed, 20);
+    BOOST_CHECK_EQUAL(lookup({2, 3})->source, 2);
+    BOOST_CHECK_EQUAL(lookup({3, 4})->rate, 5.5);
+}
+
+BOOST_AUTO_TEST_CASE(speed_profile_csv)
+{
+    TemporaryFile first;
+    {
+        std::ofstream output(first.path);
+        output << "1,2,50 50 20 50\n2,3,30\n";
+    }
+    TemporaryFile second;
+    {
+        std::ofstream output(second.path);
+        output << "2,3,40 10,comment\n";
+    }
+
+    const auto lookup = readSpeedProfileValues({first.path, second.path});
+    BOOST_REQUIRE_EQUAL(lookup.lookup.size(), 2);
+    BOOST_CHECK_EQUAL(lookup({1, 2})->speeds.size(), 4);
+    BOOST_CHECK_EQUAL(lookup({1, 2})->speeds[2], 20);
+    BOOST_CHECK_EQUAL(lookup({2, 3})->speeds.size(), 2);
+    BOOST_CHECK_EQUAL(lookup({2, 3})->source, 2);
+
+    // profiles have no binary snapshots
+    TemporaryFile snapshot;
+    binary::writeSegmentValues(snapshot.path, {{{1, 2}, makeSpeed(10, NAN)}});
+    BOOST_CHECK_THROW(readSpeedProfileValues({snapshot.path}), util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(truncated_snapshot)
+{
+    TemporaryFile file;
+    binary::writeSegmentValues(file.path, {{{1, 2}, makeSpeed(10, NAN)}});
+    boost::filesystem::resize_file(file.path, boost::filesystem::file_size(file.path) - 1);
+
+    BOOST_CHECK_THROW(binary::readSegmentValues(file.path, 1), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -276,4 +276,59 @@ BOOST_AUTO_TEST_CASE(check_opening_hours_extended_hours_nonoverlapping)
     BOOST_CHECK_EQUAL(CheckOpeningHours(opening_hours, time("Thu, 22 Dec 2016 20:00:00")), false);
 }
 
+BOOST_AUTO_TEST_CASE(opening_intervals_weekdays)
+{
+    using osrm::util::ParseOpeningHours;
+    using osrm::util::GetOpeningIntervals;
+
+    // Mon, 02 Jan 2017 00:00:00 UTC
+    const std::time_t monday = 1483315200;
+    const std::time_t hour = 3600, day = 24 * hour;
+
+    const auto &opening_hours = ParseOpeningHours("Mo-Fr 07:00-09:00");
+    const auto intervals = GetOpeningIntervals(opening_hours, monday, monday + 7 * day, 0);
+    BOOST_REQUIRE_EQUAL(intervals.size(), 5);
+    for (std::size_t index = 0; index < intervals.size(); ++index)
+    {
+        const auto midnight = monday + static_cast<std::time_t>(index) * day;
+        BOOST_CHECK_EQUAL(intervals[index].first, midnight + 7 * hour);
+        BOOST_CHECK_EQUAL(intervals[index].second, midnight + 9 * hour);
+    }
+
+    // 07:00 at UTC+1 is 06:00 UTC
+    const auto shifted = GetOpeningIntervals(opening_hours, monday, monday + 7 * day, hour);
+    BOOST_REQUIRE_EQUAL(shifted.size(), 5);
+    BOOST_CHECK_EQUAL(shifted[0].first, monday + 6 * hour);
+    BOOST_CHECK_EQUAL(shifted[0].second, monday + 8 * hour);
+
+    // intervals are clipped to the requested range
+    const auto clipped =
+        GetOpeningIntervals(opening_hours, monday + 8 * hour, monday + day + 8 * hour, 0);
+    BOOST_REQUIRE_EQUAL(clipped.size(), 2);
+    BOOST_CHECK_EQUAL(clipped[0].first, monday + 8 * hour);
+    BOOST_CHECK_EQUAL(clipped[0].second, monday + 9 * hour);
+    BOOST_CHECK_EQUAL(clipped[1].first, monday + day + 7 * hour);
+    BOOST_CHECK_EQUAL(clipped[1].second, monday + day + 8 * hour);
+}
+
+BOOST_AUTO_TEST_CASE(opening_intervals_overnight)
+{
+    using osrm::util::ParseOpeningHours;
+    using osrm::util::GetOpeningIntervals;
+
+    const std::time_t monday = 1483315200;
+    const std::time_t hour = 3600, day = 24 * hour;
+
+    const auto &opening_hours = ParseOpeningHours("22:00-03:00");
+    const auto intervals = GetOpeningIntervals(opening_hours, monday, monday + 2 * day, 0);
+    BOOST_REQUIRE_EQUAL(intervals.size(), 3);
+    BOOST_CHECK_EQUAL(intervals[0].first, monday);
+    BOOST_CHECK_EQUAL(intervals[0].second, monday + 3 * hour);
+    // the span continues over midnight without a break
+    BOOST_CHECK_EQUAL(intervals[1].first, monday + 22 * hour);
+    BOOST_CHECK_EQUAL(intervals[1].second, monday + day + 3 * hour);
+    BOOST_CHECK_EQUAL(intervals[2].first, monday + day + 22 * hour);
+    BOOST_CHECK_EQUAL(intervals[2].second, monday + 2 * day);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
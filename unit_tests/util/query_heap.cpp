@@ -157,4 +157,44 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(trim_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    heap.Clear();
+    BOOST_CHECK_EQUAL(heap.GetHighWaterMark(), NUM_NODES);
+    const auto large_memory_usage = heap.GetMemoryUsage();
+
+    // a trim keeps the memory of the largest query since the last trim
+    heap.Trim();
+    BOOST_CHECK_EQUAL(heap.GetHighWaterMark(), 0);
+    BOOST_CHECK_EQUAL(heap.GetQueriesSinceTrim(), 0);
+
+    for (unsigned idx = 0; idx < 10; ++idx)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    BOOST_CHECK_EQUAL(heap.GetHighWaterMark(), 10);
+    heap.Clear();
+    heap.Clear();
+    BOOST_CHECK_EQUAL(heap.GetQueriesSinceTrim(), 0);
+    heap.CountQuery();
+    BOOST_CHECK_EQUAL(heap.GetQueriesSinceTrim(), 1);
+
+    heap.Trim();
+    BOOST_CHECK_LE(heap.GetMemoryUsage(), large_memory_usage);
+
+    // the heap still works after the trim
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    BOOST_CHECK_EQUAL(heap.Min(), ids.front());
+    BOOST_CHECK(heap.WasInserted(ids.back()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()